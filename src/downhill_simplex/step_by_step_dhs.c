@@ -49,8 +49,36 @@ thot package
 #include <math.h>
 #include <stdlib.h>
 
+// Data of the objective function used by step_by_step_simplex
+struct images_file_data
+{
+  FILE* images_file;
+  double* x;
+  int verbosity;
+};
+
+//--------------------------------------------------------
+static int images_file_objfunc(void* data, int n, double* curr_vertex, double* y)
+{
+  struct images_file_data* file_data = (struct images_file_data*)data;
+  return step_by_step_objfunc(file_data->images_file, n, curr_vertex, file_data->x, y, file_data->verbosity);
+}
+
+//--------------------------------------------------------
 int step_by_step_simplex(double start[], int n, double FTOL, double scale, void (*constrain)(double[], int n),
                          FILE* images_file, int* nfunk, double* y, double* x, double* curr_ftol, int verbosity)
+{
+  struct images_file_data file_data;
+  file_data.images_file = images_file;
+  file_data.x = x;
+  file_data.verbosity = verbosity;
+  return downhill_simplex(start, n, FTOL, scale, constrain, images_file_objfunc, &file_data, nfunk, y, curr_ftol,
+                          verbosity);
+}
+
+//--------------------------------------------------------
+int downhill_simplex(double start[], int n, double FTOL, double scale, void (*constrain)(double[], int n),
+                     dhs_objfunc objfunc, void* objfunc_data, int* nfunk, double* y, double* curr_ftol, int verbosity)
 {
   int vs; /* vertex with smallest value */
   int vh; /* vertex with next smallest value */
@@ -135,11 +163,11 @@ int step_by_step_simplex(double start[], int n, double FTOL, double scale, void
   for (j = 0; j <= n; j++)
   {
     // f[j] = objfunc(v[j]);
-    ret = step_by_step_objfunc(images_file, n, v[j], x, &f[j], verbosity);
-    if (ret == DSO_EVAL_FUNC)
+    ret = objfunc(objfunc_data, n, v[j], &f[j]);
+    if (ret != THOT_OK)
     {
       deallocate_dhs_mem(n, v, f, vr, ve, vc, vm);
-      return DSO_EVAL_FUNC;
+      return ret;
     }
   }
 
@@ -217,11 +245,11 @@ int step_by_step_simplex(double start[], int n, double FTOL, double scale, void
       constrain(vr, n);
     }
     // fr = objfunc(vr);
-    ret = step_by_step_objfunc(images_file, n, vr, x, &fr, verbosity);
-    if (ret == DSO_EVAL_FUNC)
+    ret = objfunc(objfunc_data, n, vr, &fr);
+    if (ret != THOT_OK)
     {
       deallocate_dhs_mem(n, v, f, vr, ve, vc, vm);
-      return DSO_EVAL_FUNC;
+      return ret;
     }
 
     k++;
@@ -248,11 +276,11 @@ int step_by_step_simplex(double start[], int n, double FTOL, double scale, void
         constrain(ve, n);
       }
       // fe = objfunc(ve);
-      ret = step_by_step_objfunc(images_file, n, ve, x, &fe, verbosity);
-      if (ret == DSO_EVAL_FUNC)
+      ret = objfunc(objfunc_data, n, ve, &fe);
+      if (ret != THOT_OK)
       {
         deallocate_dhs_mem(n, v, f, vr, ve, vc, vm);
-        return DSO_EVAL_FUNC;
+        return ret;
       }
 
       k++;
@@ -295,11 +323,11 @@ int step_by_step_simplex(double start[], int n, double FTOL, double scale, void
           constrain(vc, n);
         }
         // fc = objfunc(vc);
-        ret = step_by_step_objfunc(images_file, n, vc, x, &fc, verbosity);
-        if (ret == DSO_EVAL_FUNC)
+        ret = objfunc(objfunc_data, n, vc, &fc);
+        if (ret != THOT_OK)
         {
           deallocate_dhs_mem(n, v, f, vr, ve, vc, vm);
-          return DSO_EVAL_FUNC;
+          return ret;
         }
 
         k++;
@@ -317,11 +345,11 @@ int step_by_step_simplex(double start[], int n, double FTOL, double scale, void
           constrain(vc, n);
         }
         // fc = objfunc(vc);
-        ret = step_by_step_objfunc(images_file, n, vc, x, &fc, verbosity);
-        if (ret == DSO_EVAL_FUNC)
+        ret = objfunc(objfunc_data, n, vc, &fc);
+        if (ret != THOT_OK)
         {
           deallocate_dhs_mem(n, v, f, vr, ve, vc, vm);
-          return DSO_EVAL_FUNC;
+          return ret;
         }
 
         k++;
@@ -357,11 +385,11 @@ int step_by_step_simplex(double start[], int n, double FTOL, double scale, void
           constrain(v[vg], n);
         }
         // f[vg] = objfunc(v[vg]);
-        ret = step_by_step_objfunc(images_file, n, v[vg], x, &f[vg], verbosity);
-        if (ret == DSO_EVAL_FUNC)
+        ret = objfunc(objfunc_data, n, v[vg], &f[vg]);
+        if (ret != THOT_OK)
         {
           deallocate_dhs_mem(n, v, f, vr, ve, vc, vm);
-          return DSO_EVAL_FUNC;
+          return ret;
         }
 
         k++;
@@ -370,11 +398,11 @@ int step_by_step_simplex(double start[], int n, double FTOL, double scale, void
           constrain(v[vh], n);
         }
         // f[vh] = objfunc(v[vh]);
-        ret = step_by_step_objfunc(images_file, n, v[vh], x, &f[vh], verbosity);
-        if (ret == DSO_EVAL_FUNC)
+        ret = objfunc(objfunc_data, n, v[vh], &f[vh]);
+        if (ret != THOT_OK)
         {
           deallocate_dhs_mem(n, v, f, vr, ve, vc, vm);
-          return DSO_EVAL_FUNC;
+          return ret;
         }
 
         k++;
@@ -441,11 +469,11 @@ int step_by_step_simplex(double start[], int n, double FTOL, double scale, void
   }
 
   // min=objfunc(v[vs]);
-  ret = step_by_step_objfunc(images_file, n, v[vs], x, &min, verbosity);
-  if (ret == DSO_EVAL_FUNC)
+  ret = objfunc(objfunc_data, n, v[vs], &min);
+  if (ret != THOT_OK)
   {
     deallocate_dhs_mem(n, v, f, vr, ve, vc, vm);
-    return DSO_EVAL_FUNC;
+    return ret;
   }
 
   k++;
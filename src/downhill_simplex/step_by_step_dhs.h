@@ -38,6 +38,19 @@
 extern "C"
 {
 #endif
+  // Objective function used by downhill_simplex. It stores in y the
+  // value of the function at vertex and returns THOT_OK, any other
+  // return value interrupts the minimization
+  typedef int (*dhs_objfunc)(void* data, int n, double* vertex, double* y);
+
+  // Minimizes objfunc in memory, objfunc_data is passed to each call
+  int downhill_simplex(double start[], int n, double FTOL, double scale, void (*constrain)(double[], int n),
+                       dhs_objfunc objfunc, void* objfunc_data, int* nfunk, double* y, double* curr_ftol,
+                       int verbosity);
+
+  // Minimizes a function whose values are read from images_file, the
+  // minimization is restarted from the beginning each time a new value
+  // is required, returning DSO_EVAL_FUNC with the vertex in x
   int step_by_step_simplex(double start[], int n, double FTOL, double scale, void (*constrain)(double[], int n),
                            FILE* images_file, int* nfunk, double* y, double* x, double* curr_ftol, int verbosity);
   int get_next_funk(FILE* images_file, double* y, int verbosity);
@@ -78,6 +78,16 @@ public:
                          const std::string& word, EcmScoreInfo& newEsi) = 0;
   // Extends ecm score info
 
+  virtual void prepareEsiExtension(const std::vector<std::string>& prefixDiffVec,
+                                   const std::vector<std::string>& vocab) = 0;
+  // Precomputes the information needed to extend ecm score info
+  // objects given prefixDiffVec for each word of the vocabulary
+
+  virtual void extendEsiGivenWordId(const EcmScoreInfo& prevEsi, unsigned int wordId, EcmScoreInfo& newEsi) const = 0;
+  // The same as extendEsi() for the wordId'th word of the vocabulary
+  // given to prepareEsiExtension(). This function does not modify the
+  // model, so it can be called concurrently
+
   virtual std::vector<Score> obtainScrVecFromEsi(const EcmScoreInfo& esi) = 0;
   // Returns a vector of error correcting scores for the
   // EcmScoreInfo object esi. The last score of the vector
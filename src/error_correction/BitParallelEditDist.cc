@@ -0,0 +1,212 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file BitParallelEditDist.cc
+ *
+ * @brief Definitions file for BitParallelEditDist.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "error_correction/BitParallelEditDist.h"
+
+//--------------- BitParallelEditDist class function definitions
+
+//---------------------------------------
+BitParallelEditDist::BitParallelEditDist(void) : patternLength(0), numBlocks(0)
+{
+}
+
+//---------------------------------------
+void BitParallelEditDist::setPattern(const std::string& y)
+{
+  patternLength = y.size();
+  numBlocks = (y.size() + WORD_BITS - 1) / WORD_BITS;
+  charPeq.assign(NUM_CHARS * numBlocks, 0);
+  for (size_t j = 0; j < y.size(); ++j)
+    charPeq[(unsigned char)y[j] * numBlocks + j / WORD_BITS] |= (Word)1 << (j % WORD_BITS);
+}
+
+//---------------------------------------
+void BitParallelEditDist::setPattern(const std::vector<unsigned int>& y)
+{
+  patternLength = y.size();
+  numBlocks = (y.size() + WORD_BITS - 1) / WORD_BITS;
+  idRows.clear();
+  idPeq.assign(numBlocks, 0);
+  for (size_t j = 0; j < y.size(); ++j)
+  {
+    std::pair<std::unordered_map<unsigned int, size_t>::iterator, bool> result =
+        idRows.insert(std::make_pair(y[j], idRows.size() + 1));
+    if (result.second)
+      idPeq.resize(idPeq.size() + numBlocks, 0);
+    idPeq[result.first->second * numBlocks + j / WORD_BITS] |= (Word)1 << (j % WORD_BITS);
+  }
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::calculateEditDist(const std::string& x) const
+{
+  return calculate(x, false);
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::calculateEditDist(const std::vector<unsigned int>& x) const
+{
+  return calculate(x, false);
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::calculateEditDistPrefix(const std::string& x) const
+{
+  return calculate(x, true);
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::calculateEditDistPrefix(const std::vector<unsigned int>& x) const
+{
+  return calculate(x, true);
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::editDist(const std::string& x, const std::string& y)
+{
+  if (y.size() <= WORD_BITS)
+    return calculateSingleBlock(x, y, false);
+
+  BitParallelEditDist editDist;
+  editDist.setPattern(y);
+  return editDist.calculateEditDist(x);
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::editDistPrefix(const std::string& x, const std::string& y)
+{
+  if (y.size() <= WORD_BITS)
+    return calculateSingleBlock(x, y, true);
+
+  BitParallelEditDist editDist;
+  editDist.setPattern(y);
+  return editDist.calculateEditDistPrefix(x);
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::editDist(const std::vector<unsigned int>& x, const std::vector<unsigned int>& y)
+{
+  BitParallelEditDist editDist;
+  editDist.setPattern(y);
+  return editDist.calculateEditDist(x);
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::editDistPrefix(const std::vector<unsigned int>& x,
+                                                 const std::vector<unsigned int>& y)
+{
+  BitParallelEditDist editDist;
+  editDist.setPattern(y);
+  return editDist.calculateEditDistPrefix(x);
+}
+
+//---------------------------------------
+template <class SEQ>
+unsigned int BitParallelEditDist::calculate(const SEQ& x, bool prefix) const
+{
+  // Without pattern, every symbol of x is deleted
+  if (patternLength == 0)
+    return x.size();
+
+  // The first column is the one of an empty x, where the cell of row
+  // j contains j
+  std::vector<Word> pv(numBlocks, ~(Word)0);
+  std::vector<Word> mv(numBlocks, 0);
+  Word lastRowMask = (Word)1 << ((patternLength - 1) % WORD_BITS);
+  int score = patternLength;
+  int bestScore = score;
+
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    const Word* eq = eqBlocks(x[i]);
+
+    // The first row of each column is one more than the previous one
+    int hout = 1;
+    for (size_t b = 0; b + 1 < numBlocks; ++b)
+      hout = advanceBlock(pv[b], mv[b], eq[b], hout, (Word)1 << (WORD_BITS - 1));
+    score += advanceBlock(pv[numBlocks - 1], mv[numBlocks - 1], eq[numBlocks - 1], hout, lastRowMask);
+
+    if (score < bestScore)
+      bestScore = score;
+  }
+  return prefix ? bestScore : score;
+}
+
+//---------------------------------------
+int BitParallelEditDist::advanceBlock(Word& pv, Word& mv, Word eq, int hin, Word outMask)
+{
+  Word xv = eq | mv;
+  if (hin < 0)
+    eq |= 1;
+  Word xh = (((eq & pv) + pv) ^ pv) | eq;
+  Word ph = mv | ~(xh | pv);
+  Word mh = pv & xh;
+
+  int hout = 0;
+  if (ph & outMask)
+    hout = 1;
+  else if (mh & outMask)
+    hout = -1;
+
+  ph <<= 1;
+  mh <<= 1;
+  if (hin < 0)
+    mh |= 1;
+  else if (hin > 0)
+    ph |= 1;
+  pv = mh | ~(xv | ph);
+  mv = ph & xv;
+  return hout;
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::calculateSingleBlock(const std::string& x, const std::string& y, bool prefix)
+{
+  if (y.empty())
+    return x.size();
+
+  // The table is kept cleared between calls, only the rows of the
+  // characters of y are set and reset
+  static thread_local Word peq[NUM_CHARS] = {0};
+  for (size_t j = 0; j < y.size(); ++j)
+    peq[(unsigned char)y[j]] |= (Word)1 << j;
+
+  Word pv = ~(Word)0;
+  Word mv = 0;
+  Word lastRowMask = (Word)1 << (y.size() - 1);
+  int score = y.size();
+  int bestScore = score;
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    score += advanceBlock(pv, mv, peq[(unsigned char)x[i]], 1, lastRowMask);
+    if (score < bestScore)
+      bestScore = score;
+  }
+
+  for (size_t j = 0; j < y.size(); ++j)
+    peq[(unsigned char)y[j]] = 0;
+
+  return prefix ? bestScore : score;
+}
@@ -0,0 +1,127 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file BitParallelEditDist.h
+ *
+ * @brief Defines the BitParallelEditDist class, which calculates
+ * unit-cost edit distances by means of bit vectors.
+ */
+
+#pragma once
+
+//--------------- Include files --------------------------------------
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- BitParallelEditDist class declaration
+
+/**
+ * @brief Unit-cost edit distance kernels based on the bit-vector
+ * algorithm of Myers, as formulated by Hyyrö.
+ *
+ * A column of the edit distance matrix is encoded by the vertical
+ * differences between its cells, which are stored in bit vectors of
+ * 64 cells per block, so that a symbol of x is processed with a few
+ * word operations per block. The pattern y is preprocessed once and
+ * can be compared with any number of sequences x. Sequences are
+ * either strings, compared character by character, or sequences of
+ * interned word ids.
+ *
+ * The distances are the ones obtained by EditDistForStr and
+ * EditDistForVec with the cost model (0,1,1,1) for hits, insertions,
+ * substitutions and deletions.
+ */
+class BitParallelEditDist
+{
+public:
+  BitParallelEditDist(void);
+
+  void setPattern(const std::string& y);
+  void setPattern(const std::vector<unsigned int>& y);
+  // Sets the sequence y against which the distances are calculated
+
+  unsigned int calculateEditDist(const std::string& x) const;
+  unsigned int calculateEditDist(const std::vector<unsigned int>& x) const;
+  // Calculates the edit distance between x and the pattern
+  // (operations to transform x into y)
+
+  unsigned int calculateEditDistPrefix(const std::string& x) const;
+  unsigned int calculateEditDistPrefix(const std::vector<unsigned int>& x) const;
+  // Calculates the edit distance between x and the pattern, given
+  // that the pattern is an incomplete prefix: once the pattern has
+  // been completed, the remaining symbols of x are deleted with no
+  // cost (PREF_DEL_OP). As in EditDistForStr, an empty pattern does
+  // not allow such deletions
+
+  static unsigned int editDist(const std::string& x, const std::string& y);
+  static unsigned int editDistPrefix(const std::string& x, const std::string& y);
+  // Versions of the previous functions for a single pair of strings,
+  // they avoid the preprocessing of the pattern for short strings
+
+  static unsigned int editDist(const std::vector<unsigned int>& x, const std::vector<unsigned int>& y);
+  static unsigned int editDistPrefix(const std::vector<unsigned int>& x, const std::vector<unsigned int>& y);
+  // Versions of the previous functions for a single pair of word id
+  // sequences
+
+private:
+  typedef uint64_t Word;
+
+  static const unsigned int WORD_BITS = 64;
+  static const unsigned int NUM_CHARS = 256;
+
+  size_t patternLength;
+  size_t numBlocks;
+
+  // Match vectors of the characters, NUM_CHARS rows of numBlocks
+  // blocks
+  std::vector<Word> charPeq;
+
+  // Match vectors of the word ids, the first row is the one of the
+  // ids that do not appear in the pattern
+  std::unordered_map<unsigned int, size_t> idRows;
+  std::vector<Word> idPeq;
+
+  const Word* eqBlocks(char c) const
+  {
+    return charPeq.data() + (unsigned char)c * numBlocks;
+  }
+  const Word* eqBlocks(unsigned int id) const
+  {
+    std::unordered_map<unsigned int, size_t>::const_iterator iter = idRows.find(id);
+    return idPeq.data() + (iter == idRows.end() ? 0 : iter->second * numBlocks);
+  }
+
+  template <class SEQ>
+  unsigned int calculate(const SEQ& x, bool prefix) const;
+  // Processes the symbols of x and returns the distance to the whole
+  // pattern, or its minimum over the prefixes of x if prefix is true
+
+  static int advanceBlock(Word& pv, Word& mv, Word eq, int hin, Word outMask);
+  // Processes a symbol for a block of the column given the
+  // horizontal difference entering its first cell, returns the
+  // horizontal difference leaving the cell given by outMask
+
+  static unsigned int calculateSingleBlock(const std::string& x, const std::string& y, bool prefix);
+  // Calculates the distance for a pattern of at most WORD_BITS
+  // characters with a per-thread table of match vectors
+};
@@ -26,6 +26,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "error_correction/EditDistForStr.h"
 
+#include "error_correction/BitParallelEditDist.h"
+
 //--------------- Classes --------------------------------------------
 
 //--------------- EditDist class method definitions
@@ -34,11 +36,22 @@ EditDistForStr::EditDistForStr(void) : _editDist<std::string>()
 {
 }
 
+//---------------------------------------
+Score EditDistForStr::calculateEditDist(const std::string& x, const std::string& y, int verbose)
+{
+  if (hasUnitCosts() && !verbose)
+    return insCost * BitParallelEditDist::editDist(x, y);
+
+  return _editDist<std::string>::calculateEditDist(x, y, verbose);
+}
+
 //---------------------------------------
 Score EditDistForStr::calculateEditDistPrefix(const std::string& x, const std::string& y, int verbose)
 {
-  std::vector<unsigned int> ops;
+  if (hasUnitCosts() && !verbose)
+    return insCost * BitParallelEditDist::editDistPrefix(x, y);
 
+  std::vector<unsigned int> ops;
   return calculateEditDistPrefixOps(x, y, ops, verbose);
 }
 
@@ -83,6 +96,12 @@ Score EditDistForStr::calculateEditDistPrefixOpsAux(const std::string& x, const
   return dm[x.size()][y.size()];
 }
 
+//---------------------------------------
+bool EditDistForStr::hasUnitCosts(void) const
+{
+  return hitCost == 0 && insCost == substCost && substCost == delCost;
+}
+
 //---------------------------------------
 Score EditDistForStr::processMatrixCell(const std::string& x, const std::string& y, const DistMatrix& dm, int i, int j,
                                         int& pred_i, int& pred_j, int& op_id)
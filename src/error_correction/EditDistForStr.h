@@ -45,6 +45,10 @@ class EditDistForStr : public _editDist<std::string>
 public:
   EditDistForStr(void);
 
+  Score calculateEditDist(const std::string& x, const std::string& y, int verbose = 0);
+  // Calculates edit distance between strings x and y (operations to
+  // transform x into y)
+
   Score calculateEditDistPrefix(const std::string& x, const std::string& y, int verbose = 0);
   // Calculates edit distance between x and y, given that y is an
   // incomplete prefix
@@ -57,6 +61,11 @@ public:
   // The same as the previous function, but the special PREF_DEL_OP
   // operation is not allowed
 
+  bool hasUnitCosts(void) const;
+  // Returns true if hits have no cost and the rest of operations
+  // have the same cost, the distances without operations are then
+  // calculated by bit-parallel kernels
+
   ~EditDistForStr(void);
 
 protected:
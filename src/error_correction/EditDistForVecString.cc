@@ -265,6 +265,94 @@ void EditDistForVecString::incrEditDistPrefixCached(const std::string& xWord, co
   }
 }
 
+//---------------------------------------
+void EditDistForVecString::obtainIncrEditDistPrefixCosts(const std::string& xWord,
+                                                         const std::vector<std::string>& incr_y, Score& delCostX,
+                                                         Score* substCosts, int* substOpIds)
+{
+  // A blank character in the last word of y means that this word
+  // should not be treated as a prefix
+  bool lastWordIsComplete = StrProcUtils::lastCharIsBlank(incr_y.back());
+
+  delCostX = deletionCost(xWord);
+  for (unsigned int j = 0; j < incr_y.size(); ++j)
+  {
+    std::string yWord = incr_y[j];
+    if (j == incr_y.size() - 1 && lastWordIsComplete)
+      yWord = StrProcUtils::removeLastBlank(yWord);
+
+    if (j == incr_y.size() - 1 && !lastWordIsComplete)
+      substCosts[j] = prefSubstitutionCost(xWord, yWord);
+    else
+      substCosts[j] = substitutionCost(xWord, yWord);
+
+    if (xWord == yWord || (!lastWordIsComplete && StrProcUtils::isPrefix(yWord, xWord)))
+      substOpIds[j] = HIT_OP;
+    else
+      substOpIds[j] = SUBST_OP;
+  }
+}
+
+//---------------------------------------
+void EditDistForVecString::obtainIncrEditDistPrefixInsCosts(const std::vector<std::string>& incr_y,
+                                                            std::vector<Score>& insCosts)
+{
+  bool lastWordIsComplete = StrProcUtils::lastCharIsBlank(incr_y.back());
+
+  insCosts.clear();
+  for (unsigned int j = 0; j < incr_y.size(); ++j)
+  {
+    if (j == incr_y.size() - 1 && lastWordIsComplete)
+      insCosts.push_back(insertionCost(StrProcUtils::removeLastBlank(incr_y[j])));
+    else
+      insCosts.push_back(insertionCost(incr_y[j]));
+  }
+}
+
+//---------------------------------------
+void EditDistForVecString::incrEditDistPrefixGivenCosts(Score delCostX, const Score* substCosts, const int* substOpIds,
+                                                        const std::vector<Score>& insCosts,
+                                                        const std::vector<Score>& prevScoreVec,
+                                                        std::vector<Score>& newScoreVec,
+                                                        std::vector<int>& opIdVec) const
+{
+  // Make room for newScoreVec
+  if (newScoreVec.size() < prevScoreVec.size())
+    newScoreVec.resize(prevScoreVec.size(), 0);
+
+  // Fill the new positions of the second row of the edit distance
+  // matrix, processMatrixCellPref() is applied using the given costs
+  unsigned int startyPos = prevScoreVec.size() - insCosts.size();
+  for (unsigned int j = 0; j < insCosts.size(); ++j)
+  {
+    unsigned int pos = startyPos + j;
+
+    // Treat substitution operation
+    Score min = prevScoreVec[pos - 1] + substCosts[j];
+    int op_id = substOpIds[j];
+
+    // Treat deletion operation
+    if (prevScoreVec[pos] + delCostX < min)
+    {
+      min = prevScoreVec[pos] + delCostX;
+      if (delCostX == 0)
+        op_id = PREF_DEL_OP;
+      else
+        op_id = DEL_OP;
+    }
+
+    // Treat insertion operation
+    if (newScoreVec[pos - 1] + insCosts[j] < min)
+    {
+      min = newScoreVec[pos - 1] + insCosts[j];
+      op_id = INS_OP;
+    }
+
+    newScoreVec[pos] = min;
+    opIdVec.push_back(op_id);
+  }
+}
+
 //---------------------------------------
 void EditDistForVecString::setErrorModel(Score _hitCost, Score _insCost, Score _substCost, Score _delCost)
 {
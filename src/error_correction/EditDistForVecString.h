@@ -92,6 +92,25 @@ public:
   // previous vector of costs and new partially calculated vector of
   // costs (uses substCostMap to cache subsitution costs)
 
+  void obtainIncrEditDistPrefixCosts(const std::string& xWord, const std::vector<std::string>& incr_y, Score& delCostX,
+                                     Score* substCosts, int* substOpIds);
+  // Obtains the costs used by incrEditDistPrefix() that only depend
+  // on xWord: its deletion cost, and the cost and operation of its
+  // substitution by each word of incr_y (substCosts and substOpIds
+  // must have room for incr_y.size() elements)
+
+  void obtainIncrEditDistPrefixInsCosts(const std::vector<std::string>& incr_y, std::vector<Score>& insCosts);
+  // Obtains the insertion costs of the words of incr_y used by
+  // incrEditDistPrefix()
+
+  void incrEditDistPrefixGivenCosts(Score delCostX, const Score* substCosts, const int* substOpIds,
+                                    const std::vector<Score>& insCosts, const std::vector<Score>& prevScoreVec,
+                                    std::vector<Score>& newScoreVec, std::vector<int>& opIdVec) const;
+  // The same as incrEditDistPrefix(), but the costs are given by the
+  // two previous functions, so that they can be shared by all the
+  // occurrences of xWord. The operations for the new positions are
+  // appended to opIdVec
+
   void setErrorModel(Score _hitCost, Score _insCost, Score _substCost, Score _delCost);
   // Sets the cost of each operation (insertions, deletions and
   // substitutions)
@@ -147,6 +166,9 @@ protected:
     else
       return substCost;
 #else
+    if (editDistForStr.hasUnitCosts())
+      return editDistForStr.calculateEditDist(x, y);
+
     unsigned int hCount;
     unsigned int iCount;
     unsigned int sCount;
@@ -167,6 +189,9 @@ protected:
     else
       return substCost;
 #else
+    if (editDistForStr.hasUnitCosts())
+      return editDistForStr.calculateEditDistPrefix(x, y);
+
     // Obtain edit distance for prefix
     std::vector<unsigned int> ops;
     editDistForStr.calculateEditDistPrefixOps(x, y, ops);
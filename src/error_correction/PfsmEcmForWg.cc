@@ -93,6 +93,36 @@ void PfsmEcmForWg::extendEsi(const std::vector<std::string>& prefixDiffVec, cons
     newEsi.opIdVec.push_back(opIdVec[i]);
 }
 
+//---------------------------------------
+void PfsmEcmForWg::prepareEsiExtension(const std::vector<std::string>& prefixDiffVec,
+                                       const std::vector<std::string>& vocab)
+{
+  // Substitution costs are stored in a row of prefixDiffVec.size()
+  // elements for each word of the vocabulary
+  unsigned int diffSize = prefixDiffVec.size();
+  editDistForVecStr.obtainIncrEditDistPrefixInsCosts(prefixDiffVec, extInsCosts);
+  extDelCosts.resize(vocab.size());
+  extSubstCosts.resize(vocab.size() * diffSize);
+  extSubstOpIds.resize(vocab.size() * diffSize);
+
+#pragma omp parallel for schedule(dynamic)
+  for (int wordId = 0; wordId < (int)vocab.size(); ++wordId)
+  {
+    editDistForVecStr.obtainIncrEditDistPrefixCosts(vocab[wordId], prefixDiffVec, extDelCosts[wordId],
+                                                    extSubstCosts.data() + wordId * diffSize,
+                                                    extSubstOpIds.data() + wordId * diffSize);
+  }
+}
+
+//---------------------------------------
+void PfsmEcmForWg::extendEsiGivenWordId(const EcmScoreInfo& prevEsi, unsigned int wordId, EcmScoreInfo& newEsi) const
+{
+  unsigned int diffSize = extInsCosts.size();
+  editDistForVecStr.incrEditDistPrefixGivenCosts(extDelCosts[wordId], extSubstCosts.data() + wordId * diffSize,
+                                                 extSubstOpIds.data() + wordId * diffSize, extInsCosts, prevEsi.scrVec,
+                                                 newEsi.scrVec, newEsi.opIdVec);
+}
+
 //---------------------------------------
 std::vector<Score> PfsmEcmForWg::obtainScrVecFromEsi(const EcmScoreInfo& esi)
 {
@@ -68,6 +68,11 @@ public:
                  EcmScoreInfo& newEsi);
   // Extends ecm score info
 
+  void prepareEsiExtension(const std::vector<std::string>& prefixDiffVec, const std::vector<std::string>& vocab);
+  void extendEsiGivenWordId(const EcmScoreInfo& prevEsi, unsigned int wordId, EcmScoreInfo& newEsi) const;
+  // Extends ecm score info using the edit costs of the words of the
+  // vocabulary, which are stored in flat arrays indexed by word id
+
   // Functions to extract data from a given esi
   std::vector<Score> obtainScrVecFromEsi(const EcmScoreInfo& esi);
   std::vector<int> obtainLastInsPrefWordVecFromEsi(const EcmScoreInfo& esi);
@@ -88,4 +93,9 @@ public:
   ~PfsmEcmForWg();
 
 protected:
+  // Edit costs for the extension of ecm score info objects
+  std::vector<Score> extInsCosts;
+  std::vector<Score> extDelCosts;
+  std::vector<Score> extSubstCosts;
+  std::vector<int> extSubstOpIds;
 };
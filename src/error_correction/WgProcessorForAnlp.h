@@ -32,7 +32,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "nlp_common/StrProcUtils.h"
 #include "nlp_common/ctimer.h"
 
+#include <algorithm>
 #include <map>
+#include <queue>
 #include <set>
 #include <vector>
 
@@ -92,6 +94,22 @@ protected:
   typedef std::multimap<float, HypSubStateIdx, std::greater<float>> NbestHypSubStates;
   typedef std::set<HypStateIndex> StatesInvolvedInArcs;
 
+  // Entry of a bounded heap used to obtain n-best lists, the order in
+  // which the entries were inserted breaks ties
+  template <class T>
+  struct NbestHeapEntry
+  {
+    float score;
+    unsigned int order;
+    T item;
+
+    bool operator<(const NbestHeapEntry& other) const
+    {
+      // The top of the heap is the worst entry
+      return score > other.score || (score == other.score && order < other.order);
+    }
+  };
+
   std::vector<std::string> previousPrefixVec;
 
   const WordGraph* wg_ptr;
@@ -126,11 +144,19 @@ protected:
 
   StatesInvolvedInArcs statesInvolvedInArcs; // List of states involved in arcs
 
+  std::vector<HypStateIndex> layerStates; // States of the word-graph
+                                          // grouped by topological layer
+  std::vector<unsigned int> layerOffsets; // Offsets of the layers in
+                                          // the layerStates vector
+
   // Auxiliary functions
 
   // Functions to initialize word-graph
   void initVars(unsigned int verbose = 0);
   void genListOfStatesInvolvedInArcs(StatesInvolvedInArcs& stInvInArcs) const;
+  void genTopologicalLayers(void);
+  // Groups the states in layers, the arcs arriving to the states of a
+  // layer leave states of previous layers
   void updateSizeOfVars(const std::vector<std::string>& validProcPrefixVec);
   void initWgpInfoForArcs(unsigned int verbose = 0);
   void initWgpInfoForInitState(unsigned int verbose = 0);
@@ -154,13 +180,11 @@ protected:
   // Auxiliar function of the obtainNbestHypStates() function, it
   // updates the information of the word-processor for the initial
   // state.
-  void updateWgpInfoForArc(const std::vector<std::string>& prefixDiffVec, WordGraphArcId wgArcId,
-                           unsigned int verbose = 0);
-  // Auxiliar function of the obtainNbestHypStates() function, it
-  // updates the information of the word-processor for a given state
-  // and arc.
-  void updateEcmScoreInfoForArc(const std::vector<std::string>& prefixDiffVec, WordGraphArcId wgArcId,
-                                unsigned int verbose = 0);
+  void updateEcmScoreInfoForArc(WordGraphArcId wgArcId, unsigned int verbose = 0);
+  // Auxiliar function of the procWgGivenPrefDiff() function, it
+  // extends the ecm score info of the words of a given arc for the
+  // prefix difference given to the prepareEsiExtension() function of
+  // the error correcting model.
   NbestCorrections obtainNbestCorrections(std::vector<std::string> prefixVec, unsigned int n,
                                           const RejectedWordsSet& rejectedWords, const NbestHypStates& nbestHypStates,
                                           const NbestHypSubStates& nbestHypSubStates, unsigned int verbose = 0);
@@ -174,9 +198,16 @@ protected:
                                                  const RejectedWordsSet& rejectedWords, unsigned int verbose = 0);
   std::vector<std::string> obtainCorrForHypSubState(std::vector<std::string> prefixVec, HypSubStateIdx hypSubStateIdx,
                                                     unsigned int verbose = 0);
-  void removeLastFromNbestHypStates(NbestHypStates& nbestHypStates);
-  void removeLastFromNbestHypSubStates(NbestHypSubStates& nbestHypSubStates);
   void removeLastFromNbestCorrs(NbestCorrections& nbestCorrections);
+  template <class T>
+  void insertIntoNbestHeap(std::priority_queue<NbestHeapEntry<T>>& nbestHeap, unsigned int n, float score,
+                           const T& item, unsigned int order);
+  // Inserts the order'th item into a heap that keeps the n best items
+  template <class T>
+  std::multimap<float, T, std::greater<float>> nbestHeapToMultimap(std::priority_queue<NbestHeapEntry<T>>& nbestHeap);
+  // Moves the items of the heap to a multimap, in the same order they
+  // would have if they had been inserted into the multimap and the
+  // worst item had been removed after each insertion
 
   // Functions to update best scores
   void updateBestScoresForInitState(unsigned int verbose = 0);
@@ -414,24 +445,25 @@ void WgProcessorForAnlp<ECM_FOR_WG>::initWgpInfoForArc(WordGraphArcId wgArcId, u
 template <class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::initEcmScoreInfoForArc(WordGraphArcId wgArcId, unsigned int /*verbose*/ /*=0*/)
 {
-  // Obtain arc from arc identifier
-  WordGraphArc wgArc = wg_ptr->wordGraphArcId2WordGraphArc(wgArcId);
+  // Obtain arc information from the CSR layout of the word-graph
+  const WordGraphCsr& layout = wg_ptr->getCsr();
+  unsigned int numWords = layout.numWords(wgArcId);
 
   // Obtain predecessor state index
-  HypStateIndex idx = wgArc.predStateIndex;
+  HypStateIndex idx = layout.predStates[wgArcId];
 
   // Init ecm score info for each word of the arc
   EcmScoreInfo prevEsi = ecmScrInfoForState[idx];
 
   // Grow new esi for arc if necessary
-  while (ecmScrInfoForArcVec[wgArcId].size() < wgArc.words.size())
+  while (ecmScrInfoForArcVec[wgArcId].size() < numWords)
   {
     EcmScoreInfo esi;
     ecmScrInfoForArcVec[wgArcId].push_back(esi);
   }
-  for (unsigned int w = 0; w < wgArc.words.size(); ++w)
+  for (unsigned int w = 0; w < numWords; ++w)
   {
-    ecmScrInfoForArcVec[wgArcId][w] = ecm_wg_ptr->constructEsi(prevEsi, wgArc.words[w]);
+    ecmScrInfoForArcVec[wgArcId][w] = ecm_wg_ptr->constructEsi(prevEsi, layout.word(wgArcId, w));
     prevEsi = ecmScrInfoForArcVec[wgArcId][w];
   }
 }
@@ -478,29 +510,57 @@ void WgProcessorForAnlp<ECM_FOR_WG>::procWgGivenPrefDiff(std::vector<std::string
                                                          unsigned int verbose /*=0*/)
 {
   // Declare and initialize variables
+  const WordGraphCsr& layout = wg_ptr->getCsr();
 
   // Obtain arc range
   std::pair<WordGraphArcId, WordGraphArcId> arcIdxRange = wg_ptr->getArcIndexRange();
+  if (verbose)
+    std::cerr << "Arc id range: " << arcIdxRange.first << " " << arcIdxRange.second << std::endl;
+
+  if (prefixDiffVec.size() == 0)
+    return;
 
   // Process initial state
-  if (prefixDiffVec.size() != 0)
+  updateWgpInfoForInitState(prefixDiffVec, verbose);
+
+  // Obtain the edit costs of the words of the word-graph for the new
+  // prefix words, they are shared by all the arcs
+  ecm_wg_ptr->prepareEsiExtension(prefixDiffVec, layout.vocab);
+
+  // Process the states layer by layer. The arcs arriving to the
+  // states of a layer leave states of previous layers, so the states
+  // of a layer and the arcs leaving them can be processed in
+  // parallel. The arcs arriving to each state are visited in
+  // increasing id order, as when the arcs are processed one after
+  // another in topological order
+  for (unsigned int layer = 0; layer + 1 < layerOffsets.size(); ++layer)
   {
-    updateWgpInfoForInitState(prefixDiffVec, verbose);
-  }
+    int layerBegin = layerOffsets[layer];
+    int layerEnd = layerOffsets[layer + 1];
 
-  // Iterate over the arcs of the word-graph (IMPORTANT: it is
-  // assumed that the arcs of the word-graph are topologically
-  // ordered)
-  if (verbose)
-    std::cerr << "Arc id range: " << arcIdxRange.first << " " << arcIdxRange.second << std::endl;
+    // Update best scores for the states of the layer
+#pragma omp parallel for schedule(dynamic)
+    for (int k = layerBegin; k < layerEnd; ++k)
+    {
+      HypStateIndex idx = layerStates[k];
+      for (const WordGraphArcId* arcIdPtr = layout.inArcsBegin(idx); arcIdPtr != layout.inArcsEnd(idx); ++arcIdPtr)
+      {
+        if (!wg_ptr->arcPruned(*arcIdPtr))
+          updateBestScoresForState(*arcIdPtr, prefixDiffVec.size(), verbose);
+      }
+    }
 
-  if (prefixDiffVec.size() != 0)
-  {
-    for (unsigned int aIdx = arcIdxRange.first; aIdx <= arcIdxRange.second; ++aIdx)
+    // Update ecm score info for the arcs leaving the states of the
+    // layer
+#pragma omp parallel for schedule(dynamic)
+    for (int k = layerBegin; k < layerEnd; ++k)
     {
-      // Update info for arcs
-      if (!wg_ptr->arcPruned(aIdx))
-        updateWgpInfoForArc(prefixDiffVec, aIdx, verbose);
+      HypStateIndex idx = layerStates[k];
+      for (const WordGraphArcId* arcIdPtr = layout.outArcsBegin(idx); arcIdPtr != layout.outArcsEnd(idx); ++arcIdPtr)
+      {
+        if (!wg_ptr->arcPruned(*arcIdPtr))
+          updateEcmScoreInfoForArc(*arcIdPtr, verbose);
+      }
     }
   }
 }
@@ -510,8 +570,9 @@ template <class ECM_FOR_WG>
 typename WgProcessorForAnlp<ECM_FOR_WG>::NbestHypStates WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestHypStates(
     unsigned int n, const RejectedWordsSet& rejectedWords, unsigned int /*verbose*/ /*=0*/)
 {
-  // nbestHypStates stores an ordered list of states
-  NbestHypStates nbestHypStates;
+  // nbestHeap stores the n best states found so far
+  std::priority_queue<NbestHeapEntry<HypStateIndex>> nbestHeap;
+  unsigned int numCandidates = 0;
 
   // Iterate over states involved in arcs
   StatesInvolvedInArcs::iterator iter;
@@ -525,19 +586,20 @@ typename WgProcessorForAnlp<ECM_FOR_WG>::NbestHypStates WgProcessorForAnlp<ECM_F
     bool hypStateOk = true;
     if (!rejectedWords.empty())
     {
-      // Obtain successors
-      std::vector<WordGraphArc> wgArcs;
-      wg_ptr->getArcsToSuccStates(hsIdx, wgArcs);
-
       // Find the best successor
+      const WordGraphCsr& layout = wg_ptr->getCsr();
       Score bestRestScoreForSucc = SMALL_SCORE;
-      for (unsigned int i = 0; i < wgArcs.size(); ++i)
+      for (const WordGraphArcId* arcIdPtr = layout.outArcsBegin(hsIdx); arcIdPtr != layout.outArcsEnd(hsIdx);
+           ++arcIdPtr)
       {
+        if (wg_ptr->arcPruned(*arcIdPtr))
+          continue;
+
         // Check that the constraint is satisfied
-        bool wordSatisfiesConstraint = wordSatisfiesRejWordConstraint(wgArcs[i].words[0], rejectedWords);
+        bool wordSatisfiesConstraint = wordSatisfiesRejWordConstraint(layout.word(*arcIdPtr, 0), rejectedWords);
         if (wordSatisfiesConstraint)
         {
-          Score restScoreForArc = wgArcs[i].arcScore + restScores[wgArcs[i].succStateIndex];
+          Score restScoreForArc = layout.arcScores[*arcIdPtr] + restScores[layout.succStates[*arcIdPtr]];
           if (bestRestScoreForSucc < restScoreForArc)
             bestRestScoreForSucc = restScoreForArc;
         }
@@ -555,16 +617,12 @@ typename WgProcessorForAnlp<ECM_FOR_WG>::NbestHypStates WgProcessorForAnlp<ECM_F
 
       // Insert state in the n-best list
       Score score = bestScoresForState[hsIdx].back() + (wgWeight * restScore);
-      nbestHypStates.insert(std::make_pair(score, hsIdx));
-
-      // Prune list if necessary
-      if (nbestHypStates.size() > n)
-        removeLastFromNbestHypStates(nbestHypStates);
+      insertIntoNbestHeap(nbestHeap, n, score, hsIdx, numCandidates++);
     }
   }
 
   // Return list of n-best states
-  return nbestHypStates;
+  return nbestHeapToMultimap(nbestHeap);
 }
 
 //---------------------------------------
@@ -572,37 +630,36 @@ template <class ECM_FOR_WG>
 typename WgProcessorForAnlp<ECM_FOR_WG>::NbestHypSubStates WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestHypSubStates(
     unsigned int n, const RejectedWordsSet& rejectedWords, unsigned int /*verbose*/ /*=0*/)
 {
-  // nbestHypStates stores an ordered list of sub-states
-  NbestHypSubStates nbestHypSubStates;
-
-  // Obtain arc range
-  std::pair<WordGraphArcId, WordGraphArcId> arcIdxRange = wg_ptr->getArcIndexRange();
+  // nbestHeap stores the n best sub-states found so far
+  std::priority_queue<NbestHeapEntry<HypSubStateIdx>> nbestHeap;
+  unsigned int numCandidates = 0;
 
   // Process sub-states
-  for (WordGraphArcId wgArcId = arcIdxRange.first; wgArcId <= arcIdxRange.second; ++wgArcId)
+  const WordGraphCsr& layout = wg_ptr->getCsr();
+  for (WordGraphArcId wgArcId = 0; wgArcId < layout.numArcs(); ++wgArcId)
   {
     if (!wg_ptr->arcPruned(wgArcId))
     {
       // Insert sub-state in the n-best list
-      // Obtain arc from arc id.
-      WordGraphArc wgArc = wg_ptr->wordGraphArcId2WordGraphArc(wgArcId);
       // Iterate over the words of the arc
-      if (wgArc.words.size() > 1)
+      unsigned int numWords = layout.numWords(wgArcId);
+      if (numWords > 1)
       {
-        // NOTE: the last word of the arc wgArc constitutes a sub-state
-        // equivalent to wgArc.succStateIndex state
+        // NOTE: the last word of the arc constitutes a sub-state
+        // equivalent to its successor state
 
         // Obtain wg score for predecessor state
-        Score wgScr = wgScoreForState[wgArc.predStateIndex];
+        HypStateIndex predStateIndex = layout.predStates[wgArcId];
+        Score wgScr = wgScoreForState[predStateIndex];
 
-        for (unsigned int w = 0; w < wgArc.words.size() - 1; ++w)
+        for (unsigned int w = 0; w < numWords - 1; ++w)
         {
           // Check that the sub-state satisfies the constraints
           // imposed by the set of rejected words
           bool subHypStateOk = true;
           if (!rejectedWords.empty())
           {
-            bool wordSatisfiesConstraint = wordSatisfiesRejWordConstraint(wgArc.words[w + 1], rejectedWords);
+            bool wordSatisfiesConstraint = wordSatisfiesRejWordConstraint(layout.word(wgArcId, w + 1), rejectedWords);
             if (!wordSatisfiesConstraint)
               subHypStateOk = false;
           }
@@ -615,18 +672,14 @@ typename WgProcessorForAnlp<ECM_FOR_WG>::NbestHypSubStates WgProcessorForAnlp<EC
             std::vector<Score> ecmScrVec = ecm_wg_ptr->obtainScrVecFromEsi(ecmScrInfoForArcVec[wgArcId][w]);
             // Calculate score of the sub-state
             Score score =
-                wgWeight * wgScr + ecmWeight * ecmScrVec.back() + (wgWeight * restScores[wgArc.predStateIndex]);
+                wgWeight * wgScr + ecmWeight * ecmScrVec.back() + (wgWeight * restScores[predStateIndex]);
 
             // Create sub-state object
             HypSubStateIdx hssIdx;
             hssIdx.first = wgArcId;
             hssIdx.second = w;
             // Insert sub-state in the n-best list
-            nbestHypSubStates.insert(std::make_pair(score, hssIdx));
-
-            // Prune list if necessary
-            if (nbestHypSubStates.size() > n)
-              removeLastFromNbestHypSubStates(nbestHypSubStates);
+            insertIntoNbestHeap(nbestHeap, n, score, hssIdx, numCandidates++);
           }
         }
       }
@@ -634,7 +687,7 @@ typename WgProcessorForAnlp<ECM_FOR_WG>::NbestHypSubStates WgProcessorForAnlp<EC
   }
 
   // Return n-best sub-state list
-  return nbestHypSubStates;
+  return nbestHeapToMultimap(nbestHeap);
 }
 
 //---------------------------------------
@@ -687,42 +740,28 @@ void WgProcessorForAnlp<ECM_FOR_WG>::updateWgpInfoForInitState(const std::vector
 
 //---------------------------------------
 template <class ECM_FOR_WG>
-void WgProcessorForAnlp<ECM_FOR_WG>::updateWgpInfoForArc(const std::vector<std::string>& prefixDiffVec,
-                                                         WordGraphArcId wgArcId, unsigned int verbose /*=0*/)
-{
-  // Update ecm score info for each word of the arc
-  updateEcmScoreInfoForArc(prefixDiffVec, wgArcId, verbose);
-
-  // Update best scores for state
-  updateBestScoresForState(wgArcId, prefixDiffVec.size(), verbose);
-}
-
-//---------------------------------------
-template <class ECM_FOR_WG>
-void WgProcessorForAnlp<ECM_FOR_WG>::updateEcmScoreInfoForArc(const std::vector<std::string>& prefixDiffVec,
-                                                              WordGraphArcId wgArcId, unsigned int /*verbose*/ /*=0*/)
+void WgProcessorForAnlp<ECM_FOR_WG>::updateEcmScoreInfoForArc(WordGraphArcId wgArcId, unsigned int /*verbose*/ /*=0*/)
 {
-  // Obtain arc from arc identifier
-  WordGraphArc wgArc = wg_ptr->wordGraphArcId2WordGraphArc(wgArcId);
+  // Obtain arc information from the CSR layout of the word-graph
+  const WordGraphCsr& layout = wg_ptr->getCsr();
+  unsigned int numWords = layout.numWords(wgArcId);
 
   // Obtain predecessor state
-  HypStateIndex idx = wgArc.predStateIndex;
+  HypStateIndex idx = layout.predStates[wgArcId];
 
   // Update ecm score info for each word of the arc
-  EcmScoreInfo prevEsi = ecmScrInfoForState[idx];
+  const EcmScoreInfo* prevEsi = &ecmScrInfoForState[idx];
 
   // Grow new esi for arc if necessary
-  while (ecmScrInfoForArcVec[wgArcId].size() < wgArc.words.size())
-  {
-    EcmScoreInfo esi;
-    ecmScrInfoForArcVec[wgArcId].push_back(esi);
-  }
+  if (ecmScrInfoForArcVec[wgArcId].size() < numWords)
+    ecmScrInfoForArcVec[wgArcId].resize(numWords);
 
-  for (unsigned int w = 0; w < wgArc.words.size(); ++w)
+  for (unsigned int w = 0; w < numWords; ++w)
   {
-    // Extend ecm score info
-    ecm_wg_ptr->extendEsi(prefixDiffVec, prevEsi, wgArc.words[w], ecmScrInfoForArcVec[wgArcId][w]);
-    prevEsi = ecmScrInfoForArcVec[wgArcId][w];
+    // Extend ecm score info, the edit costs of the word were obtained
+    // by the prepareEsiExtension() function
+    ecm_wg_ptr->extendEsiGivenWordId(*prevEsi, layout.wordId(wgArcId, w), ecmScrInfoForArcVec[wgArcId][w]);
+    prevEsi = &ecmScrInfoForArcVec[wgArcId][w];
   }
 }
 
@@ -756,28 +795,23 @@ template <class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::updateBestScoresForState(WordGraphArcId wgArcId, unsigned int prefDiffSize,
                                                               unsigned int /*verbose*/ /*=0*/)
 {
-  // Obtain arc from arc identifier
-  WordGraphArc wgArc = wg_ptr->wordGraphArcId2WordGraphArc(wgArcId);
-
   // Retrieve predecessor and successor states
-  HypStateIndex predIdx = wgArc.predStateIndex;
-  HypStateIndex succIdx = wgArc.succStateIndex;
+  const WordGraphCsr& layout = wg_ptr->getCsr();
+  HypStateIndex predIdx = layout.predStates[wgArcId];
+  HypStateIndex succIdx = layout.succStates[wgArcId];
 
   // Check if ecmScrInfoForArcVec[wgArcId] is
   // empty. ecmScrInfoForArcVec[wgArcId] may be empty if wgArc has
   // no words
-  EcmScoreInfo prevEsi;
-  if (ecmScrInfoForArcVec[wgArcId].empty())
-    prevEsi = ecmScrInfoForState[predIdx];
-  else
-    prevEsi = ecmScrInfoForArcVec[wgArcId].back();
+  const EcmScoreInfo& prevEsi =
+      ecmScrInfoForArcVec[wgArcId].empty() ? ecmScrInfoForState[predIdx] : ecmScrInfoForArcVec[wgArcId].back();
 
   // Obtain ecm score vector for successor state
   std::vector<Score> ecmScrVec = ecm_wg_ptr->obtainScrVecFromEsi(prevEsi);
 
   // Obtain wg score for successor state from the wg score
   // vector of the predecessor state
-  Score wgScr = wgScoreForState[predIdx] + wgArc.arcScore;
+  Score wgScr = wgScoreForState[predIdx] + layout.arcScores[wgArcId];
 
   // Update vector of best scores for state
 
@@ -1007,16 +1041,17 @@ std::vector<std::string> WgProcessorForAnlp<ECM_FOR_WG>::obtainCorrForHypState(s
 
   // Obtain set of excluded arcs
   std::set<WordGraphArcId> excludedWgArcIdSet;
-  std::vector<WordGraphArcId> arcIdsSuccStatesVec;
   if (!rejectedWords.empty())
   {
-    wg_ptr->getArcIdsToSuccStates(hypStateIndex, arcIdsSuccStatesVec);
-    for (unsigned int i = 0; i < arcIdsSuccStatesVec.size(); ++i)
+    const WordGraphCsr& layout = wg_ptr->getCsr();
+    for (const WordGraphArcId* arcIdPtr = layout.outArcsBegin(hypStateIndex);
+         arcIdPtr != layout.outArcsEnd(hypStateIndex); ++arcIdPtr)
     {
-      WordGraphArc wgArc = wg_ptr->wordGraphArcId2WordGraphArc(arcIdsSuccStatesVec[i]);
-      bool wordSatisfiesConstraint = wordSatisfiesRejWordConstraint(wgArc.words[0], rejectedWords);
+      if (wg_ptr->arcPruned(*arcIdPtr))
+        continue;
+      bool wordSatisfiesConstraint = wordSatisfiesRejWordConstraint(layout.word(*arcIdPtr, 0), rejectedWords);
       if (!wordSatisfiesConstraint)
-        excludedWgArcIdSet.insert(arcIdsSuccStatesVec[i]);
+        excludedWgArcIdSet.insert(*arcIdPtr);
     }
   }
 
@@ -1170,44 +1205,60 @@ std::vector<std::string> WgProcessorForAnlp<ECM_FOR_WG>::obtainCorrForHypSubStat
 
 //---------------------------------------
 template <class ECM_FOR_WG>
-void WgProcessorForAnlp<ECM_FOR_WG>::removeLastFromNbestHypStates(NbestHypStates& nbestHypStates)
+void WgProcessorForAnlp<ECM_FOR_WG>::removeLastFromNbestCorrs(NbestCorrections& nbestCorrections)
 {
-  NbestHypStates::iterator pos;
+  NbestCorrections::iterator pos;
 
-  if (!nbestHypStates.empty())
+  if (!nbestCorrections.empty())
   {
-    pos = nbestHypStates.end();
+    pos = nbestCorrections.end();
     --pos;
-    nbestHypStates.erase(pos--);
+    nbestCorrections.erase(pos--);
   }
 }
 
 //---------------------------------------
 template <class ECM_FOR_WG>
-void WgProcessorForAnlp<ECM_FOR_WG>::removeLastFromNbestHypSubStates(NbestHypSubStates& nbestHypSubStates)
+template <class T>
+void WgProcessorForAnlp<ECM_FOR_WG>::insertIntoNbestHeap(std::priority_queue<NbestHeapEntry<T>>& nbestHeap,
+                                                         unsigned int n, float score, const T& item,
+                                                         unsigned int order)
 {
-  NbestHypSubStates::iterator pos;
-
-  if (!nbestHypSubStates.empty())
-  {
-    pos = nbestHypSubStates.end();
-    --pos;
-    nbestHypSubStates.erase(pos--);
-  }
+  // The new entry is worse than the entries with the same score, so it
+  // is discarded if it is not better than the worst entry
+  if (nbestHeap.size() >= n && (n == 0 || score <= nbestHeap.top().score))
+    return;
+
+  NbestHeapEntry<T> entry;
+  entry.score = score;
+  entry.order = order;
+  entry.item = item;
+  nbestHeap.push(entry);
+  if (nbestHeap.size() > n)
+    nbestHeap.pop();
 }
 
 //---------------------------------------
 template <class ECM_FOR_WG>
-void WgProcessorForAnlp<ECM_FOR_WG>::removeLastFromNbestCorrs(NbestCorrections& nbestCorrections)
+template <class T>
+std::multimap<float, T, std::greater<float>> WgProcessorForAnlp<ECM_FOR_WG>::nbestHeapToMultimap(
+    std::priority_queue<NbestHeapEntry<T>>& nbestHeap)
 {
-  NbestCorrections::iterator pos;
-
-  if (!nbestCorrections.empty())
+  std::vector<NbestHeapEntry<T>> entries;
+  while (!nbestHeap.empty())
   {
-    pos = nbestCorrections.end();
-    --pos;
-    nbestCorrections.erase(pos--);
+    entries.push_back(nbestHeap.top());
+    nbestHeap.pop();
   }
+
+  // Insert the entries by insertion order, so that entries with the
+  // same score keep their relative order
+  std::sort(entries.begin(), entries.end(),
+            [](const NbestHeapEntry<T>& a, const NbestHeapEntry<T>& b) { return a.order < b.order; });
+  std::multimap<float, T, std::greater<float>> result;
+  for (unsigned int i = 0; i < entries.size(); ++i)
+    result.insert(std::make_pair(entries[i].score, entries[i].item));
+  return result;
 }
 
 //---------------------------------------
@@ -1222,6 +1273,8 @@ void WgProcessorForAnlp<ECM_FOR_WG>::clear(void)
   wgScoreForState.clear();
   bestScoresForState.clear();
   bestPredsForState.clear();
+  layerStates.clear();
+  layerOffsets.clear();
 }
 
 //---------------------------------------
@@ -1257,7 +1310,7 @@ void WgProcessorForAnlp<ECM_FOR_WG>::initVars(unsigned int verbose /*=0*/)
   wgScoreForState.clear();
   if (wg_ptr != NULL)
   {
-    Score scr;
+    Score scr = 0;
     wgScoreForState.insert(wgScoreForState.begin(), wg_ptr->numStates(), scr);
   }
 
@@ -1285,6 +1338,9 @@ void WgProcessorForAnlp<ECM_FOR_WG>::initVars(unsigned int verbose /*=0*/)
   // Generate list of states involved in arcs
   genListOfStatesInvolvedInArcs(statesInvolvedInArcs);
 
+  // Group states in topological layers
+  genTopologicalLayers();
+
   // Update initVarsExecuted variable
   initVarsExecuted = true;
 }
@@ -1294,19 +1350,50 @@ template <class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::genListOfStatesInvolvedInArcs(StatesInvolvedInArcs& stInvInArcs) const
 {
   stInvInArcs.clear();
-  std::pair<WordGraphArcId, WordGraphArcId> arcIdxRange = wg_ptr->getArcIndexRange();
-  for (unsigned int aIdx = arcIdxRange.first; aIdx <= arcIdxRange.second; ++aIdx)
+  const WordGraphCsr& layout = wg_ptr->getCsr();
+  for (WordGraphArcId aIdx = 0; aIdx < layout.numArcs(); ++aIdx)
   {
     // Update info for arcs
     if (!wg_ptr->arcPruned(aIdx))
     {
-      WordGraphArc wgArc = wg_ptr->wordGraphArcId2WordGraphArc(aIdx);
-      stInvInArcs.insert(wgArc.predStateIndex);
-      stInvInArcs.insert(wgArc.succStateIndex);
+      stInvInArcs.insert(layout.predStates[aIdx]);
+      stInvInArcs.insert(layout.succStates[aIdx]);
     }
   }
 }
 
+//---------------------------------------
+template <class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::genTopologicalLayers(void)
+{
+  // Obtain the layer of each state, that is, the length of the longest
+  // path of non-pruned arcs arriving to it (IMPORTANT: it is assumed
+  // that the arcs of the word-graph are topologically ordered)
+  const WordGraphCsr& layout = wg_ptr->getCsr();
+  std::vector<unsigned int> layerForState(wg_ptr->numStates(), 0);
+  unsigned int numLayers = layerForState.empty() ? 0 : 1;
+  for (WordGraphArcId aIdx = 0; aIdx < layout.numArcs(); ++aIdx)
+  {
+    if (!wg_ptr->arcPruned(aIdx))
+    {
+      HypStateIndex succIdx = layout.succStates[aIdx];
+      layerForState[succIdx] = std::max(layerForState[succIdx], layerForState[layout.predStates[aIdx]] + 1);
+      numLayers = std::max(numLayers, layerForState[succIdx] + 1);
+    }
+  }
+
+  // Sort states by layer
+  layerOffsets.assign(numLayers + 1, 0);
+  for (HypStateIndex idx = 0; idx < layerForState.size(); ++idx)
+    ++layerOffsets[layerForState[idx] + 1];
+  for (unsigned int layer = 0; layer < numLayers; ++layer)
+    layerOffsets[layer + 1] += layerOffsets[layer];
+  layerStates.resize(layerForState.size());
+  std::vector<unsigned int> layerPos(layerOffsets.begin(), layerOffsets.end() - 1);
+  for (HypStateIndex idx = 0; idx < layerForState.size(); ++idx)
+    layerStates[layerPos[layerForState[idx]]++] = idx;
+}
+
 //---------------------------------------
 template <class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::updateSizeOfVars(const std::vector<std::string>& validProcPrefixVec)
@@ -18,11 +18,322 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "error_correction/WordGraph.h"
 
+#include "nlp_common/MappedFile.h"
 #include "nlp_common/StrProcUtils.h"
 
+#include <queue>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+// Binary word graph format
+const char WORD_GRAPH_BINARY_MAGIC[8] = {'T', 'H', 'O', 'T', 'W', 'G', 'B', 'N'};
+const uint32_t WORD_GRAPH_BINARY_VERSION = 1;
+const uint32_t WORD_GRAPH_BINARY_BYTE_ORDER_MARK = 0x01020304;
+
+enum WgSection
+{
+  CompWeightNameOffsets,
+  CompWeightNameChars,
+  CompWeightValues,
+  VocabOffsets,
+  VocabChars,
+  FinalStates,
+  PredStates,
+  SuccStates,
+  ArcScores,
+  SrcStartIndices,
+  SrcEndIndices,
+  ArcFlags,
+  WordOffsets,
+  Words,
+  ScrCompOffsets,
+  ScrComps,
+  NumWgSections
+};
+
+enum WgArcFlag
+{
+  UnknownArcFlag = 1,
+  PrunedArcFlag = 2
+};
+
+struct WgBinaryHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrderMark;
+  uint64_t numStates;
+  uint64_t numArcs;
+  uint64_t numWords;
+  uint64_t numCompWeights;
+  uint64_t numFinalStates;
+  double initialStateScore;
+  // Start of each section plus the end of the file
+  uint64_t sectionOffsets[NumWgSections + 1];
+};
+
+bool writeWgSection(FILE* file, WgBinaryHeader& header, WgSection sect, const void* ptr, size_t size)
+{
+  // Sections are aligned to 8 bytes
+  static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  uint64_t& end = header.sectionOffsets[NumWgSections];
+  size_t padSize = (size_t)((8 - end % 8) % 8);
+  if (padSize > 0 && fwrite(padding, 1, padSize, file) != padSize)
+    return false;
+  end += padSize;
+
+  header.sectionOffsets[sect] = end;
+  if (size > 0 && fwrite(ptr, 1, size, file) != size)
+    return false;
+  end += size;
+  return true;
+}
+
+template <class T>
+const T* wgSection(const char* data, const WgBinaryHeader& header, WgSection sect)
+{
+  return reinterpret_cast<const T*>(data + header.sectionOffsets[sect]);
+}
+
+bool wgSectionsAreValid(const char* data, size_t dataSize)
+{
+  const WgBinaryHeader& header = *reinterpret_cast<const WgBinaryHeader*>(data);
+  if (memcmp(header.magic, WORD_GRAPH_BINARY_MAGIC, sizeof(header.magic)) != 0
+      || header.version != WORD_GRAPH_BINARY_VERSION || header.byteOrderMark != WORD_GRAPH_BINARY_BYTE_ORDER_MARK
+      || header.sectionOffsets[NumWgSections] != dataSize || header.numStates >= INVALID_STATE
+      || header.numArcs >= INVALID_ARCID)
+    return false;
+
+  // The number of elements of a section cannot exceed what fits in the
+  // file, which also keeps the section sizes computed below from
+  // overflowing
+  if (header.numCompWeights > dataSize / 8 || header.numWords > dataSize / 8 || header.numFinalStates > dataSize / 4)
+    return false;
+
+  // Sections must be aligned and lie within the file
+  for (unsigned int sect = 0; sect < NumWgSections; ++sect)
+  {
+    if (header.sectionOffsets[sect] % 8 != 0 || header.sectionOffsets[sect] < sizeof(WgBinaryHeader)
+        || header.sectionOffsets[sect] > header.sectionOffsets[sect + 1])
+      return false;
+  }
+
+  // Sections must be large enough for the number of elements given in
+  // the header
+  uint64_t minSizes[NumWgSections];
+  minSizes[CompWeightNameOffsets] = (header.numCompWeights + 1) * 8;
+  minSizes[CompWeightNameChars] = 0;
+  minSizes[CompWeightValues] = header.numCompWeights * 4;
+  minSizes[VocabOffsets] = (header.numWords + 1) * 8;
+  minSizes[VocabChars] = 0;
+  minSizes[FinalStates] = header.numFinalStates * 4;
+  minSizes[PredStates] = header.numArcs * 4;
+  minSizes[SuccStates] = header.numArcs * 4;
+  minSizes[ArcScores] = header.numArcs * 8;
+  minSizes[SrcStartIndices] = header.numArcs * 4;
+  minSizes[SrcEndIndices] = header.numArcs * 4;
+  minSizes[ArcFlags] = header.numArcs;
+  minSizes[WordOffsets] = (header.numArcs + 1) * 8;
+  minSizes[Words] = 0;
+  minSizes[ScrCompOffsets] = (header.numArcs + 1) * 8;
+  minSizes[ScrComps] = 0;
+  for (unsigned int sect = 0; sect < NumWgSections; ++sect)
+  {
+    if (header.sectionOffsets[sect + 1] - header.sectionOffsets[sect] < minSizes[sect])
+      return false;
+  }
+
+  // Offset arrays must be non-decreasing and lie within their element
+  // sections
+  struct
+  {
+    WgSection offsets;
+    uint64_t num;
+    WgSection elems;
+    uint64_t elemSize;
+  } groups[] = {{CompWeightNameOffsets, header.numCompWeights, CompWeightNameChars, 1},
+                {VocabOffsets, header.numWords, VocabChars, 1},
+                {WordOffsets, header.numArcs, Words, 4},
+                {ScrCompOffsets, header.numArcs, ScrComps, 8}};
+  for (unsigned int g = 0; g < sizeof(groups) / sizeof(groups[0]); ++g)
+  {
+    const uint64_t* offsets = wgSection<uint64_t>(data, header, groups[g].offsets);
+    for (uint64_t i = 0; i < groups[g].num; ++i)
+    {
+      if (offsets[i] > offsets[i + 1])
+        return false;
+    }
+    if (offsets[0] != 0
+        || offsets[groups[g].num]
+               > (header.sectionOffsets[groups[g].elems + 1] - header.sectionOffsets[groups[g].elems])
+                     / groups[g].elemSize)
+      return false;
+  }
+
+  // Arcs must refer to existing states and words
+  const uint32_t* predStates = wgSection<uint32_t>(data, header, PredStates);
+  const uint32_t* succStates = wgSection<uint32_t>(data, header, SuccStates);
+  for (uint64_t arcId = 0; arcId < header.numArcs; ++arcId)
+  {
+    if (predStates[arcId] >= header.numStates || succStates[arcId] >= header.numStates)
+      return false;
+  }
+  const uint32_t* words = wgSection<uint32_t>(data, header, Words);
+  uint64_t numArcWords = wgSection<uint64_t>(data, header, WordOffsets)[header.numArcs];
+  for (uint64_t i = 0; i < numArcWords; ++i)
+  {
+    if (words[i] >= header.numWords)
+      return false;
+  }
+  return true;
+}
+
+// Lazy enumeration of the best paths of a word graph in the style of
+// Huang and Chiang (2005), Algorithm 3. The k-th best path from a state
+// to a final state is either the empty path (if the state is final) or
+// an arc followed by the j-th best path from its successor state, so
+// each state keeps the list of paths found so far and a heap of
+// candidates. After a path is found, only the candidate that follows
+// the same arc with the next path of the successor state is added
+class LazyKBestPaths
+{
+public:
+  struct Derivation
+  {
+    Score score;
+    WordGraphArcId arcId;
+    unsigned int succRank;
+  };
+
+  LazyKBestPaths(const WordGraphCsr& _layout, const std::vector<bool>& _arcsPruned,
+                 const WordGraph::FinalStateSet& finalStateSet)
+      : layout(_layout), arcsPruned(_arcsPruned), states(_layout.numStates())
+  {
+    // Paths end at the first final state they reach, except for the
+    // empty path of the initial state
+    for (HypStateIndex idx : finalStateSet)
+    {
+      if (idx != INITIAL_STATE && idx < states.size())
+        states[idx].isFinal = true;
+    }
+
+    // Obtain score of the best path from each state
+    // WARNING: arcs must be topologically ordered
+    bestScores.assign(states.size(), SMALL_SCORE);
+    for (HypStateIndex idx = 0; idx < states.size(); ++idx)
+    {
+      if (states[idx].isFinal)
+        bestScores[idx] = 0;
+    }
+    for (WordGraphArcId wgArcId = (WordGraphArcId)layout.numArcs(); wgArcId-- > 0;)
+    {
+      HypStateIndex predStateIndex = layout.predStates[wgArcId];
+      HypStateIndex succStateIndex = layout.succStates[wgArcId];
+      if (!arcsPruned[wgArcId] && !states[predStateIndex].isFinal && bestScores[succStateIndex] != SMALL_SCORE)
+        bestScores[predStateIndex] =
+            std::max(bestScores[predStateIndex], layout.arcScores[wgArcId] + bestScores[succStateIndex]);
+    }
+  }
+
+  // Returns the k-th best path from the given state, or NULL if the
+  // state has less than k+1 paths
+  const Derivation* getDerivation(HypStateIndex idx, unsigned int k)
+  {
+    if (idx >= states.size())
+      return NULL;
+
+    StateInfo& state = states[idx];
+    if (!state.initialized)
+      initState(idx);
+    if (state.derivations.empty())
+      return NULL;
+
+    while (state.derivations.size() <= k)
+    {
+      // Add next candidate of the last path found
+      const Derivation& last = state.derivations.back();
+      if (last.arcId != INVALID_ARCID)
+        pushCandidate(state, last.arcId, last.succRank + 1);
+
+      if (state.candidates.empty())
+        return NULL;
+      state.derivations.push_back(state.candidates.top());
+      state.candidates.pop();
+    }
+    return &state.derivations[k];
+  }
+
+private:
+  struct CandidateCompare
+  {
+    bool operator()(const Derivation& a, const Derivation& b) const
+    {
+      if (a.score != b.score)
+        return a.score < b.score;
+      if (a.arcId != b.arcId)
+        return a.arcId > b.arcId;
+      return a.succRank > b.succRank;
+    }
+  };
+
+  struct StateInfo
+  {
+    StateInfo() : isFinal(false), initialized(false)
+    {
+    }
+
+    bool isFinal;
+    bool initialized;
+    std::vector<Derivation> derivations;
+    std::priority_queue<Derivation, std::vector<Derivation>, CandidateCompare> candidates;
+  };
+
+  const WordGraphCsr& layout;
+  const std::vector<bool>& arcsPruned;
+  std::vector<StateInfo> states;
+  std::vector<Score> bestScores;
+
+  void initState(HypStateIndex idx)
+  {
+    StateInfo& state = states[idx];
+    state.initialized = true;
+    if (state.isFinal)
+    {
+      state.derivations.push_back(Derivation{0, INVALID_ARCID, 0});
+      return;
+    }
+    if (bestScores[idx] == SMALL_SCORE)
+      return;
+
+    // The best path of each arc is known without expanding the
+    // successor state
+    const WordGraphArcId* arcIdsEnd = layout.outArcsEnd(idx);
+    for (const WordGraphArcId* arcIdPtr = layout.outArcsBegin(idx); arcIdPtr != arcIdsEnd; ++arcIdPtr)
+    {
+      HypStateIndex succStateIndex = layout.succStates[*arcIdPtr];
+      if (!arcsPruned[*arcIdPtr] && bestScores[succStateIndex] != SMALL_SCORE)
+        state.candidates.push(Derivation{layout.arcScores[*arcIdPtr] + bestScores[succStateIndex], *arcIdPtr, 0});
+    }
+    state.derivations.push_back(state.candidates.top());
+    state.candidates.pop();
+  }
+
+  void pushCandidate(StateInfo& state, WordGraphArcId wgArcId, unsigned int succRank)
+  {
+    const Derivation* succDerivation = getDerivation(layout.succStates[wgArcId], succRank);
+    if (succDerivation != NULL)
+      state.candidates.push(Derivation{layout.arcScores[wgArcId] + succDerivation->score, wgArcId, succRank});
+  }
+};
+} // namespace
+
 WordGraph::WordGraph()
 {
   initialStateScore = 0;
+  csrUpToDate = false;
 }
 
 void WordGraph::setCompWeights(const std::vector<std::pair<std::string, float>>& _compWeights)
@@ -53,6 +364,7 @@ void WordGraph::rescoreArcsGivenWeights(const std::vector<std::pair<std::string,
       }
     }
   }
+  invalidateCsr();
 }
 
 void WordGraph::getCompWeights(std::vector<std::pair<std::string, float>>& _compWeights) const
@@ -77,6 +389,7 @@ void WordGraph::addArc(HypStateIndex predStateIndex, HypStateIndex succStateInde
   wordGraphArc.unknown = unknown;
 
   // Insert arc and retrieve index
+  invalidateCsr();
   wordGraphArcs.push_back(wordGraphArc);
   wordGraphArcId = wordGraphArcs.size() - 1;
 
@@ -281,6 +594,28 @@ bool WordGraph::stateIsFinal(HypStateIndex hypStateIndex) const
     return true;
 }
 
+const WordGraphCsr& WordGraph::getCsr() const
+{
+  if (!csrUpToDate)
+    buildCsr();
+  return csr;
+}
+
+void WordGraph::buildCsr() const
+{
+  csr.build(wordGraphArcs, wordGraphStates.size());
+  csrUpToDate = true;
+}
+
+void WordGraph::invalidateCsr()
+{
+  if (csrUpToDate)
+  {
+    csr.clear();
+    csrUpToDate = false;
+  }
+}
+
 unsigned int WordGraph::getNumberOfPrunedAndNonPrunedArcs() const
 {
   return wordGraphArcs.size();
@@ -327,7 +662,8 @@ bool WordGraph::arcPruned(WordGraphArcId wordGraphArcId) const
 
 void WordGraph::obtainNbestList(unsigned int len, std::vector<std::pair<Score, std::string>>& nblist,
                                 std::vector<NbSearchHighLevelHyp>& highLevelHypList,
-                                std::vector<std::vector<Score>>& scoreCompsVec, int verbosity /*=false*/)
+                                std::vector<std::vector<Score>>& scoreCompsVec, int verbosity /*=false*/,
+                                bool lazy /*=false*/)
 {
   // Check if word-graph is empty
   if (wordGraphArcs.empty())
@@ -336,6 +672,24 @@ void WordGraph::obtainNbestList(unsigned int len, std::vector<std::pair<Score, s
     nblist.clear();
     highLevelHypList.clear();
   }
+  else if (lazy)
+  {
+    // Execute lazy k-best search
+    std::vector<std::pair<Score, NbSearchHyp>> hypList;
+    lazyNbSearch(len, hypList, verbosity);
+
+    // Obtain strings and high level hypotheses for the returned paths
+    nblist.clear();
+    highLevelHypList.clear();
+    for (unsigned int i = 0; i < hypList.size(); ++i)
+    {
+      std::vector<Score> scoreComps;
+      nblist.push_back(std::make_pair(hypList[i].first, stringAssociatedToHyp(hypList[i].second, scoreComps)));
+      if (!scoreComps.empty())
+        scoreCompsVec.push_back(scoreComps);
+      highLevelHypList.push_back(hypToHighLevelHyp(hypList[i].second));
+    }
+  }
   else
   {
     // Word-graph is not empty
@@ -356,7 +710,8 @@ void WordGraph::obtainNbestList(unsigned int len, std::vector<std::pair<Score, s
   }
 }
 
-void WordGraph::obtainNbestList(unsigned int len, std::vector<TranslationData>& nblist, int verbosity /*=false*/)
+void WordGraph::obtainNbestList(unsigned int len, std::vector<TranslationData>& nblist, int verbosity /*=false*/,
+                                bool lazy /*=false*/)
 {
   // Check if word-graph is empty
   if (wordGraphArcs.empty())
@@ -364,6 +719,21 @@ void WordGraph::obtainNbestList(unsigned int len, std::vector<TranslationData>&
     // clear nblist and scoreCompsVec output variables
     nblist.clear();
   }
+  else if (lazy)
+  {
+    // Execute lazy k-best search
+    std::vector<std::pair<Score, NbSearchHyp>> hypList;
+    lazyNbSearch(len, hypList, verbosity);
+
+    nblist.clear();
+    for (unsigned int i = 0; i < hypList.size(); ++i)
+    {
+      TranslationData data;
+      data.score = hypList[i].first;
+      getTranslationData(hypList[i].second, data);
+      nblist.push_back(data);
+    }
+  }
   else
   {
     // Word-graph is not empty
@@ -411,18 +781,16 @@ void WordGraph::obtainNbSearchHeurInfo(std::vector<Score>& heurForEachState)
 
   // Explore arcs in reverse order
   // WARNING: arcs must be topologically ordered
-  if (!wordGraphArcs.empty())
+  const WordGraphCsr& layout = getCsr();
+  for (WordGraphArcId wgArcId = 0; wgArcId < layout.numArcs(); ++wgArcId)
   {
-    for (WordGraphArcId wgArcId = 0; wgArcId < wordGraphArcs.size(); ++wgArcId)
+    WordGraphArcId reverseWgArcId = layout.numArcs() - wgArcId - 1;
+    if (!arcPruned(reverseWgArcId))
     {
-      WordGraphArcId reverseWgArcId = wordGraphArcs.size() - wgArcId - 1;
-      if (!arcPruned(reverseWgArcId))
-      {
-        WordGraphArc wgArc = wordGraphArcId2WordGraphArc(reverseWgArcId);
-        Score scr = wgArc.arcScore + heurForEachState[wgArc.succStateIndex];
-        if (heurForEachState[wgArc.predStateIndex] < scr)
-          heurForEachState[wgArc.predStateIndex] = scr;
-      }
+      HypStateIndex predStateIndex = layout.predStates[reverseWgArcId];
+      Score scr = layout.arcScores[reverseWgArcId] + heurForEachState[layout.succStates[reverseWgArcId]];
+      if (heurForEachState[predStateIndex] < scr)
+        heurForEachState[predStateIndex] = scr;
     }
   }
 }
@@ -432,6 +800,7 @@ void WordGraph::nbSearch(unsigned int len, const std::vector<Score>& heurForEach
                          std::vector<std::vector<Score>>& scoreCompsVec, int verbosity /*=false*/)
 {
   // Perform A-star search
+  const WordGraphCsr& layout = getCsr();
 
   // Create null hypothesis
   NbSearchHyp nbSearchHyp;
@@ -473,10 +842,7 @@ void WordGraph::nbSearch(unsigned int len, const std::vector<Score>& heurForEach
         if (scrHypPair.second.empty())
           lastHypStateIndex = INITIAL_STATE;
         else
-        {
-          WordGraphArc wgArc = wordGraphArcId2WordGraphArc(scrHypPair.second.back());
-          lastHypStateIndex = wgArc.succStateIndex;
-        }
+          lastHypStateIndex = layout.succStates[scrHypPair.second.back()];
 
         // Subtract heuristic
         scrHypPair.first -= heurForEachState[lastHypStateIndex];
@@ -500,39 +866,30 @@ void WordGraph::nbSearch(unsigned int len, const std::vector<Score>& heurForEach
             std::cerr << "- Expanding top of the stack..." << std::endl;
 
           // Expand hypothesis
-          std::vector<WordGraphArcId> wgArcIds;
-          getArcIdsToSuccStates(lastHypStateIndex, wgArcIds);
-
-          std::vector<std::pair<Score, NbSearchHyp>> scrHypPairVec;
-          for (unsigned int i = 0; i < wgArcIds.size(); ++i)
+          const WordGraphArcId* arcIdsEnd = layout.outArcsEnd(lastHypStateIndex);
+          for (const WordGraphArcId* arcIdPtr = layout.outArcsBegin(lastHypStateIndex); arcIdPtr != arcIdsEnd;
+               ++arcIdPtr)
           {
-            if (!arcPruned(wgArcIds[i]))
+            if (!arcPruned(*arcIdPtr))
             {
-              WordGraphArc wgArc = wordGraphArcId2WordGraphArc(wgArcIds[i]);
               std::pair<Score, NbSearchHyp> newScrHypPair;
               newScrHypPair = scrHypPair;
               // Obtain new score
-              newScrHypPair.first += wgArc.arcScore;
+              newScrHypPair.first += layout.arcScores[*arcIdPtr];
               // Add heuristic
-              newScrHypPair.first += heurForEachState[wgArc.succStateIndex];
+              newScrHypPair.first += heurForEachState[layout.succStates[*arcIdPtr]];
               // Add new arc
-              newScrHypPair.second.push_back(wgArcIds[i]);
-              // Push into vector
-              scrHypPairVec.push_back(newScrHypPair);
+              newScrHypPair.second.push_back(*arcIdPtr);
+              // Push into the stack
+              nbSearchStack.push(newScrHypPair.first, newScrHypPair.second);
 
               if (verbosity >= 1)
               {
-                std::cerr << "  Adding extension, score contribution: " << wgArc.arcScore
-                          << " ; successor state: " << wgArc.succStateIndex << std::endl;
+                std::cerr << "  Adding extension, score contribution: " << layout.arcScores[*arcIdPtr]
+                          << " ; successor state: " << layout.succStates[*arcIdPtr] << std::endl;
               }
             }
           }
-
-          // Push results into the stack
-          for (unsigned int i = 0; i < scrHypPairVec.size(); ++i)
-          {
-            nbSearchStack.push(scrHypPairVec[i].first, scrHypPairVec[i].second);
-          }
         }
       }
       else
@@ -576,11 +933,40 @@ void WordGraph::nbSearch(unsigned int len, const std::vector<Score>& heurForEach
     {
       std::cerr << scrHypPair.first << " ||| " << translation << " |||";
       for (unsigned int j = 0; j < scrHypPair.second.size(); ++j)
-      {
-        WordGraphArc wgArc = wordGraphArcId2WordGraphArc(scrHypPair.second[j]);
-        HypStateIndex hidx = wgArc.succStateIndex;
-        std::cerr << " " << hidx;
-      }
+        std::cerr << " " << layout.succStates[scrHypPair.second[j]];
+      std::cerr << std::endl;
+    }
+  }
+}
+
+void WordGraph::lazyNbSearch(unsigned int len, std::vector<std::pair<Score, NbSearchHyp>>& hypList,
+                             int verbosity /*=false*/)
+{
+  const WordGraphCsr& layout = getCsr();
+  LazyKBestPaths kBestPaths(layout, arcsPruned, finalStateSet);
+
+  hypList.clear();
+  for (unsigned int k = 0; k < len; ++k)
+  {
+    const LazyKBestPaths::Derivation* derivation = kBestPaths.getDerivation(INITIAL_STATE, k);
+    if (derivation == NULL)
+      break;
+
+    // Follow the arcs of the path
+    std::pair<Score, NbSearchHyp> scrHypPair;
+    scrHypPair.first = initialStateScore + derivation->score;
+    while (derivation->arcId != INVALID_ARCID)
+    {
+      scrHypPair.second.push_back(derivation->arcId);
+      derivation = kBestPaths.getDerivation(layout.succStates[derivation->arcId], derivation->succRank);
+    }
+    hypList.push_back(scrHypPair);
+
+    if (verbosity >= 1)
+    {
+      std::cerr << "* Path " << k << ": " << scrHypPair.first << " ;";
+      for (unsigned int j = 0; j < scrHypPair.second.size(); ++j)
+        std::cerr << " " << scrHypPair.second[j];
       std::cerr << std::endl;
     }
   }
@@ -591,33 +977,27 @@ bool WordGraph::hypIsComplete(const NbSearchHyp& nbSearchHyp)
   if (nbSearchHyp.empty())
     return false;
   else
-  {
-    WordGraphArc wgArc = wordGraphArcId2WordGraphArc(nbSearchHyp.back());
-    HypStateIndex hidx = wgArc.succStateIndex;
-    if (stateIsFinal(hidx))
-      return true;
-    else
-      return false;
-  }
+    return stateIsFinal(getCsr().succStates[nbSearchHyp.back()]);
 }
 
 std::string WordGraph::stringAssociatedToHyp(const NbSearchHyp& nbSearchHyp, std::vector<Score>& scoreComps)
 {
+  const WordGraphCsr& layout = getCsr();
   std::string str;
   for (unsigned int i = 0; i < nbSearchHyp.size(); ++i)
   {
     WordGraphArcId wgArcId = nbSearchHyp[i];
-    WordGraphArc wgArc = wordGraphArcId2WordGraphArc(wgArcId);
 
     // Add words to str
     if (i != 0)
-      str = str + " ";
+      str += " ";
 
-    for (unsigned int k = 0; k < wgArc.words.size(); ++k)
+    unsigned int numWords = layout.numWords(wgArcId);
+    for (unsigned int k = 0; k < numWords; ++k)
     {
-      str = str + wgArc.words[k];
-      if (k != wgArc.words.size() - 1)
-        str = str + " ";
+      str += layout.word(wgArcId, k);
+      if (k != numWords - 1)
+        str += " ";
     }
 
     // Sum score components
@@ -642,19 +1022,20 @@ void WordGraph::getTranslationData(const NbSearchHyp& nbSearchHyp, TranslationDa
   data.targetSegmentCuts.clear();
   data.targetUnknownWords.clear();
   data.scoreComponents.clear();
+  const WordGraphCsr& layout = getCsr();
   for (unsigned int i = 0; i < nbSearchHyp.size(); ++i)
   {
     WordGraphArcId wgArcId = nbSearchHyp[i];
-    WordGraphArc wgArc = wordGraphArcId2WordGraphArc(wgArcId);
 
-    for (unsigned int k = 0; k < wgArc.words.size(); ++k)
+    for (unsigned int k = 0; k < layout.numWords(wgArcId); ++k)
     {
-      data.target.push_back(wgArc.words[k]);
-      if (wgArc.unknown)
+      data.target.push_back(layout.word(wgArcId, k));
+      if (layout.unknown[wgArcId])
         data.targetUnknownWords.insert(data.target.size() - 1);
     }
 
-    data.sourceSegmentation.push_back(std::make_pair(wgArc.srcStartIndex, wgArc.srcEndIndex));
+    data.sourceSegmentation.push_back(
+        std::make_pair(layout.srcStartIndices[wgArcId], layout.srcEndIndices[wgArcId]));
     data.targetSegmentCuts.push_back(data.target.size());
 
     // Sum score components
@@ -692,6 +1073,7 @@ void WordGraph::obtainWgComposedOfUsefulStates()
     wordGraphStates.clear();
     finalStateSet.clear();
     scrCompsVec.clear();
+    invalidateCsr();
 
     // Regenerate final states
     FinalStateSet::iterator iter;
@@ -740,6 +1122,7 @@ void WordGraph::orderArcsTopol()
 {
   // Define auxiliary variables
   WordGraphArcs wordGraphArcsAux;
+  std::vector<WordGraphArcId> arcOrder;
 
   std::vector<bool> arcAdded;
   arcAdded.insert(arcAdded.begin(), wordGraphArcs.size(), false);
@@ -795,6 +1178,7 @@ void WordGraph::orderArcsTopol()
           atLeastOneArcAdded = true;
           // Add arc
           wordGraphArcsAux.push_back(wgArc);
+          arcOrder.push_back(wgArcId);
           // Mark arc as added
           arcAdded[wgArcId] = true;
           // Close state
@@ -814,9 +1198,34 @@ void WordGraph::orderArcsTopol()
   // Check if new arc ordering has been successfully obtained
   if (wordGraphArcsAux.size() == wordGraphArcs.size())
   {
-    // Replace wordGraphArcs with wordGraphArcsAux
+    // Replace wordGraphArcs with wordGraphArcsAux, together with the
+    // information indexed by arc id
+    std::vector<bool> arcsPrunedAux;
+    std::vector<std::vector<Score>> scrCompsVecAux;
+    for (unsigned int i = 0; i < arcOrder.size(); ++i)
+    {
+      arcsPrunedAux.push_back(arcsPruned[arcOrder[i]]);
+      scrCompsVecAux.push_back(scrCompsVec[arcOrder[i]]);
+    }
     wordGraphArcs = wordGraphArcsAux;
+    arcsPruned = arcsPrunedAux;
+    scrCompsVec = scrCompsVecAux;
+
+    // Regenerate the arcs of each state
+    for (unsigned int i = 0; i < wordGraphStates.size(); ++i)
+    {
+      wordGraphStates[i].arcsToPredStates.clear();
+      wordGraphStates[i].arcsToSuccStates.clear();
+    }
+    for (WordGraphArcId wgArcId = 0; wgArcId < wordGraphArcs.size(); ++wgArcId)
+    {
+      wordGraphStates[wordGraphArcs[wgArcId].predStateIndex].arcsToSuccStates.push_back(wgArcId);
+      wordGraphStates[wordGraphArcs[wgArcId].succStateIndex].arcsToPredStates.push_back(wgArcId);
+    }
   }
+
+  // Freeze the CSR layout of the ordered word graph
+  buildCsr();
 }
 
 void WordGraph::calcPrevScores(HypStateIndex hypStateIndex, const std::set<WordGraphArcId>& excludedArcs,
@@ -869,19 +1278,31 @@ void WordGraph::calcPrevScoresWeights(HypStateIndex hypStateIndex, const std::se
     accessibleStateVec.insert(accessibleStateVec.begin(), wordGraphStates.size() - INITIAL_STATE, false);
     accessibleStateVec[hypStateIndex] = true;
 
+    // Mark excluded arcs
+    std::vector<bool> arcExcludedVec;
+    if (!excludedArcs.empty())
+    {
+      arcExcludedVec.insert(arcExcludedVec.begin(), wordGraphArcs.size(), false);
+      for (std::set<WordGraphArcId>::const_iterator iter = excludedArcs.begin(); iter != excludedArcs.end(); ++iter)
+      {
+        if (*iter < arcExcludedVec.size())
+          arcExcludedVec[*iter] = true;
+      }
+    }
+
     // Iteration over the arcs (arcs are assumed to be topologically
     // ordered)
-    std::pair<WordGraphArcId, WordGraphArcId> wgArcIdPair = getArcIndexRange();
-
-    for (WordGraphArcId wgArcId = wgArcIdPair.first; wgArcId <= wgArcIdPair.second; ++wgArcId)
+    const WordGraphCsr& layout = getCsr();
+    for (WordGraphArcId wgArcId = 0; wgArcId < layout.numArcs(); ++wgArcId)
     {
       // Check if arc has not been pruned
       if (!arcPruned(wgArcId))
       {
-        WordGraphArc wordGraphArc = wordGraphArcId2WordGraphArc(wgArcId);
+        HypStateIndex predStateIndex = layout.predStates[wgArcId];
+        HypStateIndex succStateIndex = layout.succStates[wgArcId];
 
-        // Check if wordGraphArc.predStateIndex is accessible
-        if (accessibleStateVec[wordGraphArc.predStateIndex])
+        // Check if predStateIndex is accessible
+        if (accessibleStateVec[predStateIndex])
         {
           // Determine score of arc
           Score arcScore = 0;
@@ -891,36 +1312,29 @@ void WordGraph::calcPrevScoresWeights(HypStateIndex hypStateIndex, const std::se
               arcScore += altCompWeights[i] * scrCompsVec[wgArcId][i];
           }
           else
-            arcScore = wordGraphArc.arcScore;
+            arcScore = layout.arcScores[wgArcId];
 
           // Update score
-          Score score = arcScore + prevScores[wordGraphArc.predStateIndex];
-          if (!excludedArcs.empty())
-          {
-            // If predecessor state is the initial state, check that the
-            // first word is not contained in the set of rejected words
-            std::set<WordGraphArcId>::const_iterator wgArcIdSetIter;
-            wgArcIdSetIter = excludedArcs.find(wgArcId);
-            if (wgArcIdSetIter != excludedArcs.end())
-              score = SMALL_SCORE;
-          }
+          Score score = arcScore + prevScores[predStateIndex];
+          if (!arcExcludedVec.empty() && arcExcludedVec[wgArcId])
+            score = SMALL_SCORE;
 
           if (score < SMALL_SCORE)
             score = SMALL_SCORE;
-          if (score > prevScores[wordGraphArc.succStateIndex])
+          if (score > prevScores[succStateIndex])
           {
-            prevScores[wordGraphArc.succStateIndex] = score;
-            bestPredArcForStateVec[wordGraphArc.succStateIndex] = wgArcId;
+            prevScores[succStateIndex] = score;
+            bestPredArcForStateVec[succStateIndex] = wgArcId;
           }
           // Update accessibleStateVec vector
-          accessibleStateVec[wordGraphArc.succStateIndex] = true;
+          accessibleStateVec[succStateIndex] = true;
         }
         else
         {
-          // If wordGraphArc.succStateIndex is not accessible, assign
-          // SMALL_SCORE to it
-          if (!accessibleStateVec[wordGraphArc.succStateIndex])
-            prevScores[wordGraphArc.succStateIndex] = SMALL_SCORE;
+          // If succStateIndex is not accessible, assign SMALL_SCORE to
+          // it
+          if (!accessibleStateVec[succStateIndex])
+            prevScores[succStateIndex] = SMALL_SCORE;
         }
       }
     }
@@ -967,19 +1381,18 @@ void WordGraph::calcRestScores(std::vector<Score>& restScores) const
 
   // Reverse iteration over the arcs (arcs are assumed to be
   // topologically ordered)
-  for (unsigned int i = 0; i < wordGraphArcs.size(); ++i)
+  const WordGraphCsr& layout = getCsr();
+  for (unsigned int i = 0; i < layout.numArcs(); ++i)
   {
-    unsigned int r = wordGraphArcs.size() - i - 1;
+    unsigned int r = layout.numArcs() - i - 1;
     // Check if arc has not been pruned
     if (!arcPruned(r))
     {
-      WordGraphArc wordGraphArc = wordGraphArcs[r];
-
-      Score score = wordGraphArc.arcScore + restScores[wordGraphArc.succStateIndex];
+      Score score = layout.arcScores[r] + restScores[layout.succStates[r]];
       if (score < SMALL_SCORE)
         score = SMALL_SCORE;
-      if (score > restScores[wordGraphArc.predStateIndex])
-        restScores[wordGraphArc.predStateIndex] = score;
+      if (score > restScores[layout.predStates[r]])
+        restScores[layout.predStates[r]] = score;
     }
   }
 }
@@ -1113,20 +1526,17 @@ unsigned int WordGraph::pruneArcsToPredStates(float threshold)
   unsigned int numPrunedArcs = 0;
 
   // Explore nodes
-  for (HypStateIndex hidx = 0; hidx < wordGraphStates.size(); ++hidx)
+  const WordGraphCsr& layout = getCsr();
+  for (HypStateIndex hidx = 0; hidx < layout.numStates(); ++hidx)
   {
-    std::vector<std::pair<Score, WordGraphArcId>> scoreArcIdVec;
-
     // Iterate over the arcs to predecessors
-    std::vector<WordGraphArcId>::iterator arcIdVecIter;
-    for (arcIdVecIter = wordGraphStates[hidx].arcsToPredStates.begin();
-         arcIdVecIter != wordGraphStates[hidx].arcsToPredStates.end(); ++arcIdVecIter)
+    for (const WordGraphArcId* arcIdPtr = layout.inArcsBegin(hidx); arcIdPtr != layout.inArcsEnd(hidx); ++arcIdPtr)
     {
       // Extract relevant arc information
-      WordGraphArcId wordGraphArcId = *arcIdVecIter;
-      HypStateIndex predStateIndex = wordGraphArcs[wordGraphArcId].predStateIndex;
-      HypStateIndex succStateIndex = wordGraphArcs[wordGraphArcId].succStateIndex;
-      Score arcScore = wordGraphArcs[wordGraphArcId].arcScore;
+      WordGraphArcId wordGraphArcId = *arcIdPtr;
+      HypStateIndex predStateIndex = layout.predStates[wordGraphArcId];
+      HypStateIndex succStateIndex = layout.succStates[wordGraphArcId];
+      Score arcScore = layout.arcScores[wordGraphArcId];
       Score bestScoreAssociatedToArc = prevScores[predStateIndex] + arcScore + restScores[succStateIndex];
       // std::cerr<<predStateIndex<<" -> "<<succStateIndex<<" , "<<prevScores[predStateIndex]<<" ";
       // std::cerr<<arcScore<<" "<<restScores[succStateIndex]<<" , "<<bestScoreAssociatedToArc<<" , "<<bestHypScore<<"
@@ -1149,15 +1559,14 @@ unsigned int WordGraph::pruneArcsToPredStates(float threshold)
 
 bool WordGraph::finalStatePruned(HypStateIndex hypStateIndex) const
 {
-  // Obtain arcs to predecessors for final state
-  std::vector<WordGraphArcId> wgArcIds;
-  getArcIdsToPredStates(hypStateIndex, wgArcIds);
-
-  // Verify if there is at least one arc that has not been pruned
+  // Verify if there is at least one arc to predecessors that has not
+  // been pruned
+  const WordGraphCsr& layout = getCsr();
   bool finalStatePrunedBool = true;
-  for (unsigned int i = 0; i < wgArcIds.size(); ++i)
+  for (const WordGraphArcId* arcIdPtr = layout.inArcsBegin(hypStateIndex); arcIdPtr != layout.inArcsEnd(hypStateIndex);
+       ++arcIdPtr)
   {
-    if (!arcPruned(wgArcIds[i]))
+    if (!arcPruned(*arcIdPtr))
     {
       finalStatePrunedBool = false;
       break;
@@ -1177,14 +1586,11 @@ void WordGraph::obtainStatesReachableFromInit(std::vector<bool>& stateReachableF
     stateReachableFromInitVec[INITIAL_STATE] = true;
   // Direct iteration over the arcs (arcs are assumed to be
   // topologically ordered)
-  for (WordGraphArcId wgArcId = 0; wgArcId < wordGraphArcs.size(); ++wgArcId)
+  const WordGraphCsr& layout = getCsr();
+  for (WordGraphArcId wgArcId = 0; wgArcId < layout.numArcs(); ++wgArcId)
   {
-    if (!arcPruned(wgArcId))
-    {
-      WordGraphArc wgArc = wordGraphArcId2WordGraphArc(wgArcId);
-      if (stateReachableFromInitVec[wgArc.predStateIndex])
-        stateReachableFromInitVec[wgArc.succStateIndex] = true;
-    }
+    if (!arcPruned(wgArcId) && stateReachableFromInitVec[layout.predStates[wgArcId]])
+      stateReachableFromInitVec[layout.succStates[wgArcId]] = true;
   }
 }
 
@@ -1200,24 +1606,9 @@ void WordGraph::obtainUsefulStates(std::vector<bool>& stateIsUsefulVec,
   FinalStateSet::const_iterator fssIter;
   for (fssIter = finalStateSet.begin(); fssIter != finalStateSet.end(); ++fssIter)
   {
-    bool atLeastOneArcArrivesToState = false;
-
-    // Obtain arcs to final state
-    std::vector<WordGraphArcId> wgArcIds;
-    getArcIdsToPredStates(*fssIter, wgArcIds);
-
-    // Check if there is at least one not pruned arc
-    for (unsigned int j = 0; j < wgArcIds.size(); ++j)
-    {
-      if (!arcPruned(wgArcIds[j]))
-      {
-        atLeastOneArcArrivesToState = true;
-        break;
-      }
-    }
-    // If at least one arc arrives to the final state, mark it as
-    // a useful one
-    if (atLeastOneArcArrivesToState)
+    // If at least one not pruned arc arrives to the final state, mark
+    // it as a useful one
+    if (*fssIter < stateIsUsefulVec.size() && !finalStatePruned(*fssIter))
       stateIsUsefulVec[*fssIter] = true;
   }
 
@@ -1227,14 +1618,15 @@ void WordGraph::obtainUsefulStates(std::vector<bool>& stateIsUsefulVec,
 
   // Reverse iteration over the arcs (arcs are assumed to be
   // topologically ordered)
-  for (WordGraphArcId wgArcId = 0; wgArcId < wordGraphArcs.size(); ++wgArcId)
+  const WordGraphCsr& layout = getCsr();
+  for (WordGraphArcId wgArcId = 0; wgArcId < layout.numArcs(); ++wgArcId)
   {
-    WordGraphArcId reverseWgArcId = wordGraphArcs.size() - wgArcId - 1;
+    WordGraphArcId reverseWgArcId = layout.numArcs() - wgArcId - 1;
     if (!arcPruned(reverseWgArcId))
     {
-      WordGraphArc wgArc = wordGraphArcId2WordGraphArc(reverseWgArcId);
-      if (stateReachableFromInitVec[wgArc.predStateIndex] && stateIsUsefulVec[wgArc.succStateIndex])
-        stateIsUsefulVec[wgArc.predStateIndex] = true;
+      HypStateIndex predStateIndex = layout.predStates[reverseWgArcId];
+      if (stateReachableFromInitVec[predStateIndex] && stateIsUsefulVec[layout.succStates[reverseWgArcId]])
+        stateIsUsefulVec[predStateIndex] = true;
     }
   }
 
@@ -1257,8 +1649,112 @@ void WordGraph::obtainUsefulStates(std::vector<bool>& stateIsUsefulVec,
   }
 }
 
+bool WordGraph::isBinaryFile(const char* filename)
+{
+  FILE* file = fopen(filename, "rb");
+  if (file == NULL)
+    return false;
+
+  char magic[8];
+  bool result = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+             && memcmp(magic, WORD_GRAPH_BINARY_MAGIC, sizeof(magic)) == 0;
+  fclose(file);
+  return result;
+}
+
+bool WordGraph::loadBinary(const char* filename)
+{
+  // Clear word graph
+  clear();
+
+  MappedFile mappedFile;
+  if (mappedFile.open(filename) == THOT_ERROR || mappedFile.size() < sizeof(WgBinaryHeader)
+      || !wgSectionsAreValid(mappedFile.data(), mappedFile.size()))
+  {
+    std::cerr << "Error: " << filename << " is not a valid binary word graph\n";
+    return THOT_ERROR;
+  }
+  const char* data = mappedFile.data();
+  const WgBinaryHeader& header = *reinterpret_cast<const WgBinaryHeader*>(data);
+
+  // Read component weights and final states
+  const uint64_t* compWeightNameOffsets = wgSection<uint64_t>(data, header, CompWeightNameOffsets);
+  const char* compWeightNameChars = wgSection<char>(data, header, CompWeightNameChars);
+  const float* compWeightValues = wgSection<float>(data, header, CompWeightValues);
+  for (uint64_t i = 0; i < header.numCompWeights; ++i)
+  {
+    std::string name(compWeightNameChars + compWeightNameOffsets[i],
+                     compWeightNameOffsets[i + 1] - compWeightNameOffsets[i]);
+    compWeights.push_back(std::make_pair(name, compWeightValues[i]));
+  }
+  const uint32_t* finalStates = wgSection<uint32_t>(data, header, FinalStates);
+  finalStateSet.insert(finalStates, finalStates + header.numFinalStates);
+  initialStateScore = header.initialStateScore;
+
+  // Read the CSR layout directly from the arc arrays
+  const uint64_t* vocabOffsets = wgSection<uint64_t>(data, header, VocabOffsets);
+  const char* vocabChars = wgSection<char>(data, header, VocabChars);
+  csr.vocab.reserve(header.numWords);
+  for (uint64_t w = 0; w < header.numWords; ++w)
+    csr.vocab.push_back(std::string(vocabChars + vocabOffsets[w], vocabOffsets[w + 1] - vocabOffsets[w]));
+
+  size_t numArcs = header.numArcs;
+  const uint8_t* arcFlags = wgSection<uint8_t>(data, header, ArcFlags);
+  const uint64_t* wordOffsets = wgSection<uint64_t>(data, header, WordOffsets);
+  const uint32_t* words = wgSection<uint32_t>(data, header, Words);
+  csr.predStates.assign(wgSection<uint32_t>(data, header, PredStates),
+                        wgSection<uint32_t>(data, header, PredStates) + numArcs);
+  csr.succStates.assign(wgSection<uint32_t>(data, header, SuccStates),
+                        wgSection<uint32_t>(data, header, SuccStates) + numArcs);
+  csr.arcScores.assign(wgSection<double>(data, header, ArcScores),
+                       wgSection<double>(data, header, ArcScores) + numArcs);
+  csr.srcStartIndices.assign(wgSection<uint32_t>(data, header, SrcStartIndices),
+                             wgSection<uint32_t>(data, header, SrcStartIndices) + numArcs);
+  csr.srcEndIndices.assign(wgSection<uint32_t>(data, header, SrcEndIndices),
+                           wgSection<uint32_t>(data, header, SrcEndIndices) + numArcs);
+  csr.wordOffsets.assign(wordOffsets, wordOffsets + numArcs + 1);
+  csr.words.assign(words, words + wordOffsets[numArcs]);
+  csr.unknown.resize(numArcs);
+  for (size_t wgArcId = 0; wgArcId < numArcs; ++wgArcId)
+    csr.unknown[wgArcId] = (arcFlags[wgArcId] & UnknownArcFlag) != 0;
+  csr.buildAdjacency(header.numStates);
+
+  // Regenerate arcs and states
+  const uint64_t* scrCompOffsets = wgSection<uint64_t>(data, header, ScrCompOffsets);
+  const Score* scrComps = wgSection<Score>(data, header, ScrComps);
+  wordGraphStates.resize(header.numStates);
+  wordGraphArcs.resize(numArcs);
+  arcsPruned.resize(numArcs);
+  scrCompsVec.resize(numArcs);
+  for (WordGraphArcId wgArcId = 0; wgArcId < numArcs; ++wgArcId)
+  {
+    WordGraphArc& wgArc = wordGraphArcs[wgArcId];
+    wgArc.predStateIndex = csr.predStates[wgArcId];
+    wgArc.succStateIndex = csr.succStates[wgArcId];
+    wgArc.arcScore = csr.arcScores[wgArcId];
+    wgArc.srcStartIndex = csr.srcStartIndices[wgArcId];
+    wgArc.srcEndIndex = csr.srcEndIndices[wgArcId];
+    wgArc.unknown = csr.unknown[wgArcId];
+    for (unsigned int k = 0; k < csr.numWords(wgArcId); ++k)
+      wgArc.words.push_back(csr.word(wgArcId, k));
+    arcsPruned[wgArcId] = (arcFlags[wgArcId] & PrunedArcFlag) != 0;
+    scrCompsVec[wgArcId].assign(scrComps + scrCompOffsets[wgArcId], scrComps + scrCompOffsets[wgArcId + 1]);
+  }
+  for (HypStateIndex idx = 0; idx < header.numStates; ++idx)
+  {
+    wordGraphStates[idx].arcsToSuccStates.assign(csr.outArcsBegin(idx), csr.outArcsEnd(idx));
+    wordGraphStates[idx].arcsToPredStates.assign(csr.inArcsBegin(idx), csr.inArcsEnd(idx));
+  }
+  csrUpToDate = true;
+
+  return THOT_OK;
+}
+
 bool WordGraph::load(const char* filename)
 {
+  if (isBinaryFile(filename))
+    return loadBinary(filename);
+
   AwkInputStream awk;
 
   if (awk.open(filename) == THOT_ERROR)
@@ -1277,7 +1773,7 @@ bool WordGraph::load(const char* filename)
     awk.getln();
 
     // Check if first line has component weights
-    if (awk.dollar(1) == "#")
+    if (awk.dollarEquals(1, "#"))
     {
       // Read weights
       std::vector<std::pair<std::string, float>> _compWeights;
@@ -1285,7 +1781,7 @@ bool WordGraph::load(const char* filename)
       {
         std::pair<std::string, float> compWeight;
         compWeight.first = awk.dollar(i);
-        compWeight.second = atof(awk.dollar(i + 1).c_str());
+        compWeight.second = awk.dollarToDouble(i + 1);
         _compWeights.push_back(compWeight);
       }
       compWeights = _compWeights;
@@ -1299,7 +1795,7 @@ bool WordGraph::load(const char* filename)
     for (unsigned int i = 1; i <= awk.NF; ++i)
     {
       HypStateIndex finalState;
-      finalState = atoi(awk.dollar(i).c_str());
+      finalState = awk.dollarToInt(i);
       finalStateSet.insert(finalState);
     }
 
@@ -1309,26 +1805,26 @@ bool WordGraph::load(const char* filename)
       if (awk.NF >= 3)
       {
         // Read state indices
-        HypStateIndex predStateIndex = atoi(awk.dollar(1).c_str());
-        HypStateIndex succStateIndex = atoi(awk.dollar(2).c_str());
+        HypStateIndex predStateIndex = awk.dollarToInt(1);
+        HypStateIndex succStateIndex = awk.dollarToInt(2);
 
         // Read arcScore
-        Score arcScore = atof(awk.dollar(3).c_str());
+        Score arcScore = awk.dollarToDouble(3);
 
-        PositionIndex srcStartIndex = atoi(awk.dollar(4).c_str());
-        PositionIndex srcEndIndex = atoi(awk.dollar(5).c_str());
+        PositionIndex srcStartIndex = awk.dollarToInt(4);
+        PositionIndex srcEndIndex = awk.dollarToInt(5);
 
-        bool unknown = atoi(awk.dollar(6).c_str());
+        bool unknown = awk.dollarToInt(6);
 
         // Read score components if given
         std::vector<Score> scrVec;
         unsigned int col = 7;
-        if (awk.dollar(7) == "|||")
+        if (awk.dollarEquals(7, "|||"))
         {
           col = 8;
-          while (awk.dollar(col) != "|||" && col <= awk.NF)
+          while (!awk.dollarEquals(col, "|||") && col <= awk.NF)
           {
-            scrVec.push_back(atof(awk.dollar(col).c_str()));
+            scrVec.push_back(awk.dollarToDouble(col));
             ++col;
           }
           ++col;
@@ -1347,6 +1843,9 @@ bool WordGraph::load(const char* filename)
       }
     }
     awk.close();
+
+    // Freeze the CSR layout of the loaded word graph
+    buildCsr();
     return THOT_OK;
   }
 }
@@ -1441,6 +1940,103 @@ void WordGraph::print(std::ostream& outS, bool printOnlyUsefulStates /*=false*/)
   }
 }
 
+bool WordGraph::printBinary(const char* filename) const
+{
+  const WordGraphCsr& layout = getCsr();
+
+  // Obtain component weights
+  std::vector<uint64_t> compWeightNameOffsets(1, 0);
+  std::string compWeightNameChars;
+  std::vector<float> compWeightValues;
+  for (unsigned int i = 0; i < compWeights.size(); ++i)
+  {
+    compWeightNameChars += compWeights[i].first;
+    compWeightNameOffsets.push_back(compWeightNameChars.size());
+    compWeightValues.push_back(compWeights[i].second);
+  }
+
+  // Obtain vocabulary
+  std::vector<uint64_t> vocabOffsets(1, 0);
+  std::string vocabChars;
+  for (unsigned int w = 0; w < layout.vocab.size(); ++w)
+  {
+    vocabChars += layout.vocab[w];
+    vocabOffsets.push_back(vocabChars.size());
+  }
+
+  // Obtain the arc arrays that are not part of the CSR layout
+  std::vector<uint32_t> finalStates(finalStateSet.begin(), finalStateSet.end());
+  std::vector<uint8_t> arcFlags;
+  std::vector<uint64_t> wordOffsets(layout.wordOffsets.begin(), layout.wordOffsets.end());
+  std::vector<uint64_t> scrCompOffsets(1, 0);
+  std::vector<Score> scrComps;
+  for (WordGraphArcId wgArcId = 0; wgArcId < layout.numArcs(); ++wgArcId)
+  {
+    arcFlags.push_back((layout.unknown[wgArcId] ? UnknownArcFlag : 0) | (arcsPruned[wgArcId] ? PrunedArcFlag : 0));
+    scrComps.insert(scrComps.end(), scrCompsVec[wgArcId].begin(), scrCompsVec[wgArcId].end());
+    scrCompOffsets.push_back(scrComps.size());
+  }
+
+  FILE* file = fopen(filename, "wb");
+  if (file == NULL)
+  {
+    std::cerr << "Error while printing binary word graph to file " << filename << std::endl;
+    return THOT_ERROR;
+  }
+
+  WgBinaryHeader header;
+  memset(&header, 0, sizeof(WgBinaryHeader));
+  memcpy(header.magic, WORD_GRAPH_BINARY_MAGIC, sizeof(header.magic));
+  header.version = WORD_GRAPH_BINARY_VERSION;
+  header.byteOrderMark = WORD_GRAPH_BINARY_BYTE_ORDER_MARK;
+  header.numStates = wordGraphStates.size();
+  header.numArcs = layout.numArcs();
+  header.numWords = layout.vocab.size();
+  header.numCompWeights = compWeights.size();
+  header.numFinalStates = finalStates.size();
+  header.initialStateScore = initialStateScore;
+  header.sectionOffsets[NumWgSections] = sizeof(WgBinaryHeader);
+
+  size_t numArcs = layout.numArcs();
+  bool ok =
+      fwrite(&header, sizeof(WgBinaryHeader), 1, file) == 1
+      && writeWgSection(file, header, CompWeightNameOffsets, compWeightNameOffsets.data(),
+                        compWeightNameOffsets.size() * 8)
+      && writeWgSection(file, header, CompWeightNameChars, compWeightNameChars.data(), compWeightNameChars.size())
+      && writeWgSection(file, header, CompWeightValues, compWeightValues.data(), compWeightValues.size() * 4)
+      && writeWgSection(file, header, VocabOffsets, vocabOffsets.data(), vocabOffsets.size() * 8)
+      && writeWgSection(file, header, VocabChars, vocabChars.data(), vocabChars.size())
+      && writeWgSection(file, header, FinalStates, finalStates.data(), finalStates.size() * 4)
+      && writeWgSection(file, header, PredStates, layout.predStates.data(), numArcs * 4)
+      && writeWgSection(file, header, SuccStates, layout.succStates.data(), numArcs * 4)
+      && writeWgSection(file, header, ArcScores, layout.arcScores.data(), numArcs * 8)
+      && writeWgSection(file, header, SrcStartIndices, layout.srcStartIndices.data(), numArcs * 4)
+      && writeWgSection(file, header, SrcEndIndices, layout.srcEndIndices.data(), numArcs * 4)
+      && writeWgSection(file, header, ArcFlags, arcFlags.data(), numArcs)
+      && writeWgSection(file, header, WordOffsets, wordOffsets.data(), wordOffsets.size() * 8)
+      && writeWgSection(file, header, Words, layout.words.data(), layout.words.size() * 4)
+      && writeWgSection(file, header, ScrCompOffsets, scrCompOffsets.data(), scrCompOffsets.size() * 8)
+      && writeWgSection(file, header, ScrComps, scrComps.data(), scrComps.size() * 8);
+
+  // Rewrite the header with the final section offsets
+  ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(WgBinaryHeader), 1, file) == 1;
+  ok = (fclose(file) == 0) && ok;
+  if (!ok)
+  {
+    std::cerr << "Error while printing binary word graph to file " << filename << std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+bool WordGraph::convertToBinary(const char* textFilename, const char* binaryFilename)
+{
+  WordGraph wg;
+  if (wg.load(textFilename) == THOT_ERROR)
+    return THOT_ERROR;
+  return wg.printBinary(binaryFilename);
+}
+
 bool WordGraph::empty() const
 {
   return wordGraphArcs.empty();
@@ -1465,4 +2061,5 @@ void WordGraph::clear()
   initialStateScore = 0;
   scrCompsVec.clear();
   compWeights.clear();
+  invalidateCsr();
 }
@@ -23,6 +23,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "error_correction/NbSearchStack.h"
 #include "error_correction/WordGraphArc.h"
 #include "error_correction/WordGraphArcId.h"
+#include "error_correction/WordGraphCsr.h"
 #include "error_correction/WordGraphStateData.h"
 #include "nlp_common/AwkInputStream.h"
 #include "nlp_common/ErrorDefs.h"
@@ -96,6 +97,11 @@ public:
   void getArcIdsToSuccStates(HypStateIndex hypStateIndex, std::vector<WordGraphArcId>& wgArcIds) const;
   FinalStateSet getFinalStateSet() const;
   bool stateIsFinal(HypStateIndex hypStateIndex) const;
+  const WordGraphCsr& getCsr() const;
+  // Returns the frozen CSR layout of the word graph. The layout is
+  // built by orderArcsTopol() and load(), and rebuilt on demand after
+  // the word graph is modified. Pruned arcs are included in the
+  // layout, the arcPruned() function should be used to skip them
 
   // Functions to calculate previous and rest scores for
   // each state
@@ -160,8 +166,15 @@ public:
   // Function to obtain n-best list
   void obtainNbestList(unsigned int len, std::vector<std::pair<Score, std::string>>& nblist,
                        std::vector<NbSearchHighLevelHyp>& highLevelHypList,
-                       std::vector<std::vector<Score>>& scoreCompsVec, int verbosity = false);
-  void obtainNbestList(unsigned int len, std::vector<TranslationData>& nblist, int verbosity = false);
+                       std::vector<std::vector<Score>>& scoreCompsVec, int verbosity = false, bool lazy = false);
+  void obtainNbestList(unsigned int len, std::vector<TranslationData>& nblist, int verbosity = false,
+                       bool lazy = false);
+  // If lazy is true, the n-best list is obtained by means of a lazy
+  // k-best algorithm over the topologically ordered arcs instead of an
+  // A-star search. Each additional path costs about O(log n) and
+  // strings are only generated for the returned paths, so this option
+  // is recommended for large n-best lists. Hypotheses with the same
+  // score may be returned in a different order
 
   // Function to obtain a wordgraph composed of useful states
   // (if wordgraph has been pruned, this function obtains a pruned
@@ -174,6 +187,10 @@ public:
 
   // Functions to load word graphs
   bool load(const char* filename);
+  // Word graphs can be given in text format or in the binary format
+  // generated by printBinary()
+  static bool isBinaryFile(const char* filename);
+  // Returns true if the given file contains a binary word graph
 
   // Functions to print word graphs
   //
@@ -184,6 +201,16 @@ public:
   bool print(const char* filename, bool printOnlyUsefulStates = false) const;
   void print(std::ostream& outS, bool printOnlyUsefulStates = false) const;
 
+  // Functions to print word graphs in binary format
+  //
+  // NOTE: The binary format stores a vocabulary block, the arc arrays
+  // (states, scores, source positions, flags, words and score
+  // components) and the component weights in native byte order. Arc
+  // order, scores and pruning information are preserved exactly
+  bool printBinary(const char* filename) const;
+  static bool convertToBinary(const char* textFilename, const char* binaryFilename);
+  // Converts a word graph in text format to binary format
+
   // size related functions
   bool empty() const;
   size_t numArcs() const;
@@ -203,6 +230,15 @@ protected:
   Score initialStateScore;
   std::vector<std::pair<std::string, float>> compWeights;
   std::vector<std::vector<Score>> scrCompsVec;
+  mutable WordGraphCsr csr;
+  mutable bool csrUpToDate;
+
+  // CSR layout related functions
+  void buildCsr() const;
+  void invalidateCsr();
+
+  // Auxiliary function to load word graphs in binary format
+  bool loadBinary(const char* filename);
 
   // Auxiliary functions for pruning
   unsigned int pruneArcsToPredStates(float threshold);
@@ -216,6 +252,7 @@ protected:
   void nbSearch(unsigned int len, const std::vector<Score>& heurForEachState,
                 std::vector<std::pair<Score, std::string>>& nblist, std::vector<NbSearchHyp>& hypList,
                 std::vector<std::vector<Score>>& scoreCompsVec, int verbosity = false);
+  void lazyNbSearch(unsigned int len, std::vector<std::pair<Score, NbSearchHyp>>& hypList, int verbosity = false);
   bool hypIsComplete(const NbSearchHyp& nbSearchHyp);
   std::string stringAssociatedToHyp(const NbSearchHyp& nbSearchHyp, std::vector<Score>& scoreComps);
   void getTranslationData(const NbSearchHyp& nbSearchHyp, TranslationData& data);
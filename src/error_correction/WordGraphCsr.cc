@@ -0,0 +1,113 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordGraphCsr.cc
+ *
+ * @brief Definitions file for WordGraphCsr.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "error_correction/WordGraphCsr.h"
+
+#include <unordered_map>
+
+//--------------- WordGraphCsr class function definitions
+
+//---------------------------------------
+void WordGraphCsr::build(const std::vector<WordGraphArc>& arcs, size_t numStates)
+{
+  clear();
+
+  // Fill arc arrays and intern words
+  std::unordered_map<std::string, unsigned int> wordIds;
+  predStates.reserve(arcs.size());
+  succStates.reserve(arcs.size());
+  arcScores.reserve(arcs.size());
+  srcStartIndices.reserve(arcs.size());
+  srcEndIndices.reserve(arcs.size());
+  unknown.reserve(arcs.size());
+  wordOffsets.reserve(arcs.size() + 1);
+  wordOffsets.push_back(0);
+  for (const WordGraphArc& arc : arcs)
+  {
+    predStates.push_back(arc.predStateIndex);
+    succStates.push_back(arc.succStateIndex);
+    arcScores.push_back(arc.arcScore);
+    srcStartIndices.push_back(arc.srcStartIndex);
+    srcEndIndices.push_back(arc.srcEndIndex);
+    unknown.push_back(arc.unknown);
+    for (const std::string& w : arc.words)
+    {
+      std::pair<std::unordered_map<std::string, unsigned int>::iterator, bool> result =
+          wordIds.insert(std::make_pair(w, (unsigned int)vocab.size()));
+      if (result.second)
+        vocab.push_back(w);
+      words.push_back(result.first->second);
+    }
+    wordOffsets.push_back(words.size());
+  }
+  buildAdjacency(numStates);
+}
+
+//---------------------------------------
+void WordGraphCsr::buildAdjacency(size_t numStates)
+{
+  // Count arcs of each state and turn counts into offsets
+  outOffsets.assign(numStates + 1, 0);
+  inOffsets.assign(numStates + 1, 0);
+  for (WordGraphArcId arcId = 0; arcId < numArcs(); ++arcId)
+  {
+    ++outOffsets[predStates[arcId] + 1];
+    ++inOffsets[succStates[arcId] + 1];
+  }
+  for (size_t idx = 0; idx < numStates; ++idx)
+  {
+    outOffsets[idx + 1] += outOffsets[idx];
+    inOffsets[idx + 1] += inOffsets[idx];
+  }
+
+  // Place arc ids, arcs are visited in increasing id order
+  outArcs.resize(numArcs());
+  inArcs.resize(numArcs());
+  std::vector<unsigned int> outPos(outOffsets.begin(), outOffsets.end() - 1);
+  std::vector<unsigned int> inPos(inOffsets.begin(), inOffsets.end() - 1);
+  for (WordGraphArcId arcId = 0; arcId < numArcs(); ++arcId)
+  {
+    outArcs[outPos[predStates[arcId]]++] = arcId;
+    inArcs[inPos[succStates[arcId]]++] = arcId;
+  }
+}
+
+//---------------------------------------
+void WordGraphCsr::clear(void)
+{
+  vocab.clear();
+  predStates.clear();
+  succStates.clear();
+  arcScores.clear();
+  srcStartIndices.clear();
+  srcEndIndices.clear();
+  unknown.clear();
+  wordOffsets.clear();
+  words.clear();
+  outOffsets.clear();
+  outArcs.clear();
+  inOffsets.clear();
+  inArcs.clear();
+}
@@ -0,0 +1,123 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordGraphCsr.h
+ *
+ * @brief Defines the WordGraphCsr class, a frozen compressed sparse row
+ * layout of a word graph.
+ */
+
+#pragma once
+
+//--------------- Include files --------------------------------------
+
+#include "error_correction/HypStateIndex.h"
+#include "error_correction/WordGraphArc.h"
+#include "error_correction/WordGraphArcId.h"
+#include "nlp_common/PositionIndex.h"
+#include "nlp_common/Score.h"
+
+#include <string>
+#include <vector>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- WordGraphCsr class
+
+/**
+ * @brief Frozen compressed sparse row (CSR) layout of a word graph.
+ *
+ * The attributes of the arcs are stored in contiguous arrays indexed by
+ * arc id and the words of the arcs are interned in a vocabulary. The
+ * arcs leaving and entering each state are stored in contiguous ranges
+ * of arc ids delimited by offset arrays, in increasing arc id order.
+ * The layout does not store which arcs were pruned.
+ */
+class WordGraphCsr
+{
+public:
+  // Build the layout from the arcs of a word graph with numStates
+  // states
+  void build(const std::vector<WordGraphArc>& arcs, size_t numStates);
+  // Build the offset arrays of the states once the arc arrays have
+  // been filled
+  void buildAdjacency(size_t numStates);
+
+  size_t numArcs(void) const
+  {
+    return predStates.size();
+  }
+  size_t numStates(void) const
+  {
+    return outOffsets.empty() ? 0 : outOffsets.size() - 1;
+  }
+
+  // Words of the arcs
+  unsigned int numWords(WordGraphArcId arcId) const
+  {
+    return wordOffsets[arcId + 1] - wordOffsets[arcId];
+  }
+  unsigned int wordId(WordGraphArcId arcId, unsigned int k) const
+  {
+    return words[wordOffsets[arcId] + k];
+  }
+  const std::string& word(WordGraphArcId arcId, unsigned int k) const
+  {
+    return vocab[words[wordOffsets[arcId] + k]];
+  }
+
+  // Ranges of arc ids leaving and entering a state, states out of
+  // range have no arcs
+  const WordGraphArcId* outArcsBegin(HypStateIndex idx) const
+  {
+    return idx < numStates() ? outArcs.data() + outOffsets[idx] : NULL;
+  }
+  const WordGraphArcId* outArcsEnd(HypStateIndex idx) const
+  {
+    return idx < numStates() ? outArcs.data() + outOffsets[idx + 1] : NULL;
+  }
+  const WordGraphArcId* inArcsBegin(HypStateIndex idx) const
+  {
+    return idx < numStates() ? inArcs.data() + inOffsets[idx] : NULL;
+  }
+  const WordGraphArcId* inArcsEnd(HypStateIndex idx) const
+  {
+    return idx < numStates() ? inArcs.data() + inOffsets[idx + 1] : NULL;
+  }
+
+  void clear(void);
+
+  // Vocabulary of interned words
+  std::vector<std::string> vocab;
+
+  // Arc arrays
+  std::vector<HypStateIndex> predStates;
+  std::vector<HypStateIndex> succStates;
+  std::vector<Score> arcScores;
+  std::vector<PositionIndex> srcStartIndices;
+  std::vector<PositionIndex> srcEndIndices;
+  std::vector<char> unknown;
+  std::vector<unsigned int> wordOffsets;
+  std::vector<unsigned int> words;
+
+  // Adjacency of the states
+  std::vector<unsigned int> outOffsets;
+  std::vector<WordGraphArcId> outArcs;
+  std::vector<unsigned int> inOffsets;
+  std::vector<WordGraphArcId> inArcs;
+};
@@ -0,0 +1,502 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file CompletionTrie.cc
+ *
+ * @brief Definitions file for CompletionTrie.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "incr_models/CompletionTrie.h"
+
+#include "nlp_common/ErrorDefs.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+// Binary completion trie format
+const char COMPLETION_TRIE_BINARY_MAGIC[8] = {'T', 'H', 'O', 'T', 'W', 'P', 'B', 'N'};
+const uint32_t COMPLETION_TRIE_BINARY_VERSION = 1;
+const uint32_t COMPLETION_TRIE_BINARY_BYTE_ORDER_MARK = 0x01020304;
+
+enum CtSection
+{
+  Base,
+  Check,
+  NodeWords,
+  CompletionOffsets,
+  Completions,
+  Counts,
+  WordOffsets,
+  WordChars,
+  NumCtSections
+};
+
+struct CtBinaryHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrderMark;
+  uint64_t numNodes;
+  uint64_t numWords;
+  uint64_t maxCompletions;
+  // Start of each section plus the end of the file
+  uint64_t sectionOffsets[NumCtSections + 1];
+};
+
+bool writeCtSection(FILE* file, CtBinaryHeader& header, CtSection sect, const void* ptr, size_t size)
+{
+  // Sections are aligned to 8 bytes
+  static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  uint64_t& end = header.sectionOffsets[NumCtSections];
+  size_t padSize = (size_t)((8 - end % 8) % 8);
+  if (padSize > 0 && fwrite(padding, 1, padSize, file) != padSize)
+    return false;
+  end += padSize;
+
+  header.sectionOffsets[sect] = end;
+  if (size > 0 && fwrite(ptr, 1, size, file) != size)
+    return false;
+  end += size;
+  return true;
+}
+
+template <class T>
+const T* ctSection(const char* data, const CtBinaryHeader& header, CtSection sect)
+{
+  return reinterpret_cast<const T*>(data + header.sectionOffsets[sect]);
+}
+
+bool ctSectionsAreValid(const char* data, size_t dataSize)
+{
+  const CtBinaryHeader& header = *reinterpret_cast<const CtBinaryHeader*>(data);
+  if (memcmp(header.magic, COMPLETION_TRIE_BINARY_MAGIC, sizeof(header.magic)) != 0
+      || header.version != COMPLETION_TRIE_BINARY_VERSION
+      || header.byteOrderMark != COMPLETION_TRIE_BINARY_BYTE_ORDER_MARK
+      || header.sectionOffsets[NumCtSections] != dataSize || header.numNodes == 0
+      || header.numNodes > 0x7fffffff || header.numWords >= CompletionTrie::NO_WORD)
+    return false;
+
+  // Sections must be aligned and lie within the file
+  for (unsigned int sect = 0; sect < NumCtSections; ++sect)
+  {
+    if (header.sectionOffsets[sect] % 8 != 0 || header.sectionOffsets[sect] < sizeof(CtBinaryHeader)
+        || header.sectionOffsets[sect] > header.sectionOffsets[sect + 1])
+      return false;
+  }
+
+  // Sections must be large enough for the number of elements given in
+  // the header
+  uint64_t minSizes[NumCtSections];
+  minSizes[Base] = header.numNodes * 4;
+  minSizes[Check] = header.numNodes * 4;
+  minSizes[NodeWords] = header.numNodes * 4;
+  minSizes[CompletionOffsets] = (header.numNodes + 1) * 8;
+  minSizes[Completions] = 0;
+  minSizes[Counts] = header.numWords * 4;
+  minSizes[WordOffsets] = (header.numWords + 1) * 8;
+  minSizes[WordChars] = 0;
+  for (unsigned int sect = 0; sect < NumCtSections; ++sect)
+  {
+    if (header.sectionOffsets[sect + 1] - header.sectionOffsets[sect] < minSizes[sect])
+      return false;
+  }
+
+  // Offset arrays must be non-decreasing and lie within their element
+  // sections
+  struct
+  {
+    CtSection offsets;
+    uint64_t num;
+    CtSection elems;
+    uint64_t elemSize;
+  } groups[] = {{CompletionOffsets, header.numNodes, Completions, 4}, {WordOffsets, header.numWords, WordChars, 1}};
+  for (unsigned int g = 0; g < sizeof(groups) / sizeof(groups[0]); ++g)
+  {
+    const uint64_t* offsets = ctSection<uint64_t>(data, header, groups[g].offsets);
+    for (uint64_t i = 0; i < groups[g].num; ++i)
+    {
+      if (offsets[i] > offsets[i + 1])
+        return false;
+    }
+    if (offsets[0] != 0
+        || offsets[groups[g].num] * groups[g].elemSize
+               > header.sectionOffsets[groups[g].elems + 1] - header.sectionOffsets[groups[g].elems])
+      return false;
+  }
+
+  // Nodes and completions must refer to existing words
+  const uint32_t* nodeWords = ctSection<uint32_t>(data, header, NodeWords);
+  for (uint64_t node = 0; node < header.numNodes; ++node)
+  {
+    if (nodeWords[node] != CompletionTrie::NO_WORD && nodeWords[node] >= header.numWords)
+      return false;
+  }
+  const uint32_t* completions = ctSection<uint32_t>(data, header, Completions);
+  uint64_t numCompletions = ctSection<uint64_t>(data, header, CompletionOffsets)[header.numNodes];
+  for (uint64_t i = 0; i < numCompletions; ++i)
+  {
+    if (completions[i] >= header.numWords)
+      return false;
+  }
+  return true;
+}
+} // namespace
+
+//--------------- CompletionTrie class function definitions
+
+const CompletionTrie::WordId CompletionTrie::NO_WORD;
+
+//---------------------------------------
+CompletionTrie::CompletionTrie(void)
+{
+  clear();
+}
+
+//---------------------------------------
+void CompletionTrie::build(const std::map<std::string, Count>& wordCounts, unsigned int _maxCompletions)
+{
+  clear();
+  maxCompletions = _maxCompletions;
+
+  // Store words, their ids follow the lexicographic order of the map
+  std::vector<std::string> words;
+  wordOffsetVec.push_back(0);
+  for (std::map<std::string, Count>::const_iterator iter = wordCounts.begin(); iter != wordCounts.end(); ++iter)
+  {
+    words.push_back(iter->first);
+    countVec.push_back((float)iter->second);
+    wordCharVec.insert(wordCharVec.end(), iter->first.begin(), iter->first.end());
+    wordOffsetVec.push_back(wordCharVec.size());
+  }
+
+  // Place the nodes, the root is the first one
+  baseVec.assign(1, 0);
+  checkVec.assign(1, -1);
+  nodeWordVec.assign(1, NO_WORD);
+  std::vector<bool> used(1, true);
+  size_t firstFree = 1;
+  std::vector<std::vector<WordId>> nodeCompletions(1);
+  buildNode(0, words, 0, words.size(), 0, used, firstFree, nodeCompletions);
+
+  // Flatten the completions of the nodes
+  completionOffsetVec.push_back(0);
+  for (size_t node = 0; node < baseVec.size(); ++node)
+  {
+    completionVec.insert(completionVec.end(), nodeCompletions[node].begin(), nodeCompletions[node].end());
+    completionOffsetVec.push_back(completionVec.size());
+  }
+
+  setArrays();
+}
+
+//---------------------------------------
+void CompletionTrie::buildNode(int32_t node, const std::vector<std::string>& words, size_t begin, size_t end,
+                               size_t depth, std::vector<bool>& used, size_t& firstFree,
+                               std::vector<std::vector<WordId>>& nodeCompletions)
+{
+  // Words in [begin,end) share the prefix of length depth that
+  // corresponds to node, and the first one may be the prefix itself
+  std::vector<WordId> candidates;
+  if (begin < end && words[begin].size() == depth)
+  {
+    nodeWordVec[node] = begin;
+    candidates.push_back(begin);
+    ++begin;
+  }
+
+  // Group the rest of words by their next byte
+  std::vector<int> codes;
+  std::vector<size_t> bounds;
+  for (size_t i = begin; i < end;)
+  {
+    unsigned char c = words[i][depth];
+    size_t j = i + 1;
+    while (j < end && (unsigned char)words[j][depth] == c)
+      ++j;
+    codes.push_back(c + 1);
+    bounds.push_back(i);
+    i = j;
+  }
+  bounds.push_back(end);
+
+  if (!codes.empty())
+  {
+    int32_t b = placeChildren(codes, used, firstFree);
+    baseVec[node] = b;
+    nodeCompletions.resize(baseVec.size());
+    for (size_t k = 0; k < codes.size(); ++k)
+      checkVec[b + codes[k]] = node;
+
+    for (size_t k = 0; k < codes.size(); ++k)
+    {
+      int32_t childNode = b + codes[k];
+      buildNode(childNode, words, bounds[k], bounds[k + 1], depth + 1, used, firstFree, nodeCompletions);
+      candidates.insert(candidates.end(), nodeCompletions[childNode].begin(), nodeCompletions[childNode].end());
+    }
+  }
+
+  // Keep the best completions among the word of the node and the
+  // completions of its children
+  const std::vector<float>& wordCounts = countVec;
+  size_t numKept = std::min(candidates.size(), (size_t)maxCompletions);
+  std::partial_sort(candidates.begin(), candidates.begin() + numKept, candidates.end(),
+                    [&wordCounts](WordId a, WordId b) {
+                      return wordCounts[a] > wordCounts[b] || (wordCounts[a] == wordCounts[b] && a < b);
+                    });
+  candidates.resize(numKept);
+  nodeCompletions[node].swap(candidates);
+}
+
+//---------------------------------------
+int32_t CompletionTrie::placeChildren(const std::vector<int>& codes, std::vector<bool>& used, size_t& firstFree)
+{
+  while (firstFree < used.size() && used[firstFree])
+    ++firstFree;
+
+  // Find the first base whose child positions are all free
+  size_t numUsedSeen = 0;
+  for (size_t pos = firstFree;; ++pos)
+  {
+    if (pos < used.size() && used[pos])
+    {
+      ++numUsedSeen;
+      continue;
+    }
+    if (pos < (size_t)codes[0])
+      continue;
+
+    size_t b = pos - codes[0];
+    bool fits = true;
+    for (size_t k = 1; k < codes.size() && fits; ++k)
+      fits = b + codes[k] >= used.size() || !used[b + codes[k]];
+    if (!fits)
+      continue;
+
+    size_t size = std::max(used.size(), b + codes.back() + 1);
+    used.resize(size, false);
+    baseVec.resize(size, 0);
+    checkVec.resize(size, -1);
+    nodeWordVec.resize(size, NO_WORD);
+    for (size_t k = 0; k < codes.size(); ++k)
+      used[b + codes[k]] = true;
+
+    // Skip densely used regions in later searches
+    if (numUsedSeen >= 0.95 * (pos - firstFree + 1))
+      firstFree = pos;
+    return b;
+  }
+}
+
+//---------------------------------------
+void CompletionTrie::setArrays(void)
+{
+  numNodes = baseVec.size();
+  nWords = countVec.size();
+  base = baseVec.data();
+  check = checkVec.data();
+  nodeWords = nodeWordVec.data();
+  completionOffsets = completionOffsetVec.data();
+  completions = completionVec.data();
+  counts = countVec.data();
+  wordOffsets = wordOffsetVec.data();
+  wordChars = wordCharVec.data();
+}
+
+//---------------------------------------
+bool CompletionTrie::printBinary(const char* fileName) const
+{
+  FILE* file = numNodes == 0 ? NULL : fopen(fileName, "wb");
+  if (file == NULL)
+  {
+    std::cerr << "Error while printing binary completion trie to file " << fileName << std::endl;
+    return THOT_ERROR;
+  }
+
+  CtBinaryHeader header;
+  memset(&header, 0, sizeof(CtBinaryHeader));
+  memcpy(header.magic, COMPLETION_TRIE_BINARY_MAGIC, sizeof(header.magic));
+  header.version = COMPLETION_TRIE_BINARY_VERSION;
+  header.byteOrderMark = COMPLETION_TRIE_BINARY_BYTE_ORDER_MARK;
+  header.numNodes = numNodes;
+  header.numWords = nWords;
+  header.maxCompletions = maxCompletions;
+  header.sectionOffsets[NumCtSections] = sizeof(CtBinaryHeader);
+
+  bool ok = fwrite(&header, sizeof(CtBinaryHeader), 1, file) == 1
+         && writeCtSection(file, header, Base, base, numNodes * 4)
+         && writeCtSection(file, header, Check, check, numNodes * 4)
+         && writeCtSection(file, header, NodeWords, nodeWords, numNodes * 4)
+         && writeCtSection(file, header, CompletionOffsets, completionOffsets, (numNodes + 1) * 8)
+         && writeCtSection(file, header, Completions, completions, completionOffsets[numNodes] * 4)
+         && writeCtSection(file, header, Counts, counts, nWords * 4)
+         && writeCtSection(file, header, WordOffsets, wordOffsets, (nWords + 1) * 8)
+         && writeCtSection(file, header, WordChars, wordChars, wordOffsets[nWords]);
+
+  // Rewrite the header with the final section offsets
+  ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(CtBinaryHeader), 1, file) == 1;
+  ok = (fclose(file) == 0) && ok;
+  if (!ok)
+  {
+    std::cerr << "Error while printing binary completion trie to file " << fileName << std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//---------------------------------------
+bool CompletionTrie::isBinaryFile(const char* fileName)
+{
+  FILE* file = fopen(fileName, "rb");
+  if (file == NULL)
+    return false;
+
+  char magic[8];
+  bool result = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+             && memcmp(magic, COMPLETION_TRIE_BINARY_MAGIC, sizeof(magic)) == 0;
+  fclose(file);
+  return result;
+}
+
+//---------------------------------------
+bool CompletionTrie::loadBinary(const char* fileName)
+{
+  clear();
+
+  if (mappedFile.open(fileName) == THOT_ERROR || mappedFile.size() < sizeof(CtBinaryHeader)
+      || !ctSectionsAreValid(mappedFile.data(), mappedFile.size()))
+  {
+    std::cerr << "Error: " << fileName << " is not a valid binary completion trie" << std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+
+  // The arrays are read in place
+  const char* data = mappedFile.data();
+  const CtBinaryHeader& header = *reinterpret_cast<const CtBinaryHeader*>(data);
+  numNodes = header.numNodes;
+  nWords = header.numWords;
+  maxCompletions = header.maxCompletions;
+  base = ctSection<int32_t>(data, header, Base);
+  check = ctSection<int32_t>(data, header, Check);
+  nodeWords = ctSection<WordId>(data, header, NodeWords);
+  completionOffsets = ctSection<uint64_t>(data, header, CompletionOffsets);
+  completions = ctSection<WordId>(data, header, Completions);
+  counts = ctSection<float>(data, header, Counts);
+  wordOffsets = ctSection<uint64_t>(data, header, WordOffsets);
+  wordChars = ctSection<char>(data, header, WordChars);
+  return THOT_OK;
+}
+
+//---------------------------------------
+size_t CompletionTrie::numWords(void) const
+{
+  return nWords;
+}
+
+//---------------------------------------
+std::string CompletionTrie::word(WordId wordId) const
+{
+  return std::string(wordChars + wordOffsets[wordId], wordOffsets[wordId + 1] - wordOffsets[wordId]);
+}
+
+//---------------------------------------
+Count CompletionTrie::count(WordId wordId) const
+{
+  return counts[wordId];
+}
+
+//---------------------------------------
+CompletionTrie::WordId CompletionTrie::find(const std::string& word) const
+{
+  int64_t node = findNode(word);
+  return node < 0 ? NO_WORD : nodeWords[node];
+}
+
+//---------------------------------------
+void CompletionTrie::getCompletions(const std::string& prefix, std::vector<WordId>& result) const
+{
+  result.clear();
+  int64_t node = findNode(prefix);
+  if (node >= 0)
+    result.assign(completions + completionOffsets[node], completions + completionOffsets[node + 1]);
+}
+
+//---------------------------------------
+unsigned int CompletionTrie::getMaxCompletions(void) const
+{
+  return maxCompletions;
+}
+
+//---------------------------------------
+int64_t CompletionTrie::child(int64_t node, char c) const
+{
+  int64_t t = (int64_t)base[node] + (unsigned char)c + 1;
+  if (t <= 0 || t >= (int64_t)numNodes || check[t] != node)
+    return -1;
+  return t;
+}
+
+//---------------------------------------
+int64_t CompletionTrie::findNode(const std::string& prefix) const
+{
+  if (numNodes == 0)
+    return -1;
+
+  int64_t node = 0;
+  for (size_t i = 0; i < prefix.size() && node >= 0; ++i)
+    node = child(node, prefix[i]);
+  return node;
+}
+
+//---------------------------------------
+bool CompletionTrie::empty(void) const
+{
+  return nWords == 0;
+}
+
+//---------------------------------------
+void CompletionTrie::clear(void)
+{
+  baseVec.clear();
+  checkVec.clear();
+  nodeWordVec.clear();
+  completionOffsetVec.clear();
+  completionVec.clear();
+  countVec.clear();
+  wordOffsetVec.clear();
+  wordCharVec.clear();
+  mappedFile.close();
+
+  numNodes = 0;
+  nWords = 0;
+  maxCompletions = 0;
+  base = NULL;
+  check = NULL;
+  nodeWords = NULL;
+  completionOffsets = NULL;
+  completions = NULL;
+  counts = NULL;
+  wordOffsets = NULL;
+  wordChars = NULL;
+}
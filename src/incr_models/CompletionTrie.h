@@ -0,0 +1,126 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file CompletionTrie.h
+ *
+ * @brief Defines the CompletionTrie class, a frozen double-array trie
+ * of words that stores the best completions of each prefix.
+ */
+
+#pragma once
+
+//--------------- Include files --------------------------------------
+
+#include "nlp_common/Count.h"
+#include "nlp_common/MappedFile.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- CompletionTrie class
+
+/**
+ * @brief Frozen double-array trie of words with their counts.
+ *
+ * The child of node s for byte c is the node base[s]+c+1 if its check
+ * entry is s. Words are identified by their position in lexicographic
+ * order, and each node stores the ids of the best completions of its
+ * prefix, sorted by decreasing count and then by id, so that a
+ * completion query costs O(prefix length + number of completions).
+ *
+ * The trie is built in memory from a table of counts, or mapped from
+ * a binary file, in which case the arrays are read in place.
+ */
+class CompletionTrie
+{
+public:
+  typedef uint32_t WordId;
+
+  static const WordId NO_WORD = 0xffffffff;
+
+  CompletionTrie(void);
+
+  // Builds the trie from the given counts, storing up to
+  // maxCompletions completions per node
+  void build(const std::map<std::string, Count>& wordCounts, unsigned int maxCompletions);
+
+  // Functions to store the trie in binary format
+  //
+  // NOTE: The binary format stores the double array, the completions
+  // of the nodes and the words with their counts in native byte order
+  bool printBinary(const char* fileName) const;
+  static bool isBinaryFile(const char* fileName);
+  bool loadBinary(const char* fileName);
+
+  // Word access functions
+  size_t numWords(void) const;
+  std::string word(WordId wordId) const;
+  Count count(WordId wordId) const;
+  WordId find(const std::string& word) const;
+
+  // Obtains the ids of the best completions of prefix, including
+  // prefix itself if it is a word
+  void getCompletions(const std::string& prefix, std::vector<WordId>& completions) const;
+  unsigned int getMaxCompletions(void) const;
+
+  bool empty(void) const;
+  void clear(void);
+
+private:
+  // Storage of a trie built in memory
+  std::vector<int32_t> baseVec;
+  std::vector<int32_t> checkVec;
+  std::vector<WordId> nodeWordVec;
+  std::vector<uint64_t> completionOffsetVec;
+  std::vector<WordId> completionVec;
+  std::vector<float> countVec;
+  std::vector<uint64_t> wordOffsetVec;
+  std::vector<char> wordCharVec;
+
+  // Storage of a trie loaded from a binary file
+  MappedFile mappedFile;
+
+  // Arrays of the trie, they point to either of the previous storages
+  size_t numNodes;
+  size_t nWords;
+  unsigned int maxCompletions;
+  const int32_t* base;
+  const int32_t* check;
+  const WordId* nodeWords;
+  const uint64_t* completionOffsets;
+  const WordId* completions;
+  const float* counts;
+  const uint64_t* wordOffsets;
+  const char* wordChars;
+
+  int64_t child(int64_t node, char c) const;
+  int64_t findNode(const std::string& prefix) const;
+
+  // Build functions
+  int32_t placeChildren(const std::vector<int>& codes, std::vector<bool>& used, size_t& firstFree);
+  void buildNode(int32_t node, const std::vector<std::string>& words, size_t begin, size_t end, size_t depth,
+                 std::vector<bool>& used, size_t& firstFree, std::vector<std::vector<WordId>>& nodeCompletions);
+  void setArrays(void);
+
+  CompletionTrie(const CompletionTrie&);
+  CompletionTrie& operator=(const CompletionTrie&);
+};
@@ -26,6 +26,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "incr_models/WordPredictor.h"
 
+#include <algorithm>
+
 //--------------- WordPredictor class functions
 //
 
@@ -38,8 +40,20 @@ WordPredictor::WordPredictor()
 //---------------------------------------
 bool WordPredictor::load(const char* fileName, int verbose /*=0*/)
 {
-  // Load file with sentences
-  int ret = loadFileWithSents(fileName, verbose);
+  // Load file with sentences, a binary file replaces the current
+  // counts
+  int ret;
+  if (CompletionTrie::isBinaryFile(fileName))
+  {
+    if (verbose)
+      std::cerr << "WordPredictor: loading binary file " << fileName << std::endl;
+    addedCounts.clear();
+    ret = completionTrie.loadBinary(fileName);
+  }
+  else
+  {
+    ret = loadFileWithSents(fileName, verbose);
+  }
   if (ret == THOT_ERROR)
     return THOT_ERROR;
 
@@ -81,10 +95,27 @@ bool WordPredictor::loadFileWithSents(const char* fileName, int verbose)
       strVec.clear();
     }
     fileStream.close();
+    freeze();
     return THOT_OK;
   }
 }
 
+//---------------------------------------
+bool WordPredictor::printBinary(const char* fileName)
+{
+  freeze();
+  return completionTrie.printBinary(fileName);
+}
+
+//---------------------------------------
+bool WordPredictor::convertToBinary(const char* sentsFileName, const char* binaryFileName, int verbose /*=0*/)
+{
+  WordPredictor wordPredictor;
+  if (wordPredictor.loadFileWithSents(sentsFileName, verbose) == THOT_ERROR)
+    return THOT_ERROR;
+  return wordPredictor.printBinary(binaryFileName);
+}
+
 //---------------------------------------
 bool WordPredictor::loadFileWithAdditionalInfo(const char* fileName, int verbose)
 {
@@ -106,7 +137,7 @@ bool WordPredictor::loadFileWithAdditionalInfo(const char* fileName, int verbose
     {
       if (fileStream.NF == 1)
       {
-        numSentsToRetain = atoi(fileStream.dollar(1).c_str());
+        numSentsToRetain = fileStream.dollarToInt(1);
         if (verbose)
           std::cerr << "numSentsToRetain= " << numSentsToRetain << std::endl;
         fileStream.close();
@@ -146,64 +177,77 @@ void WordPredictor::addSentence(std::vector<std::string> strVec)
 //---------------------------------------
 void WordPredictor::addSentenceAux(std::vector<std::string> strVec)
 {
-  std::vector<char> vecChar;
-  std::string chain;
-  Count* cPtr;
-
   for (unsigned int i = 0; i < strVec.size(); ++i)
   {
-    chain = strVec[i];
-    vecChar.clear();
-    for (unsigned int j = 0; j < chain.size(); ++j)
-    {
-      vecChar.push_back(chain[j]);
-    }
-    cPtr = charTrie.find(vecChar);
-    if (cPtr == NULL)
-    {
-      charTrie.insert(vecChar, 1);
-    }
-    else
-    {
-      *cPtr = *cPtr + (Count)1;
-    }
+    Count& count = addedCounts[strVec[i]];
+    count = count + (Count)1;
   }
+
+  // Keep the scan of the added words in getSuffixList() short
+  if (addedCounts.size() > WP_MAX_ADDED_WORDS)
+    freeze();
 }
 
 //---------------------------------------
-void WordPredictor::getSuffixList(std::string input, SuffixList& out)
+Count WordPredictor::getCount(const std::string& word) const
+{
+  Count count = 0;
+  CompletionTrie::WordId wordId = completionTrie.find(word);
+  if (wordId != CompletionTrie::NO_WORD)
+    count = completionTrie.count(wordId);
+  std::map<std::string, Count>::const_iterator iter = addedCounts.find(word);
+  if (iter != addedCounts.end())
+    count = count + iter->second;
+  return count;
+}
+
+//---------------------------------------
+void WordPredictor::freeze(void)
 {
-  Trie<char, Count>* triePtr;
-  std::vector<char> charVec;
+  if (addedCounts.empty() && !completionTrie.empty())
+    return;
+
+  std::map<std::string, Count> wordCounts;
+  wordCounts.swap(addedCounts);
+  for (CompletionTrie::WordId wordId = 0; wordId < completionTrie.numWords(); ++wordId)
+  {
+    Count& count = wordCounts[completionTrie.word(wordId)];
+    count = count + completionTrie.count(wordId);
+  }
+  completionTrie.build(wordCounts, WP_NUM_COMPLETIONS);
+}
 
+//---------------------------------------
+void WordPredictor::getSuffixList(std::string input, SuffixList& out)
+{
   out.clear();
-  for (unsigned int i = 0; i < input.size(); ++i)
-    charVec.push_back(input[i]);
-  triePtr = charTrie.getState(charVec);
-  if (triePtr != NULL)
+
+  // The candidates are the best completions stored in the trie and
+  // the added words that start with input, with their total counts
+  std::vector<std::pair<Count, std::string>> candidates;
+  std::vector<CompletionTrie::WordId> wordIds;
+  completionTrie.getCompletions(input, wordIds);
+  for (unsigned int i = 0; i < wordIds.size(); ++i)
   {
-    Trie<char, Count>::const_iterator trieIter;
-    std::string suff;
-    unsigned int i;
+    std::string word = completionTrie.word(wordIds[i]);
+    if (addedCounts.find(word) == addedCounts.end())
+      candidates.push_back(std::make_pair(completionTrie.count(wordIds[i]), word));
+  }
+  for (std::map<std::string, Count>::const_iterator iter = addedCounts.lower_bound(input);
+       iter != addedCounts.end() && iter->first.compare(0, input.size(), input) == 0; ++iter)
+  {
+    candidates.push_back(std::make_pair(getCount(iter->first), iter->first));
+  }
 
-    for (trieIter = triePtr->begin(); trieIter != triePtr->end(); ++trieIter)
-    {
-      suff = "";
-      if ((double)trieIter->second > (double)0)
-      {
-        if (input.size() > 0 && trieIter->first[0] != input[input.size() - 1])
-          break;
-        // This checking is done to detect whether the iterator
-        // finish the iteration over the words that starts with the
-        // prefix input
-
-        for (i = 1; i < trieIter->first.size(); ++i)
-        {
-          suff.push_back(trieIter->first[i]);
-        }
-        out[trieIter->second] = suff;
-      }
-    }
+  // Sort candidates by decreasing count and then by word
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<Count, std::string>& a, const std::pair<Count, std::string>& b) {
+              return (float)a.first > (float)b.first || ((float)a.first == (float)b.first && a.second < b.second);
+            });
+  for (unsigned int i = 0; i < candidates.size() && i < WP_NUM_COMPLETIONS; ++i)
+  {
+    if ((double)candidates[i].first > (double)0)
+      out.insert(std::make_pair(candidates[i].first, candidates[i].second.substr(input.size())));
   }
 }
 
@@ -229,7 +273,8 @@ std::pair<Count, std::string> WordPredictor::getBestSuffix(std::string input)
 //---------------------------------------
 void WordPredictor::clear(void)
 {
-  charTrie.clear();
+  completionTrie.clear();
+  addedCounts.clear();
   numSentsToRetain = 1;
   strVecVec.clear();
 }
@@ -28,10 +28,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Include files --------------------------------------
 
+#include "incr_models/CompletionTrie.h"
 #include "nlp_common/AwkInputStream.h"
 #include "nlp_common/Count.h"
 #include "nlp_common/ErrorDefs.h"
-#include "nlp_common/Trie.h"
 
 #include <functional>
 #include <iomanip>
@@ -42,6 +42,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Constants ------------------------------------------
 
+#define WP_NUM_COMPLETIONS 10
+#define WP_MAX_ADDED_WORDS 10000
+
 //--------------- Classes --------------------------------------------
 
 //--------------- WordPredictor template class
@@ -49,6 +52,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 /**
  * @brief the WordPredictor class tries to predict the ending of
  * incomplete words, and is intended to be used in a CAT scenario
+ *
+ * Word counts are stored in a frozen CompletionTrie that keeps the
+ * WP_NUM_COMPLETIONS best completions of each prefix, plus a table
+ * with the counts of the sentences added after it was built.
  */
 
 class WordPredictor
@@ -59,13 +66,21 @@ public:
   // Constructor
   WordPredictor();
 
-  // Load file with word prediction information
+  // Load file with word prediction information, the file with
+  // sentences may also be given in binary format
   bool load(const char* fileName, int verbose = 0);
 
+  // Functions to store the word predictor in binary format
+  bool printBinary(const char* fileName);
+  static bool convertToBinary(const char* sentsFileName, const char* binaryFileName, int verbose = 0);
+  // Converts a file with sentences to binary format
+
   // Add a new sentence to the word predictor
   void addSentence(std::vector<std::string> strVec);
 
-  // Get set of possible suffixes for a string
+  // Get set of possible suffixes for a string, only the
+  // WP_NUM_COMPLETIONS best completions are considered and, given
+  // equal counts, the lexicographically smallest completion is kept
   void getSuffixList(std::string input, SuffixList& out);
 
   // Get the suffix with highest count for given string
@@ -77,10 +92,16 @@ public:
   ~WordPredictor();
 
 protected:
-  Trie<char, Count> charTrie;
+  CompletionTrie completionTrie;
+  std::map<std::string, Count> addedCounts;
   unsigned int numSentsToRetain;
   std::vector<std::vector<std::string>> strVecVec;
 
+  // Obtains the total count of a word
+  Count getCount(const std::string& word) const;
+  // Builds the completion trie again with the added counts
+  void freeze(void);
+
   bool loadFileWithSents(const char* fileName, int verbose);
   bool loadFileWithAdditionalInfo(const char* fileName, int verbose);
   void addSentenceAux(std::vector<std::string> strVec);
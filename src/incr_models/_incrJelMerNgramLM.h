@@ -34,6 +34,8 @@ extern "C"
 
 #include "incr_models/IncrNgramLM.h"
 
+#include <algorithm>
+#include <math.h>
 #include <stdio.h>
 
 //--------------- Constants ------------------------------------------
@@ -88,14 +90,32 @@ protected:
   unsigned int numBucketsPerOrder;
   double sizeOfBucket;
 
+  // Interpolation terms of the n-grams of a corpus. The terms of
+  // n-gram i are stored in [ngramOffsets[i],ngramOffsets[i+1]), from
+  // the unigram to the highest order
+  struct CorpusNgramTerms
+  {
+    std::vector<size_t> ngramOffsets;
+    std::vector<double> probs;
+    std::vector<unsigned int> weightIdxs;
+    double zerogramProb;
+    unsigned int numWords;
+    unsigned int numOfSentences;
+  };
+
   // Downhill-simplex related functions
-  int new_dhs_eval(const char* corpusFileName, FILE* tmp_file, double* x, double& obj_func);
+  int getCorpusNgramTerms(const char* corpusFileName, CorpusNgramTerms& terms);
+  void addNgramTerms(const std::vector<WordIndex>& s, const WordIndex& t, CorpusNgramTerms& terms);
+  double corpusPerplexity(const CorpusNgramTerms& terms, const double* x);
+  static int dhsObjFunc(void* data, int n, double* x, double* y);
 
   // Weights related functions
   double getJelMerWeight(const std::vector<WordIndex>& s, const WordIndex& t);
+  unsigned int getJelMerWeightIdx(const std::vector<WordIndex>& s);
   virtual double freqOfNgram(const std::vector<WordIndex>& s);
 
   // Recursive function to interpolate models
+  std::vector<WordIndex> removeExtraBos(const std::vector<WordIndex>& s);
   Prob pTrgGivenSrcRec(const std::vector<WordIndex>& s, const WordIndex& t);
 };
 
@@ -105,7 +125,15 @@ protected:
 template <class SRC_INFO, class SRCTRG_INFO>
 Prob _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::pTrgGivenSrc(const std::vector<WordIndex>& s, const WordIndex& t)
 {
-  // Remove extra BOS symbols
+  // Calculate interpolated probability
+  Prob p = pTrgGivenSrcRec(removeExtraBos(s), t);
+  return p;
+}
+
+//---------------
+template <class SRC_INFO, class SRCTRG_INFO>
+std::vector<WordIndex> _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::removeExtraBos(const std::vector<WordIndex>& s)
+{
   bool found;
   std::vector<WordIndex> aux_s;
   if (s.size() >= 2)
@@ -122,10 +150,7 @@ Prob _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::pTrgGivenSrc(const std::vector<W
   }
   else
     aux_s = s;
-
-  // Calculate interpolated probability
-  Prob p = pTrgGivenSrcRec(aux_s, t);
-  return p;
+  return aux_s;
 }
 
 //---------------
@@ -158,85 +183,43 @@ Prob _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::pTrgGivenSrcRec(const std::vecto
 template <class SRC_INFO, class SRCTRG_INFO>
 int _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::updateModelWeights(const char* corpusFileName, int verbose /*=0*/)
 {
+  // Obtain the interpolation terms of the corpus, so that each
+  // function evaluation only combines them with the new weights
+  CorpusNgramTerms terms;
+  if (getCorpusNgramTerms(corpusFileName, terms) == THOT_ERROR)
+    return THOT_ERROR;
+
   // Initialize downhill simplex input parameters
   std::vector<double> initial_weights = weights;
   int ndim = initial_weights.size();
-  double* start = (double*)malloc(ndim * sizeof(double));
+  std::vector<double> start = initial_weights;
   int nfunk = 0;
-  double* x = (double*)malloc(ndim * sizeof(double));
   double y;
+  double curr_dhs_ftol = DBL_MAX;
+  std::pair<_incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>*, const CorpusNgramTerms*> objFuncData(this, &terms);
 
-  // Create temporary file
-  FILE* tmp_file = tmpfile();
-
-  if (tmp_file == 0)
-  {
-    std::cerr << "Error updating of Jelinek Mercer's language model weights, tmp file could not be created"
+  // Execute downhill simplex algorithm
+  int ret = downhill_simplex(start.data(), ndim, DHS_LM_FTOL, DHS_LM_SCALE_PAR, NULL, dhsObjFunc, &objFuncData, &nfunk,
+                             &y, &curr_dhs_ftol, false);
+  if (ret == DSO_NMAX_ERROR)
+    std::cerr << "Error updating of Jelinek Mercer's language model weights, maximum number of iterations exceeded"
               << std::endl;
-    return THOT_ERROR;
-  }
 
-  // Execute downhill simplex algorithm
-  int ret;
-  bool end = false;
-  while (!end)
+  // Print verbose information
+  if (verbose >= 1)
   {
-    // Set initial weights (each call to step_by_step_simplex starts
-    // from the initial weights)
-    for (unsigned int i = 0; i < initial_weights.size(); ++i)
-      start[i] = initial_weights[i];
-
-    // Execute step by step simplex
-    double curr_dhs_ftol = DBL_MAX;
-    ret = step_by_step_simplex(start, ndim, DHS_LM_FTOL, DHS_LM_SCALE_PAR, NULL, tmp_file, &nfunk, &y, x,
-                               &curr_dhs_ftol, false);
-
-    switch (ret)
-    {
-    case THOT_OK:
-      end = true;
-      break;
-    case DSO_NMAX_ERROR:
-      std::cerr << "Error updating of Jelinek Mercer's language model weights, maximum number of iterations exceeded"
-                << std::endl;
-      end = true;
-      break;
-    case DSO_EVAL_FUNC: // A new function evaluation is requested by downhill simplex
-      double perp;
-      int retEval = new_dhs_eval(corpusFileName, tmp_file, x, perp);
-      if (retEval == THOT_ERROR)
-      {
-        end = true;
-        break;
-      }
-      // Print verbose information
-      if (verbose >= 1)
-      {
-        std::cerr << "niter= " << nfunk << " ; current ftol= " << curr_dhs_ftol << " (FTOL=" << DHS_LM_FTOL << ") ; ";
-        std::cerr << "weights=";
-        for (unsigned int i = 0; i < weights.size(); ++i)
-          std::cerr << " " << weights[i];
-        std::cerr << " ; perp= " << perp << std::endl;
-      }
-      break;
-    }
+    std::cerr << "niter= " << nfunk << " ; current ftol= " << curr_dhs_ftol << " (FTOL=" << DHS_LM_FTOL << ") ; ";
+    std::cerr << "weights=";
+    for (unsigned int i = 0; i < start.size(); ++i)
+      std::cerr << " " << start[i];
+    std::cerr << " ; perp= " << y << std::endl;
   }
 
   // Set new weights if updating was successful
   if (ret == THOT_OK)
-  {
-    for (unsigned int i = 0; i < weights.size(); ++i)
-      weights[i] = start[i];
-  }
+    weights = start;
   else
-  {
     weights = initial_weights;
-  }
-
-  // Clear variables
-  free(start);
-  free(x);
-  fclose(tmp_file);
 
   if (ret != THOT_OK)
     return THOT_ERROR;
@@ -246,53 +229,122 @@ int _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::updateModelWeights(const char* co
 
 //---------------
 template <class SRC_INFO, class SRCTRG_INFO>
-int _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::new_dhs_eval(const char* corpusFileName, FILE* tmp_file, double* x,
-                                                            double& obj_func)
+int _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::getCorpusNgramTerms(const char* corpusFileName,
+                                                                   CorpusNgramTerms& terms)
 {
-  unsigned int numOfSentences;
-  unsigned int numWords;
-  LgProb totalLogProb;
-  bool weightsArePositive = true;
-  bool weightsAreBelowOne = true;
-  int retVal;
-
-  // Fix weights to be evaluated
-  for (unsigned int i = 0; i < weights.size(); ++i)
+  AwkInputStream awk;
+  if (awk.open(corpusFileName) == THOT_ERROR)
   {
-    weights[i] = x[i];
-    if (weights[i] < 0)
-      weightsArePositive = false;
-    if (weights[i] >= 1)
-      weightsAreBelowOne = false;
+    std::cerr << "Error while opening corpus file " << corpusFileName << std::endl;
+    return THOT_ERROR;
   }
-  if (weightsArePositive && weightsAreBelowOne)
+
+  bool found;
+  terms.ngramOffsets.assign(1, 0);
+  terms.probs.clear();
+  terms.weightIdxs.clear();
+  terms.zerogramProb = (double)1.0 / (double)this->getVocabSize();
+  terms.numWords = 0;
+  terms.numOfSentences = 0;
+  while (awk.getln())
   {
-    // Obtain perplexity
-    retVal = this->perplexity(corpusFileName, numOfSentences, numWords, totalLogProb, obj_func);
+    // Each word and the end of the sentence are predicted from the
+    // state of the previous words
+    std::vector<WordIndex> state;
+    this->getStateForBeginOfSentence(state);
+    for (unsigned int i = 1; i <= awk.NF; ++i)
+    {
+      WordIndex w = this->stringToWordIndex(awk.dollar(i));
+      addNgramTerms(state, w, terms);
+      this->addNextWordToState(w, state);
+    }
+    addNgramTerms(state, this->getEosId(found), terms);
+
+    terms.numWords += awk.NF;
+    ++terms.numOfSentences;
   }
-  else
+  awk.close();
+
+  return THOT_OK;
+}
+
+//---------------
+template <class SRC_INFO, class SRCTRG_INFO>
+void _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::addNgramTerms(const std::vector<WordIndex>& s, const WordIndex& t,
+                                                              CorpusNgramTerms& terms)
+{
+  // The terms are stored in the reverse order of the recursion of
+  // pTrgGivenSrcRec, which removes the first word of s at each step
+  std::vector<WordIndex> aux_s = removeExtraBos(s);
+  size_t offset = terms.probs.size();
+  while (true)
   {
-    obj_func = DBL_MAX;
-    retVal = THOT_OK;
+    terms.probs.push_back((double)this->tablePtr->pTrgGivenSrc(aux_s, t));
+    terms.weightIdxs.push_back(getJelMerWeightIdx(aux_s));
+    if (aux_s.empty())
+      break;
+    aux_s.erase(aux_s.begin());
   }
-  // Print result to tmp file
-  fprintf(tmp_file, "%g\n", obj_func);
-  fflush(tmp_file);
-  // step_by_step_simplex needs that the file position
-  // indicator is set at the start of the stream
-  rewind(tmp_file);
-
-  return retVal;
+  std::reverse(terms.probs.begin() + offset, terms.probs.end());
+  std::reverse(terms.weightIdxs.begin() + offset, terms.weightIdxs.end());
+  terms.ngramOffsets.push_back(terms.probs.size());
+}
+
+//---------------
+template <class SRC_INFO, class SRCTRG_INFO>
+double _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::corpusPerplexity(const CorpusNgramTerms& terms, const double* x)
+{
+  double totalLogProb = 0;
+  int numNgrams = (int)terms.ngramOffsets.size() - 1;
+#pragma omp parallel for schedule(static) reduction(+ : totalLogProb)
+  for (int i = 0; i < numNgrams; ++i)
+  {
+    double p = terms.zerogramProb;
+    for (size_t k = terms.ngramOffsets[i]; k < terms.ngramOffsets[i + 1]; ++k)
+    {
+      double weight = x[terms.weightIdxs[k]];
+      p = weight * terms.probs[k] + (1 - weight) * p;
+    }
+    totalLogProb += log(p);
+  }
+  return exp(-totalLogProb / (terms.numWords + terms.numOfSentences));
+}
+
+//---------------
+template <class SRC_INFO, class SRCTRG_INFO>
+int _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::dhsObjFunc(void* data, int n, double* x, double* y)
+{
+  std::pair<_incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>*, const CorpusNgramTerms*>* objFuncData =
+      (std::pair<_incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>*, const CorpusNgramTerms*>*)data;
+
+  // The weights are only valid in the [0,1) interval
+  for (int i = 0; i < n; ++i)
+  {
+    if (x[i] < 0 || x[i] >= 1)
+    {
+      *y = DBL_MAX;
+      return THOT_OK;
+    }
+  }
+  *y = objFuncData->first->corpusPerplexity(*objFuncData->second, x);
+  return THOT_OK;
 }
 
 //---------------
 template <class SRC_INFO, class SRCTRG_INFO>
 double _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::getJelMerWeight(const std::vector<WordIndex>& s,
                                                                   const WordIndex& /*t*/)
+{
+  return weights[getJelMerWeightIdx(s)];
+}
+
+//---------------
+template <class SRC_INFO, class SRCTRG_INFO>
+unsigned int _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::getJelMerWeightIdx(const std::vector<WordIndex>& s)
 {
   if (numBucketsPerOrder == 1)
   {
-    return weights[s.size()];
+    return s.size();
   }
   else
   {
@@ -303,8 +355,8 @@ double _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::getJelMerWeight(const std::vec
     if (bucketIdx > numBucketsPerOrder - 1)
       bucketIdx = numBucketsPerOrder - 1;
 
-    // Return weight
-    return weights[((order - 1) * numBucketsPerOrder) + bucketIdx];
+    // Return index of weight
+    return ((order - 1) * numBucketsPerOrder) + bucketIdx;
   }
 }
 
@@ -357,12 +409,12 @@ bool _incrJelMerNgramLM<SRC_INFO, SRCTRG_INFO>::loadWeights(const char* prefixOf
       std::cerr << "Loading weights from " << weightFileName << std::endl;
     if (awk.getln())
     {
-      this->ngramOrder = atoi(awk.dollar(1).c_str());
-      numBucketsPerOrder = atoi(awk.dollar(2).c_str());
-      sizeOfBucket = (double)atof(awk.dollar(3).c_str());
+      this->ngramOrder = awk.dollarToInt(1);
+      numBucketsPerOrder = awk.dollarToInt(2);
+      sizeOfBucket = (double)awk.dollarToDouble(3);
       for (unsigned int i = 4; i <= awk.NF; ++i)
       {
-        weights.push_back((double)atof(awk.dollar(i).c_str()));
+        weights.push_back((double)awk.dollarToDouble(i));
       }
       awk.close();
       return THOT_OK;
@@ -496,9 +496,9 @@ bool _incrNgramLM<SRC_INFO, SRCTRG_INFO>::load_ngrams(const char* fileName, int
             hs.push_back(awk.dollar(i));
           }
         }
-        ht = awk.dollar(awk.NF - 2);
-        inf.first = atof(awk.dollar(awk.NF - 1).c_str());
-        inf.second = atof(awk.dollar(awk.NF).c_str());
+        awk.dollar(awk.NF - 2, ht);
+        inf.first = awk.dollarToDouble(awk.NF - 1);
+        inf.second = awk.dollarToDouble(awk.NF);
         addTableEntryHigh(hs, ht, inf);
       }
     }
@@ -105,9 +105,9 @@ bool vecx_x_incr_ecpm<HX, X, SRC_INFO, SRCTRG_INFO>::load(const char* fileName)
             hs.push_back(awk.dollar(i));
           }
         }
-        ht = awk.dollar(awk.NF - 2);
-        inf.first = atof(awk.dollar(awk.NF - 1).c_str());
-        inf.second = atof(awk.dollar(awk.NF).c_str());
+        awk.dollar(awk.NF - 2, ht);
+        inf.first = awk.dollarToDouble(awk.NF - 1);
+        inf.second = awk.dollarToDouble(awk.NF);
         this->addTableEntryHigh(hs, ht, inf);
       }
     }
@@ -27,12 +27,15 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "nlp_common/ErrorDefs.h"
 #include "nlp_common/getline.h"
 
+#include <string.h>
+
 //----------
 AwkInputStream::AwkInputStream(void)
 {
   FS = 0;
   buff = NULL;
   buftlen = 0;
+  lineLength = 0;
   fopen_called = false;
 }
 
@@ -73,6 +76,8 @@ bool AwkInputStream::getln(void)
         }
         buff[read] = '\0';
       }
+      // Embedded null characters end the line
+      lineLength = strlen(buff);
       ++FNR;
       NF = get_NF();
       return true;
@@ -87,25 +92,70 @@ bool AwkInputStream::getln(void)
 //----------
 std::string AwkInputStream::dollar(unsigned int n)
 {
-  if (FS != 0)
-  {
-    if (n == 0)
-    {
-      return buff;
-    }
-    else
-    {
-      if (n > NF)
-        return "";
-      else
-      {
-        retrieveField(n - 1);
-        return fieldStr;
-      }
-    }
-  }
+  std::string field;
+  dollar(n, field);
+  return field;
+}
+
+//----------
+const char* AwkInputStream::dollarData(unsigned int n) const
+{
+  if (FS == 0 || n > NF)
+    return "";
+  else if (n == 0)
+    return buff;
+  else
+    return buff + fieldStarts[n - 1];
+}
+
+//----------
+size_t AwkInputStream::dollarSize(unsigned int n) const
+{
+  if (FS == 0 || n > NF)
+    return 0;
+  else if (n == 0)
+    return lineLength;
+  else
+    return fieldEnds[n - 1] - fieldStarts[n - 1];
+}
+
+//----------
+bool AwkInputStream::dollarEquals(unsigned int n, const char* str) const
+{
+  size_t size = dollarSize(n);
+  return strncmp(dollarData(n), str, size) == 0 && str[size] == '\0';
+}
+
+//----------
+void AwkInputStream::dollar(unsigned int n, std::string& field) const
+{
+  field.assign(dollarData(n), dollarSize(n));
+}
+
+//----------
+double AwkInputStream::dollarToDouble(unsigned int n) const
+{
+  // The field is converted in place unless the conversion would go
+  // beyond its end, which may happen for separators other than blanks
+  const char* data = dollarData(n);
+  char* end;
+  double value = strtod(data, &end);
+  if (end <= data + dollarSize(n))
+    return value;
+  else
+    return atof(std::string(data, dollarSize(n)).c_str());
+}
+
+//----------
+int AwkInputStream::dollarToInt(unsigned int n) const
+{
+  const char* data = dollarData(n);
+  char* end;
+  long value = strtol(data, &end, 10);
+  if (end <= data + dollarSize(n))
+    return (int)value;
   else
-    return NULL;
+    return atoi(std::string(data, dollarSize(n)).c_str());
 }
 
 //----------
@@ -121,9 +171,13 @@ bool AwkInputStream::open(const char* str)
   }
   else
   {
+    // Large reads reduce the number of system calls when loading big
+    // model files
+    setvbuf(filePtr, NULL, _IOFBF, AWK_INPUT_STREAM_BUFFER_SIZE);
     fopen_called = true;
     fileName = str;
     FNR = 0;
+    NF = 0;
     FS = ' ';
     return THOT_OK;
   }
@@ -143,6 +197,7 @@ bool AwkInputStream::open_stream(FILE* stream)
   else
   {
     FNR = 0;
+    NF = 0;
     FS = ' ';
     return THOT_OK;
   }
@@ -153,7 +208,6 @@ void AwkInputStream::close(void)
 {
   if (fopen_called)
     fclose(filePtr);
-  fieldStr = "";
   FS = 0;
   fopen_called = false;
 }
@@ -178,11 +232,8 @@ void AwkInputStream::printFields(void)
 
   if (FS != 0)
   {
-    for (i = 0; i < NF; ++i)
-    {
-      retrieveField(i);
-      printf("|%s", fieldStr.c_str());
-    }
+    for (i = 1; i <= NF; ++i)
+      printf("|%.*s", (int)dollarSize(i), dollarData(i));
   }
   printf("|\n");
 }
@@ -199,79 +250,22 @@ AwkInputStream::~AwkInputStream()
 //----------
 int AwkInputStream::get_NF(void)
 {
-  unsigned int i = 0;
-
-  NF = 0;
-
-  while (buff[i] != 0 && buff[i] == FS)
-    ++i;
-  while (buff[i] != 0)
-  {
-    if (buff[i] == FS)
-    {
-      ++NF;
-      while (buff[i] != 0 && buff[i] == FS)
-        ++i;
-    }
-    else
-    {
-      ++i;
-      if (buff[i] == 0)
-        ++NF;
-    }
-  }
-  return NF;
-}
-
-//----------
-void AwkInputStream::retrieveField(unsigned int n)
-{
-  unsigned int numFields = 0, i = 0;
-
-  fieldStr = "";
-  NF = 0;
-
-  while (buff[i] != 0 && buff[i] == FS)
-    ++i;
-  while (buff[i] != 0)
-  {
-    if (buff[i] == FS)
-    {
-      ++NF;
-      while (buff[i] != 0 && buff[i] == FS)
-        ++i;
-    }
-    else
-    {
-      ++i;
-      if (buff[i] == 0)
-        ++NF;
-    }
-  }
+  // Locate the fields of the line in a single pass, sequences of
+  // separators are treated as a single one
+  fieldStarts.clear();
+  fieldEnds.clear();
 
-  i = 0;
-  numFields = 0;
-  while (buff[i] != 0 && buff[i] == FS)
-    ++i;
-  while (buff[i] != 0)
+  size_t i = 0;
+  while (i < lineLength)
   {
-    if (buff[i] == FS)
-    {
-      ++numFields;
-      while (buff[i] != 0 && buff[i] == FS)
-        ++i;
-    }
-    else
-    {
-      if (n == numFields)
-        fieldStr += buff[i];
+    while (i < lineLength && buff[i] == FS)
       ++i;
-      if (buff[i] == 0 && n == numFields)
-      {
-        ++numFields;
-      }
-    }
-    if (numFields > n)
+    if (i == lineLength)
       break;
+    fieldStarts.push_back(i);
+    const char* sep = (const char*)memchr(buff + i, FS, lineLength - i);
+    i = sep == NULL ? lineLength : sep - buff;
+    fieldEnds.push_back(i);
   }
+  return (int)fieldStarts.size();
 }
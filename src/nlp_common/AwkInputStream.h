@@ -21,10 +21,13 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <vector>
 #if THOT_HAVE_UNISTD_H
 #include <unistd.h>
 #endif
 
+#define AWK_INPUT_STREAM_BUFFER_SIZE (1024 * 1024)
+
 //--------------- AwkInputStream class: awk-like input stream class
 
 class AwkInputStream
@@ -40,6 +43,18 @@ public:
   AwkInputStream& operator=(const AwkInputStream& awk);
   bool getln(void);
   std::string dollar(unsigned int n);
+
+  // Zero-copy access to the fields of the current line. Fields are
+  // located once per line, dollarData() returns a pointer into the
+  // line buffer that is not null-terminated at the end of the field
+  const char* dollarData(unsigned int n) const;
+  size_t dollarSize(unsigned int n) const;
+  bool dollarEquals(unsigned int n, const char* str) const;
+  void dollar(unsigned int n, std::string& field) const;
+  // Number conversions with the semantics of atof() and atoi()
+  double dollarToDouble(unsigned int n) const;
+  int dollarToInt(unsigned int n) const;
+
   bool open(const char* str);
   bool open_stream(FILE* stream);
   void close(void);
@@ -48,12 +63,13 @@ public:
   ~AwkInputStream();
 
 protected:
-  std::string fieldStr;
   char* buff;
   size_t buftlen;
+  size_t lineLength;
+  std::vector<size_t> fieldStarts;
+  std::vector<size_t> fieldEnds;
   FILE* filePtr;
   bool fopen_called;
 
   int get_NF(void);
-  void retrieveField(unsigned int n);
 };
@@ -0,0 +1,130 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file MappedFile.cc
+ *
+ * @brief Definitions file for MappedFile.h
+ */
+
+//--------------- Include files ---------------------------------------
+
+#include "nlp_common/MappedFile.h"
+
+#include "nlp_common/ErrorDefs.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//--------------- MappedFile class function definitions
+
+//-------------------------
+MappedFile::MappedFile(void) : ptr(NULL), fileSize(0)
+{
+}
+
+//-------------------------
+bool MappedFile::open(const char* fileName)
+{
+  close();
+
+#ifdef _WIN32
+  HANDLE fileHandle =
+      CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (fileHandle == INVALID_HANDLE_VALUE)
+    return THOT_ERROR;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0)
+  {
+    CloseHandle(fileHandle);
+    return THOT_ERROR;
+  }
+  HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+  void* view = mappingHandle == NULL ? NULL : MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+  // The view keeps the mapping alive once the handles are closed
+  if (mappingHandle != NULL)
+    CloseHandle(mappingHandle);
+  CloseHandle(fileHandle);
+  if (view == NULL)
+    return THOT_ERROR;
+  fileSize = (size_t)size.QuadPart;
+#else
+  int fd = ::open(fileName, O_RDONLY);
+  if (fd < 0)
+    return THOT_ERROR;
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+  {
+    ::close(fd);
+    return THOT_ERROR;
+  }
+  void* view = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping remains valid once the descriptor is closed
+  ::close(fd);
+  if (view == MAP_FAILED)
+    return THOT_ERROR;
+  fileSize = (size_t)fileStat.st_size;
+#endif
+  ptr = static_cast<const char*>(view);
+  return THOT_OK;
+}
+
+//-------------------------
+bool MappedFile::isOpen(void) const
+{
+  return ptr != NULL;
+}
+
+//-------------------------
+const char* MappedFile::data(void) const
+{
+  return ptr;
+}
+
+//-------------------------
+size_t MappedFile::size(void) const
+{
+  return fileSize;
+}
+
+//-------------------------
+void MappedFile::close(void)
+{
+  if (ptr != NULL)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(ptr);
+#else
+    munmap(const_cast<char*>(ptr), fileSize);
+#endif
+  }
+  ptr = NULL;
+  fileSize = 0;
+}
+
+//-------------------------
+MappedFile::~MappedFile()
+{
+  close();
+}
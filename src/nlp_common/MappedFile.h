@@ -0,0 +1,61 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file MappedFile.h
+ *
+ * @brief Read-only memory mapping of a file.
+ */
+
+#pragma once
+
+//--------------- Include files ---------------------------------------
+
+#include <stddef.h>
+
+//--------------- Classes ---------------------------------------------
+
+//--------------- MappedFile class
+
+/**
+ * @brief Maps a whole file into memory for reading. The mapping is
+ * released by close() or when the object is destroyed.
+ */
+class MappedFile
+{
+public:
+  MappedFile(void);
+
+  // Maps the given file, returns non-zero if error. Empty files cannot
+  // be mapped
+  bool open(const char* fileName);
+
+  bool isOpen(void) const;
+  const char* data(void) const;
+  size_t size(void) const;
+
+  void close(void);
+
+  ~MappedFile();
+
+private:
+  const char* ptr;
+  size_t fileSize;
+
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+};
@@ -113,4 +113,11 @@ public:
       fill(p.begin(), p.end(), t);
     }
   }
+  // Set new dimensions and fill every cell with t, reusing the allocated storage when it is large enough
+  inline void assign(unsigned int a, unsigned int b, const T& t)
+  {
+    h1 = a;
+    h2 = b;
+    p.assign(h1 * h2, t);
+  }
 };
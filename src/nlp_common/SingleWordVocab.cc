@@ -173,8 +173,8 @@ bool SingleWordVocab::loadGIZASrcVocab(const char* srcInputVocabFileName, int ve
       {
         if (awk.NF == 2 || awk.NF == 3)
         {
-          stringToSrcWordIndexMap[awk.dollar(2)] = atoi(awk.dollar(1).c_str());
-          srcWordIndexMapToString[atoi(awk.dollar(1).c_str())] = awk.dollar(2);
+          stringToSrcWordIndexMap[awk.dollar(2)] = awk.dollarToInt(1);
+          srcWordIndexMapToString[awk.dollarToInt(1)] = awk.dollar(2);
         }
         else
         {
@@ -329,8 +329,8 @@ bool SingleWordVocab::loadGIZATrgVocab(const char* trgInputVocabFileName, int ve
       {
         if (awk.NF == 2 || awk.NF == 3)
         {
-          stringToTrgWordIndexMap[awk.dollar(2)] = atoi(awk.dollar(1).c_str());
-          trgWordIndexMapToString[atoi(awk.dollar(1).c_str())] = awk.dollar(2);
+          stringToTrgWordIndexMap[awk.dollar(2)] = awk.dollarToInt(1);
+          trgWordIndexMapToString[awk.dollarToInt(1)] = awk.dollar(2);
         }
         else
         {
@@ -112,13 +112,13 @@ bool AlignmentExtractor::rewind(void)
 }
 
 //-------------------------
-std::vector<std::string> AlignmentExtractor::get_ns(void)
+const std::vector<std::string>& AlignmentExtractor::get_ns(void) const
 {
   return ns;
 }
 
 //-------------------------
-std::vector<std::string> AlignmentExtractor::get_s(void)
+std::vector<std::string> AlignmentExtractor::get_s(void) const
 {
   std::vector<std::string> s;
   for (unsigned int i = 1; i < ns.size(); ++i)
@@ -127,19 +127,19 @@ std::vector<std::string> AlignmentExtractor::get_s(void)
 }
 
 //-------------------------
-std::vector<std::string> AlignmentExtractor::get_t(void)
+const std::vector<std::string>& AlignmentExtractor::get_t(void) const
 {
   return t;
 }
 
 //-------------------------
-WordAlignmentMatrix AlignmentExtractor::get_wamatrix(void)
+const WordAlignmentMatrix& AlignmentExtractor::get_wamatrix(void) const
 {
   return wordAligMatrix;
 }
 
 //-------------------------
-float AlignmentExtractor::get_numReps(void)
+float AlignmentExtractor::get_numReps(void) const
 {
   return numReps;
 }
@@ -165,9 +165,7 @@ bool AlignmentExtractor::getNextAlignInGIZAFormat(void)
   // must start with the '#' symbol.
   if (awkInpStrm.getln())
   {
-    if (awkInpStrm.NF >= 1
-        && (strcmp("#", awkInpStrm.dollar(1).c_str()) == 0
-            || strcmp("<ALMOHADILLA>", awkInpStrm.dollar(1).c_str()) == 0))
+    if (awkInpStrm.NF >= 1 && (awkInpStrm.dollarEquals(1, "#") || awkInpStrm.dollarEquals(1, "<ALMOHADILLA>")))
     {
       if (awkInpStrm.NF > 2)
         numReps = 1;
@@ -176,7 +174,7 @@ bool AlignmentExtractor::getNextAlignInGIZAFormat(void)
         if (awkInpStrm.NF == 1)
           numReps = 1;
         else
-          numReps = atof(awkInpStrm.dollar(2).c_str());
+          numReps = awkInpStrm.dollarToDouble(2);
       }
 
       awkInpStrm.getln();
@@ -190,7 +188,7 @@ bool AlignmentExtractor::getNextAlignInGIZAFormat(void)
       slen = 0;
       while (i <= awkInpStrm.NF)
       {
-        if (strcmp("({", awkInpStrm.dollar(i).c_str()) == 0)
+        if (awkInpStrm.dollarEquals(i, "({"))
           ++slen;
         ++i;
       }
@@ -211,18 +209,18 @@ bool AlignmentExtractor::getNextAlignInGIZAFormat(void)
         bool opBraceFound;
 
         opBraceFound = false;
-        ew = awkInpStrm.dollar(i);
+        awkInpStrm.dollar(i, ew);
         ++i;
-        if (strcmp("({", awkInpStrm.dollar(i).c_str()) == 0)
+        if (awkInpStrm.dollarEquals(i, "({"))
           opBraceFound = true;
-        while (i <= awkInpStrm.NF && strcmp("({", awkInpStrm.dollar(i).c_str()) != 0)
+        while (i <= awkInpStrm.NF && !awkInpStrm.dollarEquals(i, "({"))
         {
           ++i;
         }
         ++i;
-        while (i <= awkInpStrm.NF && strcmp("})", awkInpStrm.dollar(i).c_str()) != 0)
+        while (i <= awkInpStrm.NF && !awkInpStrm.dollarEquals(i, "})"))
         {
-          trgPos = atoi(awkInpStrm.dollar(i).c_str());
+          trgPos = awkInpStrm.dollarToInt(i);
 
           if (trgPos - 1 >= t.size())
           {
@@ -265,9 +263,9 @@ bool AlignmentExtractor::getNextAlignInAlignOpFormat(void)
 
   if (awkInpStrm.getln())
   {
-    if (awkInpStrm.NF == 2 && strcmp("#", awkInpStrm.dollar(1).c_str()) == 0)
+    if (awkInpStrm.NF == 2 && awkInpStrm.dollarEquals(1, "#"))
     {
-      numReps = atof(awkInpStrm.dollar(2).c_str());
+      numReps = awkInpStrm.dollarToDouble(2);
       awkInpStrm.getln();
       for (i = 1; i <= awkInpStrm.NF; ++i)
       {
@@ -291,7 +289,7 @@ bool AlignmentExtractor::getNextAlignInAlignOpFormat(void)
         {
           for (col = 1; col <= t.size(); ++col)
           {
-            wordAligMatrix.setValue(row - 1, col - 1, atoi(awkInpStrm.dollar(col).c_str()) > 0);
+            wordAligMatrix.setValue(row - 1, col - 1, awkInpStrm.dollarToInt(col) > 0);
           }
         }
       }
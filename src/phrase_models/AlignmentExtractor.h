@@ -41,11 +41,11 @@ public:
   bool getNextAlignment(void);
 
   // Functions to access alignment information
-  std::vector<std::string> get_ns(void);
-  std::vector<std::string> get_s(void);
-  std::vector<std::string> get_t(void);
-  WordAlignmentMatrix get_wamatrix(void);
-  float get_numReps(void);
+  const std::vector<std::string>& get_ns(void) const;
+  std::vector<std::string> get_s(void) const;
+  const std::vector<std::string>& get_t(void) const;
+  const WordAlignmentMatrix& get_wamatrix(void) const;
+  float get_numReps(void) const;
 
   // Functions to operate alignments
   void transposeAlig(void);
@@ -52,7 +52,7 @@ public:
   typedef BasePhrasePairFilter* create_t(const char*);
   typedef const char* type_id_t(void);
 
-  virtual bool phrasePairIsOk(std::vector<std::string> s_, std::vector<std::string> t_) = 0;
+  virtual bool phrasePairIsOk(const std::vector<std::string>& s_, const std::vector<std::string>& t_) = 0;
 
   virtual ~BasePhrasePairFilter(){};
 };
@@ -37,7 +37,7 @@ CategPhrasePairFilter::CategPhrasePairFilter(void)
 }
 
 //-------------------------
-bool CategPhrasePairFilter::phrasePairIsOk(std::vector<std::string> s_, std::vector<std::string> t_)
+bool CategPhrasePairFilter::phrasePairIsOk(const std::vector<std::string>& s_, const std::vector<std::string>& t_)
 {
   // Initialize category maps
   std::map<std::string, unsigned int> srcCategMap;
@@ -45,7 +45,7 @@ class CategPhrasePairFilter : public BasePhrasePairFilter
 public:
   CategPhrasePairFilter(void);
 
-  bool phrasePairIsOk(std::vector<std::string> s_, std::vector<std::string> t_);
+  bool phrasePairIsOk(const std::vector<std::string>& s_, const std::vector<std::string>& t_);
 
   ~CategPhrasePairFilter(){};
 
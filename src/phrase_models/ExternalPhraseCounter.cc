@@ -0,0 +1,478 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ExternalPhraseCounter.cc
+ *
+ * @brief Definitions file for ExternalPhraseCounter.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "phrase_models/ExternalPhraseCounter.h"
+
+#include "nlp_common/ErrorDefs.h"
+#include "nlp_common/NbestTableNode.h"
+
+#include <algorithm>
+#include <iostream>
+
+//--------------- Function definitions
+
+namespace
+{
+//---------------
+bool writeVarUInt(FILE* file, unsigned int value)
+{
+  while (value >= 0x80)
+  {
+    if (fputc((int)((value & 0x7F) | 0x80), file) == EOF)
+      return false;
+    value >>= 7;
+  }
+  return fputc((int)value, file) != EOF;
+}
+
+//---------------
+bool readVarUInt(FILE* file, unsigned int& value)
+{
+  value = 0;
+  for (unsigned int shift = 0; shift < 35; shift += 7)
+  {
+    int byte = fgetc(file);
+    if (byte == EOF)
+      return false;
+    value |= (unsigned int)(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+//---------------
+// Keys store the length of the first phrase followed by the words of both phrases
+void buildKey(const std::vector<WordIndex>& first, const std::vector<WordIndex>& second, std::vector<WordIndex>& key)
+{
+  key.clear();
+  key.reserve(first.size() + second.size() + 1);
+  key.push_back((WordIndex)first.size());
+  key.insert(key.end(), first.begin(), first.end());
+  key.insert(key.end(), second.begin(), second.end());
+}
+
+//---------------
+void splitKey(const std::vector<WordIndex>& key, std::vector<WordIndex>& first, std::vector<WordIndex>& second)
+{
+  std::vector<WordIndex>::const_iterator middle = key.begin() + 1 + key[0];
+  first.assign(key.begin() + 1, middle);
+  second.assign(middle, key.end());
+}
+} // namespace
+
+//--------------- PhraseCountRuns class functions
+
+//---------------
+PhraseCountRuns::PhraseCountRuns(size_t _memoryBudget)
+    : memoryBudget(_memoryBudget), bufferBytes(0), writeFailed(false), mergeQueue(HeadGreater{&heads})
+{
+}
+
+//---------------
+bool PhraseCountRuns::add(const std::vector<WordIndex>& key, float c_s, float c_st)
+{
+  // Records cannot be counted once a run has been lost
+  if (writeFailed)
+    return THOT_ERROR;
+
+  Record record;
+  record.key = key;
+  record.c_s = c_s;
+  record.c_st = c_st;
+  buffer.push_back(record);
+  bufferBytes += sizeof(Record) + key.size() * sizeof(WordIndex);
+
+  if (bufferBytes >= memoryBudget)
+    return spill();
+  return THOT_OK;
+}
+
+//---------------
+bool PhraseCountRuns::spill(void)
+{
+  if (buffer.empty())
+    return THOT_OK;
+
+  FILE* runFile = tmpfile();
+  if (runFile == NULL)
+  {
+    std::cerr << "Error while creating temporary file for phrase counts" << std::endl;
+    writeFailed = true;
+    return THOT_ERROR;
+  }
+
+  std::sort(buffer.begin(), buffer.end());
+  size_t i = 0;
+  while (i < buffer.size())
+  {
+    Record combined = buffer[i];
+    for (++i; i < buffer.size() && buffer[i].key == combined.key; ++i)
+    {
+      combined.c_s += buffer[i].c_s;
+      combined.c_st += buffer[i].c_st;
+    }
+    if (!writeRecord(runFile, combined))
+      break;
+  }
+  if (fflush(runFile) != 0 || ferror(runFile))
+  {
+    std::cerr << "Error while writing phrase counts to temporary file" << std::endl;
+    fclose(runFile);
+    writeFailed = true;
+    return THOT_ERROR;
+  }
+  runs.push_back(runFile);
+
+  buffer.clear();
+  std::vector<Record>().swap(buffer);
+  bufferBytes = 0;
+  return THOT_OK;
+}
+
+//---------------
+bool PhraseCountRuns::startMerge(void)
+{
+  if (writeFailed || spill() == THOT_ERROR)
+    return THOT_ERROR;
+
+  // Merge groups of runs until the number of open runs is bounded
+  while (runs.size() > EXT_PHR_COUNTER_MAX_MERGE_FAN_IN)
+  {
+    FILE* mergedFile = tmpfile();
+    if (mergedFile == NULL)
+    {
+      std::cerr << "Error while creating temporary file for phrase counts" << std::endl;
+      writeFailed = true;
+      return THOT_ERROR;
+    }
+    initMerge(0, EXT_PHR_COUNTER_MAX_MERGE_FAN_IN);
+    Record record;
+    while (popMin(record))
+    {
+      if (!writeRecord(mergedFile, record))
+        break;
+    }
+    if (fflush(mergedFile) != 0 || ferror(mergedFile))
+    {
+      std::cerr << "Error while writing phrase counts to temporary file" << std::endl;
+      fclose(mergedFile);
+      writeFailed = true;
+      return THOT_ERROR;
+    }
+    for (size_t i = 0; i < EXT_PHR_COUNTER_MAX_MERGE_FAN_IN; ++i)
+      fclose(runs[i]);
+    runs.erase(runs.begin(), runs.begin() + EXT_PHR_COUNTER_MAX_MERGE_FAN_IN);
+    runs.push_back(mergedFile);
+  }
+
+  initMerge(0, runs.size());
+  return THOT_OK;
+}
+
+//---------------
+void PhraseCountRuns::initMerge(size_t first, size_t last)
+{
+  heads.assign(runs.size(), Record());
+  mergeQueue = std::priority_queue<unsigned int, std::vector<unsigned int>, HeadGreater>(HeadGreater{&heads});
+  for (size_t i = first; i < last; ++i)
+  {
+    rewind(runs[i]);
+    if (readRecord(runs[i], heads[i]))
+      mergeQueue.push((unsigned int)i);
+  }
+}
+
+//---------------
+bool PhraseCountRuns::popMin(Record& record)
+{
+  if (mergeQueue.empty())
+    return false;
+
+  unsigned int run = mergeQueue.top();
+  mergeQueue.pop();
+  record = heads[run];
+  if (readRecord(runs[run], heads[run]))
+    mergeQueue.push(run);
+
+  // Combine records with the same key coming from other runs
+  while (!mergeQueue.empty() && heads[mergeQueue.top()].key == record.key)
+  {
+    run = mergeQueue.top();
+    mergeQueue.pop();
+    record.c_s += heads[run].c_s;
+    record.c_st += heads[run].c_st;
+    if (readRecord(runs[run], heads[run]))
+      mergeQueue.push(run);
+  }
+  return true;
+}
+
+//---------------
+bool PhraseCountRuns::next(std::vector<WordIndex>& key, float& c_s, float& c_st)
+{
+  Record record;
+  if (!popMin(record))
+    return false;
+  key.swap(record.key);
+  c_s = record.c_s;
+  c_st = record.c_st;
+  return true;
+}
+
+//---------------
+bool PhraseCountRuns::writeRecord(FILE* file, const Record& record)
+{
+  if (!writeVarUInt(file, (unsigned int)record.key.size()))
+    return false;
+  for (size_t i = 0; i < record.key.size(); ++i)
+  {
+    if (!writeVarUInt(file, record.key[i]))
+      return false;
+  }
+  return fwrite(&record.c_s, sizeof(float), 1, file) == 1 && fwrite(&record.c_st, sizeof(float), 1, file) == 1;
+}
+
+//---------------
+bool PhraseCountRuns::readRecord(FILE* file, Record& record)
+{
+  unsigned int keySize;
+  if (!readVarUInt(file, keySize))
+    return false;
+  record.key.resize(keySize);
+  for (unsigned int i = 0; i < keySize; ++i)
+  {
+    unsigned int word;
+    if (!readVarUInt(file, word))
+      return false;
+    record.key[i] = (WordIndex)word;
+  }
+  return fread(&record.c_s, sizeof(float), 1, file) == 1 && fread(&record.c_st, sizeof(float), 1, file) == 1;
+}
+
+//---------------
+size_t PhraseCountRuns::numRuns(void) const
+{
+  return runs.size();
+}
+
+//---------------
+bool PhraseCountRuns::failed(void) const
+{
+  return writeFailed;
+}
+
+//---------------
+void PhraseCountRuns::clear(void)
+{
+  for (size_t i = 0; i < runs.size(); ++i)
+    fclose(runs[i]);
+  runs.clear();
+  buffer.clear();
+  bufferBytes = 0;
+  writeFailed = false;
+  heads.clear();
+  mergeQueue = std::priority_queue<unsigned int, std::vector<unsigned int>, HeadGreater>(HeadGreater{&heads});
+}
+
+//---------------
+PhraseCountRuns::~PhraseCountRuns()
+{
+  clear();
+}
+
+//--------------- ExternalPhraseCounter class functions
+
+//---------------
+ExternalPhraseCounter::ExternalPhraseCounter(size_t _memoryBudget)
+    : memoryBudget(_memoryBudget), srcTrgRuns(_memoryBudget)
+{
+}
+
+//---------------
+bool ExternalPhraseCounter::incrCountsOfEntry(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t,
+                                              float count)
+{
+  std::vector<WordIndex> key;
+  buildKey(s, t, key);
+  return srcTrgRuns.add(key, 0, count);
+}
+
+//---------------
+bool ExternalPhraseCounter::printPhraseTable(FILE* file, const SingleWordVocab& vocab, int n)
+{
+  // First pass: obtain joint counts ordered by source phrase, which
+  // gives the source marginals, and spill them ordered by target phrase
+  if (srcTrgRuns.startMerge() == THOT_ERROR)
+  {
+    srcTrgRuns.clear();
+    return THOT_ERROR;
+  }
+
+  PhraseCountRuns trgSrcRuns(memoryBudget);
+  std::vector<WordIndex> key, s, t, trgSrcKey;
+  std::vector<std::vector<WordIndex>> trgPhrases;
+  std::vector<float> c_stVec;
+  std::vector<WordIndex> currSrc;
+  float c_s = 0;
+  float c_st;
+  float dummy;
+  bool more = srcTrgRuns.next(key, dummy, c_st);
+  while (more)
+  {
+    splitKey(key, s, t);
+    if (s != currSrc)
+    {
+      for (size_t i = 0; i < trgPhrases.size(); ++i)
+      {
+        buildKey(trgPhrases[i], currSrc, trgSrcKey);
+        if (trgSrcRuns.add(trgSrcKey, c_s, c_stVec[i]) == THOT_ERROR)
+        {
+          srcTrgRuns.clear();
+          return THOT_ERROR;
+        }
+      }
+      trgPhrases.clear();
+      c_stVec.clear();
+      currSrc = s;
+      c_s = 0;
+    }
+    trgPhrases.push_back(t);
+    c_stVec.push_back(c_st);
+    c_s += c_st;
+    more = srcTrgRuns.next(key, dummy, c_st);
+  }
+  for (size_t i = 0; i < trgPhrases.size(); ++i)
+  {
+    buildKey(trgPhrases[i], currSrc, trgSrcKey);
+    if (trgSrcRuns.add(trgSrcKey, c_s, c_stVec[i]) == THOT_ERROR)
+    {
+      srcTrgRuns.clear();
+      return THOT_ERROR;
+    }
+  }
+  srcTrgRuns.clear();
+
+  // Second pass: print entries grouped by target phrase
+  if (trgSrcRuns.startMerge() == THOT_ERROR)
+    return THOT_ERROR;
+
+  std::vector<WordIndex> currTrg;
+  std::vector<std::vector<WordIndex>> srcPhrases;
+  std::vector<float> c_sVec;
+  c_stVec.clear();
+  while (trgSrcRuns.next(key, c_s, c_st))
+  {
+    splitKey(key, t, s);
+    if (t != currTrg)
+    {
+      printTrgGroup(file, vocab, currTrg, srcPhrases, c_sVec, c_stVec, n);
+      srcPhrases.clear();
+      c_sVec.clear();
+      c_stVec.clear();
+      currTrg = t;
+    }
+    srcPhrases.push_back(s);
+    c_sVec.push_back(c_s);
+    c_stVec.push_back(c_st);
+  }
+  printTrgGroup(file, vocab, currTrg, srcPhrases, c_sVec, c_stVec, n);
+
+  return THOT_OK;
+}
+
+//---------------
+void ExternalPhraseCounter::printTrgGroup(FILE* file, const SingleWordVocab& vocab, const std::vector<WordIndex>& t,
+                                          const std::vector<std::vector<WordIndex>>& srcPhrases,
+                                          const std::vector<float>& c_sVec, const std::vector<float>& c_stVec, int n)
+{
+  if (n < 0 || (int)srcPhrases.size() <= n)
+  {
+    for (size_t i = 0; i < srcPhrases.size(); ++i)
+      printPhraseTableEntry(file, vocab, srcPhrases[i], t, c_sVec[i], c_stVec[i]);
+  }
+  else
+  {
+    NbestTableNode<unsigned int> nbt;
+    for (size_t i = 0; i < srcPhrases.size(); ++i)
+      nbt.insert(c_stVec[i], (unsigned int)i);
+
+    int count = 0;
+    float remainder = 0;
+    NbestTableNode<unsigned int>::iterator nbtIter;
+    for (nbtIter = nbt.begin(); nbtIter != nbt.end(); ++nbtIter)
+    {
+      count++;
+      if (count <= n)
+      {
+        unsigned int i = nbtIter->second;
+        printPhraseTableEntry(file, vocab, srcPhrases[i], t, c_sVec[i], c_stVec[i]);
+      }
+      else
+      {
+        remainder += nbtIter->first;
+      }
+    }
+
+    if (remainder > 0)
+    {
+      fprintf(file, "<UNUSED_WORD> |||");
+      for (size_t j = 0; j < t.size(); ++j)
+        fprintf(file, " %s", vocab.wordIndexToTrgString(t[j]).c_str());
+      fprintf(file, " ||| 0 %.8f\n", remainder);
+    }
+  }
+}
+
+//---------------
+void ExternalPhraseCounter::printPhraseTableEntry(FILE* file, const SingleWordVocab& vocab,
+                                                  const std::vector<WordIndex>& s, const std::vector<WordIndex>& t,
+                                                  float c_s, float c_st)
+{
+  for (size_t i = 0; i < s.size(); ++i)
+    fprintf(file, "%s ", vocab.wordIndexToSrcString(s[i]).c_str());
+  fprintf(file, "|||");
+  for (size_t j = 0; j < t.size(); ++j)
+    fprintf(file, " %s", vocab.wordIndexToTrgString(t[j]).c_str());
+  fprintf(file, " ||| %.8f %.8f\n", c_s, c_st);
+}
+
+//---------------
+size_t ExternalPhraseCounter::numRuns(void) const
+{
+  return srcTrgRuns.numRuns();
+}
+
+//---------------
+bool ExternalPhraseCounter::failed(void) const
+{
+  return srcTrgRuns.failed();
+}
+
+//---------------
+void ExternalPhraseCounter::clear(void)
+{
+  srcTrgRuns.clear();
+}
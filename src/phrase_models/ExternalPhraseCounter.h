@@ -0,0 +1,157 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ExternalPhraseCounter.h
+ *
+ * @brief Defines the ExternalPhraseCounter class, which accumulates
+ * phrase pair counts in external memory.
+ */
+
+#pragma once
+
+//--------------- Include files --------------------------------------
+
+#include "nlp_common/SingleWordVocab.h"
+#include "nlp_common/WordIndex.h"
+
+#include <queue>
+#include <stdio.h>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define EXT_PHR_COUNTER_DEFAULT_MEM_BUDGET (512 * 1024 * 1024)
+#define EXT_PHR_COUNTER_MAX_MERGE_FAN_IN 64
+
+//--------------- Classes --------------------------------------------
+
+//--------------- PhraseCountRuns class
+
+/**
+ * @brief Set of sorted runs of (key, count) records stored in temporary
+ * files.
+ *
+ * Records are buffered in memory until the memory budget is exceeded.
+ * The buffer is then sorted, records with equal keys are combined and
+ * the result is spilled to disk as a run. Keys and counts are
+ * variable-length encoded to keep runs compact. Once all records have
+ * been added, the runs are k-way merged and the combined records are
+ * returned in key order.
+ */
+class PhraseCountRuns
+{
+public:
+  PhraseCountRuns(size_t memoryBudget);
+
+  // Add a new record. Returns THOT_ERROR if the records could not be
+  // spilled to disk, in which case no more records are accepted
+  bool add(const std::vector<WordIndex>& key, float c_s, float c_st);
+
+  // Spill remaining records and prepare the merge of the runs
+  bool startMerge(void);
+
+  // Obtain next record in key order, adding the counts of equal keys
+  bool next(std::vector<WordIndex>& key, float& c_s, float& c_st);
+
+  size_t numRuns(void) const;
+  // Whether a run could not be written, which loses its records
+  bool failed(void) const;
+  void clear(void);
+
+  ~PhraseCountRuns();
+
+private:
+  struct Record
+  {
+    std::vector<WordIndex> key;
+    float c_s;
+    float c_st;
+
+    bool operator<(const Record& right) const
+    {
+      return key < right.key;
+    }
+  };
+
+  struct HeadGreater
+  {
+    const std::vector<Record>* heads;
+
+    bool operator()(unsigned int left, unsigned int right) const
+    {
+      return (*heads)[right] < (*heads)[left];
+    }
+  };
+
+  size_t memoryBudget;
+  size_t bufferBytes;
+  bool writeFailed;
+  std::vector<Record> buffer;
+  std::vector<FILE*> runs;
+
+  // Merge state: current record of each run and heap of run indices
+  std::vector<Record> heads;
+  std::priority_queue<unsigned int, std::vector<unsigned int>, HeadGreater> mergeQueue;
+
+  bool spill(void);
+  void initMerge(size_t first, size_t last);
+  bool popMin(Record& record);
+  static bool writeRecord(FILE* file, const Record& record);
+  static bool readRecord(FILE* file, Record& record);
+};
+
+//--------------- ExternalPhraseCounter class
+
+/**
+ * @brief Accumulates phrase pair counts with a bounded amount of memory.
+ *
+ * Phrase pairs are spilled in sorted runs ordered by source phrase. The
+ * first merge obtains joint counts and source marginals, which are
+ * spilled again in runs ordered by target phrase. The second merge
+ * writes the phrase table directly to disk, grouped by target phrase as
+ * done by WbaIncrPhraseModel::printPhraseTable. Target marginals are
+ * obtained from the joint counts when the table is loaded.
+ */
+class ExternalPhraseCounter
+{
+public:
+  ExternalPhraseCounter(size_t memoryBudget = EXT_PHR_COUNTER_DEFAULT_MEM_BUDGET);
+
+  // Increase the count of a phrase pair. Returns THOT_ERROR if the
+  // counts could not be spilled to disk
+  bool incrCountsOfEntry(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t, float count);
+
+  // Merge the accumulated counts and print them in phrase table
+  // format, keeping at most n entries per target phrase (n<0 keeps
+  // all of them). The accumulated counts are released afterwards
+  bool printPhraseTable(FILE* file, const SingleWordVocab& vocab, int n = -1);
+
+  size_t numRuns(void) const;
+  bool failed(void) const;
+  void clear(void);
+
+private:
+  size_t memoryBudget;
+  PhraseCountRuns srcTrgRuns;
+
+  void printPhraseTableEntry(FILE* file, const SingleWordVocab& vocab, const std::vector<WordIndex>& s,
+                             const std::vector<WordIndex>& t, float c_s, float c_st);
+  void printTrgGroup(FILE* file, const SingleWordVocab& vocab, const std::vector<WordIndex>& t,
+                     const std::vector<std::vector<WordIndex>>& srcPhrases, const std::vector<float>& c_sVec,
+                     const std::vector<float>& c_stVec, int n);
+};
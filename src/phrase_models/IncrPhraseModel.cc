@@ -27,6 +27,14 @@ bool IncrPhraseModel::printPhraseTable(const char* outputFileName, int n)
     return THOT_ERROR;
   }
 
+  MmapPhraseTable* mmapPtPtr = dynamic_cast<MmapPhraseTable*>(basePhraseTablePtr);
+  if (mmapPtPtr) // C++ RTTI
+  {
+    printMmapPhraseTable(file, *mmapPtPtr, n);
+    fclose(file);
+    return THOT_OK;
+  }
+
 #ifdef THOT_USE_HAT_TRIE_PHRASE_TABLE
   HatTriePhraseTable* ptPtr = 0;
 
@@ -0,0 +1,804 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file MmapPhraseTable.cc
+ *
+ * @brief Definitions file for MmapPhraseTable.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "phrase_models/MmapPhraseTable.h"
+
+#include "nlp_common/AwkInputStream.h"
+#include "nlp_common/ErrorDefs.h"
+#include "nlp_common/MappedFile.h"
+#include "nlp_common/MathDefs.h"
+#include "nlp_common/SingleWordVocab.h"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string.h>
+
+#define MMAP_PHRASE_TABLE_BYTE_ORDER_MARK 0x01020304
+
+//--------------- Function definitions
+
+//-------------------------
+MmapPhraseTable::MmapPhraseTable(void)
+    : mappedFile(), data(NULL), header(NULL), srcVocabOffsets(NULL), srcVocabChars(NULL), trgVocabOffsets(NULL),
+      trgVocabChars(NULL), srcPhrases(), trgPhrases(), srcPairs(), trgPairs(), readOnlyErrorReported(false)
+{
+}
+
+//-------------------------
+bool MmapPhraseTable::compile(const char* phraseTableFileName, const char* outputFileName, int verbose /*=0*/)
+{
+  struct PhraseEntry
+  {
+    float count;
+    uint32_t idx;
+  };
+  typedef std::map<std::vector<WordIndex>, PhraseEntry> PhraseEntries;
+  typedef std::map<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>, float> PairEntries;
+
+  AwkInputStream awk;
+  if (awk.open(phraseTableFileName) == THOT_ERROR)
+  {
+    if (verbose)
+      std::cerr << "Error in phrase model file: " << phraseTableFileName << std::endl;
+    return THOT_ERROR;
+  }
+
+  // Read the phrase table, counts are combined in the same way as
+  // done when the table is loaded into an incremental phrase table
+  SingleWordVocab vocab;
+  PhraseEntries srcEntries;
+  PhraseEntries trgEntries;
+  PairEntries pairEntries;
+  std::vector<WordIndex> s, t;
+  unsigned int numEntry = 1;
+  while (awk.getln())
+  {
+    if (awk.FNR >= 1 && awk.NF > 1)
+    {
+      // Read source phrase
+      unsigned int i = 1;
+      s.clear();
+      while (i <= awk.NF && !awk.dollarEquals(i, "|||"))
+      {
+        s.push_back(vocab.addSrcSymbol(awk.dollar(i)));
+        ++i;
+      }
+      // Read target phrase
+      ++i;
+      t.clear();
+      while (i <= awk.NF && !awk.dollarEquals(i, "|||"))
+      {
+        t.push_back(vocab.addTrgSymbol(awk.dollar(i)));
+        ++i;
+      }
+      // Verify entry
+      if (i < awk.NF - 1 && awk.dollarEquals(i, "|||") && !s.empty() && !t.empty())
+      {
+        float count_s_ = (float)awk.dollarToDouble(i + 1);
+        float count_s_t_ = (float)awk.dollarToDouble(i + 2);
+        srcEntries[s].count = count_s_;
+        trgEntries[t].count += count_s_t_;
+        pairEntries[std::make_pair(s, t)] = count_s_t_;
+      }
+      else
+      {
+        if (verbose)
+          std::cerr << "Warning: discarding anomalous phrase table entry at line " << numEntry << std::endl;
+      }
+    }
+    ++numEntry;
+  }
+  awk.close();
+
+  // Obtain vocabularies
+  std::vector<uint64_t> srcVocabOffsets(1, 0);
+  std::string srcVocabChars;
+  for (WordIndex w = 0; w < vocab.getSrcVocabSize(); ++w)
+  {
+    srcVocabChars += vocab.wordIndexToSrcString(w);
+    srcVocabOffsets.push_back(srcVocabChars.size());
+  }
+  std::vector<uint64_t> trgVocabOffsets(1, 0);
+  std::string trgVocabChars;
+  for (WordIndex w = 0; w < vocab.getTrgVocabSize(); ++w)
+  {
+    trgVocabChars += vocab.wordIndexToTrgString(w);
+    trgVocabOffsets.push_back(trgVocabChars.size());
+  }
+
+  // Obtain sorted phrase lists, phrase indices follow the
+  // lexicographic order of the phrases
+  std::vector<uint64_t> srcPhraseOffsets(1, 0);
+  std::vector<uint32_t> srcPhraseWords;
+  std::vector<float> srcCounts;
+  for (PhraseEntries::iterator iter = srcEntries.begin(); iter != srcEntries.end(); ++iter)
+  {
+    iter->second.idx = (uint32_t)srcCounts.size();
+    srcPhraseWords.insert(srcPhraseWords.end(), iter->first.begin(), iter->first.end());
+    srcPhraseOffsets.push_back(srcPhraseWords.size());
+    srcCounts.push_back(iter->second.count);
+  }
+  std::vector<uint64_t> trgPhraseOffsets(1, 0);
+  std::vector<uint32_t> trgPhraseWords;
+  std::vector<float> trgCounts;
+  for (PhraseEntries::iterator iter = trgEntries.begin(); iter != trgEntries.end(); ++iter)
+  {
+    iter->second.idx = (uint32_t)trgCounts.size();
+    trgPhraseWords.insert(trgPhraseWords.end(), iter->first.begin(), iter->first.end());
+    trgPhraseOffsets.push_back(trgPhraseWords.size());
+    trgCounts.push_back(iter->second.count);
+  }
+
+  // Obtain phrase pairs grouped by source phrase. Pairs are visited
+  // in (source, target) order, so each group is sorted by target
+  std::vector<uint64_t> srcPairOffsets(srcCounts.size() + 1, 0);
+  std::vector<uint32_t> srcPairTrgs;
+  std::vector<float> srcPairCounts;
+  std::vector<uint64_t> trgPairOffsets(trgCounts.size() + 1, 0);
+  std::vector<uint32_t> pairSrcs;
+  for (PairEntries::const_iterator iter = pairEntries.begin(); iter != pairEntries.end(); ++iter)
+  {
+    uint32_t srcIdx = srcEntries[iter->first.first].idx;
+    uint32_t trgIdx = trgEntries[iter->first.second].idx;
+    ++srcPairOffsets[srcIdx + 1];
+    ++trgPairOffsets[trgIdx + 1];
+    pairSrcs.push_back(srcIdx);
+    srcPairTrgs.push_back(trgIdx);
+    srcPairCounts.push_back(iter->second);
+  }
+  for (size_t i = 1; i < srcPairOffsets.size(); ++i)
+    srcPairOffsets[i] += srcPairOffsets[i - 1];
+  for (size_t i = 1; i < trgPairOffsets.size(); ++i)
+    trgPairOffsets[i] += trgPairOffsets[i - 1];
+
+  // Obtain phrase pairs grouped by target phrase, each group is
+  // sorted by source since pairs are visited in source order
+  std::vector<uint32_t> trgPairSrcs(srcPairTrgs.size());
+  std::vector<float> trgPairCounts(srcPairTrgs.size());
+  std::vector<uint64_t> nextPos(trgPairOffsets.begin(), trgPairOffsets.end() - 1);
+  for (size_t pair = 0; pair < srcPairTrgs.size(); ++pair)
+  {
+    uint64_t pos = nextPos[srcPairTrgs[pair]]++;
+    trgPairSrcs[pos] = pairSrcs[pair];
+    trgPairCounts[pos] = srcPairCounts[pair];
+  }
+
+  // Write compiled table
+  FILE* file = fopen(outputFileName, "wb");
+  if (file == NULL)
+  {
+    if (verbose)
+      std::cerr << "Error while writing compiled phrase table to file " << outputFileName << std::endl;
+    return THOT_ERROR;
+  }
+
+  Header header;
+  memset(&header, 0, sizeof(Header));
+  memcpy(header.magic, MMAP_PHRASE_TABLE_MAGIC, sizeof(header.magic));
+  header.version = MMAP_PHRASE_TABLE_VERSION;
+  header.byteOrderMark = MMAP_PHRASE_TABLE_BYTE_ORDER_MARK;
+  header.numSrcWords = srcVocabOffsets.size() - 1;
+  header.numTrgWords = trgVocabOffsets.size() - 1;
+  header.numSrcPhrases = srcCounts.size();
+  header.numTrgPhrases = trgCounts.size();
+  header.numPairs = srcPairTrgs.size();
+  header.sectionOffsets[NumSections] = sizeof(Header);
+
+  bool ok = fwrite(&header, sizeof(Header), 1, file) == 1
+         && writeSection(file, header, SrcVocabOffsets, srcVocabOffsets.data(), srcVocabOffsets.size() * 8)
+         && writeSection(file, header, SrcVocabChars, srcVocabChars.data(), srcVocabChars.size())
+         && writeSection(file, header, TrgVocabOffsets, trgVocabOffsets.data(), trgVocabOffsets.size() * 8)
+         && writeSection(file, header, TrgVocabChars, trgVocabChars.data(), trgVocabChars.size())
+         && writeSection(file, header, SrcPhraseOffsets, srcPhraseOffsets.data(), srcPhraseOffsets.size() * 8)
+         && writeSection(file, header, SrcPhraseWords, srcPhraseWords.data(), srcPhraseWords.size() * 4)
+         && writeSection(file, header, SrcCounts, srcCounts.data(), srcCounts.size() * 4)
+         && writeSection(file, header, TrgPhraseOffsets, trgPhraseOffsets.data(), trgPhraseOffsets.size() * 8)
+         && writeSection(file, header, TrgPhraseWords, trgPhraseWords.data(), trgPhraseWords.size() * 4)
+         && writeSection(file, header, TrgCounts, trgCounts.data(), trgCounts.size() * 4)
+         && writeSection(file, header, SrcPairOffsets, srcPairOffsets.data(), srcPairOffsets.size() * 8)
+         && writeSection(file, header, SrcPairTrgs, srcPairTrgs.data(), srcPairTrgs.size() * 4)
+         && writeSection(file, header, SrcPairCounts, srcPairCounts.data(), srcPairCounts.size() * 4)
+         && writeSection(file, header, TrgPairOffsets, trgPairOffsets.data(), trgPairOffsets.size() * 8)
+         && writeSection(file, header, TrgPairSrcs, trgPairSrcs.data(), trgPairSrcs.size() * 4)
+         && writeSection(file, header, TrgPairCounts, trgPairCounts.data(), trgPairCounts.size() * 4);
+
+  // Rewrite the header with the final section offsets
+  ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(Header), 1, file) == 1;
+  ok = (fclose(file) == 0) && ok;
+  if (!ok)
+  {
+    if (verbose)
+      std::cerr << "Error while writing compiled phrase table to file " << outputFileName << std::endl;
+    return THOT_ERROR;
+  }
+
+  if (verbose)
+    std::cerr << "Compiled phrase table with " << header.numPairs << " phrase pairs" << std::endl;
+  return THOT_OK;
+}
+
+//-------------------------
+bool MmapPhraseTable::writeSection(FILE* file, Header& header, Section sect, const void* ptr, size_t size)
+{
+  // Sections are aligned to 8 bytes
+  static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  uint64_t& end = header.sectionOffsets[NumSections];
+  size_t padSize = (size_t)((8 - end % 8) % 8);
+  if (padSize > 0 && fwrite(padding, 1, padSize, file) != padSize)
+    return false;
+  end += padSize;
+
+  header.sectionOffsets[sect] = end;
+  if (size > 0 && fwrite(ptr, 1, size, file) != size)
+    return false;
+  end += size;
+  return true;
+}
+
+//-------------------------
+bool MmapPhraseTable::isCompiledTable(const char* fileName)
+{
+  FILE* file = fopen(fileName, "rb");
+  if (file == NULL)
+    return false;
+
+  char magic[8];
+  bool result = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+             && memcmp(magic, MMAP_PHRASE_TABLE_MAGIC, sizeof(magic)) == 0;
+  fclose(file);
+  return result;
+}
+
+//-------------------------
+bool MmapPhraseTable::load(const char* fileName, int verbose /*=0*/)
+{
+  clear();
+
+  if (verbose)
+    std::cerr << "Mapping compiled phrase table from file " << fileName << std::endl;
+
+  if (mappedFile.open(fileName) == THOT_ERROR)
+  {
+    if (verbose)
+      std::cerr << "Error while mapping compiled phrase table " << fileName << std::endl;
+    return THOT_ERROR;
+  }
+  if (mappedFile.size() < sizeof(Header))
+  {
+    unmap();
+    if (verbose)
+      std::cerr << "Error: " << fileName << " is not a compiled phrase table" << std::endl;
+    return THOT_ERROR;
+  }
+  data = mappedFile.data();
+  header = reinterpret_cast<const Header*>(data);
+
+  if (!sectionsAreValid())
+  {
+    unmap();
+    if (verbose)
+      std::cerr << "Error: " << fileName << " is not a valid compiled phrase table" << std::endl;
+    return THOT_ERROR;
+  }
+
+  srcVocabOffsets = section<uint64_t>(SrcVocabOffsets);
+  srcVocabChars = section<char>(SrcVocabChars);
+  trgVocabOffsets = section<uint64_t>(TrgVocabOffsets);
+  trgVocabChars = section<char>(TrgVocabChars);
+
+  srcPhrases.offsets = section<uint64_t>(SrcPhraseOffsets);
+  srcPhrases.words = section<uint32_t>(SrcPhraseWords);
+  srcPhrases.counts = section<float>(SrcCounts);
+  srcPhrases.size = header->numSrcPhrases;
+  trgPhrases.offsets = section<uint64_t>(TrgPhraseOffsets);
+  trgPhrases.words = section<uint32_t>(TrgPhraseWords);
+  trgPhrases.counts = section<float>(TrgCounts);
+  trgPhrases.size = header->numTrgPhrases;
+
+  srcPairs.offsets = section<uint64_t>(SrcPairOffsets);
+  srcPairs.others = section<uint32_t>(SrcPairTrgs);
+  srcPairs.counts = section<float>(SrcPairCounts);
+  trgPairs.offsets = section<uint64_t>(TrgPairOffsets);
+  trgPairs.others = section<uint32_t>(TrgPairSrcs);
+  trgPairs.counts = section<float>(TrgPairCounts);
+
+  return THOT_OK;
+}
+
+//-------------------------
+template <class T>
+const T* MmapPhraseTable::section(Section sect) const
+{
+  return reinterpret_cast<const T*>(data + header->sectionOffsets[sect]);
+}
+
+//-------------------------
+bool MmapPhraseTable::sectionsAreValid(void) const
+{
+  if (memcmp(header->magic, MMAP_PHRASE_TABLE_MAGIC, sizeof(header->magic)) != 0
+      || header->version != MMAP_PHRASE_TABLE_VERSION || header->byteOrderMark != MMAP_PHRASE_TABLE_BYTE_ORDER_MARK
+      || header->sectionOffsets[NumSections] != mappedFile.size())
+    return false;
+
+  // Sections must be aligned and lie within the file
+  for (unsigned int sect = 0; sect < NumSections; ++sect)
+  {
+    if (header->sectionOffsets[sect] % 8 != 0 || header->sectionOffsets[sect] < sizeof(Header)
+        || header->sectionOffsets[sect] > header->sectionOffsets[sect + 1])
+      return false;
+  }
+
+  // Sections must be large enough for the number of elements given in
+  // the header. Only the last offset of each group is checked, so that
+  // the data does not need to be scanned
+  uint64_t minSizes[NumSections];
+  minSizes[SrcVocabOffsets] = (header->numSrcWords + 1) * 8;
+  minSizes[TrgVocabOffsets] = (header->numTrgWords + 1) * 8;
+  minSizes[SrcPhraseOffsets] = (header->numSrcPhrases + 1) * 8;
+  minSizes[SrcCounts] = header->numSrcPhrases * 4;
+  minSizes[TrgPhraseOffsets] = (header->numTrgPhrases + 1) * 8;
+  minSizes[TrgCounts] = header->numTrgPhrases * 4;
+  minSizes[SrcPairOffsets] = (header->numSrcPhrases + 1) * 8;
+  minSizes[SrcPairTrgs] = header->numPairs * 4;
+  minSizes[SrcPairCounts] = header->numPairs * 4;
+  minSizes[TrgPairOffsets] = (header->numTrgPhrases + 1) * 8;
+  minSizes[TrgPairSrcs] = header->numPairs * 4;
+  minSizes[TrgPairCounts] = header->numPairs * 4;
+  minSizes[SrcVocabChars] = 0;
+  minSizes[TrgVocabChars] = 0;
+  minSizes[SrcPhraseWords] = 0;
+  minSizes[TrgPhraseWords] = 0;
+  for (unsigned int sect = 0; sect < NumSections; ++sect)
+  {
+    if (header->sectionOffsets[sect + 1] - header->sectionOffsets[sect] < minSizes[sect])
+      return false;
+  }
+
+  struct
+  {
+    Section offsets;
+    uint64_t num;
+    Section elems;
+    uint64_t elemSize;
+  } groups[] = {{SrcVocabOffsets, header->numSrcWords, SrcVocabChars, 1},
+                {TrgVocabOffsets, header->numTrgWords, TrgVocabChars, 1},
+                {SrcPhraseOffsets, header->numSrcPhrases, SrcPhraseWords, 4},
+                {TrgPhraseOffsets, header->numTrgPhrases, TrgPhraseWords, 4},
+                {SrcPairOffsets, header->numSrcPhrases, SrcPairTrgs, 4},
+                {TrgPairOffsets, header->numTrgPhrases, TrgPairSrcs, 4}};
+  for (unsigned int g = 0; g < sizeof(groups) / sizeof(groups[0]); ++g)
+  {
+    uint64_t last = section<uint64_t>(groups[g].offsets)[groups[g].num];
+    if (last * groups[g].elemSize > header->sectionOffsets[groups[g].elems + 1] - header->sectionOffsets[groups[g].elems])
+      return false;
+  }
+  return section<uint64_t>(SrcPairOffsets)[header->numSrcPhrases] == header->numPairs
+      && section<uint64_t>(TrgPairOffsets)[header->numTrgPhrases] == header->numPairs;
+}
+
+//-------------------------
+size_t MmapPhraseTable::getSrcVocabSize(void) const
+{
+  return header == NULL ? 0 : (size_t)header->numSrcWords;
+}
+
+//-------------------------
+std::string MmapPhraseTable::wordIndexToSrcString(WordIndex w) const
+{
+  if (w >= getSrcVocabSize())
+    return UNK_WORD_STR;
+  return std::string(srcVocabChars + srcVocabOffsets[w], srcVocabChars + srcVocabOffsets[w + 1]);
+}
+
+//-------------------------
+size_t MmapPhraseTable::getTrgVocabSize(void) const
+{
+  return header == NULL ? 0 : (size_t)header->numTrgWords;
+}
+
+//-------------------------
+std::string MmapPhraseTable::wordIndexToTrgString(WordIndex w) const
+{
+  if (w >= getTrgVocabSize())
+    return UNK_WORD_STR;
+  return std::string(trgVocabChars + trgVocabOffsets[w], trgVocabChars + trgVocabOffsets[w + 1]);
+}
+
+//-------------------------
+size_t MmapPhraseTable::getNumTrgPhrases(void) const
+{
+  return header == NULL ? 0 : (size_t)trgPhrases.size;
+}
+
+//-------------------------
+void MmapPhraseTable::getTrgPhrase(size_t idx, std::vector<WordIndex>& t) const
+{
+  trgPhrases.get(idx, t);
+}
+
+//-------------------------
+bool MmapPhraseTable::PhraseList::find(const std::vector<WordIndex>& phrase, uint32_t& idx) const
+{
+  // Binary search for the first phrase that is not less than the
+  // given one
+  uint64_t first = 0;
+  uint64_t count = size;
+  while (count > 0)
+  {
+    uint64_t step = count / 2;
+    uint64_t mid = first + step;
+    if (std::lexicographical_compare(words + offsets[mid], words + offsets[mid + 1], phrase.begin(), phrase.end()))
+    {
+      first = mid + 1;
+      count -= step + 1;
+    }
+    else
+      count = step;
+  }
+
+  if (first < size && offsets[first + 1] - offsets[first] == phrase.size()
+      && std::equal(phrase.begin(), phrase.end(), words + offsets[first]))
+  {
+    idx = (uint32_t)first;
+    return true;
+  }
+  return false;
+}
+
+//-------------------------
+void MmapPhraseTable::PhraseList::get(uint64_t idx, std::vector<WordIndex>& phrase) const
+{
+  phrase.assign(words + offsets[idx], words + offsets[idx + 1]);
+}
+
+//-------------------------
+bool MmapPhraseTable::PairList::find(uint32_t idx, uint32_t otherIdx, float& count) const
+{
+  const uint32_t* begin = others + offsets[idx];
+  const uint32_t* end = others + offsets[idx + 1];
+  const uint32_t* iter = std::lower_bound(begin, end, otherIdx);
+  if (iter != end && *iter == otherIdx)
+  {
+    count = counts[iter - others];
+    return true;
+  }
+  return false;
+}
+
+//-------------------------
+void MmapPhraseTable::reportReadOnlyError(void)
+{
+  if (!readOnlyErrorReported)
+  {
+    std::cerr << "Error: compiled phrase tables cannot be modified" << std::endl;
+    readOnlyErrorReported = true;
+  }
+}
+
+//-------------------------
+void MmapPhraseTable::addTableEntry(const std::vector<WordIndex>& /*s*/, const std::vector<WordIndex>& /*t*/,
+                                    PhrasePairInfo /*inf*/)
+{
+  reportReadOnlyError();
+}
+
+//-------------------------
+void MmapPhraseTable::addSrcInfo(const std::vector<WordIndex>& /*s*/, Count /*s_inf*/)
+{
+  reportReadOnlyError();
+}
+
+//-------------------------
+void MmapPhraseTable::addSrcTrgInfo(const std::vector<WordIndex>& /*s*/, const std::vector<WordIndex>& /*t*/,
+                                    Count /*st_inf*/)
+{
+  reportReadOnlyError();
+}
+
+//-------------------------
+void MmapPhraseTable::incrCountsOfEntry(const std::vector<WordIndex>& /*s*/, const std::vector<WordIndex>& /*t*/,
+                                        Count /*c*/)
+{
+  reportReadOnlyError();
+}
+
+//-------------------------
+PhrasePairInfo MmapPhraseTable::infSrcTrg(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t, bool& found)
+{
+  PhrasePairInfo ppi;
+
+  ppi.first = getSrcInfo(s, found);
+  if (!found)
+  {
+    ppi.second = 0;
+    return ppi;
+  }
+  else
+  {
+    ppi.second = getSrcTrgInfo(s, t, found);
+    return ppi;
+  }
+}
+
+//-------------------------
+Count MmapPhraseTable::getSrcInfo(const std::vector<WordIndex>& s, bool& found)
+{
+  uint32_t srcIdx;
+  found = data != NULL && srcPhrases.find(s, srcIdx);
+  if (!found)
+    return 0;
+  return srcPhrases.counts[srcIdx];
+}
+
+//-------------------------
+Count MmapPhraseTable::getSrcTrgInfo(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t, bool& found)
+{
+  uint32_t srcIdx, trgIdx;
+  float count;
+  found = data != NULL && srcPhrases.find(s, srcIdx) && trgPhrases.find(t, trgIdx)
+       && srcPairs.find(srcIdx, trgIdx, count);
+  if (!found)
+    return 0;
+  return count;
+}
+
+//-------------------------
+Prob MmapPhraseTable::pTrgGivenSrc(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t)
+{
+  Count st_count = cSrcTrg(s, t);
+  if ((float)st_count > 0)
+  {
+    Count s_count = cSrc(s);
+    if ((float)s_count > 0)
+      return ((float)st_count) / ((float)s_count);
+    else
+      return PHRASE_PROB_SMOOTH;
+  }
+  else
+    return PHRASE_PROB_SMOOTH;
+}
+
+//-------------------------
+LgProb MmapPhraseTable::logpTrgGivenSrc(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t)
+{
+  return log((double)pTrgGivenSrc(s, t));
+}
+
+//-------------------------
+Prob MmapPhraseTable::pSrcGivenTrg(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t)
+{
+  Count count_s_t_ = cSrcTrg(s, t);
+  if ((float)count_s_t_ > 0)
+  {
+    Count count_t_ = cTrg(t);
+    if ((float)count_t_ > 0)
+      return (float)count_s_t_ / (float)count_t_;
+    else
+      return PHRASE_PROB_SMOOTH;
+  }
+  else
+    return PHRASE_PROB_SMOOTH;
+}
+
+//-------------------------
+LgProb MmapPhraseTable::logpSrcGivenTrg(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t)
+{
+  return log((double)pSrcGivenTrg(s, t));
+}
+
+//-------------------------
+bool MmapPhraseTable::getEntriesForTarget(const std::vector<WordIndex>& t, MmapPhraseTable::SrcTableNode& srctn)
+{
+  srctn.clear(); // Make sure that structure does not keep old values
+
+  uint32_t trgIdx;
+  if (data == NULL || !trgPhrases.find(t, trgIdx))
+    return false;
+
+  std::vector<WordIndex> s;
+  for (uint64_t pair = trgPairs.offsets[trgIdx]; pair < trgPairs.offsets[trgIdx + 1]; ++pair)
+  {
+    uint32_t srcIdx = trgPairs.others[pair];
+    PhrasePairInfo ppi;
+    ppi.first = srcPhrases.counts[srcIdx]; // s count
+    ppi.second = trgPairs.counts[pair];    // (s, t) count
+
+    if (fabs(ppi.first.get_c_s()) < EPSILON || fabs(ppi.second.get_c_s()) < EPSILON)
+      continue;
+
+    srcPhrases.get(srcIdx, s);
+    srctn.insert(std::pair<std::vector<WordIndex>, PhrasePairInfo>(s, ppi));
+  }
+
+  return srctn.size();
+}
+
+//-------------------------
+bool MmapPhraseTable::getEntriesForSource(const std::vector<WordIndex>& s, MmapPhraseTable::TrgTableNode& trgtn)
+{
+  trgtn.clear(); // Make sure that structure does not keep old values
+
+  uint32_t srcIdx;
+  if (data == NULL || !srcPhrases.find(s, srcIdx))
+    return false;
+
+  std::vector<WordIndex> t;
+  for (uint64_t pair = srcPairs.offsets[srcIdx]; pair < srcPairs.offsets[srcIdx + 1]; ++pair)
+  {
+    uint32_t trgIdx = srcPairs.others[pair];
+    PhrasePairInfo ppi;
+    ppi.first = trgPhrases.counts[trgIdx]; // t count
+    ppi.second = srcPairs.counts[pair];    // (s, t) count
+
+    if (fabs(ppi.first.get_c_s()) < EPSILON || fabs(ppi.second.get_c_s()) < EPSILON)
+      continue;
+
+    trgPhrases.get(trgIdx, t);
+    trgtn.insert(std::pair<std::vector<WordIndex>, PhrasePairInfo>(t, ppi));
+  }
+
+  return trgtn.size();
+}
+
+//-------------------------
+bool MmapPhraseTable::getNbestForSrc(const std::vector<WordIndex>& s, NbestTableNode<PhraseTransTableNodeData>& nbt)
+{
+  MmapPhraseTable::TrgTableNode::iterator iter;
+
+  bool found;
+  Count s_count;
+  MmapPhraseTable::TrgTableNode node;
+  LgProb lgProb;
+
+  // Make sure that collection does not contain any old elements
+  nbt.clear();
+
+  found = getEntriesForSource(s, node);
+  s_count = cSrc(s);
+
+  if (found)
+  {
+    // Generate transTableNode
+    for (iter = node.end(); iter != node.begin();)
+    {
+      iter--;
+      float c_st = (float)iter->second.second.get_c_st();
+      lgProb = log(c_st / (float)s_count);
+      nbt.insert(lgProb, iter->first); // Insert pair <log probability, target phrase>
+    }
+
+#ifdef DO_STABLE_SORT_ON_NBEST_TABLE
+    nbt.stableSort();
+#endif
+    return true;
+  }
+  else
+  {
+    // Cannot find the source phrase
+    return false;
+  }
+}
+
+//-------------------------
+bool MmapPhraseTable::getNbestForTrg(const std::vector<WordIndex>& t, NbestTableNode<PhraseTransTableNodeData>& nbt,
+                                     int N)
+{
+  MmapPhraseTable::SrcTableNode::iterator iter;
+
+  bool found;
+  Count t_count;
+  MmapPhraseTable::SrcTableNode node;
+  LgProb lgProb;
+
+  // Make sure that collection does not contain any old elements
+  nbt.clear();
+
+  found = getEntriesForTarget(t, node);
+  t_count = cTrg(t);
+
+  if (found)
+  {
+    // Generate transTableNode
+    for (iter = node.begin(); iter != node.end(); iter++)
+    {
+      float c_st = (float)iter->second.second.get_c_st();
+      lgProb = log(c_st / (float)t_count);
+      nbt.insert(lgProb, iter->first); // Insert pair <log probability, source phrase>
+    }
+
+#ifdef DO_STABLE_SORT_ON_NBEST_TABLE
+    nbt.stableSort();
+#endif
+
+    while (nbt.size() > (unsigned int)N && N >= 0)
+    {
+      // node contains N inverse translations, remove last element
+      nbt.removeLastElement();
+    }
+
+    return true;
+  }
+  else
+  {
+    // Cannot find the target phrase
+    return false;
+  }
+}
+
+//-------------------------
+Count MmapPhraseTable::cSrcTrg(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t)
+{
+  bool found;
+  return getSrcTrgInfo(s, t, found).get_c_st();
+}
+
+//-------------------------
+Count MmapPhraseTable::cSrc(const std::vector<WordIndex>& s)
+{
+  bool found;
+  return getSrcInfo(s, found).get_c_s();
+}
+
+//-------------------------
+Count MmapPhraseTable::cTrg(const std::vector<WordIndex>& t)
+{
+  uint32_t trgIdx;
+  if (data == NULL || !trgPhrases.find(t, trgIdx))
+    return 0;
+  return trgPhrases.counts[trgIdx];
+}
+
+//-------------------------
+size_t MmapPhraseTable::size(void)
+{
+  if (header == NULL)
+    return 0;
+  return (size_t)(header->numSrcPhrases + header->numTrgPhrases + header->numPairs);
+}
+
+//-------------------------
+void MmapPhraseTable::clear(void)
+{
+  unmap();
+}
+
+//-------------------------
+void MmapPhraseTable::unmap(void)
+{
+  mappedFile.close();
+  data = NULL;
+  header = NULL;
+  srcPhrases = PhraseList();
+  trgPhrases = PhraseList();
+  srcPairs = PairList();
+  trgPairs = PairList();
+}
+
+//-------------------------
+MmapPhraseTable::~MmapPhraseTable(void)
+{
+  unmap();
+}
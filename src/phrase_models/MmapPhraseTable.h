@@ -0,0 +1,205 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file MmapPhraseTable.h
+ *
+ * @brief Implements a read-only bilingual phrase table stored in a
+ * compiled binary file that is memory-mapped when loaded.
+ */
+
+#pragma once
+
+//--------------- Include files --------------------------------------
+
+#include "nlp_common/MappedFile.h"
+#include "phrase_models/BasePhraseTable.h"
+
+#include <stdint.h>
+#include <string>
+
+//--------------- Constants ------------------------------------------
+
+#define MMAP_PHRASE_TABLE_MAGIC "THOTPTBN"
+#define MMAP_PHRASE_TABLE_VERSION 1
+
+//--------------- Classes --------------------------------------------
+
+//--------------- MmapPhraseTable class
+
+/**
+ * @brief Read-only phrase table backed by a compiled binary file.
+ *
+ * The compiled file contains the source and target vocabularies, the
+ * lexicographically sorted source and target phrases with their
+ * marginal counts, and the phrase pairs twice: grouped by source phrase
+ * and grouped by target phrase. All sections are arrays of fixed-size
+ * elements in native byte order, so the file is used in place after
+ * mapping it into memory and loading does not depend on the size of the
+ * table. Phrases and phrase pairs are located by binary search.
+ *
+ * Compiled files are generated from plain text phrase tables with
+ * compile(). Functions that modify the table are not supported.
+ */
+class MmapPhraseTable : public BasePhraseTable
+{
+public:
+  typedef BasePhraseTable::SrcTableNode SrcTableNode;
+  typedef BasePhraseTable::TrgTableNode TrgTableNode;
+
+  // Constructor
+  MmapPhraseTable(void);
+
+  // Compiles the plain text phrase table phraseTableFileName into
+  // outputFileName, returns non-zero if error
+  static bool compile(const char* phraseTableFileName, const char* outputFileName, int verbose = 0);
+  // Returns true if the given file is a compiled phrase table
+  static bool isCompiledTable(const char* fileName);
+
+  // Maps a compiled phrase table into memory, returns non-zero if error
+  bool load(const char* fileName, int verbose = 0);
+
+  // Vocabularies stored in the compiled table
+  size_t getSrcVocabSize(void) const;
+  std::string wordIndexToSrcString(WordIndex w) const;
+  size_t getTrgVocabSize(void) const;
+  std::string wordIndexToTrgString(WordIndex w) const;
+
+  // Access to target phrases in lexicographic order
+  size_t getNumTrgPhrases(void) const;
+  void getTrgPhrase(size_t idx, std::vector<WordIndex>& t) const;
+
+  // Abstract function definitions
+  virtual void addTableEntry(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t, PhrasePairInfo inf);
+  virtual void addSrcInfo(const std::vector<WordIndex>& s, Count s_inf);
+  virtual void addSrcTrgInfo(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t, Count st_inf);
+  virtual void incrCountsOfEntry(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t, Count c);
+  // The table is read-only, the previous functions report an error
+  // and leave it unchanged
+  virtual PhrasePairInfo infSrcTrg(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t, bool& found);
+  // Returns information related to a given s and t
+  virtual Count getSrcInfo(const std::vector<WordIndex>& s, bool& found);
+  // Returns information related to a given s
+  virtual Count getSrcTrgInfo(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t, bool& found);
+  // Returns information related to a given s and t
+  virtual Prob pTrgGivenSrc(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t);
+  virtual LgProb logpTrgGivenSrc(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t);
+  virtual Prob pSrcGivenTrg(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t);
+  virtual LgProb logpSrcGivenTrg(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t);
+  virtual bool getEntriesForTarget(const std::vector<WordIndex>& t, SrcTableNode& srctn);
+  // Stores in srctn the entries associated to a given target
+  // phrase t, returns true if there are one or more entries
+  virtual bool getEntriesForSource(const std::vector<WordIndex>& s, TrgTableNode& trgtn);
+  // Stores in trgtn the entries associated to a given source
+  // phrase s, returns true if there are one or more entries
+  virtual bool getNbestForSrc(const std::vector<WordIndex>& s, NbestTableNode<PhraseTransTableNodeData>& nbt);
+  virtual bool getNbestForTrg(const std::vector<WordIndex>& t, NbestTableNode<PhraseTransTableNodeData>& nbt,
+                              int N = -1);
+
+  // Counts-related functions
+  virtual Count cSrcTrg(const std::vector<WordIndex>& s, const std::vector<WordIndex>& t);
+  virtual Count cSrc(const std::vector<WordIndex>& s);
+  virtual Count cTrg(const std::vector<WordIndex>& t);
+
+  // size and clear functions
+  virtual size_t size(void);
+  virtual void clear(void);
+  // clear() unmaps the compiled file
+
+  // Destructor
+  virtual ~MmapPhraseTable();
+
+private:
+  // Sections of the compiled file
+  enum Section
+  {
+    SrcVocabOffsets,
+    SrcVocabChars,
+    TrgVocabOffsets,
+    TrgVocabChars,
+    SrcPhraseOffsets,
+    SrcPhraseWords,
+    SrcCounts,
+    TrgPhraseOffsets,
+    TrgPhraseWords,
+    TrgCounts,
+    SrcPairOffsets,
+    SrcPairTrgs,
+    SrcPairCounts,
+    TrgPairOffsets,
+    TrgPairSrcs,
+    TrgPairCounts,
+    NumSections
+  };
+
+  struct Header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint64_t numSrcWords;
+    uint64_t numTrgWords;
+    uint64_t numSrcPhrases;
+    uint64_t numTrgPhrases;
+    uint64_t numPairs;
+    // Start of each section plus the end of the file
+    uint64_t sectionOffsets[NumSections + 1];
+  };
+
+  // Read-only view of a sorted list of phrases
+  struct PhraseList
+  {
+    const uint64_t* offsets;
+    const uint32_t* words;
+    const float* counts;
+    uint64_t size;
+
+    bool find(const std::vector<WordIndex>& phrase, uint32_t& idx) const;
+    void get(uint64_t idx, std::vector<WordIndex>& phrase) const;
+  };
+
+  // Read-only view of the phrase pairs grouped by source or target
+  struct PairList
+  {
+    const uint64_t* offsets;
+    const uint32_t* others;
+    const float* counts;
+
+    bool find(uint32_t idx, uint32_t otherIdx, float& count) const;
+  };
+
+  MappedFile mappedFile;
+  const char* data;
+  const Header* header;
+  const uint64_t* srcVocabOffsets;
+  const char* srcVocabChars;
+  const uint64_t* trgVocabOffsets;
+  const char* trgVocabChars;
+  PhraseList srcPhrases;
+  PhraseList trgPhrases;
+  PairList srcPairs;
+  PairList trgPairs;
+  bool readOnlyErrorReported;
+
+  template <class T>
+  const T* section(Section sect) const;
+  bool sectionsAreValid(void) const;
+  void reportReadOnlyError(void);
+  void unmap(void);
+
+  static bool writeSection(FILE* file, Header& header, Section sect, const void* ptr, size_t size);
+};
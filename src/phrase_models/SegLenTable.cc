@@ -128,10 +128,10 @@ bool SegLenTable::load_seglentable(const char* segmLengthTableFileName, int verb
     {
       if (awk.NF == 3)
       {
-        if (atoi(awk.dollar(1).c_str()) < MAX_SENTENCE_LENGTH && atoi(awk.dollar(2).c_str()) < MAX_SENTENCE_LENGTH)
+        if (awk.dollarToInt(1) < MAX_SENTENCE_LENGTH && awk.dollarToInt(2) < MAX_SENTENCE_LENGTH)
         {
-          segmLengthCount[atoi(awk.dollar(1).c_str())][atoi(awk.dollar(2).c_str())] = atof(awk.dollar(3).c_str());
-          ksegmLengthCountMargin[atoi(awk.dollar(1).c_str())] += atof(awk.dollar(3).c_str());
+          segmLengthCount[awk.dollarToInt(1)][awk.dollarToInt(2)] = awk.dollarToDouble(3);
+          ksegmLengthCountMargin[awk.dollarToInt(1)] += awk.dollarToDouble(3);
         }
         else if (verbose)
         {
@@ -98,13 +98,13 @@ bool SrcSegmLenTable::load(const char* segmLengthTableFileName, int verbose /*=0
     clear();
     if (awk.getln())
     {
-      if (strcmp("Uniform", awk.dollar(1).c_str()) == 0)
+      if (awk.dollarEquals(1, "Uniform"))
       {
         if (verbose)
           std::cerr << "Using source segment length model based on a uniform distribution." << std::endl;
         mode = SRCSEGMLEN_UNIFORM;
       }
-      if (strcmp("Geometric", awk.dollar(1).c_str()) == 0)
+      if (awk.dollarEquals(1, "Geometric"))
       {
         if (verbose)
           std::cerr << "Using source segment length model based on a geometric distribution." << std::endl;
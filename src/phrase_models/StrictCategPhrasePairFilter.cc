@@ -37,7 +37,7 @@ StrictCategPhrasePairFilter::StrictCategPhrasePairFilter(void)
 }
 
 //-------------------------
-bool StrictCategPhrasePairFilter::phrasePairIsOk(std::vector<std::string> s_, std::vector<std::string> t_)
+bool StrictCategPhrasePairFilter::phrasePairIsOk(const std::vector<std::string>& s_, const std::vector<std::string>& t_)
 {
   // Initialize category maps
   std::map<std::string, unsigned int> srcCategMap;
@@ -47,7 +47,7 @@ class StrictCategPhrasePairFilter : public BasePhrasePairFilter
 public:
   StrictCategPhrasePairFilter(void);
 
-  bool phrasePairIsOk(std::vector<std::string> s_, std::vector<std::string> t_);
+  bool phrasePairIsOk(const std::vector<std::string>& s_, const std::vector<std::string>& t_);
 
   ~StrictCategPhrasePairFilter(){};
 
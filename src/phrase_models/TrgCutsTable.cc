@@ -64,7 +64,7 @@ bool TrgCutsTable::load(const char* trgCutsTableFileName, int verbose /*=0*/)
   {
     if (awk.getln())
     {
-      stopJumps = atof(awk.dollar(1).c_str());
+      stopJumps = awk.dollarToDouble(1);
       jumpOnePar = 1 - stopJumps;
       if (verbose)
         std::cerr << "Target sentence cuts parameters: jumpOnePar=" << jumpOnePar << " ; stopJumps=" << stopJumps
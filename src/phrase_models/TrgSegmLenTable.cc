@@ -130,13 +130,13 @@ bool TrgSegmLenTable::load(const char* segmLengthTableFileName, int verbose /*=0
     clear();
     if (awk.getln())
     {
-      if (strcmp("Uniform", awk.dollar(1).c_str()) == 0)
+      if (awk.dollarEquals(1, "Uniform"))
       {
         if (verbose)
           std::cerr << "Using target segment length model based on a uniform distribution." << std::endl;
         mode = TRGSEGMLEN_UNIFORM;
       }
-      if (strcmp("Poisson", awk.dollar(1).c_str()) == 0)
+      if (awk.dollarEquals(1, "Poisson"))
       {
         mode = TRGSEGMLEN_POISSON;
         bool ret = readAvgSegmLen(segmLengthTableFileName, verbose);
@@ -153,7 +153,7 @@ bool TrgSegmLenTable::load(const char* segmLengthTableFileName, int verbose /*=0
           std::cerr << "Using target segment length model based on a Poisson distribution." << std::endl;
         return ret;
       }
-      if (strcmp("Geometric", awk.dollar(1).c_str()) == 0)
+      if (awk.dollarEquals(1, "Geometric"))
       {
         if (verbose)
           std::cerr << "Using target segment length model based on a geometric distribution." << std::endl;
@@ -182,7 +182,7 @@ bool TrgSegmLenTable::readAvgSegmLen(const char* avgSegmLenFileName, int verbose
     awk.getln();
     if (awk.NF == 6)
     {
-      avgSrcSegmLen = atof(awk.dollar(6).c_str());
+      avgSrcSegmLen = awk.dollarToDouble(6);
     }
     else
     {
@@ -193,7 +193,7 @@ bool TrgSegmLenTable::readAvgSegmLen(const char* avgSegmLenFileName, int verbose
     awk.getln();
     if (awk.NF == 6)
     {
-      avgTrgSegmLen = atof(awk.dollar(6).c_str());
+      avgTrgSegmLen = awk.dollarToDouble(6);
     }
     else
     {
@@ -27,6 +27,21 @@ bool WbaIncrPhraseModel::printPhraseTable(const char* outputFileName, int n)
     return THOT_ERROR;
   }
 
+  if (extPhraseCounterPtr)
+  {
+    bool ret = extPhraseCounterPtr->printPhraseTable(file, singleWordVocab, n);
+    fclose(file);
+    return ret;
+  }
+
+  MmapPhraseTable* mmapPtPtr = dynamic_cast<MmapPhraseTable*>(basePhraseTablePtr);
+  if (mmapPtPtr) // C++ RTTI
+  {
+    printMmapPhraseTable(file, *mmapPtPtr, n);
+    fclose(file);
+    return THOT_OK;
+  }
+
 #ifdef THOT_USE_HAT_TRIE_PHRASE_TABLE
   HatTriePhraseTable* ptPtr = 0;
 
@@ -212,6 +212,7 @@ bool _incrPhraseModel::load_given_prefix(const char* prefix, int verbose /*=0*/)
   bool ret;
 
   // Clear previous tables
+  restoreIncrPhraseTable();
   basePhraseTablePtr->clear();
   segLenTable.clear();
 
@@ -247,6 +248,9 @@ bool _incrPhraseModel::load_given_prefix(const char* prefix, int verbose /*=0*/)
 
 bool _incrPhraseModel::load_ttable(const char* _incrPhraseModelFileName, int verbose /*=0*/)
 {
+  if (MmapPhraseTable::isCompiledTable(_incrPhraseModelFileName))
+    return loadCompiledPhraseTable(_incrPhraseModelFileName, verbose);
+
   AwkInputStream awk;
 
   if (awk.open(_incrPhraseModelFileName) == THOT_ERROR)
@@ -259,8 +263,7 @@ bool _incrPhraseModel::load_ttable(const char* _incrPhraseModelFileName, int ver
   {
     if (awk.getln())
     {
-      if (awk.NF == 4 && strcmp("****", awk.dollar(1).c_str()) == 0 && strcmp("cache", awk.dollar(2).c_str()) == 0
-          && strcmp("ttable", awk.dollar(3).c_str()) == 0)
+      if (awk.NF == 4 && awk.dollarEquals(1, "****") && awk.dollarEquals(2, "cache") && awk.dollarEquals(3, "ttable"))
       {
         if (verbose)
           std::cerr << "Error in ttable file: " << _incrPhraseModelFileName << "\n";
@@ -292,6 +295,8 @@ bool _incrPhraseModel::loadPlainTextPhraseTable(const char* phraseTTableFileName
   if (verbose)
     std::cerr << "Loading phrase ttable from file " << phraseTTableFileName << std::endl;
 
+  restoreIncrPhraseTable();
+
   if (awk.open(phraseTTableFileName) == THOT_ERROR)
   {
     if (verbose)
@@ -308,7 +313,7 @@ bool _incrPhraseModel::loadPlainTextPhraseTable(const char* phraseTTableFileName
         // Read source phrase
         i = 1;
         s.clear();
-        while (i <= awk.NF && strcmp("|||", awk.dollar(i).c_str()) != 0)
+        while (i <= awk.NF && !awk.dollarEquals(i, "|||"))
         {
           s.push_back(awk.dollar(i));
           ++i;
@@ -316,19 +321,19 @@ bool _incrPhraseModel::loadPlainTextPhraseTable(const char* phraseTTableFileName
         // Read target phrase
         ++i;
         t.clear();
-        while (i <= awk.NF && strcmp("|||", awk.dollar(i).c_str()) != 0)
+        while (i <= awk.NF && !awk.dollarEquals(i, "|||"))
         {
           t.push_back(awk.dollar(i));
           ++i;
         }
         // Verify entry
-        if (i < awk.NF - 1 && strcmp("|||", awk.dollar(i).c_str()) == 0 && !s.empty() && !t.empty())
+        if (i < awk.NF - 1 && awk.dollarEquals(i, "|||") && !s.empty() && !t.empty())
         {
           // Read count information
           ++i;
-          count_s_ = atof(awk.dollar(i).c_str());
+          count_s_ = awk.dollarToDouble(i);
           ++i;
-          count_s_t_ = atof(awk.dollar(i).c_str());
+          count_s_t_ = awk.dollarToDouble(i);
 
           // Add table entry
           phpinfo.first = count_s_;
@@ -347,6 +352,61 @@ bool _incrPhraseModel::loadPlainTextPhraseTable(const char* phraseTTableFileName
   return THOT_OK;
 }
 
+bool _incrPhraseModel::loadCompiledPhraseTable(const char* phraseTTableFileName, int verbose)
+{
+  MmapPhraseTable* mmapPhraseTablePtr = new MmapPhraseTable;
+  if (mmapPhraseTablePtr->load(phraseTTableFileName, verbose) == THOT_ERROR)
+  {
+    delete mmapPhraseTablePtr;
+    return THOT_ERROR;
+  }
+
+  // Word indices of the compiled table are used as they are, so the
+  // vocabularies are rebuilt from the ones stored in the table
+  singleWordVocab.clear();
+  for (WordIndex w = 0; w < mmapPhraseTablePtr->getSrcVocabSize(); ++w)
+  {
+    if (addSrcSymbol(mmapPhraseTablePtr->wordIndexToSrcString(w)) != w)
+    {
+      if (verbose)
+        std::cerr << "Error: inconsistent source vocabulary in " << phraseTTableFileName << std::endl;
+      delete mmapPhraseTablePtr;
+      return THOT_ERROR;
+    }
+  }
+  for (WordIndex w = 0; w < mmapPhraseTablePtr->getTrgVocabSize(); ++w)
+  {
+    if (addTrgSymbol(mmapPhraseTablePtr->wordIndexToTrgString(w)) != w)
+    {
+      if (verbose)
+        std::cerr << "Error: inconsistent target vocabulary in " << phraseTTableFileName << std::endl;
+      delete mmapPhraseTablePtr;
+      return THOT_ERROR;
+    }
+  }
+
+  if (incrPhraseTablePtr == NULL)
+  {
+    incrPhraseTablePtr = basePhraseTablePtr;
+    incrPhraseTablePtr->clear();
+  }
+  else
+    delete basePhraseTablePtr;
+  basePhraseTablePtr = mmapPhraseTablePtr;
+
+  return THOT_OK;
+}
+
+void _incrPhraseModel::restoreIncrPhraseTable(void)
+{
+  if (incrPhraseTablePtr != NULL)
+  {
+    delete basePhraseTablePtr;
+    basePhraseTablePtr = incrPhraseTablePtr;
+    incrPhraseTablePtr = NULL;
+  }
+}
+
 bool _incrPhraseModel::load_seglentable(const char* segmLengthTableFileName, int verbose /*=0*/)
 {
   return segLenTable.load_seglentable(segmLengthTableFileName, verbose);
@@ -386,6 +446,53 @@ void _incrPhraseModel::printPhraseTableEntry(FILE* file, const PhraseTransTableN
           (float)srctnIter->second.second.get_c_st());
 }
 
+void _incrPhraseModel::printMmapPhraseTable(FILE* file, const MmapPhraseTable& mmapPhraseTable, int n)
+{
+  PhraseTransTableNodeData t;
+  for (size_t idx = 0; idx < mmapPhraseTable.getNumTrgPhrases(); ++idx)
+  {
+    BasePhraseTable::SrcTableNode srctn;
+    BasePhraseTable::SrcTableNode::iterator srctnIter;
+    mmapPhraseTable.getTrgPhrase(idx, t);
+    basePhraseTablePtr->getEntriesForTarget(t, srctn);
+
+    if (n < 0 || (int)srctn.size() <= n)
+    {
+      for (srctnIter = srctn.begin(); srctnIter != srctn.end(); ++srctnIter)
+        printPhraseTableEntry(file, t, srctnIter);
+    }
+    else
+    {
+      NbestTableNode<PhraseTransTableNodeData> nbt;
+      for (srctnIter = srctn.begin(); srctnIter != srctn.end(); ++srctnIter)
+        nbt.insert(srctnIter->second.second.get_c_st(), srctnIter->first);
+
+      int count = 0;
+      float remainder = 0;
+      NbestTableNode<PhraseTransTableNodeData>::iterator nbtIter;
+      for (nbtIter = nbt.begin(); nbtIter != nbt.end(); ++nbtIter)
+      {
+        count++;
+        if (count <= n)
+        {
+          srctnIter = srctn.find(nbtIter->second);
+          printPhraseTableEntry(file, t, srctnIter);
+        }
+        else
+          remainder += nbtIter->first;
+      }
+
+      if (remainder > 0)
+      {
+        fprintf(file, "<UNUSED_WORD> |||");
+        for (size_t i = 0; i < t.size(); ++i)
+          fprintf(file, " %s", wordIndexToTrgString(t[i]).c_str());
+        fprintf(file, " ||| 0 %.8f\n", remainder);
+      }
+    }
+  }
+}
+
 bool _incrPhraseModel::printSegmLengthTable(const char* outputFileName)
 {
   std::ofstream outF;
@@ -596,6 +703,7 @@ size_t _incrPhraseModel::size(void)
 
 void _incrPhraseModel::clear(void)
 {
+  restoreIncrPhraseTable();
   singleWordVocab.clear();
   basePhraseTablePtr->clear();
   alignmentExtractor.close();
@@ -608,4 +716,6 @@ void _incrPhraseModel::clearTempVars(void)
 
 _incrPhraseModel::~_incrPhraseModel()
 {
+  // Derived classes release basePhraseTablePtr
+  delete incrPhraseTablePtr;
 }
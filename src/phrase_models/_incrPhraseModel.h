@@ -8,6 +8,7 @@
 #include "nlp_common/printAligFuncs.h"
 #include "phrase_models/AlignmentExtractor.h"
 #include "phrase_models/BaseIncrPhraseModel.h"
+#include "phrase_models/MmapPhraseTable.h"
 #include "phrase_models/SegLenTable.h"
 #include "phrase_models/SrcSegmLenTable.h"
 #include "phrase_models/TrgCutsTable.h"
@@ -85,7 +86,7 @@ public:
   bool load(const char* prefix, int verbose = 0);
   bool load_given_prefix(const char* prefix, int verbose = 0);
   virtual bool load_ttable(const char* phraseTTableFileName, int verbose = 0);
-  // Reads a (plain text or binarized) translation table, returns
+  // Reads a (plain text or compiled) translation table, returns
   // non-zero if error
   bool load_seglentable(const char* segmLengthTableFileName, int verbose = 0);
   // Load a table with segmentation length information
@@ -157,6 +158,10 @@ protected:
   BasePhraseTable* basePhraseTablePtr{};
 #endif
 
+  // Incremental phrase table that is set aside while a compiled
+  // phrase table is loaded
+  BasePhraseTable* incrPhraseTablePtr{};
+
   SegLenTable segLenTable;
 
   SrcSegmLenTable srcSegmLenTable;
@@ -168,6 +173,8 @@ protected:
   void printPhraseTableEntry(FILE* file, const PhraseTransTableNodeData& t,
                              BasePhraseTable::SrcTableNode::iterator srctnIter);
 
+  void printMmapPhraseTable(FILE* file, const MmapPhraseTable& mmapPhraseTable, int n);
+
   void printNbestTransTableNode(NbestTableNode<PhraseTransTableNodeData> tTableNode, std::ostream& outS);
   void printSegmLengthTable(std::ostream& outS);
 
@@ -175,4 +182,11 @@ protected:
   virtual bool loadPlainTextPhraseTable(const char* phraseTTableFileName, int verbose);
   // Reads a plain text phrase model file, returns non-zero if
   // error
+  bool loadCompiledPhraseTable(const char* phraseTTableFileName, int verbose);
+  // Maps a compiled phrase table into memory, replacing the
+  // vocabularies and the incremental phrase table, returns non-zero
+  // if error
+  void restoreIncrPhraseTable(void);
+  // Discards the compiled phrase table, if any, and uses the
+  // incremental phrase table again
 };
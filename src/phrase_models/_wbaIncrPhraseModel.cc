@@ -25,6 +25,17 @@ bool _wbaIncrPhraseModel::generateWbaIncrPhraseModel(const char* aligFileName, P
   return extendModel(aligFileName, phePars, BRF, verbose);
 }
 
+void _wbaIncrPhraseModel::enableExternalCounting(size_t memoryBudget)
+{
+  delete extPhraseCounterPtr;
+  extPhraseCounterPtr = new ExternalPhraseCounter(memoryBudget);
+}
+
+bool _wbaIncrPhraseModel::externalCountingEnabled(void) const
+{
+  return extPhraseCounterPtr != NULL;
+}
+
 bool _wbaIncrPhraseModel::extendModel(const char* aligFileName, PhraseExtractParameters phePars, bool BRF,
                                       int verbose /*=0*/)
 {
@@ -38,36 +49,110 @@ bool _wbaIncrPhraseModel::extendModel(const char* aligFileName, PhraseExtractPar
   extendModelFromAlignments(phePars, BRF, alignmentExtractor, verbose);
   alignmentExtractor.close();
 
+  if (extPhraseCounterPtr && extPhraseCounterPtr->failed())
+    return THOT_ERROR;
   return THOT_OK;
 }
 
 void _wbaIncrPhraseModel::extendModelFromAlignments(PhraseExtractParameters phePars, bool BRF,
                                                     AlignmentExtractor& outAlignments, int verbose /*=0*/)
 {
-  std::vector<std::string> ns, t;
-  WordAlignmentMatrix waMatrix;
-  float numReps;
-
   numSent = 0;
 
-  while (outAlignments.getNextAlignment())
+  if (BRF)
+  {
+    // BRF estimation relies on randomized segmentations, so sentence
+    // pairs are processed sequentially
+    while (outAlignments.getNextAlignment())
+    {
+      ++numSent;
+      if (verbose && (numSent % 10) == 0)
+        std::cerr << "Processing sent. pair #" << numSent << "..." << std::endl;
+      extendModelFromPairPlusAlig(phePars, BRF, outAlignments.get_ns(), outAlignments.get_t(),
+                                  outAlignments.get_wamatrix(), outAlignments.get_numReps(), verbose);
+    }
+    return;
+  }
+
+  // RF estimation is pipelined over chunks of sentence pairs: while the
+  // phrase pairs of the current chunk are extracted in parallel, one
+  // thread reads the next chunk and another one stores the phrase pairs
+  // of the previous chunk. Phrase pairs are stored in corpus order, so
+  // the resulting counts do not depend on the number of threads
+  std::vector<AligChunkEntry> chunks[3];
+  unsigned int curr = 0;
+  readAligChunk(outAlignments, chunks[curr]);
+  while (!chunks[curr].empty())
+  {
+    unsigned int next = (curr + 1) % 3;
+    unsigned int prev = (curr + 2) % 3;
+    std::vector<AligChunkEntry>& currChunk = chunks[curr];
+
+#pragma omp parallel
+    {
+#pragma omp single nowait
+      readAligChunk(outAlignments, chunks[next]);
+
+#pragma omp single nowait
+      storeAligChunk(chunks[prev], verbose);
+
+      Extractor threadPhraseExtract;
+#pragma omp for schedule(dynamic)
+      for (int i = 0; i < (int)currChunk.size(); ++i)
+      {
+        AligChunkEntry& entry = currChunk[i];
+        if (sentLengthIsOk(entry.ns, entry.t))
+          extractFiltPhrasePairs(threadPhraseExtract, phePars, entry.ns, entry.t, entry.waMatrix, entry.vecPhPair);
+      }
+    }
+    curr = next;
+  }
+  storeAligChunk(chunks[(curr + 2) % 3], verbose);
+}
+
+void _wbaIncrPhraseModel::readAligChunk(AlignmentExtractor& outAlignments, std::vector<AligChunkEntry>& chunk)
+{
+  chunk.clear();
+  while (chunk.size() < WBA_PHR_EXTRACT_CHUNK_SIZE && outAlignments.getNextAlignment())
   {
     ++numSent;
-    if (verbose && (numSent % 10) == 0 && BRF)
-      std::cerr << "Processing sent. pair #" << numSent << "..." << std::endl;
-    t = outAlignments.get_t();
-    ns = outAlignments.get_ns();
-    waMatrix = outAlignments.get_wamatrix();
-
-    numReps = outAlignments.get_numReps();
-    extendModelFromPairPlusAlig(phePars, BRF, ns, t, waMatrix, numReps, verbose);
+    chunk.push_back(AligChunkEntry());
+    AligChunkEntry& entry = chunk.back();
+    entry.sentNum = numSent;
+    entry.ns = outAlignments.get_ns();
+    entry.t = outAlignments.get_t();
+    entry.waMatrix = outAlignments.get_wamatrix();
+    entry.numReps = outAlignments.get_numReps();
+  }
+}
+
+void _wbaIncrPhraseModel::storeAligChunk(std::vector<AligChunkEntry>& chunk, int verbose /*=0*/)
+{
+  for (unsigned int i = 0; i < chunk.size(); ++i)
+  {
+    const AligChunkEntry& entry = chunk[i];
+    if (sentLengthIsOk(entry.ns, entry.t))
+    {
+      if (verbose)
+      {
+        std::cerr << "* Processing sent. pair " << entry.sentNum << " (t length: " << entry.t.size()
+                  << " , s length: " << entry.ns.size() - 1 << " , numReps: " << entry.numReps << ")";
+        std::cerr << std::endl;
+      }
+      storePhrasePairs(entry.vecPhPair, entry.numReps, verbose);
+    }
+    else if (verbose)
+    {
+      std::cerr << "  Warning: Max. sentence length exceeded for sentence pair " << entry.sentNum << std::endl;
+    }
   }
+  chunk.clear();
 }
 
 void _wbaIncrPhraseModel::extModelFromPairAligVec(PhraseExtractParameters phePars, bool BRF,
-                                                  std::vector<std::vector<std::string>> sVec,
-                                                  std::vector<std::vector<std::string>> tVec,
-                                                  std::vector<WordAlignmentMatrix> waMatrixVec, float numReps,
+                                                  const std::vector<std::vector<std::string>>& sVec,
+                                                  const std::vector<std::vector<std::string>>& tVec,
+                                                  const std::vector<WordAlignmentMatrix>& waMatrixVec, float numReps,
                                                   int verbose /*=0*/)
 {
   if (sVec.size() == tVec.size() && sVec.size() == waMatrixVec.size())
@@ -83,10 +168,12 @@ void _wbaIncrPhraseModel::extModelFromPairAligVec(PhraseExtractParameters phePar
 }
 
 void _wbaIncrPhraseModel::extendModelFromPairPlusAlig(PhraseExtractParameters phePars, bool BRF,
-                                                      std::vector<std::string> ns, std::vector<std::string> t,
-                                                      WordAlignmentMatrix waMatrix, float numReps, int verbose /*=0*/)
+                                                      const std::vector<std::string>& ns,
+                                                      const std::vector<std::string>& t,
+                                                      const WordAlignmentMatrix& waMatrix, float numReps,
+                                                      int verbose /*=0*/)
 {
-  if (t.size() < MAX_SENTENCE_LENGTH && ns.size() - 1 < MAX_SENTENCE_LENGTH)
+  if (sentLengthIsOk(ns, t))
   {
     if (verbose)
     {
@@ -97,17 +184,8 @@ void _wbaIncrPhraseModel::extendModelFromPairPlusAlig(PhraseExtractParameters ph
     if (!BRF)
     {
       // RF estimation
-      std::vector<PhrasePair> vecPhPair;
-      phraseExtract.extractConsistentPhrases(phePars, ns, t, waMatrix, vecPhPair);
-
-      // Filter phrase pairs
       std::vector<PhrasePair> vecFiltPhPair;
-      for (unsigned int i = 0; i < vecPhPair.size(); ++i)
-      {
-        if (phrasePairFilter.phrasePairIsOk(vecPhPair[i].s_, vecPhPair[i].t_))
-          vecFiltPhPair.push_back(vecPhPair[i]);
-      }
-
+      extractFiltPhrasePairs(phraseExtract, phePars, ns, t, waMatrix, vecFiltPhPair);
       storePhrasePairs(vecFiltPhPair, numReps, verbose);
     }
     else
@@ -136,11 +214,30 @@ void _wbaIncrPhraseModel::extendModelFromPairPlusAlig(PhraseExtractParameters ph
   }
 }
 
-void _wbaIncrPhraseModel::extractPhrasesFromPairPlusAlig(PhraseExtractParameters phePars, std::vector<std::string> ns,
-                                                         std::vector<std::string> t, WordAlignmentMatrix waMatrix,
+void _wbaIncrPhraseModel::extractFiltPhrasePairs(Extractor& extractor, PhraseExtractParameters phePars,
+                                                 const std::vector<std::string>& ns, const std::vector<std::string>& t,
+                                                 const WordAlignmentMatrix& waMatrix,
+                                                 std::vector<PhrasePair>& vecFiltPhPair)
+{
+  std::vector<PhrasePair> vecPhPair;
+  extractor.extractConsistentPhrases(phePars, ns, t, waMatrix, vecPhPair);
+
+  // Filter phrase pairs
+  vecFiltPhPair.clear();
+  for (unsigned int i = 0; i < vecPhPair.size(); ++i)
+  {
+    if (phrasePairFilter.phrasePairIsOk(vecPhPair[i].s_, vecPhPair[i].t_))
+      vecFiltPhPair.push_back(vecPhPair[i]);
+  }
+}
+
+void _wbaIncrPhraseModel::extractPhrasesFromPairPlusAlig(PhraseExtractParameters phePars,
+                                                         const std::vector<std::string>& ns,
+                                                         const std::vector<std::string>& t,
+                                                         const WordAlignmentMatrix& waMatrix,
                                                          std::vector<PhrasePair>& vecPhPair, int verbose /*=0*/)
 {
-  if (t.size() < MAX_SENTENCE_LENGTH && ns.size() - 1 < MAX_SENTENCE_LENGTH)
+  if (sentLengthIsOk(ns, t))
   {
     phraseExtract.extractConsistentPhrases(phePars, ns, t, waMatrix, vecPhPair);
   }
@@ -150,14 +247,17 @@ void _wbaIncrPhraseModel::extractPhrasesFromPairPlusAlig(PhraseExtractParameters
   }
 }
 
-void _wbaIncrPhraseModel::storePhrasePairs(const std::vector<PhrasePair>& vecPhPair, float numReps, int verbose /*=0*/)
+bool _wbaIncrPhraseModel::sentLengthIsOk(const std::vector<std::string>& ns, const std::vector<std::string>& t)
 {
-  std::vector<std::string> t_, s_;
+  return t.size() < MAX_SENTENCE_LENGTH && ns.size() - 1 < MAX_SENTENCE_LENGTH;
+}
 
+void _wbaIncrPhraseModel::storePhrasePairs(const std::vector<PhrasePair>& vecPhPair, float numReps, int verbose /*=0*/)
+{
   for (unsigned int x = 0; x < vecPhPair.size(); ++x)
   {
-    t_ = vecPhPair[x].t_;
-    s_ = vecPhPair[x].s_;
+    const std::vector<std::string>& t_ = vecPhPair[x].t_;
+    const std::vector<std::string>& s_ = vecPhPair[x].s_;
     if (verbose == 2)
       std::cerr << "- ";
     if (verbose == 2)
@@ -171,7 +271,18 @@ void _wbaIncrPhraseModel::storePhrasePairs(const std::vector<PhrasePair>& vecPhP
     if (verbose == 2 && s_.size() > 0)
       std::cerr << std::endl;
 
-    strIncrCountsOfEntry(s_, t_, numReps * vecPhPair[x].weight);
+    if (extPhraseCounterPtr)
+    {
+      bool ret = extPhraseCounterPtr->incrCountsOfEntry(strVectorToSrcIndexVector(s_), strVectorToTrgIndexVector(t_),
+                                                        numReps * vecPhPair[x].weight);
+      // The remaining pairs cannot be counted once the counts could not be spilled
+      if (ret == THOT_ERROR)
+        return;
+    }
+    else
+    {
+      strIncrCountsOfEntry(s_, t_, numReps * vecPhPair[x].weight);
+    }
   }
 }
 
@@ -207,6 +318,8 @@ std::ostream& _wbaIncrPhraseModel::printPars(std::ostream& outS, PhraseExtractPa
 void _wbaIncrPhraseModel::clear(void)
 {
   _incrPhraseModel::clear();
+  if (extPhraseCounterPtr)
+    extPhraseCounterPtr->clear();
   numSent = 0;
 }
 
@@ -223,4 +336,5 @@ std::vector<std::string> _wbaIncrPhraseModel::addNullWordToStrVec(const std::vec
 
 _wbaIncrPhraseModel::~_wbaIncrPhraseModel()
 {
+  delete extPhraseCounterPtr;
 }
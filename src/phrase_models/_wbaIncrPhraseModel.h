@@ -19,6 +19,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include "phrase_models/CategPhrasePairFilter.h"
+#include "phrase_models/ExternalPhraseCounter.h"
 #include "phrase_models/_incrPhraseModel.h"
 
 #ifdef USE_OCH_PHRASE_EXTRACT
@@ -27,6 +28,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "phrase_models/PhraseExtractionTable.h"
 #endif
 
+// Number of sentence pairs read from the alignment file at a time when
+// extracting phrase pairs in parallel
+#define WBA_PHR_EXTRACT_CHUNK_SIZE 10000
+
 /**
  * Defines the _wbaIncrPhraseModel class.  _wbaIncrPhraseModel is
  * a predecessor class for derivating new phrase model classes which use
@@ -43,6 +48,12 @@ public:
     numSent = 0;
   }
 
+  void enableExternalCounting(size_t memoryBudget = EXT_PHR_COUNTER_DEFAULT_MEM_BUDGET);
+  // Makes phrase pairs extracted from alignments be counted in
+  // external memory using at most memoryBudget bytes. Counts are then
+  // only available through printPhraseTable()
+  bool externalCountingEnabled(void) const;
+
   bool generateWbaIncrPhraseModel(const char* aligFileName, PhraseExtractParameters phePars, bool pseudoML,
                                   int verbose = 0);
   // Generates a WBA Phrase Model from the provided ????.A3.final
@@ -57,18 +68,19 @@ public:
   // Extends the model giving a previously initialized
   // AlignmentExtractor object.
   virtual void extModelFromPairAligVec(PhraseExtractParameters phePars, bool pseudoML,
-                                       std::vector<std::vector<std::string>> sVec,
-                                       std::vector<std::vector<std::string>> tVec,
-                                       std::vector<WordAlignmentMatrix> waMatrixVec, float numReps, int verbose = 0);
+                                       const std::vector<std::vector<std::string>>& sVec,
+                                       const std::vector<std::vector<std::string>>& tVec,
+                                       const std::vector<WordAlignmentMatrix>& waMatrixVec, float numReps,
+                                       int verbose = 0);
   // Extends the model given a vector of sentence pairs and their
   // corresponding alignment matrix.
-  virtual void extendModelFromPairPlusAlig(PhraseExtractParameters phePars, bool pseudoML, std::vector<std::string> ns,
-                                           std::vector<std::string> t, WordAlignmentMatrix waMatrix, float numReps,
-                                           int verbose = 0);
+  virtual void extendModelFromPairPlusAlig(PhraseExtractParameters phePars, bool pseudoML,
+                                           const std::vector<std::string>& ns, const std::vector<std::string>& t,
+                                           const WordAlignmentMatrix& waMatrix, float numReps, int verbose = 0);
   // Extends the model given a sentence pair and its corresponding
   // alignment matrix.
-  void extractPhrasesFromPairPlusAlig(PhraseExtractParameters phePars, std::vector<std::string> ns,
-                                      std::vector<std::string> t, WordAlignmentMatrix waMatrix,
+  void extractPhrasesFromPairPlusAlig(PhraseExtractParameters phePars, const std::vector<std::string>& ns,
+                                      const std::vector<std::string>& t, const WordAlignmentMatrix& waMatrix,
                                       std::vector<PhrasePair>& vecPhPair, int /*verbose=0*/);
   // Extracts the set of consistent phrases given a sentence pair
   // and its corresponding alignment matrix.
@@ -82,17 +94,38 @@ public:
   ~_wbaIncrPhraseModel();
 
 protected:
+  // Sentence pair read from an alignment file, together with the
+  // phrase pairs extracted from it
+  struct AligChunkEntry
+  {
+    unsigned int sentNum;
+    std::vector<std::string> ns;
+    std::vector<std::string> t;
+    WordAlignmentMatrix waMatrix;
+    float numReps;
+    std::vector<PhrasePair> vecPhPair;
+  };
+
 #ifdef USE_OCH_PHRASE_EXTRACT
-  PhraseExtractor phraseExtract;
+  typedef PhraseExtractor Extractor;
 #else
-  PhraseExtractionTable phraseExtract;
+  typedef PhraseExtractionTable Extractor;
 #endif
 
+  Extractor phraseExtract;
+
   LgProb logLikelihood;
   LgProb logLikelihoodMaxApprox;
   unsigned int numSent;
   CategPhrasePairFilter phrasePairFilter;
-
+  ExternalPhraseCounter* extPhraseCounterPtr{};
+
+  void readAligChunk(AlignmentExtractor& outAlignments, std::vector<AligChunkEntry>& chunk);
+  void extractFiltPhrasePairs(Extractor& extractor, PhraseExtractParameters phePars, const std::vector<std::string>& ns,
+                              const std::vector<std::string>& t, const WordAlignmentMatrix& waMatrix,
+                              std::vector<PhrasePair>& vecFiltPhPair);
+  void storeAligChunk(std::vector<AligChunkEntry>& chunk, int verbose = 0);
+  bool sentLengthIsOk(const std::vector<std::string>& ns, const std::vector<std::string>& t);
   bool existRowOfNulls(unsigned int j1, unsigned int j2, std::vector<unsigned int>& alig);
   void storePhrasePairs(const std::vector<PhrasePair>& vecPhPair, float numReps, int verbose = 0);
   Bitset<MAX_SENTENCE_LENGTH> zeroFertBitset(std::vector<unsigned int>& alig);
@@ -20,6 +20,7 @@
 #include "sw_models/SentenceLengthModel.h"
 #include "sw_models/SymmetrizedAligner.h"
 
+#include <algorithm>
 #include <memory>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
@@ -95,6 +96,110 @@ std::vector<WordIndex> getTrgWordIndices(Aligner& aligner, const std::vector<std
   return wordIndices;
 }
 
+const std::vector<WordIndex>& getSrcWordIndices(Aligner& aligner, const std::vector<WordIndex>& srcSentence)
+{
+  return srcSentence;
+}
+
+const std::vector<WordIndex>& getTrgWordIndices(Aligner& aligner, const std::vector<WordIndex>& trgSentence)
+{
+  return trgSentence;
+}
+
+template <class SENTENCE>
+std::vector<std::tuple<double, WordAlignmentMatrix>> getBestAlignments(Aligner& aligner,
+                                                                       const std::vector<SENTENCE>& srcSentences,
+                                                                       const std::vector<SENTENCE>& trgSentences)
+{
+  std::vector<std::tuple<double, WordAlignmentMatrix>> alignments(srcSentences.size());
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < (int)srcSentences.size(); ++i)
+  {
+    WordAlignmentMatrix waMatrix;
+    LgProb logProb = aligner.getBestAlignment(getSrcWordIndices(aligner, srcSentences[i]),
+                                              getTrgWordIndices(aligner, trgSentences[i]), waMatrix);
+    alignments[i] = std::make_tuple((double)logProb, std::move(waMatrix));
+  }
+  return alignments;
+}
+
+// Wraps a buffer into a NumPy array without copying it. The array takes
+// ownership of the buffer
+template <class T>
+py::array_t<T> toNumpyArray(std::vector<T>&& values, const std::vector<py::ssize_t>& shape)
+{
+  auto buffer = new std::vector<T>(std::move(values));
+  py::capsule owner(buffer, [](void* ptr) { delete static_cast<std::vector<T>*>(ptr); });
+  return py::array_t<T>(shape, buffer->data(), owner);
+}
+
+template <class SENTENCE>
+std::tuple<py::array_t<double>, py::array_t<unsigned int>> getBestAlignmentsCoo(
+    Aligner& aligner, const std::vector<SENTENCE>& srcSentences, const std::vector<SENTENCE>& trgSentences)
+{
+  std::vector<std::tuple<double, WordAlignmentMatrix>> alignments =
+      getBestAlignments(aligner, srcSentences, trgSentences);
+
+  std::vector<double> logProbs;
+  logProbs.reserve(alignments.size());
+  std::vector<unsigned int> indices;
+  for (unsigned int k = 0; k < alignments.size(); ++k)
+  {
+    logProbs.push_back(std::get<0>(alignments[k]));
+    const WordAlignmentMatrix& waMatrix = std::get<1>(alignments[k]);
+    for (unsigned int i = 0; i < waMatrix.get_I(); ++i)
+    {
+      for (unsigned int j = 0; j < waMatrix.get_J(); ++j)
+      {
+        if (waMatrix.getValue(i, j))
+        {
+          indices.push_back(k);
+          indices.push_back(i);
+          indices.push_back(j);
+        }
+      }
+    }
+  }
+  py::ssize_t numAlignedPairs = (py::ssize_t)indices.size() / 3;
+  py::ssize_t numSentences = (py::ssize_t)logProbs.size();
+  return std::make_tuple(toNumpyArray(std::move(logProbs), {numSentences}),
+                         toNumpyArray(std::move(indices), {numAlignedPairs, 3}));
+}
+
+template <class SENTENCE>
+std::tuple<py::array_t<double>, py::array_t<bool>> getBestAlignmentsPadded(Aligner& aligner,
+                                                                           const std::vector<SENTENCE>& srcSentences,
+                                                                           const std::vector<SENTENCE>& trgSentences)
+{
+  std::vector<std::tuple<double, WordAlignmentMatrix>> alignments =
+      getBestAlignments(aligner, srcSentences, trgSentences);
+
+  std::vector<double> logProbs;
+  logProbs.reserve(alignments.size());
+  py::ssize_t maxSrcLen = 0;
+  py::ssize_t maxTrgLen = 0;
+  for (auto& alignment : alignments)
+  {
+    logProbs.push_back(std::get<0>(alignment));
+    maxSrcLen = std::max(maxSrcLen, (py::ssize_t)std::get<1>(alignment).get_I());
+    maxTrgLen = std::max(maxTrgLen, (py::ssize_t)std::get<1>(alignment).get_J());
+  }
+
+  // std::vector<bool> is not contiguous, so the tensor is stored in a
+  // plain array owned by the NumPy array
+  py::ssize_t numSentences = (py::ssize_t)alignments.size();
+  bool* tensor = new bool[numSentences * maxSrcLen * maxTrgLen]();
+  py::capsule owner(tensor, [](void* ptr) { delete[] static_cast<bool*>(ptr); });
+  for (py::ssize_t k = 0; k < numSentences; ++k)
+  {
+    WordAlignmentMatrix& waMatrix = std::get<1>(alignments[k]);
+    for (unsigned int i = 0; i < waMatrix.get_I(); ++i)
+      std::copy(waMatrix.ptr()[i], waMatrix.ptr()[i] + waMatrix.get_J(), tensor + (k * maxSrcLen + i) * maxTrgLen);
+  }
+  return std::make_tuple(toNumpyArray(std::move(logProbs), {numSentences}),
+                         py::array_t<bool>({numSentences, maxSrcLen, maxTrgLen}, tensor, owner));
+}
+
 AlignmentModel* createAlignmentModel(AlignmentModelType type)
 {
   switch (type)
@@ -260,37 +365,18 @@ PYBIND11_MODULE(thot, m)
             return std::make_tuple((double)logProb, std::move(waMatrix));
           },
           py::arg("src_sentence"), py::arg("trg_sentence"))
-      .def(
-          "get_best_alignments",
-          [](Aligner& aligner, const std::vector<std::vector<std::string>>& srcSentences,
-             const std::vector<std::vector<std::string>>& trgSentences) {
-            std::vector<std::tuple<double, WordAlignmentMatrix>> alignments(srcSentences.size());
-#pragma omp parallel for schedule(dynamic)
-            for (int i = 0; i < (int)srcSentences.size(); ++i)
-            {
-              WordAlignmentMatrix waMatrix;
-              LgProb logProb = aligner.getBestAlignment(getSrcWordIndices(aligner, srcSentences[i]),
-                                                        getTrgWordIndices(aligner, trgSentences[i]), waMatrix);
-              alignments[i] = std::make_tuple((double)logProb, std::move(waMatrix));
-            }
-            return alignments;
-          },
-          py::arg("src_sentences"), py::arg("trg_sentences"))
-      .def(
-          "get_best_alignments",
-          [](Aligner& aligner, const std::vector<std::vector<WordIndex>>& srcSentences,
-             const std::vector<std::vector<WordIndex>>& trgSentences) {
-            std::vector<std::tuple<double, WordAlignmentMatrix>> alignments(srcSentences.size());
-#pragma omp parallel for schedule(dynamic)
-            for (int i = 0; i < (int)srcSentences.size(); ++i)
-            {
-              WordAlignmentMatrix waMatrix;
-              LgProb logProb = aligner.getBestAlignment(srcSentences[i], trgSentences[i], waMatrix);
-              alignments[i] = std::make_tuple((double)logProb, std::move(waMatrix));
-            }
-            return alignments;
-          },
-          py::arg("src_sentences"), py::arg("trg_sentences"));
+      .def("get_best_alignments", &getBestAlignments<std::vector<std::string>>, py::arg("src_sentences"),
+           py::arg("trg_sentences"))
+      .def("get_best_alignments", &getBestAlignments<std::vector<WordIndex>>, py::arg("src_sentences"),
+           py::arg("trg_sentences"))
+      .def("get_best_alignments_coo", &getBestAlignmentsCoo<std::vector<std::string>>, py::arg("src_sentences"),
+           py::arg("trg_sentences"))
+      .def("get_best_alignments_coo", &getBestAlignmentsCoo<std::vector<WordIndex>>, py::arg("src_sentences"),
+           py::arg("trg_sentences"))
+      .def("get_best_alignments_padded", &getBestAlignmentsPadded<std::vector<std::string>>, py::arg("src_sentences"),
+           py::arg("trg_sentences"))
+      .def("get_best_alignments_padded", &getBestAlignmentsPadded<std::vector<WordIndex>>, py::arg("src_sentences"),
+           py::arg("trg_sentences"));
 
   py::enum_<SymmetrizationHeuristic>(alignment, "SymmetrizationHeuristic")
       .value("NONE", SymmetrizationHeuristic::None)
@@ -321,6 +407,10 @@ PYBIND11_MODULE(thot, m)
   py::class_<AlignmentModel, Aligner, std::shared_ptr<AlignmentModel>>(alignment, "AlignmentModel")
       .def_property_readonly("model_type", &AlignmentModel::getModelType)
       .def_property("variational_bayes", &AlignmentModel::getVariationalBayes, &AlignmentModel::setVariationalBayes)
+      .def_property("max_translation_options", &AlignmentModel::getMaxTranslationOptions,
+                    &AlignmentModel::setMaxTranslationOptions)
+      .def_property("min_translation_option_dice", &AlignmentModel::getMinTranslationOptionDice,
+                    &AlignmentModel::setMinTranslationOptionDice)
       .def(
           "read_sentence_pairs",
           [](AlignmentModel& model, const char* srcFileName, const char* trgFileName, const char* sentCountsFile) {
@@ -389,14 +479,14 @@ PYBIND11_MODULE(thot, m)
           },
           py::arg("s"), py::arg("threshold") = 0)
       .def("clear", &AlignmentModel::clear)
-      .def(
-          "translation_prob",
-          [](AlignmentModel& model, WordIndex s, WordIndex t) { return (double)model.translationProb(s, t); },
-          py::arg("src_word_index"), py::arg("trg_word_index"))
-      .def(
-          "translation_log_prob",
-          [](AlignmentModel& model, WordIndex s, WordIndex t) { return (double)model.translationLogProb(s, t); },
-          py::arg("src_word_index"), py::arg("trg_word_index"))
+      .def("translation_prob", py::vectorize([](AlignmentModel& model, WordIndex s, WordIndex t) {
+             return (double)model.translationProb(s, t);
+           }),
+           py::arg("src_word_index"), py::arg("trg_word_index"))
+      .def("translation_log_prob", py::vectorize([](AlignmentModel& model, WordIndex s, WordIndex t) {
+             return (double)model.translationLogProb(s, t);
+           }),
+           py::arg("src_word_index"), py::arg("trg_word_index"))
       .def(
           "map_src_word_to_word_class",
           [](AlignmentModel& model, const std::string& word, const std::string& wordClass) {
@@ -438,18 +528,16 @@ PYBIND11_MODULE(thot, m)
       .def(py::init<Ibm1AlignmentModel&>(), py::arg("model"))
       .def_property("compact_alignment_table", &Ibm2AlignmentModel::getCompactAlignmentTable,
                     &Ibm2AlignmentModel::setCompactAlignmentTable)
-      .def(
-          "alignment_prob",
-          [](Ibm2AlignmentModel& model, PositionIndex j, PositionIndex slen, PositionIndex tlen, PositionIndex i) {
-            return (double)model.alignmentProb(j, slen, tlen, i);
-          },
-          py::arg("j"), py::arg("src_length"), py::arg("trg_length"), py::arg("i"))
-      .def(
-          "alignment_log_prob",
-          [](Ibm2AlignmentModel& model, PositionIndex j, PositionIndex slen, PositionIndex tlen, PositionIndex i) {
-            return (double)model.alignmentLogProb(j, slen, tlen, i);
-          },
-          py::arg("j"), py::arg("src_length"), py::arg("trg_length"), py::arg("i"));
+      .def_property("collect_ibm3_transfer_counts", &Ibm2AlignmentModel::getCollectIbm3TransferCounts,
+                    &Ibm2AlignmentModel::setCollectIbm3TransferCounts)
+      .def("alignment_prob",
+           py::vectorize([](Ibm2AlignmentModel& model, PositionIndex j, PositionIndex slen, PositionIndex tlen,
+                            PositionIndex i) { return (double)model.alignmentProb(j, slen, tlen, i); }),
+           py::arg("j"), py::arg("src_length"), py::arg("trg_length"), py::arg("i"))
+      .def("alignment_log_prob",
+           py::vectorize([](Ibm2AlignmentModel& model, PositionIndex j, PositionIndex slen, PositionIndex tlen,
+                            PositionIndex i) { return (double)model.alignmentLogProb(j, slen, tlen, i); }),
+           py::arg("j"), py::arg("src_length"), py::arg("trg_length"), py::arg("i"));
 
   py::class_<IncrIbm2AlignmentModel, Ibm2AlignmentModel, IncrAlignmentModel, std::shared_ptr<IncrIbm2AlignmentModel>>(
       alignment, "IncrIbm2AlignmentModel")
@@ -465,18 +553,16 @@ PYBIND11_MODULE(thot, m)
                     &HmmAlignmentModel::setLexicalSmoothFactor)
       .def_property("hmm_alignment_smoothing_factor", &HmmAlignmentModel::getHmmAlignmentSmoothFactor,
                     &HmmAlignmentModel::setHmmAlignmentSmoothFactor)
-      .def(
-          "hmm_alignment_prob",
-          [](HmmAlignmentModel& model, PositionIndex prev_i, PositionIndex slen, PositionIndex i) {
-            return (double)model.hmmAlignmentProb(prev_i, slen, i);
-          },
-          py::arg("prev_i"), py::arg("src_length"), py::arg("i"))
-      .def(
-          "hmm_alignment_log_prob",
-          [](HmmAlignmentModel& model, PositionIndex prev_i, PositionIndex slen, PositionIndex i) {
-            return (double)model.hmmAlignmentLogProb(prev_i, slen, i);
-          },
-          py::arg("prev_i"), py::arg("src_length"), py::arg("i"));
+      .def("hmm_alignment_prob",
+           py::vectorize([](HmmAlignmentModel& model, PositionIndex prev_i, PositionIndex slen, PositionIndex i) {
+             return (double)model.hmmAlignmentProb(prev_i, slen, i);
+           }),
+           py::arg("prev_i"), py::arg("src_length"), py::arg("i"))
+      .def("hmm_alignment_log_prob",
+           py::vectorize([](HmmAlignmentModel& model, PositionIndex prev_i, PositionIndex slen, PositionIndex i) {
+             return (double)model.hmmAlignmentLogProb(prev_i, slen, i);
+           }),
+           py::arg("prev_i"), py::arg("src_length"), py::arg("i"));
 
   py::class_<IncrHmmAlignmentModel, HmmAlignmentModel, IncrAlignmentModel, std::shared_ptr<IncrHmmAlignmentModel>>(
       alignment, "IncrHmmAlignmentModel")
@@ -488,18 +574,14 @@ PYBIND11_MODULE(thot, m)
       .def_property(
           "fast_align_p0", [](FastAlignModel& model) { return double{model.getFastAlignP0()}; },
           [](FastAlignModel& model, double p0) { model.setFastAlignP0(p0); })
-      .def(
-          "alignment_prob",
-          [](FastAlignModel& model, PositionIndex j, PositionIndex slen, PositionIndex tlen, PositionIndex i) {
-            return (double)model.alignmentProb(j, slen, tlen, i);
-          },
-          py::arg("j"), py::arg("src_length"), py::arg("trg_length"), py::arg("i"))
-      .def(
-          "alignment_log_prob",
-          [](FastAlignModel& model, PositionIndex j, PositionIndex slen, PositionIndex tlen, PositionIndex i) {
-            return (double)model.alignmentLogProb(j, slen, tlen, i);
-          },
-          py::arg("j"), py::arg("src_length"), py::arg("trg_length"), py::arg("i"));
+      .def("alignment_prob",
+           py::vectorize([](FastAlignModel& model, PositionIndex j, PositionIndex slen, PositionIndex tlen,
+                            PositionIndex i) { return (double)model.alignmentProb(j, slen, tlen, i); }),
+           py::arg("j"), py::arg("src_length"), py::arg("trg_length"), py::arg("i"))
+      .def("alignment_log_prob",
+           py::vectorize([](FastAlignModel& model, PositionIndex j, PositionIndex slen, PositionIndex tlen,
+                            PositionIndex i) { return (double)model.alignmentLogProb(j, slen, tlen, i); }),
+           py::arg("j"), py::arg("src_length"), py::arg("trg_length"), py::arg("i"));
 
   py::class_<Ibm3AlignmentModel, Ibm2AlignmentModel, std::shared_ptr<Ibm3AlignmentModel>>(alignment,
                                                                                           "Ibm3AlignmentModel")
@@ -650,6 +732,9 @@ PYBIND11_MODULE(thot, m)
       .def_property("w", &PhrLocalSwLiTm::get_W_par, &PhrLocalSwLiTm::set_W_par)
       .def_property("a", &PhrLocalSwLiTm::get_A_par, &PhrLocalSwLiTm::set_A_par)
       .def_property("e", &PhrLocalSwLiTm::get_E_par, &PhrLocalSwLiTm::set_E_par)
+      .def_property("cube_pruning_pop_limit", &PhrLocalSwLiTm::get_P_par, &PhrLocalSwLiTm::set_P_par)
+      .def_property("future_cost_caching", &PhrLocalSwLiTm::getFutureCostCaching,
+                    &PhrLocalSwLiTm::setFutureCostCaching)
       .def_property("heuristic", &PhrLocalSwLiTm::getHeuristic, &PhrLocalSwLiTm::setHeuristic)
       .def_property(
           "online_training_parameters", &PhrLocalSwLiTm::getOnlineTrainingPars,
@@ -860,7 +945,9 @@ PYBIND11_MODULE(thot, m)
             decoder.disableWordGraph();
 #endif
 
-            // Train generative models
+            // Train generative models (the cached heuristic scores of the
+            // decoder model are not valid after training)
+            decoder.getSmtModel()->clearFutureCostCache();
             return decoder.getParentSmtModel()->onlineTrainFeatsSentPair(sourceSentence.c_str(), targetSentence.c_str(),
                                                                          sysSent.c_str())
                 == THOT_OK;
@@ -890,6 +977,14 @@ PYBIND11_MODULE(thot, m)
             return model.printPhraseTable(fileName, n) == THOT_OK;
           },
           py::arg("filename"), py::arg("n") = -1)
+      .def("enable_external_counting", &WbaIncrPhraseModel::enableExternalCounting,
+           py::arg("memory_budget") = (size_t)EXT_PHR_COUNTER_DEFAULT_MEM_BUDGET)
+      .def_static(
+          "compile_phrase_table",
+          [](const char* fileName, const char* compiledFileName) {
+            return MmapPhraseTable::compile(fileName, compiledFileName) == THOT_OK;
+          },
+          py::arg("filename"), py::arg("compiled_filename"))
       .def("clear", &WbaIncrPhraseModel::clear);
 
   py::class_<AlignmentExtractor>(translation, "AlignmentExtractor")
@@ -5,6 +5,7 @@
 
 #include "incr_models/IncrJelMerNgramLM.h"
 #include "incr_models/WordPenaltyModel.h"
+#include "incr_models/WordPredictor.h"
 #include "phrase_models/WbaIncrPhraseModel.h"
 #include "stack_dec/BasePbTransModel.h"
 #include "stack_dec/KbMiraLlWu.h"
@@ -27,7 +28,9 @@
 #include "sw_models/IncrHmmAlignmentModel.h"
 #include "sw_models/IncrIbm1AlignmentModel.h"
 #include "sw_models/IncrIbm2AlignmentModel.h"
+#include "sw_models/SymmetrizedAligner.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 
@@ -134,6 +137,61 @@ AlignmentModel* createAlignmentModel(int type, AlignmentModel* model = nullptr)
   return nullptr;
 }
 
+// Creates a decoder with a copy of the model and the parameters of
+// the given one, so that both can translate concurrently
+multi_stack_decoder_rec<PhrLocalSwLiTm>* cloneDecoder(multi_stack_decoder_rec<PhrLocalSwLiTm>* stackDecoder)
+{
+  auto clonedDecoder = new multi_stack_decoder_rec<PhrLocalSwLiTm>;
+
+  clonedDecoder->setParentSmtModel(stackDecoder->getParentSmtModel());
+  auto smtModel = dynamic_cast<PhrLocalSwLiTm*>(stackDecoder->getSmtModel()->clone());
+  smtModel->setTranslationMetadata(new TranslationMetadata<PhrScoreInfo>);
+  clonedDecoder->setSmtModel(smtModel);
+
+  clonedDecoder->copyParameters(*stackDecoder);
+
+  return clonedDecoder;
+}
+
+TranslationData* translate(multi_stack_decoder_rec<PhrLocalSwLiTm>* stackDecoder, const char* sentence)
+{
+  auto result = new TranslationData;
+
+  // Use translator
+  PhrLocalSwLiTm::Hypothesis hyp = stackDecoder->translate(sentence);
+
+  std::vector<std::pair<PositionIndex, PositionIndex>> amatrix;
+  // Obtain phrase alignment
+  stackDecoder->getSmtModel()->aligMatrix(hyp, amatrix);
+  stackDecoder->getSmtModel()->getPhraseAlignment(amatrix, result->sourceSegmentation, result->targetSegmentCuts);
+  result->target = stackDecoder->getSmtModel()->getTransInPlainTextVec(hyp, result->targetUnknownWords);
+  result->score = stackDecoder->getSmtModel()->getScoreForHyp(hyp);
+  result->scoreComponents = stackDecoder->getSmtModel()->scoreCompsForHyp(hyp);
+
+  return result;
+}
+
+unsigned int translateNBest(multi_stack_decoder_rec<PhrLocalSwLiTm>* stackDecoder, unsigned int n,
+                            const char* sentence, void** results)
+{
+  // Enable word graph generation
+  stackDecoder->enableWordGraph();
+
+  // Use translator
+  stackDecoder->translate(sentence);
+  WordGraph* wg = stackDecoder->getWordGraphPtr();
+
+  stackDecoder->disableWordGraph();
+
+  std::vector<TranslationData> translations;
+  wg->obtainNbestList(n, translations);
+
+  for (unsigned int i = 0; i < n && i < translations.size(); ++i)
+    results[i] = new TranslationData(translations[i]);
+
+  return (unsigned int)translations.size();
+}
+
 extern "C"
 {
   void* smtModel_create(int alignmentModelType)
@@ -211,6 +269,18 @@ extern "C"
     smtModelInfo->smtModel->set_E_par(e);
   }
 
+  void smtModel_setCubePruningPopLimit(void* smtModelHandle, unsigned int popLimit)
+  {
+    auto smtModelInfo = static_cast<SmtModelInfo*>(smtModelHandle);
+    smtModelInfo->smtModel->set_P_par(popLimit);
+  }
+
+  void smtModel_setFutureCostCaching(void* smtModelHandle, bool enabled)
+  {
+    auto smtModelInfo = static_cast<SmtModelInfo*>(smtModelHandle);
+    smtModelInfo->smtModel->setFutureCostCaching(enabled);
+  }
+
   void smtModel_setHeuristic(void* smtModelHandle, unsigned int heuristic)
   {
     auto smtModelInfo = static_cast<SmtModelInfo*>(smtModelHandle);
@@ -314,43 +384,47 @@ extern "C"
   void* decoder_translate(void* decoderHandle, const char* sentence)
   {
     auto stackDecoder = static_cast<multi_stack_decoder_rec<PhrLocalSwLiTm>*>(decoderHandle);
+    return translate(stackDecoder, sentence);
+  }
 
-    auto result = new TranslationData;
-
-    // Use translator
-    PhrLocalSwLiTm::Hypothesis hyp = stackDecoder->translate(sentence);
-
-    std::vector<std::pair<PositionIndex, PositionIndex>> amatrix;
-    // Obtain phrase alignment
-    stackDecoder->getSmtModel()->aligMatrix(hyp, amatrix);
-    stackDecoder->getSmtModel()->getPhraseAlignment(amatrix, result->sourceSegmentation, result->targetSegmentCuts);
-    result->target = stackDecoder->getSmtModel()->getTransInPlainTextVec(hyp, result->targetUnknownWords);
-    result->score = stackDecoder->getSmtModel()->getScoreForHyp(hyp);
-    result->scoreComponents = stackDecoder->getSmtModel()->scoreCompsForHyp(hyp);
+  void decoder_translateBatch(void* decoderHandle, const char** sentences, unsigned int sentenceCount, void** results)
+  {
+    auto stackDecoder = static_cast<multi_stack_decoder_rec<PhrLocalSwLiTm>*>(decoderHandle);
 
-    return result;
+    // Each thread translates with its own copy of the decoder
+#pragma omp parallel
+    {
+      std::unique_ptr<multi_stack_decoder_rec<PhrLocalSwLiTm>> threadDecoder(cloneDecoder(stackDecoder));
+#pragma omp for schedule(dynamic)
+      for (int i = 0; i < (int)sentenceCount; ++i)
+        results[i] = translate(threadDecoder.get(), sentences[i]);
+    }
   }
 
   unsigned int decoder_translateNBest(void* decoderHandle, unsigned int n, const char* sentence, void** results)
   {
     auto stackDecoder = static_cast<multi_stack_decoder_rec<PhrLocalSwLiTm>*>(decoderHandle);
+    return translateNBest(stackDecoder, n, sentence, results);
+  }
 
-    // Enable word graph generation
-    stackDecoder->enableWordGraph();
-
-    // Use translator
-    stackDecoder->translate(sentence);
-    WordGraph* wg = stackDecoder->getWordGraphPtr();
-
-    stackDecoder->disableWordGraph();
-
-    std::vector<TranslationData> translations;
-    wg->obtainNbestList(n, translations);
+  unsigned int decoder_translateNBestBatch(void* decoderHandle, unsigned int n, const char** sentences,
+                                           unsigned int sentenceCount, void** results, unsigned int* resultCounts)
+  {
+    auto stackDecoder = static_cast<multi_stack_decoder_rec<PhrLocalSwLiTm>*>(decoderHandle);
 
-    for (unsigned int i = 0; i < n && i < translations.size(); ++i)
-      results[i] = new TranslationData(translations[i]);
+    // Each thread translates with its own copy of the decoder
+#pragma omp parallel
+    {
+      std::unique_ptr<multi_stack_decoder_rec<PhrLocalSwLiTm>> threadDecoder(cloneDecoder(stackDecoder));
+#pragma omp for schedule(dynamic)
+      for (int i = 0; i < (int)sentenceCount; ++i)
+        resultCounts[i] = std::min(n, translateNBest(threadDecoder.get(), n, sentences[i], results + (size_t)i * n));
+    }
 
-    return (unsigned int)translations.size();
+    unsigned int resultCount = 0;
+    for (unsigned int i = 0; i < sentenceCount; ++i)
+      resultCount += resultCounts[i];
+    return resultCount;
   }
 
   void* decoder_getWordGraph(void* decoderHandle, const char* sentence)
@@ -435,7 +509,9 @@ extern "C"
     stackDecoder->disableWordGraph();
 #endif
 
-    // Train generative models
+    // Train generative models (the cached heuristic scores of the
+    // decoder model are not valid after training)
+    stackDecoder->getSmtModel()->clearFutureCostCache();
     return stackDecoder->getParentSmtModel()->onlineTrainFeatsSentPair(sourceSentence, targetSentence, sysSent.c_str());
   }
 
@@ -530,6 +606,16 @@ extern "C"
     delete wordGraph;
   }
 
+  bool wg_convertToBinary(const char* textFileName, const char* binaryFileName)
+  {
+    return WordGraph::convertToBinary(textFileName, binaryFileName);
+  }
+
+  bool wp_convertToBinary(const char* sentsFileName, const char* binaryFileName)
+  {
+    return WordPredictor::convertToBinary(sentsFileName, binaryFileName);
+  }
+
   void* swAlignModel_create(int type, void* swAlignModelHandle)
   {
     return createAlignmentModel(type, static_cast<AlignmentModel*>(swAlignModelHandle));
@@ -859,6 +945,48 @@ extern "C"
     return prob;
   }
 
+  unsigned int swAlignModel_getBestAlignmentBatch(void* swAlignModelHandle, const char** sourceSentences,
+                                                  const char** targetSentences, unsigned int pairCount, double* probs,
+                                                  unsigned int* alignments, unsigned int* alignmentOffsets,
+                                                  unsigned int capacity)
+  {
+    auto alignmentModel = static_cast<AlignmentModel*>(swAlignModelHandle);
+
+    // The alignment of each pair takes as many positions as target words
+    std::vector<std::vector<WordIndex>> sourceWordIndices(pairCount);
+    std::vector<std::vector<WordIndex>> targetWordIndices(pairCount);
+    alignmentOffsets[0] = 0;
+    for (unsigned int i = 0; i < pairCount; ++i)
+    {
+      sourceWordIndices[i] = getWordIndices(alignmentModel, sourceSentences[i], true);
+      targetWordIndices[i] = getWordIndices(alignmentModel, targetSentences[i], false);
+      alignmentOffsets[i + 1] = alignmentOffsets[i] + (unsigned int)targetWordIndices[i].size();
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < (int)pairCount; ++i)
+    {
+      std::vector<PositionIndex> bestAlignment;
+      probs[i] = alignmentModel->getBestAlignment(sourceWordIndices[i], targetWordIndices[i], bestAlignment);
+      for (unsigned int j = 0; j < bestAlignment.size() && alignmentOffsets[i] + j < capacity; ++j)
+        alignments[alignmentOffsets[i] + j] = bestAlignment[j];
+    }
+    return alignmentOffsets[pairCount];
+  }
+
+  bool swAlignModel_getBestSymmetrizedAlignments(void* directSwAlignModelHandle, void* inverseSwAlignModelHandle,
+                                                 int heuristic, const char* sourceFileName, const char* targetFileName,
+                                                 const char* outputFileName, unsigned int chunkSize)
+  {
+    // The models are owned by the caller
+    auto noDelete = [](Aligner*) {};
+    std::shared_ptr<Aligner> directAligner(static_cast<AlignmentModel*>(directSwAlignModelHandle), noDelete);
+    std::shared_ptr<Aligner> inverseAligner(static_cast<AlignmentModel*>(inverseSwAlignModelHandle), noDelete);
+    SymmetrizedAligner aligner(directAligner, inverseAligner);
+    aligner.setHeuristic((SymmetrizationHeuristic)heuristic);
+    return aligner.getBestAlignments(sourceFileName, targetFileName, outputFileName, chunkSize) == THOT_OK;
+  }
+
   void* swAlignModel_getTranslations(void* swAlignModelHandle, const char* srcWord, double threshold)
   {
     auto swAligModelPtr = static_cast<AlignmentModel*>(swAlignModelHandle);
@@ -935,6 +1063,25 @@ extern "C"
     return result;
   }
 
+  bool phraseModel_generateExternal(const char* alignmentFileName, int maxPhraseLength, const char* tableFileName,
+                                    int n, unsigned int memoryBudgetMb)
+  {
+    _wbaIncrPhraseModel* phraseModelPtr = new WbaIncrPhraseModel;
+    phraseModelPtr->enableExternalCounting((size_t)memoryBudgetMb * 1024 * 1024);
+    PhraseExtractParameters phePars;
+    phePars.maxTrgPhraseLength = maxPhraseLength;
+    bool result = phraseModelPtr->generateWbaIncrPhraseModel(alignmentFileName, phePars, false);
+    if (result == THOT_OK)
+      result = phraseModelPtr->printPhraseTable(tableFileName, n);
+    delete phraseModelPtr;
+    return result;
+  }
+
+  bool phraseModel_compile(const char* tableFileName, const char* compiledTableFileName)
+  {
+    return MmapPhraseTable::compile(tableFileName, compiledTableFileName);
+  }
+
   void* langModel_open(const char* prefFileName)
   {
     BaseNgramLM<LM_State>* lmPtr = new IncrJelMerNgramLM;
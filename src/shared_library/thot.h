@@ -40,6 +40,10 @@ extern "C"
 
   THOT_API void smtModel_setE(void* smtModelHandle, unsigned int e);
 
+  THOT_API void smtModel_setCubePruningPopLimit(void* smtModelHandle, unsigned int popLimit);
+
+  THOT_API void smtModel_setFutureCostCaching(void* smtModelHandle, bool enabled);
+
   THOT_API void smtModel_setHeuristic(void* smtModelHandle, unsigned int heuristic);
 
   THOT_API void smtModel_setOnlineTrainingParameters(void* smtModelHandle, unsigned int algorithm,
@@ -69,6 +73,19 @@ extern "C"
   THOT_API unsigned int decoder_translateNBest(void* decoderHandle, unsigned int n, const char* sentence,
                                                void** results);
 
+  // Translates sentenceCount sentences in parallel. results must hold sentenceCount entries, and each one receives a
+  // handle that is released with tdata_destroy
+  THOT_API void decoder_translateBatch(void* decoderHandle, const char** sentences, unsigned int sentenceCount,
+                                       void** results);
+
+  // Obtains the n best translations of sentenceCount sentences in parallel. results must hold n * sentenceCount
+  // entries, and the translations of the i-th sentence are stored from results[i * n]. resultCounts must hold
+  // sentenceCount entries and receives the number of translations of each sentence, which is at most n. Returns the
+  // total number of translations. Each result is released with tdata_destroy
+  THOT_API unsigned int decoder_translateNBestBatch(void* decoderHandle, unsigned int n, const char** sentences,
+                                                    unsigned int sentenceCount, void** results,
+                                                    unsigned int* resultCounts);
+
   THOT_API void* decoder_getWordGraph(void* decoderHandle, const char* sentence);
 
   THOT_API void* decoder_getBestPhraseAlignment(void* decoderHandle, const char* sentence, const char* translation);
@@ -102,6 +119,10 @@ extern "C"
 
   THOT_API void wg_destroy(void* wgHandle);
 
+  THOT_API bool wg_convertToBinary(const char* textFileName, const char* binaryFileName);
+
+  THOT_API bool wp_convertToBinary(const char* sentsFileName, const char* binaryFileName);
+
   THOT_API void* swAlignModel_create(int type, void* swAlignModelHandle);
 
   THOT_API void* swAlignModel_open(int type, const char* prefFileName);
@@ -195,6 +216,22 @@ extern "C"
                                                 const char* targetSentence, bool** matrix, unsigned int* iLen,
                                                 unsigned int* jLen);
 
+  // Obtains the best alignments of pairCount sentence pairs in parallel. probs must hold pairCount entries and receives
+  // the log probability of each alignment. alignmentOffsets must hold pairCount + 1 entries: the alignment of the i-th
+  // pair is stored in alignments from alignmentOffsets[i] to alignmentOffsets[i + 1], with the source position aligned
+  // to each target word (0 for the NULL word, 1 for the first source word). Returns the number of entries required by
+  // alignments. If it is greater than capacity, only the first capacity entries are stored, while probs and
+  // alignmentOffsets are complete
+  THOT_API unsigned int swAlignModel_getBestAlignmentBatch(void* swAlignModelHandle, const char** sourceSentences,
+                                                           const char** targetSentences, unsigned int pairCount,
+                                                           double* probs, unsigned int* alignments,
+                                                           unsigned int* alignmentOffsets, unsigned int capacity);
+
+  THOT_API bool swAlignModel_getBestSymmetrizedAlignments(void* directSwAlignModelHandle,
+                                                          void* inverseSwAlignModelHandle, int heuristic,
+                                                          const char* sourceFileName, const char* targetFileName,
+                                                          const char* outputFileName, unsigned int chunkSize);
+
   THOT_API void* swAlignModel_getTranslations(void* swAlignModelHandle, const char* srcWord, double threshold);
 
   THOT_API void* swAlignModel_getTranslationsByIndex(void* swAlignModelHandle, unsigned int srcWordIndex,
@@ -215,6 +252,11 @@ extern "C"
   THOT_API bool phraseModel_generate(const char* alignmentFileName, int maxPhraseLength, const char* tableFileName,
                                      int n);
 
+  THOT_API bool phraseModel_generateExternal(const char* alignmentFileName, int maxPhraseLength,
+                                             const char* tableFileName, int n, unsigned int memoryBudgetMb);
+
+  THOT_API bool phraseModel_compile(const char* tableFileName, const char* compiledTableFileName);
+
   THOT_API void* langModel_open(const char* prefFileName);
 
   THOT_API double langModel_getSentenceProbability(void* lmHandle, const char* sentence);
@@ -0,0 +1,56 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file BaseMiraScorer.cc
+ *
+ * @brief Definitions file for BaseMiraScorer.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "stack_dec/BaseMiraScorer.h"
+
+//--------------- BaseMiraScorer class functions
+
+//---------------------------------------
+void BaseMiraScorer::sentBackgroundScores(const std::vector<std::string>& nblist, const std::string& reference,
+                                          std::vector<double>& scores, std::vector<std::vector<unsigned int>>& stats)
+{
+  scores.assign(nblist.size(), 0);
+  stats.assign(nblist.size(), std::vector<unsigned int>());
+
+#pragma omp parallel for schedule(dynamic)
+  for (int n = 0; n < (int)nblist.size(); ++n)
+    sentBackgroundScore(nblist[n], reference, scores[n], stats[n]);
+}
+
+//---------------------------------------
+void BaseMiraScorer::nbestSentScores(const std::vector<std::vector<std::string>>& nblists,
+                                     const std::vector<std::string>& references,
+                                     std::vector<std::vector<double>>& scores)
+{
+  scores.assign(nblists.size(), std::vector<double>());
+
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < (int)nblists.size(); ++i)
+  {
+    scores[i].resize(nblists[i].size());
+    for (unsigned int n = 0; n < nblists[i].size(); ++n)
+      sentScore(nblists[i][n], references[i], scores[i][n]);
+  }
+}
@@ -56,6 +56,14 @@ public:
   // Score for sentence
   virtual void sentScore(const std::string& candidate, const std::string& reference, double& score) = 0;
 
+  // Scores with background corpus stats for all the candidates of an n-best list (computed in parallel)
+  virtual void sentBackgroundScores(const std::vector<std::string>& nblist, const std::string& reference,
+                                    std::vector<double>& scores, std::vector<std::vector<unsigned int>>& stats);
+
+  // Sentence scores for a matrix of n-best lists, one list per reference (computed in parallel)
+  virtual void nbestSentScores(const std::vector<std::vector<std::string>>& nblists,
+                               const std::vector<std::string>& references, std::vector<std::vector<double>>& scores);
+
   // Destructor
   virtual ~BaseMiraScorer(){};
 };
@@ -77,6 +77,8 @@ public:
   unsigned int get_E_par() const;
   void set_U_par(unsigned int U_par);
   unsigned int get_U_par() const;
+  void set_P_par(unsigned int P_par);
+  unsigned int get_P_par() const;
   bool monotoneSearch() const;
   // Returns true if the search is monotone
 
@@ -270,6 +272,18 @@ unsigned int BasePbTransModel<HYPOTHESIS>::get_U_par() const
   return pbTransModelPars.U;
 }
 
+template <class HYPOTHESIS>
+void BasePbTransModel<HYPOTHESIS>::set_P_par(unsigned int P_par)
+{
+  pbTransModelPars.P = P_par;
+}
+
+template <class HYPOTHESIS>
+unsigned int BasePbTransModel<HYPOTHESIS>::get_P_par() const
+{
+  return pbTransModelPars.P;
+}
+
 template <class HYPOTHESIS>
 bool BasePbTransModel<HYPOTHESIS>::monotoneSearch() const
 {
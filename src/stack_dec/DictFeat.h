@@ -138,7 +138,7 @@ int DictFeat<SCORE_INFO>::extractEntryInfo(AwkInputStream& awk, std::vector<std:
   srcPhr.clear();
   for (i = 1; i <= awk.NF; ++i)
   {
-    if (awk.dollar(i) == "|||")
+    if (awk.dollarEquals(i, "|||"))
       break;
     else
       srcPhr.push_back(awk.dollar(i));
@@ -151,7 +151,7 @@ int DictFeat<SCORE_INFO>::extractEntryInfo(AwkInputStream& awk, std::vector<std:
   i += 1;
   for (; i <= awk.NF; ++i)
   {
-    if (awk.dollar(i) == "|||")
+    if (awk.dollarEquals(i, "|||"))
       break;
     else
       trgPhr.push_back(awk.dollar(i));
@@ -160,7 +160,7 @@ int DictFeat<SCORE_INFO>::extractEntryInfo(AwkInputStream& awk, std::vector<std:
     return THOT_ERROR;
 
   // Obtain score
-  scr = atof(awk.dollar(awk.NF).c_str());
+  scr = awk.dollarToDouble(awk.NF);
 
   return THOT_OK;
 }
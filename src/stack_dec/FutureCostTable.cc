@@ -0,0 +1,81 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file FutureCostTable.cc
+ *
+ * @brief Definitions file for FutureCostTable.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "stack_dec/FutureCostTable.h"
+
+#include <algorithm>
+#include <float.h>
+
+//--------------- FutureCostTable class function definitions
+
+//---------------------------------------
+FutureCostTable::FutureCostTable(void) : J(0)
+{
+}
+
+//---------------------------------------
+void FutureCostTable::init(unsigned int sentenceLength)
+{
+  J = sentenceLength;
+  scores.assign((size_t)J * (J + 1) / 2, -FLT_MAX);
+}
+
+//---------------------------------------
+unsigned int FutureCostTable::getSentenceLength(void) const
+{
+  return J;
+}
+
+//---------------------------------------
+void FutureCostTable::compose(void)
+{
+  // Spans are processed by increasing length, so that the scores of
+  // the shorter spans are final when they are composed
+  for (unsigned int length = 2; length <= J; ++length)
+  {
+    Score* row = &scores[rowOffset(length)];
+    unsigned int numSpans = J - length + 1;
+    for (unsigned int lhsLength = 1; lhsLength < length; ++lhsLength)
+    {
+      const Score* lhsRow = &scores[rowOffset(lhsLength)];
+      const Score* rhsRow = &scores[rowOffset(length - lhsLength)] + lhsLength;
+      for (unsigned int left = 0; left < numSpans; ++left)
+        row[left] = std::max(row[left], lhsRow[left] + rhsRow[left]);
+    }
+  }
+}
+
+//---------------------------------------
+bool FutureCostTable::empty(void) const
+{
+  return J == 0;
+}
+
+//---------------------------------------
+void FutureCostTable::clear(void)
+{
+  J = 0;
+  scores.clear();
+}
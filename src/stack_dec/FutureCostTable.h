@@ -0,0 +1,82 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file FutureCostTable.h
+ *
+ * @brief Defines the FutureCostTable class, which stores the future
+ * cost estimations of the spans of a source sentence.
+ */
+
+#pragma once
+
+//--------------- Include files --------------------------------------
+
+#include "nlp_common/Score.h"
+
+#include <stddef.h>
+#include <vector>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- FutureCostTable class
+
+/**
+ * @brief Triangular table of scores for the spans of a sentence.
+ *
+ * The scores are stored in a flat array with one row per span length,
+ * where the spans of the same length are ordered by their first
+ * position. This way, the composition of the scores of adjacent spans
+ * runs over contiguous memory and can be vectorized by the compiler.
+ */
+class FutureCostTable
+{
+public:
+  FutureCostTable(void);
+
+  // Initializes the table for a sentence of the given length, the
+  // scores of all spans are set to -FLT_MAX
+  void init(unsigned int sentenceLength);
+  unsigned int getSentenceLength(void) const;
+
+  // Functions to access the score of the span [left,right], the
+  // positions start at zero
+  Score get(unsigned int left, unsigned int right) const
+  {
+    return scores[rowOffset(right - left + 1) + left];
+  }
+  void set(unsigned int left, unsigned int right, Score score)
+  {
+    scores[rowOffset(right - left + 1) + left] = score;
+  }
+
+  // Replaces the score of each span by the best composition of the
+  // scores of two adjacent spans covering it, if greater
+  void compose(void);
+
+  bool empty(void) const;
+  void clear(void);
+
+private:
+  unsigned int J;
+  std::vector<Score> scores;
+
+  size_t rowOffset(unsigned int length) const
+  {
+    return (size_t)(length - 1) * J - (size_t)(length - 1) * (length - 2) / 2;
+  }
+};
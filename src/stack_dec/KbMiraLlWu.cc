@@ -275,14 +275,17 @@ void KbMiraLlWu::HopeFear(const std::string& reference, const std::vector<std::s
 
   // std::cerr << "R: " << reference << std::endl;
 
+  std::vector<double> qualities;
+  std::vector<std::vector<unsigned int>> qStatsVec;
+  scorer->sentBackgroundScores(nBest, reference, qualities, qStatsVec);
+
   for (unsigned int n = 0; n < nBest.size(); n++)
   {
     double score = 0;
     for (unsigned int k = 0; k < wv.size(); k++)
       score += wv[k] * nScores[n][k];
-    double quality;
-    std::vector<unsigned int> qStats;
-    scorer->sentBackgroundScore(nBest[n], reference, quality, qStats);
+    double quality = qualities[n];
+    const std::vector<unsigned int>& qStats = qStatsVec[n];
 
     // std::cerr << nBest[n] << std::endl;
     // std::cerr << reference << std::endl;
@@ -26,14 +26,13 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "stack_dec/MiraBleu.h"
 
 #include "nlp_common/StrProcUtils.h"
-#include "stack_dec/bleu.h"
 
 #include <cmath>
 
 //--------------- MiraBleu class functions
 
 //---------------------------------------
-double MiraBleu::scoreFromStats(std::vector<unsigned int>& stats)
+double MiraBleu::scoreFromStats(const std::vector<unsigned int>& stats) const
 {
   double bp;
   if (stats[0] < stats[1])
@@ -55,20 +54,40 @@ double MiraBleu::scoreFromStats(std::vector<unsigned int>& stats)
   return bp * (double)exp(log_aux);
 }
 
+//---------------------------------------
+double MiraBleu::backgroundScoreFromStats(const std::vector<unsigned int>& sentStats) const
+{
+  std::vector<unsigned int> stats;
+  for (unsigned int i = 0; i < N_STATS; i++)
+    stats.push_back(sentStats[i] + backgroundBleu[i]);
+
+  // scale bleu to roughly typical margins
+  return scoreFromStats(stats) * stats[1]; // according to chiang
+}
+
 //---------------------------------------
 void MiraBleu::statsForSentence(const std::vector<std::string>& candidate_tokens,
-                                const std::vector<std::string>& reference_tokens, std::vector<unsigned int>& stats)
+                                const std::vector<std::string>& reference_tokens,
+                                std::vector<unsigned int>& stats) const
+{
+  BleuRefNgrams refNgrams(reference_tokens, 4);
+  statsForSentence(candidate_tokens, reference_tokens.size(), refNgrams, stats);
+}
+
+//---------------------------------------
+void MiraBleu::statsForSentence(const std::vector<std::string>& candidate_tokens, unsigned int reference_length,
+                                const BleuRefNgrams& refNgrams, std::vector<unsigned int>& stats) const
 {
   stats.clear();
 
-  unsigned int prec, total;
+  std::vector<unsigned int> prec, total;
+  refNgrams.precs(candidate_tokens, prec, total);
   stats.push_back(candidate_tokens.size());
-  stats.push_back(reference_tokens.size());
+  stats.push_back(reference_length);
   for (unsigned int sz = 1; sz <= 4; sz++)
   {
-    prec_n(reference_tokens, candidate_tokens, sz, prec, total);
-    stats.push_back(prec);
-    stats.push_back(total);
+    stats.push_back(prec[sz - 1]);
+    stats.push_back(total[sz - 1]);
   }
 }
 
@@ -82,18 +101,51 @@ void MiraBleu::sentBackgroundScore(const std::string& candidate, const std::stri
 
   statsForSentence(candidate_tokens, reference_tokens, sentStats);
 
-  std::vector<unsigned int> stats;
-  for (unsigned int i = 0; i < N_STATS; i++)
-    stats.push_back(sentStats[i] + backgroundBleu[i]);
+  bleu = backgroundScoreFromStats(sentStats);
+}
 
-  // std::cerr << "stats: [";
-  // for(unsigned k=0; k<stats.size(); k++)
-  //   std::cerr << stats[k] << " ";
-  // std::cerr << "]" << std::endl;
-  // std::cerr << scoreFromStats(stats) << "*" <<  reference_tokens.size()<< std::endl;
+//---------------------------------------
+void MiraBleu::sentBackgroundScores(const std::vector<std::string>& nblist, const std::string& reference,
+                                    std::vector<double>& scores, std::vector<std::vector<unsigned int>>& stats)
+{
+  std::vector<std::string> reference_tokens = StrProcUtils::stringToStringVector(reference);
+  BleuRefNgrams refNgrams(reference_tokens, 4);
 
-  // scale bleu to roughly typical margins
-  bleu = scoreFromStats(stats) * stats[1]; // according to chiang
+  scores.assign(nblist.size(), 0);
+  stats.assign(nblist.size(), std::vector<unsigned int>());
+
+#pragma omp parallel for schedule(dynamic)
+  for (int n = 0; n < (int)nblist.size(); ++n)
+  {
+    std::vector<std::string> candidate_tokens = StrProcUtils::stringToStringVector(nblist[n]);
+    statsForSentence(candidate_tokens, reference_tokens.size(), refNgrams, stats[n]);
+    scores[n] = backgroundScoreFromStats(stats[n]);
+  }
+}
+
+//---------------------------------------
+void MiraBleu::nbestSentScores(const std::vector<std::vector<std::string>>& nblists,
+                               const std::vector<std::string>& references, std::vector<std::vector<double>>& scores)
+{
+  scores.assign(nblists.size(), std::vector<double>());
+
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < (int)nblists.size(); ++i)
+  {
+    std::vector<std::string> reference_tokens = StrProcUtils::stringToStringVector(references[i]);
+    BleuRefNgrams refNgrams(reference_tokens, 4);
+
+    scores[i].resize(nblists[i].size());
+    for (unsigned int n = 0; n < nblists[i].size(); ++n)
+    {
+      std::vector<std::string> candidate_tokens = StrProcUtils::stringToStringVector(nblists[i][n]);
+      std::vector<unsigned int> stats;
+      statsForSentence(candidate_tokens, reference_tokens.size(), refNgrams, stats);
+      for (unsigned int k = 0; k < N_STATS; k++)
+        stats[k] += 1;
+      scores[i][n] = scoreFromStats(stats);
+    }
+  }
 }
 
 //---------------------------------------
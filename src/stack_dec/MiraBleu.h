@@ -26,6 +26,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "stack_dec/BaseMiraScorer.h"
+#include "stack_dec/bleu.h"
 
 #include <cassert>
 #include <iostream>
@@ -65,12 +66,23 @@ public:
   void corpusScore(const std::vector<std::string>& candidates, const std::vector<std::string>& references,
                    double& score);
 
+  // Scores with background corpus stats for all the candidates of an n-best list (computed in parallel)
+  void sentBackgroundScores(const std::vector<std::string>& nblist, const std::string& reference,
+                            std::vector<double>& scores, std::vector<std::vector<unsigned int>>& stats);
+
+  // Sentence scores for a matrix of n-best lists, one list per reference (computed in parallel)
+  void nbestSentScores(const std::vector<std::vector<std::string>>& nblists, const std::vector<std::string>& references,
+                       std::vector<std::vector<double>>& scores);
+
 private:
   unsigned int N_STATS;
   std::vector<double> backgroundBleu; // background corpus stats for BLEU
 
-  double scoreFromStats(std::vector<unsigned int>& stats);
+  double scoreFromStats(const std::vector<unsigned int>& stats) const;
+  double backgroundScoreFromStats(const std::vector<unsigned int>& sentStats) const;
   void statsForSentence(const std::vector<std::string>& candidate_tokens,
-                        const std::vector<std::string>& reference_tokens, std::vector<unsigned int>& stats);
+                        const std::vector<std::string>& reference_tokens, std::vector<unsigned int>& stats) const;
+  void statsForSentence(const std::vector<std::string>& candidate_tokens, unsigned int reference_length,
+                        const BleuRefNgrams& refNgrams, std::vector<unsigned int>& stats) const;
 };
 
@@ -26,6 +26,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define PBM_A_DEFAULT 10
 #define PBM_E_DEFAULT 10
 #define PBM_U_DEFAULT 10
+#define PBM_P_DEFAULT 0
 
 //--------------- Classes --------------------------------------------
 
@@ -42,6 +43,10 @@ public:
                   // the source phrase length that is
                   // being covered
   unsigned int U; // Maximum number of words jumped
+  unsigned int P; // Maximum number of expansions of a
+                  // hypothesis that are scored when
+                  // using cube pruning (0 disables cube
+                  // pruning)
 
   // Constructor
   PbTransModelPars(void)
@@ -50,6 +55,7 @@ public:
     A = PBM_A_DEFAULT;
     E = PBM_E_DEFAULT;
     U = PBM_U_DEFAULT;
+    P = PBM_P_DEFAULT;
   };
 };
 
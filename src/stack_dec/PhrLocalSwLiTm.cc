@@ -2,6 +2,8 @@
 
 #include "sw_models/IncrAlignmentModel.h"
 
+#include <unordered_map>
+
 PhrLocalSwLiTm::PhrLocalSwLiTm(void) : _phrSwTransModel<PhrLocalSwLiTmHypRec<HypEqClassF>>()
 {
   // Initialize stepNum data member
@@ -62,20 +64,10 @@ int PhrLocalSwLiTm::updateLinInterpWeights(std::string srcDevCorpusFileName, std
   initial_weights.push_back(swModelInfo->lambda_swm);
   initial_weights.push_back(swModelInfo->lambda_invswm);
   int ndim = initial_weights.size();
-  double* start = (double*)malloc(ndim * sizeof(double));
-  int nfunk;
-  double* x = (double*)malloc(ndim * sizeof(double));
+  std::vector<double> start = initial_weights;
+  int nfunk = 0;
   double y;
-
-  // Create temporary file
-  FILE* tmp_file = tmpfile();
-
-  if (tmp_file == 0)
-  {
-    std::cerr << "Error updating linear interpolation weights of the phrase model, tmp file could not be created"
-              << std::endl;
-    return THOT_ERROR;
-  }
+  double curr_dhs_ftol = DBL_MAX;
 
   // Extract phrase pairs from development corpus
   std::vector<std::vector<PhrasePair>> invPhrPairs;
@@ -83,48 +75,26 @@ int PhrLocalSwLiTm::updateLinInterpWeights(std::string srcDevCorpusFileName, std
   if (ret != THOT_OK)
     return THOT_ERROR;
 
+  // Obtain the log-probabilities of the phrase pairs, so that each
+  // function evaluation only interpolates them with the new weights
+  DevPhrPairLgProbs lgProbs;
+  getDevPhrPairLgProbs(invPhrPairs, lgProbs);
+
   // Execute downhill simplex algorithm
-  bool end = false;
-  while (!end)
+  ret = downhill_simplex(start.data(), ndim, PHRSWLITM_DHS_FTOL, PHRSWLITM_DHS_SCALE_PAR, NULL, dhsObjFunc, &lgProbs,
+                         &nfunk, &y, &curr_dhs_ftol, false);
+  if (ret == DSO_NMAX_ERROR)
+    std::cerr
+        << "Error updating linear interpolation weights of the phrase model, maximum number of iterations exceeded"
+        << std::endl;
+
+  // Print verbose information
+  if (verbose >= 1)
   {
-    // Set initial weights (each call to step_by_step_simplex starts
-    // from the initial weights)
-    for (unsigned int i = 0; i < initial_weights.size(); ++i)
-      start[i] = initial_weights[i];
-
-    // Execute step by step simplex
-    double curr_dhs_ftol;
-    ret = step_by_step_simplex(start, ndim, PHRSWLITM_DHS_FTOL, PHRSWLITM_DHS_SCALE_PAR, NULL, tmp_file, &nfunk, &y, x,
-                               &curr_dhs_ftol, false);
-    switch (ret)
-    {
-    case THOT_OK:
-      end = true;
-      break;
-    case DSO_NMAX_ERROR:
-      std::cerr
-          << "Error updating linear interpolation weights of the phrase model, maximum number of iterations exceeded"
-          << std::endl;
-      end = true;
-      break;
-    case DSO_EVAL_FUNC: // A new function evaluation is requested by downhill simplex
-      double perp;
-      int retEval = new_dhs_eval(invPhrPairs, tmp_file, x, perp);
-      if (retEval == THOT_ERROR)
-      {
-        end = true;
-        break;
-      }
-      // Print verbose information
-      if (verbose >= 1)
-      {
-        std::cerr << "niter= " << nfunk << " ; current ftol= " << curr_dhs_ftol << " (FTOL=" << PHRSWLITM_DHS_FTOL
-                  << ") ; ";
-        std::cerr << "weights= " << swModelInfo->lambda_swm << " " << swModelInfo->lambda_invswm;
-        std::cerr << " ; perp= " << perp << std::endl;
-      }
-      break;
-    }
+    std::cerr << "niter= " << nfunk << " ; current ftol= " << curr_dhs_ftol << " (FTOL=" << PHRSWLITM_DHS_FTOL
+              << ") ; ";
+    std::cerr << "weights= " << start[0] << " " << start[1];
+    std::cerr << " ; perp= " << y << std::endl;
   }
 
   // Set new weights if updating was successful
@@ -139,11 +109,6 @@ int PhrLocalSwLiTm::updateLinInterpWeights(std::string srcDevCorpusFileName, std
     swModelInfo->lambda_invswm = initial_weights[1];
   }
 
-  // Clear variables
-  free(start);
-  free(x);
-  fclose(tmp_file);
-
   if (ret != THOT_OK)
     return THOT_ERROR;
   else
@@ -260,89 +225,67 @@ int PhrLocalSwLiTm::extractPhrPairsFromDevCorpus(std::string srcDevCorpusFileNam
   return THOT_OK;
 }
 
-double PhrLocalSwLiTm::phraseModelPerplexity(const std::vector<std::vector<PhrasePair>>& invPhrPairs, int /*verbose=0*/)
+void PhrLocalSwLiTm::getDevPhrPairLgProbs(const std::vector<std::vector<PhrasePair>>& invPhrPairs,
+                                          DevPhrPairLgProbs& lgProbs)
 {
-  // Iterate over all sentences
-  double loglikelihood = 0;
-  unsigned int numPhrPairs = 0;
-
-  // Obtain perplexity contribution for consistent phrase pairs
+  lgProbs = DevPhrPairLgProbs();
   for (unsigned int i = 0; i < invPhrPairs.size(); ++i)
   {
-    // std::cerr<<std::endl;
     for (unsigned int j = 0; j < invPhrPairs[i].size(); ++j)
     {
       std::vector<WordIndex> srcPhrasePair = strVectorToSrcIndexVector(invPhrPairs[i][j].t_);
       std::vector<WordIndex> trgPhrasePair = strVectorToTrgIndexVector(invPhrPairs[i][j].s_);
 
-      // Obtain unweighted score for target given source
-      std::vector<Score> logptsScrVec = smoothedPhrScoreVec_t_s_(srcPhrasePair, trgPhrasePair);
-      Score logptsScr = 0;
-      for (unsigned int k = 0; k < logptsScrVec.size(); ++k)
-        logptsScr += logptsScrVec[k] / this->phraseModelInfo->phraseModelPars.ptsWeightVec[k];
-
-      // Obtain unweighted score for source given target
-      std::vector<Score> logpstScrVec = smoothedPhrScoreVec_s_t_(srcPhrasePair, trgPhrasePair);
-      Score logpstScr = 0;
-      for (unsigned int k = 0; k < logpstScrVec.size(); ++k)
-        logpstScr += logpstScrVec[k] / this->phraseModelInfo->phraseModelPars.pstWeightVec[k];
-
-      // Update loglikelihood
-      loglikelihood += logptsScr + logpstScr;
-
-      // for(unsigned int k=0;k<invPhrPairs[i][j].s_.size();++k)
-      //   std::cerr<<invPhrPairs[i][j].s_[k]<<" ";
-      // std::cerr<<"|||";
-      // for(unsigned int k=0;k<invPhrPairs[i][j].t_.size();++k)
-      //   std::cerr<<" "<<invPhrPairs[i][j].t_[k];
-      // std::cerr<<" ||| "<<(double)logpstScr<<" "<<(double)logptsScr<<std::endl;
+      lgProbs.phrTsLgProbs.push_back((float)phraseModelInfo->invPhraseModel->logps_t_(trgPhrasePair, srcPhrasePair));
+      lgProbs.swTsLgProbs.push_back((float)swLgProb(0, srcPhrasePair, trgPhrasePair));
+      lgProbs.phrStLgProbs.push_back((float)phraseModelInfo->invPhraseModel->logpt_s_(trgPhrasePair, srcPhrasePair));
+      lgProbs.swStLgProbs.push_back((float)invSwLgProb(0, srcPhrasePair, trgPhrasePair));
     }
-    // Update number of phrase pairs
-    numPhrPairs += invPhrPairs[i].size();
   }
-
-  // Return perplexity
-  return -1 * (loglikelihood / (double)numPhrPairs);
 }
 
-int PhrLocalSwLiTm::new_dhs_eval(const std::vector<std::vector<PhrasePair>>& invPhrPairs, FILE* tmp_file, double* x,
-                                 double& obj_func)
+double PhrLocalSwLiTm::phraseModelPerplexity(const DevPhrPairLgProbs& lgProbs, float lambda_swm, float lambda_invswm)
 {
-  LgProb totalLogProb;
-  bool weightsArePositive = true;
-  bool weightsAreBelowOne = true;
-
-  // Fix weights to be evaluated
-  swModelInfo->lambda_swm = x[0];
-  swModelInfo->lambda_invswm = x[1];
-  for (unsigned int i = 0; i < 2; ++i)
+  double loglikelihood = 0;
+  int numPhrPairs = lgProbs.phrTsLgProbs.size();
+#pragma omp parallel for schedule(static) reduction(+ : loglikelihood)
+  for (int i = 0; i < numPhrPairs; ++i)
   {
-    if (x[i] < 0)
-      weightsArePositive = false;
-    if (x[i] >= 1)
-      weightsAreBelowOne = false;
+    loglikelihood += linInterpLgProb(lambda_swm, lgProbs.phrTsLgProbs[i], lgProbs.swTsLgProbs[i]);
+    loglikelihood += linInterpLgProb(lambda_invswm, lgProbs.phrStLgProbs[i], lgProbs.swStLgProbs[i]);
   }
 
-  if (weightsArePositive && weightsAreBelowOne)
-  {
-    // Obtain perplexity
-    obj_func = phraseModelPerplexity(invPhrPairs, obj_func);
-  }
-  else
+  // Return perplexity
+  return -1 * (loglikelihood / (double)numPhrPairs);
+}
+
+int PhrLocalSwLiTm::dhsObjFunc(void* data, int n, double* x, double* y)
+{
+  // The weights are only valid in the [0,1) interval
+  for (int i = 0; i < n; ++i)
   {
-    obj_func = DBL_MAX;
+    if (x[i] < 0 || x[i] >= 1)
+    {
+      *y = DBL_MAX;
+      return THOT_OK;
+    }
   }
-
-  // Print result to tmp file
-  fprintf(tmp_file, "%g\n", obj_func);
-  fflush(tmp_file);
-  // step_by_step_simplex needs that the file position
-  // indicator is set at the start of the stream
-  rewind(tmp_file);
-
+  *y = phraseModelPerplexity(*(const DevPhrPairLgProbs*)data, x[0], x[1]);
   return THOT_OK;
 }
 
+float PhrLocalSwLiTm::linInterpLgProb(float lambda, float phrLgProb, float swLgProb)
+{
+  if (lambda == 1.0)
+    return phrLgProb;
+
+  float sum1 = log(lambda) + phrLgProb;
+  if (sum1 <= log(PHRASE_PROB_SMOOTH))
+    sum1 = PHRSWLITM_LGPROB_SMOOTH;
+  float sum2 = log(1.0 - lambda) + swLgProb;
+  return MathFuncs::lns_sumlog(sum1, sum2);
+}
+
 PhrLocalSwLiTm::Hypothesis PhrLocalSwLiTm::nullHypothesis(void)
 {
   Hypothesis hyp;
@@ -564,6 +507,9 @@ int PhrLocalSwLiTm::onlineTrainFeatsSentPair(const char* srcSent, const char* re
     return THOT_ERROR;
   }
 
+  // The cached heuristic scores are not valid after training
+  clearFutureCostCache();
+
   // Train pair according to chosen algorithm
   switch (onlineTrainingPars.onlineLearningAlgorithm)
   {
@@ -586,33 +532,47 @@ int PhrLocalSwLiTm::onlineTrainFeatsSentPair(const char* srcSent, const char* re
 
 int PhrLocalSwLiTm::incrTrainFeatsSentPair(const char* srcSent, const char* refSent, int verbose /*=0*/)
 {
-  int ret;
+  int ret = THOT_OK;
   std::vector<std::string> srcSentStrVec = StrProcUtils::charItemsToVector(srcSent);
   std::vector<std::string> refSentStrVec = StrProcUtils::charItemsToVector(refSent);
   std::pair<unsigned int, unsigned int> sentRange;
 
-  // Train language model
-  if (verbose)
-    std::cerr << "Training language model..." << std::endl;
-  ret = langModelInfo->langModel->trainSentence(refSentStrVec, onlineTrainingPars.learnStepSize, 0, verbose);
-  if (ret == THOT_ERROR)
-    return THOT_ERROR;
-
   // Revise vocabularies of the alignment models
   updateAligModelsSrcVoc(srcSentStrVec);
   updateAligModelsTrgVoc(refSentStrVec);
 
-  // Add sentence pair to the single word models
-  sentRange =
-      swModelInfo->swAligModels[0]->addSentencePair(srcSentStrVec, refSentStrVec, onlineTrainingPars.learnStepSize);
-  sentRange =
-      swModelInfo->invSwAligModels[0]->addSentencePair(refSentStrVec, srcSentStrVec, onlineTrainingPars.learnStepSize);
-
   auto alignmentModel = dynamic_cast<IncrAlignmentModel*>(swModelInfo->swAligModels[0].get());
   auto invAlignmentModel = dynamic_cast<IncrAlignmentModel*>(swModelInfo->invSwAligModels[0].get());
 
-  alignmentModel->startIncrTraining(sentRange, verbose);
-  invAlignmentModel->startIncrTraining(sentRange, verbose);
+  // The language model and the direct and inverse single word models
+  // do not share any state, so they are updated concurrently
+  int lmRet = THOT_OK;
+#pragma omp parallel sections num_threads(3)
+  {
+#pragma omp section
+    {
+      // Train language model
+      if (verbose)
+        std::cerr << "Training language model..." << std::endl;
+      lmRet = langModelInfo->langModel->trainSentence(refSentStrVec, onlineTrainingPars.learnStepSize, 0, verbose);
+    }
+#pragma omp section
+    {
+      // Add sentence pair to the single word model
+      sentRange = swModelInfo->swAligModels[0]->addSentencePair(srcSentStrVec, refSentStrVec,
+                                                                 onlineTrainingPars.learnStepSize);
+      alignmentModel->startIncrTraining(sentRange, verbose);
+    }
+#pragma omp section
+    {
+      // Add sentence pair to the inverse single word model
+      std::pair<unsigned int, unsigned int> invSentRange = swModelInfo->invSwAligModels[0]->addSentencePair(
+          refSentStrVec, srcSentStrVec, onlineTrainingPars.learnStepSize);
+      invAlignmentModel->startIncrTraining(invSentRange, verbose);
+    }
+  }
+  if (lmRet == THOT_ERROR)
+    return THOT_ERROR;
 
   // Iterate over E_par interlaced samples
   unsigned int curr_sample = sentRange.second;
@@ -625,15 +585,23 @@ int PhrLocalSwLiTm::incrTrainFeatsSentPair(const char* srcSent, const char* refS
       if (verbose)
         std::cerr << "Alig. model training iteration over sample " << n << " ..." << std::endl;
 
-      // Train sw model
-      if (verbose)
-        std::cerr << "Training single-word model..." << std::endl;
-      alignmentModel->incrTrain(std::make_pair(n, n), verbose);
-
-      // Train inverse sw model
-      if (verbose)
-        std::cerr << "Training inverse single-word model..." << std::endl;
-      invAlignmentModel->incrTrain(std::make_pair(n, n), verbose);
+#pragma omp parallel sections num_threads(2)
+      {
+#pragma omp section
+        {
+          // Train sw model
+          if (verbose)
+            std::cerr << "Training single-word model..." << std::endl;
+          alignmentModel->incrTrain(std::make_pair(n, n), verbose);
+        }
+#pragma omp section
+        {
+          // Train inverse sw model
+          if (verbose)
+            std::cerr << "Training inverse single-word model..." << std::endl;
+          invAlignmentModel->incrTrain(std::make_pair(n, n), verbose);
+        }
+      }
 
       // Add new translation options
       if (verbose)
@@ -700,37 +668,55 @@ int PhrLocalSwLiTm::minibatchTrainFeatsSentPair(const char* srcSent, const char*
       std::cerr << "Processing mini-batch of size " << minibatchSize << " , " << minibatchSentRange.first << " - "
                 << minibatchSentRange.second << std::endl;
 
-    // Set learning rate for sw model if possible
-    auto stepwiseAlignmentModel = dynamic_cast<StepwiseAlignmentModel*>(swModelInfo->swAligModels[0].get());
-    if (stepwiseAlignmentModel)
-      stepwiseAlignmentModel->set_nu_val(learningRate);
-
-    // Train sw model
-    if (verbose)
-      std::cerr << "Training single-word model..." << std::endl;
-    auto alignmentModel = dynamic_cast<IncrAlignmentModel*>(swModelInfo->swAligModels[0].get());
-    alignmentModel->startIncrTraining(minibatchSentRange, verbose);
-    for (unsigned int i = 0; i < onlineTrainingPars.emIters; ++i)
+    // The language model and the direct and inverse single word models
+    // do not share any state, so they are trained concurrently
+#pragma omp parallel sections num_threads(3)
     {
-      alignmentModel->incrTrain(minibatchSentRange, verbose);
-    }
-    alignmentModel->endIncrTraining();
+#pragma omp section
+      {
+        // Set learning rate for sw model if possible
+        auto stepwiseAlignmentModel = dynamic_cast<StepwiseAlignmentModel*>(swModelInfo->swAligModels[0].get());
+        if (stepwiseAlignmentModel)
+          stepwiseAlignmentModel->set_nu_val(learningRate);
 
-    // Set learning rate for inverse sw model if possible
-    auto invStepwiseAlignmentModel = dynamic_cast<StepwiseAlignmentModel*>(swModelInfo->invSwAligModels[0].get());
-    if (invStepwiseAlignmentModel)
-      invStepwiseAlignmentModel->set_nu_val(learningRate);
+        // Train sw model
+        if (verbose)
+          std::cerr << "Training single-word model..." << std::endl;
+        auto alignmentModel = dynamic_cast<IncrAlignmentModel*>(swModelInfo->swAligModels[0].get());
+        alignmentModel->startIncrTraining(minibatchSentRange, verbose);
+        for (unsigned int i = 0; i < onlineTrainingPars.emIters; ++i)
+        {
+          alignmentModel->incrTrain(minibatchSentRange, verbose);
+        }
+        alignmentModel->endIncrTraining();
+      }
+#pragma omp section
+      {
+        // Set learning rate for inverse sw model if possible
+        auto invStepwiseAlignmentModel =
+            dynamic_cast<StepwiseAlignmentModel*>(swModelInfo->invSwAligModels[0].get());
+        if (invStepwiseAlignmentModel)
+          invStepwiseAlignmentModel->set_nu_val(learningRate);
 
-    // Train inverse sw model
-    if (verbose)
-      std::cerr << "Training inverse single-word model..." << std::endl;
-    auto invAlignmentModel = dynamic_cast<IncrAlignmentModel*>(swModelInfo->invSwAligModels[0].get());
-    invAlignmentModel->startIncrTraining(minibatchSentRange, verbose);
-    for (unsigned int i = 0; i < onlineTrainingPars.emIters; ++i)
-    {
-      invAlignmentModel->incrTrain(minibatchSentRange, verbose);
+        // Train inverse sw model
+        if (verbose)
+          std::cerr << "Training inverse single-word model..." << std::endl;
+        auto invAlignmentModel = dynamic_cast<IncrAlignmentModel*>(swModelInfo->invSwAligModels[0].get());
+        invAlignmentModel->startIncrTraining(minibatchSentRange, verbose);
+        for (unsigned int i = 0; i < onlineTrainingPars.emIters; ++i)
+        {
+          invAlignmentModel->incrTrain(minibatchSentRange, verbose);
+        }
+        invAlignmentModel->endIncrTraining();
+      }
+#pragma omp section
+      {
+        // Train language model
+        if (verbose)
+          std::cerr << "Training language model..." << std::endl;
+        langModelInfo->langModel->trainSentenceVec(vecTrgSent, (Count)learningRate, (Count)0, verbose);
+      }
     }
-    invAlignmentModel->endIncrTraining();
 
     // Generate word alignments
     if (verbose)
@@ -772,11 +758,6 @@ int PhrLocalSwLiTm::minibatchTrainFeatsSentPair(const char* srcSent, const char*
                                                      (Count)learningRate, verbose);
     }
 
-    // Train language model
-    if (verbose)
-      std::cerr << "Training language model..." << std::endl;
-    langModelInfo->langModel->trainSentenceVec(vecTrgSent, (Count)learningRate, (Count)0, verbose);
-
     // Clear vectors with source and target sentences
     vecSrcSent.clear();
     vecTrgSent.clear();
@@ -868,33 +849,48 @@ int PhrLocalSwLiTm::batchRetrainFeatsSentPair(const char* srcSent, const char* r
     }
     swModelInfo->invSwAligModels[0]->endTraining();
 
-    // Generate word alignments
-    if (verbose)
-      std::cerr << "Generating word alignments..." << std::endl;
-    for (unsigned int n = 0; n < vecSrcSent.size(); ++n)
+    // The word alignments only depend on the single word models, so
+    // the language model is retrained at the same time
+#pragma omp parallel sections num_threads(2)
     {
-      // Generate alignments
-      WordAlignmentMatrix waMatrix;
-      WordAlignmentMatrix invWaMatrix;
+#pragma omp section
+      {
+        // Generate word alignments
+        if (verbose)
+          std::cerr << "Generating word alignments..." << std::endl;
+        for (unsigned int n = 0; n < vecSrcSent.size(); ++n)
+        {
+          // Generate alignments
+          WordAlignmentMatrix waMatrix;
+          WordAlignmentMatrix invWaMatrix;
 
-      swModelInfo->swAligModels[0]->getBestAlignment(vecSrcSent[n], vecTrgSent[n], waMatrix);
-      swModelInfo->invSwAligModels[0]->getBestAlignment(vecTrgSent[n], vecSrcSent[n], invWaMatrix);
+          swModelInfo->swAligModels[0]->getBestAlignment(vecSrcSent[n], vecTrgSent[n], waMatrix);
+          swModelInfo->invSwAligModels[0]->getBestAlignment(vecTrgSent[n], vecSrcSent[n], invWaMatrix);
 
-      // Operate alignments
-      std::vector<std::string> nrefSentStrVec = swModelInfo->swAligModels[0]->addNullWordToStrVec(vecTrgSent[n]);
+          // Operate alignments
+          std::vector<std::string> nrefSentStrVec = swModelInfo->swAligModels[0]->addNullWordToStrVec(vecTrgSent[n]);
 
-      waMatrix.transpose();
+          waMatrix.transpose();
 
-      // Execute symmetrization
-      invWaMatrix.symmetr1(waMatrix);
-      if (verbose)
+          // Execute symmetrization
+          invWaMatrix.symmetr1(waMatrix);
+          if (verbose)
+          {
+            printAlignmentInGIZAFormat(std::cerr, nrefSentStrVec, vecSrcSent[n], invWaMatrix,
+                                       "Operated word alignment for phrase model training:");
+          }
+
+          // Store word alignment matrix
+          invWaMatrixVec.push_back(invWaMatrix);
+        }
+      }
+#pragma omp section
       {
-        printAlignmentInGIZAFormat(std::cerr, nrefSentStrVec, vecSrcSent[n], invWaMatrix,
-                                   "Operated word alignment for phrase model training:");
+        // Train language model
+        if (verbose)
+          std::cerr << "Training language model..." << std::endl;
+        langModelInfo->langModel->trainSentenceVec(vecTrgSent, (Count)learningRate, (Count)0, verbose);
       }
-
-      // Store word alignment matrix
-      invWaMatrixVec.push_back(invWaMatrix);
     }
 
     // Train phrase-based model
@@ -907,10 +903,6 @@ int PhrLocalSwLiTm::batchRetrainFeatsSentPair(const char* srcSent, const char* r
       wbaIncrPhraseModelPtr->extModelFromPairAligVec(phePars, false, vecTrgSent, vecSrcSent, invWaMatrixVec,
                                                      (Count)learningRate, verbose);
     }
-    // Train language model
-    if (verbose)
-      std::cerr << "Training language model..." << std::endl;
-    langModelInfo->langModel->trainSentenceVec(vecTrgSent, (Count)learningRate, (Count)0, verbose);
   }
 
   return THOT_OK;
@@ -968,20 +960,26 @@ float PhrLocalSwLiTm::calculateNewLearningRate(int verbose /*=0*/)
 
 float PhrLocalSwLiTm::werBasedLearningRate(int verbose /*=0*/)
 {
-  EditDistForVec<std::string> edDistVecStr;
-  unsigned int hCount, iCount, sCount, dCount;
+  std::unordered_map<std::string, unsigned int> wordIds;
+  std::vector<unsigned int> trgIds;
+  std::vector<unsigned int> sysIds;
   unsigned int totalOps = 0;
   unsigned int totalTrgWords = 0;
   float wer;
   float lr;
 
-  // Set error model
-  edDistVecStr.setErrorModel(0, 1, 1, 1);
-
   for (unsigned int n = 0; n < vecTrgSent.size(); ++n)
   {
-    double dist = edDistVecStr.calculateEditDistOps(vecTrgSent[n], vecSysSent[n], hCount, iCount, sCount, dCount, 0);
-    unsigned int ops = (unsigned int)dist;
+    // Intern the words so that the unit-cost edit distance is
+    // calculated over word ids
+    trgIds.clear();
+    for (const std::string& word : vecTrgSent[n])
+      trgIds.push_back(wordIds.insert(std::make_pair(word, (unsigned int)wordIds.size())).first->second);
+    sysIds.clear();
+    for (const std::string& word : vecSysSent[n])
+      sysIds.push_back(wordIds.insert(std::make_pair(word, (unsigned int)wordIds.size())).first->second);
+
+    unsigned int ops = BitParallelEditDist::editDist(trgIds, sysIds);
     unsigned int trgWords = vecTrgSent[n].size();
     totalOps += ops;
     totalTrgWords += trgWords;
@@ -1100,8 +1098,8 @@ bool PhrLocalSwLiTm::load_lambdas(const char* lambdaFileName, int verbose)
     {
       if (awk.NF == 1)
       {
-        swModelInfo->lambda_swm = atof(awk.dollar(1).c_str());
-        swModelInfo->lambda_invswm = atof(awk.dollar(1).c_str());
+        swModelInfo->lambda_swm = awk.dollarToDouble(1);
+        swModelInfo->lambda_invswm = awk.dollarToDouble(1);
         if (verbose)
           std::cerr << "Read lambda value from file: " << lambdaFileName << " (lambda_swm=" << swModelInfo->lambda_swm
                     << ", lambda_invswm=" << swModelInfo->lambda_invswm << ")" << std::endl;
@@ -1111,8 +1109,8 @@ bool PhrLocalSwLiTm::load_lambdas(const char* lambdaFileName, int verbose)
       {
         if (awk.NF == 2)
         {
-          swModelInfo->lambda_swm = atof(awk.dollar(1).c_str());
-          swModelInfo->lambda_invswm = atof(awk.dollar(2).c_str());
+          swModelInfo->lambda_swm = awk.dollarToDouble(1);
+          swModelInfo->lambda_invswm = awk.dollarToDouble(2);
           if (verbose)
             std::cerr << "Read lambda value from file: " << lambdaFileName << " (lambda_swm=" << swModelInfo->lambda_swm
                       << ", lambda_invswm=" << swModelInfo->lambda_invswm << ")" << std::endl;
@@ -1288,20 +1286,11 @@ Score PhrLocalSwLiTm::smoothedPhrScore_s_t_(const std::vector<WordIndex>& s_, co
 
 Score PhrLocalSwLiTm::regularSmoothedPhrScore_s_t_(const std::vector<WordIndex>& s_, const std::vector<WordIndex>& t_)
 {
-  if (swModelInfo->lambda_invswm == 1.0)
-  {
-    return phraseModelInfo->phraseModelPars.pstWeightVec[0] * (double)phraseModelInfo->invPhraseModel->logpt_s_(t_, s_);
-  }
-  else
-  {
-    float sum1 = log(swModelInfo->lambda_invswm) + (float)phraseModelInfo->invPhraseModel->logpt_s_(t_, s_);
-    if (sum1 <= log(PHRASE_PROB_SMOOTH))
-      sum1 = PHRSWLITM_LGPROB_SMOOTH;
-    float sum2 = log(1.0 - swModelInfo->lambda_invswm) + (float)invSwLgProb(0, s_, t_);
-    float interp = MathFuncs::lns_sumlog(sum1, sum2);
-
-    return phraseModelInfo->phraseModelPars.pstWeightVec[0] * (double)interp;
-  }
+  float lambda = swModelInfo->lambda_invswm;
+  float phrLgProb = (float)phraseModelInfo->invPhraseModel->logpt_s_(t_, s_);
+  // The single word model is not queried if its weight is zero
+  float swmLgProb = lambda == 1.0 ? 0 : (float)invSwLgProb(0, s_, t_);
+  return phraseModelInfo->phraseModelPars.pstWeightVec[0] * (double)linInterpLgProb(lambda, phrLgProb, swmLgProb);
 }
 
 std::vector<Score> PhrLocalSwLiTm::smoothedPhrScoreVec_s_t_(const std::vector<WordIndex>& s_,
@@ -1342,19 +1331,11 @@ void PhrLocalSwLiTm::obtainTrgSwVocWordIdxVec(const std::vector<WordIndex>& t_,
 
 Score PhrLocalSwLiTm::regularSmoothedPhrScore_t_s_(const std::vector<WordIndex>& s_, const std::vector<WordIndex>& t_)
 {
-  if (swModelInfo->lambda_swm == 1.0)
-  {
-    return phraseModelInfo->phraseModelPars.ptsWeightVec[0] * (double)phraseModelInfo->invPhraseModel->logps_t_(t_, s_);
-  }
-  else
-  {
-    float sum1 = log(swModelInfo->lambda_swm) + (float)phraseModelInfo->invPhraseModel->logps_t_(t_, s_);
-    if (sum1 <= log(PHRASE_PROB_SMOOTH))
-      sum1 = PHRSWLITM_LGPROB_SMOOTH;
-    float sum2 = log(1.0 - swModelInfo->lambda_swm) + (float)swLgProb(0, s_, t_);
-    float interp = MathFuncs::lns_sumlog(sum1, sum2);
-    return phraseModelInfo->phraseModelPars.ptsWeightVec[0] * (double)interp;
-  }
+  float lambda = swModelInfo->lambda_swm;
+  float phrLgProb = (float)phraseModelInfo->invPhraseModel->logps_t_(t_, s_);
+  // The single word model is not queried if its weight is zero
+  float swmLgProb = lambda == 1.0 ? 0 : (float)swLgProb(0, s_, t_);
+  return phraseModelInfo->phraseModelPars.ptsWeightVec[0] * (double)linInterpLgProb(lambda, phrLgProb, swmLgProb);
 }
 
 std::vector<Score> PhrLocalSwLiTm::smoothedPhrScoreVec_t_s_(const std::vector<WordIndex>& s_,
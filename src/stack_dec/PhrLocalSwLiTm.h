@@ -23,7 +23,7 @@ extern "C"
 #include "downhill_simplex/step_by_step_dhs.h"
 }
 
-#include "error_correction/EditDistForVec.h"
+#include "error_correction/BitParallelEditDist.h"
 #include "phrase_models/BaseIncrPhraseModel.h"
 #include "phrase_models/PhraseExtractParameters.h"
 #include "phrase_models/PhrasePair.h"
@@ -53,6 +53,8 @@ typedef PhrHypNumcovJumps01EqClassF HypEqClassF;
  */
 class PhrLocalSwLiTm : public _phrSwTransModel<PhrLocalSwLiTmHypRec<HypEqClassF>>
 {
+  friend class PhrLocalSwLiTmTest;
+
 public:
   typedef _phrSwTransModel<PhrLocalSwLiTmHypRec<HypEqClassF>>::Hypothesis Hypothesis;
   typedef _phrSwTransModel<PhrLocalSwLiTmHypRec<HypEqClassF>>::HypScoreInfo HypScoreInfo;
@@ -111,12 +113,24 @@ protected:
   void getPmWeights(std::vector<std::pair<std::string, float>>& compWeights);
   void printPmWeights(std::ostream& outS);
 
+  // Log-probabilities of the phrase pairs of a development corpus
+  // given by the phrase model and the single word models, which are
+  // interpolated with the lambda_swm and lambda_invswm weights
+  struct DevPhrPairLgProbs
+  {
+    std::vector<float> phrTsLgProbs;
+    std::vector<float> swTsLgProbs;
+    std::vector<float> phrStLgProbs;
+    std::vector<float> swStLgProbs;
+  };
+
   // Functions related to linear interpolation weights updating
   int extractPhrPairsFromDevCorpus(std::string srcDevCorpusFileName, std::string trgDevCorpusFileName,
                                    std::vector<std::vector<PhrasePair>>& invPhrPairs, int verbose /*=0*/);
-  double phraseModelPerplexity(const std::vector<std::vector<PhrasePair>>& invPhrPairs, int verbose = 0);
-  int new_dhs_eval(const std::vector<std::vector<PhrasePair>>& invPhrPairs, FILE* tmp_file, double* x,
-                   double& obj_func);
+  void getDevPhrPairLgProbs(const std::vector<std::vector<PhrasePair>>& invPhrPairs, DevPhrPairLgProbs& lgProbs);
+  static double phraseModelPerplexity(const DevPhrPairLgProbs& lgProbs, float lambda_swm, float lambda_invswm);
+  static int dhsObjFunc(void* data, int n, double* x, double* y);
+  static float linInterpLgProb(float lambda, float phrLgProb, float swLgProb);
 
   // Function lo load and print lambda values
   bool load_lambdas(const char* lambdaFileName, int verbose);
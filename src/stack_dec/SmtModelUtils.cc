@@ -150,16 +150,16 @@ bool loadSwmLambdas(std::string lambdaFileName, float& lambda_swm, float& lambda
     {
       if (awk.NF == 1)
       {
-        lambda_swm = atof(awk.dollar(1).c_str());
-        lambda_invswm = atof(awk.dollar(1).c_str());
+        lambda_swm = awk.dollarToDouble(1);
+        lambda_invswm = awk.dollarToDouble(1);
         return THOT_OK;
       }
       else
       {
         if (awk.NF == 2)
         {
-          lambda_swm = atof(awk.dollar(1).c_str());
-          lambda_invswm = atof(awk.dollar(2).c_str());
+          lambda_swm = awk.dollarToDouble(1);
+          lambda_invswm = awk.dollarToDouble(2);
           return THOT_OK;
         }
         else
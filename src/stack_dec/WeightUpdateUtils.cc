@@ -49,7 +49,7 @@ void updateLogLinearWeights(std::string refSent, WordGraph* wgPtr, BaseLogLinWei
   std::vector<std::pair<Score, std::string>> nblist;
   std::vector<NbSearchHighLevelHyp> highLevelHypList;
   std::vector<std::vector<double>> scoreCompsVec;
-  wgPtr->obtainNbestList(len, nblist, highLevelHypList, scoreCompsVec);
+  wgPtr->obtainNbestList(len, nblist, highLevelHypList, scoreCompsVec, false, true);
 
   // Obtain current weights
   std::vector<double> currentWeights;
@@ -38,6 +38,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "stack_dec/BasePbTransModel.h"
 #include "stack_dec/DirectPhraseModelFeat.h"
 #include "stack_dec/FeaturesInfo.h"
+#include "stack_dec/FutureCostTable.h"
 #include "stack_dec/NbestTransCacheData.h"
 #include "stack_dec/OnTheFlyDictFeat.h"
 #include "stack_dec/PbTransModelInputVars.h"
@@ -163,8 +164,8 @@ protected:
   // Heuristic function to be used
   unsigned int heuristicId;
 
-  // Heuristic probability vector
-  std::vector<std::vector<Score>> heuristicScoreVec;
+  // Heuristic score table
+  FutureCostTable futureCostTable;
 
   // Additional data structures to store information about heuristics
   std::vector<LgProb> refHeurLmLgProb;
@@ -1018,7 +1019,7 @@ void _pbTransModel<HYPOTHESIS>::clearTempVars(void)
   unseenWordsSet.clear();
 
   // Clear information of the heuristic used in the translation
-  heuristicScoreVec.clear();
+  futureCostTable.clear();
 
   // Clear additional heuristic information
   refHeurLmLgProb.clear();
@@ -1132,97 +1133,57 @@ void _pbTransModel<HYPOTHESIS>::initHeuristic(unsigned int maxSrcPhraseLength)
 template <class HYPOTHESIS>
 void _pbTransModel<HYPOTHESIS>::initHeuristicLocalt(int maxSrcPhraseLength)
 {
-  std::vector<Score> row;
   NbestTableNode<PhraseTransTableNodeData> ttNode;
   NbestTableNode<PhraseTransTableNodeData>::iterator ttNodeIter;
-  Score compositionProduct;
-  Score bestScore_ts = 0;
+  Score bestScore_ts;
   Score score_ts;
 
   unsigned int J = pbtmInputVars.nsrcSentIdVec.size() - 1;
-  heuristicScoreVec.clear();
-  // Initialize row vector
-  for (unsigned int j = 0; j < J; ++j)
-    row.push_back(-FLT_MAX);
-  // Insert rows into t-heuristic table
-  for (unsigned int j = 0; j < J; ++j)
-    heuristicScoreVec.push_back(row);
-
-  // Fill the t-heuristic table
-  for (unsigned int y = 0; y < J; ++y)
-  {
-    for (unsigned int x = J - y - 1; x < J; ++x)
+  futureCostTable.init(J);
+
+  // Fill the t-heuristic table with the scores of the best
+  // translations of each span
+  std::vector<WordIndex> srcPhrase;
+  for (unsigned int left = 1; left <= J; ++left)
+  {
+    srcPhrase.clear();
+    for (unsigned int right = left; right <= J; ++right)
     {
-      // obtain source phrase
-      unsigned int segmRightMostj = y + 1;
-      unsigned int segmLeftMostj = J - x;
+      unsigned int length = right - left + 1;
+      if (length > 1 && length > (unsigned int)maxSrcPhraseLength)
+        break;
+      srcPhrase.push_back(pbtmInputVars.nsrcSentIdVec[right]);
 
       // obtain score for best translation
-      if ((segmRightMostj - segmLeftMostj) + 1 > (unsigned int)maxSrcPhraseLength)
+      ttNode.clear();
+      if (length <= (unsigned int)maxSrcPhraseLength)
       {
-        ttNode.clear();
-      }
-      else
-      {
-        std::vector<WordIndex> srcPhrase;
-        for (unsigned int j = segmLeftMostj; j <= segmRightMostj; ++j)
-          srcPhrase.push_back(pbtmInputVars.nsrcSentIdVec[j]);
-
         // Obtain translations for srcPhrase
-        getNbestTransForSrcPhraseCached(segmLeftMostj, segmRightMostj, ttNode, this->pbTransModelPars.W);
-        if (ttNode.size() != 0) // Obtain best p(srcPhrase|t_)
+        getNbestTransForSrcPhraseCached(left, right, ttNode, this->pbTransModelPars.W);
+        bestScore_ts = -FLT_MAX;
+        for (ttNodeIter = ttNode.begin(); ttNodeIter != ttNode.end(); ++ttNodeIter)
         {
-          bestScore_ts = -FLT_MAX;
-          for (ttNodeIter = ttNode.begin(); ttNodeIter != ttNode.end(); ++ttNodeIter)
-          {
-            // Obtain phrase to phrase translation probability
-            score_ts = heurDirectPmScoreLt(srcPhrase, ttNodeIter->second)
-                     + heurInversePmScoreLt(srcPhrase, ttNodeIter->second);
+          // Obtain phrase to phrase translation probability
+          score_ts = heurDirectPmScoreLt(srcPhrase, ttNodeIter->second)
+                   + heurInversePmScoreLt(srcPhrase, ttNodeIter->second);
 
-            // Obtain language model heuristic estimation
-            score_ts += heurLmScoreLtNoAdmiss(ttNodeIter->second);
+          // Obtain language model heuristic estimation
+          score_ts += heurLmScoreLtNoAdmiss(ttNodeIter->second);
 
-            if (bestScore_ts < score_ts)
-              bestScore_ts = score_ts;
-          }
+          if (bestScore_ts < score_ts)
+            bestScore_ts = score_ts;
         }
       }
 
-      // Check source phrase length
-      if (x == J - y - 1)
-      {
-        // source phrase has only one word
-        if (ttNode.size() != 0)
-        {
-          heuristicScoreVec[y][x] = bestScore_ts;
-        }
-        else
-        {
-          heuristicScoreVec[y][x] = unkWordScoreHeur();
-        }
-      }
-      else
-      {
-        // source phrase has more than one word
-        if (ttNode.size() != 0)
-        {
-          heuristicScoreVec[y][x] = bestScore_ts;
-        }
-        else
-        {
-          heuristicScoreVec[y][x] = -FLT_MAX;
-        }
-        for (unsigned int z = J - x - 1; z < y; ++z)
-        {
-          compositionProduct = heuristicScoreVec[z][x] + heuristicScoreVec[y][J - 2 - z];
-          if (heuristicScoreVec[y][x] < compositionProduct)
-          {
-            heuristicScoreVec[y][x] = compositionProduct;
-          }
-        }
-      }
+      if (ttNode.size() != 0)
+        futureCostTable.set(left - 1, right - 1, bestScore_ts);
+      else if (length == 1)
+        futureCostTable.set(left - 1, right - 1, unkWordScoreHeur());
     }
   }
+
+  // Complete the table with the best segmentation of each span
+  futureCostTable.compose();
 }
 
 //---------------------------------
@@ -1448,12 +1409,11 @@ template <class HYPOTHESIS>
 Score _pbTransModel<HYPOTHESIS>::getLocalTmHeurScore(const Hypothesis& hyp)
 {
   Score result = 0;
-  unsigned int J = pbtmInputVars.srcSentVec.size();
   std::vector<std::pair<PositionIndex, PositionIndex>> gaps;
   this->extract_gaps(hyp, gaps);
   for (unsigned int i = 0; i < gaps.size(); ++i)
   {
-    result += heuristicScoreVec[gaps[i].second - 1][J - gaps[i].first];
+    result += futureCostTable.get(gaps[i].first - 1, gaps[i].second - 1);
   }
 
   return result;
@@ -21,6 +21,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "nlp_common/Prob.h"
 #include "nlp_common/ins_op_pair.h"
 #include "stack_dec/BasePbTransModel.h"
+#include "stack_dec/FutureCostTable.h"
 #include "stack_dec/LangModelInfo.h"
 #include "stack_dec/NbestTransCacheData.h"
 #include "stack_dec/PbTransModelInputVars.h"
@@ -30,7 +31,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "stack_dec/SourceSegmentation.h"
 
 #include <math.h>
+#include <map>
 #include <memory>
+#include <queue>
 #include <set>
 
 #define NO_HEURISTIC 0
@@ -41,6 +44,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define MODEL_TRANSREF_STATE 3
 #define MODEL_TRANSVER_STATE 4
 #define MODEL_TRANSPREFIX_STATE 5
+#define FUTURE_COST_CACHE_MAX_SIZE 1000000
 
 /**
  * @brief The _phraseBasedTransModel class is a predecessor of the
@@ -106,6 +110,15 @@ public:
   void addHeuristicToHyp(Hypothesis& hyp);
   void subtractHeuristicToHyp(Hypothesis& hyp);
 
+  // Functions to cache the best translation scores of the source
+  // phrases across sentences when initializing the heuristic. The
+  // cache is cleared when the weights change or the models are loaded
+  // or trained through this object. If the models are trained through
+  // another object, the cache should be cleared explicitly
+  void setFutureCostCaching(bool enabled);
+  bool getFutureCostCaching() const;
+  void clearFutureCostCache();
+
   // Printing functions and data conversion
   void printHyp(const Hypothesis& hyp, std::ostream& outS, int verbose = false);
   std::vector<std::string> getTransInPlainTextVec(const Hypothesis& hyp) const;
@@ -150,8 +163,15 @@ protected:
 
   // Heuristic function to be used
   unsigned int heuristicId;
-  // Heuristic probability vector
-  std::vector<std::vector<Score>> heuristicScoreVec;
+  // Heuristic score table
+  FutureCostTable futureCostTable;
+  // Cross-sentence cache of the best translation scores of source
+  // phrases, the first element is false if the phrase has no
+  // translations
+  bool futureCostCaching;
+  std::map<std::vector<WordIndex>, std::pair<bool, Score>> futureCostCache;
+  std::vector<std::pair<std::string, float>> futureCostCacheWeights;
+  float futureCostCacheW;
   // Additional data structures to store information about heuristics
   std::vector<LgProb> refHeurLmLgProb;
   std::vector<LgProb> prefHeurLmLgProb;
@@ -179,6 +199,15 @@ protected:
   void extract_gaps(const Bitset<MAX_SENTENCE_LENGTH_ALLOWED>& hypKey,
                     std::vector<std::pair<PositionIndex, PositionIndex>>& gaps);
   unsigned int get_num_gaps(const Bitset<MAX_SENTENCE_LENGTH_ALLOWED>& hypKey);
+  void expandLazily(const Hypothesis& hyp, std::vector<Hypothesis>& hypVec,
+                    std::vector<std::vector<Score>>& scrCompVec);
+  // Cube pruning version of expand(), only the P best expansions
+  // according to the score of the translation options, the distortion
+  // and the heuristic are scored
+  Score heuristicLocaltDelta(const std::pair<PositionIndex, PositionIndex>& gap, PositionIndex srcLeft,
+                             PositionIndex srcRight);
+  // Obtains the change of the local t heuristic when the source
+  // phrase [srcLeft,srcRight] of the given gap is covered
 
   // Specific phrase-based functions
   virtual void extendHypDataIdx(PositionIndex srcLeft, PositionIndex srcRight,
@@ -189,6 +218,10 @@ protected:
   // Get N-best translations for a subphrase of the source sentence
   // to be translated .  If N is between 0 and 1 then N represents a
   // threshold.
+  bool getHypDataVecForGap(const Hypothesis& hyp, PositionIndex srcLeft, PositionIndex srcRight,
+                           std::vector<HypDataType>& hypDataTypeVec, std::vector<Score>& optionScores, float N);
+  // The same as the previous function, but also obtains the scores of
+  // the translation options, sorted in decreasing order
   virtual bool getHypDataVecForGapRef(const Hypothesis& hyp, PositionIndex srcLeft, PositionIndex srcRight,
                                       std::vector<HypDataType>& hypDataTypeVec, float N);
   // This function is identical to the previous function but is to
@@ -309,6 +342,10 @@ protected:
   // Heuristic related functions
   virtual Score calcHeuristicScore(const Hypothesis& hyp);
   void initHeuristicLocalt(int maxSrcPhraseLength);
+  bool getBestTransScoreFor_s_(const std::vector<WordIndex>& s_, Score& bestScore);
+  // Obtains the best heuristic score of the translations of s_,
+  // returns false if s_ has no translations
+  void checkFutureCostCache(void);
   Score heurLmScoreLt(std::vector<WordIndex>& t_);
   Score heurLmScoreLtNoAdmiss(std::vector<WordIndex>& t_);
   Score calcRefLmHeurScore(const Hypothesis& hyp);
@@ -342,6 +379,9 @@ _phraseBasedTransModel<HYPOTHESIS>::_phraseBasedTransModel(void) : BasePbTransMo
 
   // Initially, no heuristic is used
   heuristicId = NO_HEURISTIC;
+
+  futureCostCaching = false;
+  futureCostCacheW = 0;
 }
 
 template <class HYPOTHESIS>
@@ -389,6 +429,7 @@ bool _phraseBasedTransModel<HYPOTHESIS>::loadLangModel(const char* prefixFileNam
   int err;
 
   langModelInfo->langModelPars.languageModelFileName = prefixFileName;
+  clearFutureCostCache();
 
   // Initializes language model
   if (langModelInfo->langModel->load(prefixFileName, verbose) == THOT_ERROR)
@@ -412,6 +453,7 @@ bool _phraseBasedTransModel<HYPOTHESIS>::loadAligModel(const char* prefixFileNam
   phraseModelInfo->phraseModelPars.srcTrainVocabFileName = "";
   phraseModelInfo->phraseModelPars.trgTrainVocabFileName = "";
   phraseModelInfo->phraseModelPars.readTablePrefix = prefixFileName;
+  clearFutureCostCache();
 
   // Load phrase model
   if (this->phraseModelInfo->invPhraseModel->load(prefixFileName, verbose) != 0)
@@ -450,6 +492,7 @@ void _phraseBasedTransModel<HYPOTHESIS>::clear(void)
   langModelInfo->langModel->clear();
   langModelInfo->wpModel->clear();
   langModelInfo->wordPredictor.clear();
+  clearFutureCostCache();
   // Set state info
   state = MODEL_IDLE_STATE;
 }
@@ -655,7 +698,7 @@ void _phraseBasedTransModel<HYPOTHESIS>::clearTempVars(void)
   initTmToLmVocabMap();
 
   // Clear information of the heuristic used in the translation
-  heuristicScoreVec.clear();
+  futureCostTable.clear();
 
   // Clear additional heuristic information
   refHeurLmLgProb.clear();
@@ -782,97 +825,109 @@ void _phraseBasedTransModel<HYPOTHESIS>::initHeuristic(unsigned int maxSrcPhrase
 template <class HYPOTHESIS>
 void _phraseBasedTransModel<HYPOTHESIS>::initHeuristicLocalt(int maxSrcPhraseLength)
 {
-  std::vector<Score> row;
-  NbestTableNode<PhraseTransTableNodeData> ttNode;
-  NbestTableNode<PhraseTransTableNodeData>::iterator ttNodeIter;
-  Score compositionProduct;
-  Score bestScore_ts = 0;
-  Score score_ts;
-  std::vector<WordIndex> s_;
-
   unsigned int J = pbtmInputVars.nsrcSentIdVec.size() - 1;
-  heuristicScoreVec.clear();
-  // Initialize row vector
-  for (unsigned int j = 0; j < J; ++j)
-    row.push_back(-FLT_MAX);
-  // Insert rows into t-heuristic table
-  for (unsigned int j = 0; j < J; ++j)
-    heuristicScoreVec.push_back(row);
-
-  // Fill the t-heuristic table
-  for (unsigned int y = 0; y < J; ++y)
-  {
-    for (unsigned int x = J - y - 1; x < J; ++x)
+  futureCostTable.init(J);
+  if (futureCostCaching)
+    checkFutureCostCache();
+
+  // Fill the t-heuristic table with the scores of the best
+  // translations of each span
+  std::vector<WordIndex> s_;
+  for (unsigned int left = 0; left < J; ++left)
+  {
+    s_.clear();
+    for (unsigned int right = left; right < J; ++right)
     {
-      // obtain source phrase
-      unsigned int segmRightMostj = y;
-      unsigned int segmLeftMostj = J - x - 1;
-      s_.clear();
+      unsigned int length = right - left + 1;
+      if (length > 1 && length > (unsigned int)maxSrcPhraseLength)
+        break;
+      s_.push_back(pbtmInputVars.nsrcSentIdVec[right + 1]);
 
-      // obtain score for best translation
-      if ((segmRightMostj - segmLeftMostj) + 1 > (unsigned int)maxSrcPhraseLength)
-      {
-        ttNode.clear();
-      }
-      else
-      {
-        for (unsigned int j = segmLeftMostj; j <= segmRightMostj; ++j)
-          s_.push_back(pbtmInputVars.nsrcSentIdVec[j + 1]);
+      Score bestScore_ts;
+      if (length <= (unsigned int)maxSrcPhraseLength && getBestTransScoreFor_s_(s_, bestScore_ts))
+        futureCostTable.set(left, right, bestScore_ts);
+      else if (length == 1)
+        futureCostTable.set(left, right, unkWordScoreHeur());
+    }
+  }
 
-        // obtain translations for s_
-        getNbestTransFor_s_(s_, ttNode, this->pbTransModelPars.W);
-        if (ttNode.size() != 0) // Obtain best p(s_|t_)
-        {
-          bestScore_ts = -FLT_MAX;
-          for (ttNodeIter = ttNode.begin(); ttNodeIter != ttNode.end(); ++ttNodeIter)
-          {
-            // Obtain phrase to phrase translation probability
-            score_ts = phrScore_s_t_(s_, ttNodeIter->second) + phrScore_t_s_(s_, ttNodeIter->second);
-            // Obtain language model heuristic estimation
-            //            score_ts+=heurLmScoreLt(ttNodeIter->second);
-            score_ts += heurLmScoreLtNoAdmiss(ttNodeIter->second);
-
-            if (bestScore_ts < score_ts)
-              bestScore_ts = score_ts;
-          }
-        }
-      }
+  // Complete the table with the best segmentation of each span
+  futureCostTable.compose();
+}
 
-      // Check source phrase length
-      if (x == J - y - 1)
-      {
-        // source phrase has only one word
-        if (ttNode.size() != 0)
-        {
-          heuristicScoreVec[y][x] = bestScore_ts;
-        }
-        else
-        {
-          heuristicScoreVec[y][x] = unkWordScoreHeur();
-        }
-      }
-      else
-      {
-        // source phrase has more than one word
-        if (ttNode.size() != 0)
-        {
-          heuristicScoreVec[y][x] = bestScore_ts;
-        }
-        else
-        {
-          heuristicScoreVec[y][x] = -FLT_MAX;
-        }
-        for (unsigned int z = J - x - 1; z < y; ++z)
-        {
-          compositionProduct = heuristicScoreVec[z][x] + heuristicScoreVec[y][J - 2 - z];
-          if (heuristicScoreVec[y][x] < compositionProduct)
-          {
-            heuristicScoreVec[y][x] = compositionProduct;
-          }
-        }
-      }
+template <class HYPOTHESIS>
+bool _phraseBasedTransModel<HYPOTHESIS>::getBestTransScoreFor_s_(const std::vector<WordIndex>& s_, Score& bestScore)
+{
+  if (futureCostCaching)
+  {
+    typename std::map<std::vector<WordIndex>, std::pair<bool, Score>>::const_iterator iter = futureCostCache.find(s_);
+    if (iter != futureCostCache.end())
+    {
+      bestScore = iter->second.second;
+      return iter->second.first;
     }
   }
+
+  // obtain translations for s_
+  NbestTableNode<PhraseTransTableNodeData> ttNode;
+  getNbestTransFor_s_(s_, ttNode, this->pbTransModelPars.W);
+  bestScore = -FLT_MAX;
+  for (NbestTableNode<PhraseTransTableNodeData>::iterator ttNodeIter = ttNode.begin(); ttNodeIter != ttNode.end();
+       ++ttNodeIter)
+  {
+    // Obtain phrase to phrase translation probability
+    Score score_ts = phrScore_s_t_(s_, ttNodeIter->second) + phrScore_t_s_(s_, ttNodeIter->second);
+    // Obtain language model heuristic estimation
+    //            score_ts+=heurLmScoreLt(ttNodeIter->second);
+    score_ts += heurLmScoreLtNoAdmiss(ttNodeIter->second);
+
+    if (bestScore < score_ts)
+      bestScore = score_ts;
+  }
+
+  if (futureCostCaching)
+  {
+    if (futureCostCache.size() >= FUTURE_COST_CACHE_MAX_SIZE)
+      futureCostCache.clear();
+    futureCostCache[s_] = std::make_pair(ttNode.size() != 0, bestScore);
+  }
+  return ttNode.size() != 0;
+}
+
+template <class HYPOTHESIS>
+void _phraseBasedTransModel<HYPOTHESIS>::checkFutureCostCache(void)
+{
+  // The cached scores are only valid for the weights used to
+  // calculate them
+  std::vector<std::pair<std::string, float>> compWeights;
+  this->getWeights(compWeights);
+  if (compWeights != futureCostCacheWeights || this->pbTransModelPars.W != futureCostCacheW)
+  {
+    futureCostCache.clear();
+    futureCostCacheWeights = compWeights;
+    futureCostCacheW = this->pbTransModelPars.W;
+  }
+}
+
+template <class HYPOTHESIS>
+void _phraseBasedTransModel<HYPOTHESIS>::setFutureCostCaching(bool enabled)
+{
+  futureCostCaching = enabled;
+  if (!futureCostCaching)
+    clearFutureCostCache();
+}
+
+template <class HYPOTHESIS>
+bool _phraseBasedTransModel<HYPOTHESIS>::getFutureCostCaching() const
+{
+  return futureCostCaching;
+}
+
+template <class HYPOTHESIS>
+void _phraseBasedTransModel<HYPOTHESIS>::clearFutureCostCache()
+{
+  futureCostCache.clear();
+  futureCostCacheWeights.clear();
 }
 
 template <class HYPOTHESIS>
@@ -967,14 +1022,12 @@ Score _phraseBasedTransModel<HYPOTHESIS>::heuristicLocalt(const Hypothesis& hyp)
   if (state == MODEL_TRANS_STATE)
   {
     LgProb result = 0;
-    unsigned int J;
     std::vector<std::pair<PositionIndex, PositionIndex>> gaps;
 
-    J = pbtmInputVars.srcSentVec.size();
     this->extract_gaps(hyp, gaps);
     for (unsigned int i = 0; i < gaps.size(); ++i)
     {
-      result += heuristicScoreVec[gaps[i].second - 1][J - gaps[i].first];
+      result += futureCostTable.get(gaps[i].first - 1, gaps[i].second - 1);
     }
     return result;
   }
@@ -999,12 +1052,11 @@ Score _phraseBasedTransModel<HYPOTHESIS>::heuristicLocaltd(const Hypothesis& hyp
     Score result = 0;
 
     // Get local t heuristic information
-    unsigned int J = pbtmInputVars.srcSentVec.size();
     std::vector<std::pair<PositionIndex, PositionIndex>> gaps;
     this->extract_gaps(hyp, gaps);
     for (unsigned int i = 0; i < gaps.size(); ++i)
     {
-      result += heuristicScoreVec[gaps[i].second - 1][J - gaps[i].first];
+      result += futureCostTable.get(gaps[i].first - 1, gaps[i].second - 1);
     }
 
     // Distortion heuristic information
@@ -1525,6 +1577,13 @@ void _phraseBasedTransModel<HYPOTHESIS>::expand(const Hypothesis& hyp, std::vect
   std::vector<HypDataType> hypDataVec;
   std::vector<Score> scoreComponents;
 
+  // Use cube pruning if a pop limit is given
+  if (this->pbTransModelPars.P > 0)
+  {
+    expandLazily(hyp, hypVec, scrCompVec);
+    return;
+  }
+
   hypVec.clear();
   scrCompVec.clear();
 
@@ -1587,6 +1646,104 @@ void _phraseBasedTransModel<HYPOTHESIS>::expand(const Hypothesis& hyp, std::vect
   }
 }
 
+template <class HYPOTHESIS>
+void _phraseBasedTransModel<HYPOTHESIS>::expandLazily(const Hypothesis& hyp, std::vector<Hypothesis>& hypVec,
+                                                      std::vector<std::vector<Score>>& scrCompVec)
+{
+  typedef std::pair<Score, std::pair<unsigned int, unsigned int>> Candidate;
+  std::vector<std::pair<PositionIndex, PositionIndex>> gaps;
+  std::vector<std::vector<HypDataType>> spanHypDataVecs;
+  std::vector<std::vector<Score>> spanOptionScores;
+  std::vector<Score> spanEstimates;
+  std::priority_queue<Candidate> candidates;
+  Hypothesis extHyp;
+  std::vector<Score> scoreComponents;
+
+  hypVec.clear();
+  scrCompVec.clear();
+
+  // Obtain the sorted translation options of each source phrase that
+  // can be covered, the estimation of a phrase combines the distortion
+  // and the change of the heuristic
+  extract_gaps(hyp, gaps);
+  PositionIndex lastSrcPosCovered = getLastSrcPosCovered(hyp);
+  for (unsigned int k = 0; k < gaps.size(); ++k)
+  {
+    unsigned int gap_length = gaps[k].second - gaps[k].first + 1;
+    for (unsigned int x = 0; x < gap_length && x <= this->pbTransModelPars.U; ++x)
+    {
+      for (unsigned int y = x; y < gap_length; ++y)
+      {
+        unsigned int segmRightMostj = gaps[k].first + y;
+        unsigned int segmLeftMostj = gaps[k].first + x;
+        bool srcPhraseIsAffectedByConstraint =
+            this->transMetadata->srcPhrAffectedByConstraint(std::make_pair(segmLeftMostj, segmRightMostj));
+        if ((segmRightMostj - segmLeftMostj) + 1 > this->pbTransModelPars.A && !srcPhraseIsAffectedByConstraint)
+          break;
+
+        std::vector<HypDataType> hypDataVec;
+        std::vector<Score> optionScores;
+        if (getHypDataVecForGap(hyp, segmLeftMostj, segmRightMostj, hypDataVec, optionScores,
+                                this->pbTransModelPars.W))
+        {
+          Score estimate = srcJumpScore(abs((int)segmLeftMostj - (int)(lastSrcPosCovered + 1)))
+                         + heuristicLocaltDelta(gaps[k], segmLeftMostj, segmRightMostj);
+          candidates.push(Candidate(estimate + optionScores[0], std::make_pair(spanHypDataVecs.size(), 0)));
+          spanHypDataVecs.push_back(hypDataVec);
+          spanOptionScores.push_back(optionScores);
+          spanEstimates.push_back(estimate);
+        }
+      }
+    }
+  }
+
+  // Score the expansions in decreasing order of estimation until the
+  // pop limit is reached, the next option of a source phrase is only
+  // considered once the previous one has been scored
+  while (!candidates.empty() && hypVec.size() < this->pbTransModelPars.P)
+  {
+    unsigned int span = candidates.top().second.first;
+    unsigned int option = candidates.top().second.second;
+    candidates.pop();
+
+    this->incrScore(hyp, spanHypDataVecs[span][option], extHyp, scoreComponents);
+    SourceSegmentation srcSegm;
+    std::vector<PositionIndex> trgSegmCuts;
+    extHyp.getPhraseAlign(srcSegm, trgSegmCuts);
+    std::vector<std::string> targetWordVec = this->getTransInPlainTextVec(extHyp);
+    if (this->transMetadata->translationSatisfiesConstraints(srcSegm, trgSegmCuts, targetWordVec))
+    {
+      hypVec.push_back(extHyp);
+      scrCompVec.push_back(scoreComponents);
+    }
+
+    if (option + 1 < spanHypDataVecs[span].size())
+    {
+      candidates.push(Candidate(spanEstimates[span] + spanOptionScores[span][option + 1],
+                                std::make_pair(span, option + 1)));
+    }
+  }
+#ifdef THOT_STATS
+  this->basePbTmStats.transOptions += hypVec.size();
+  ++this->basePbTmStats.getTransCalls;
+#endif
+}
+
+template <class HYPOTHESIS>
+Score _phraseBasedTransModel<HYPOTHESIS>::heuristicLocaltDelta(const std::pair<PositionIndex, PositionIndex>& gap,
+                                                               PositionIndex srcLeft, PositionIndex srcRight)
+{
+  if (heuristicId == NO_HEURISTIC || futureCostTable.empty())
+    return 0;
+
+  Score delta = -futureCostTable.get(gap.first - 1, gap.second - 1);
+  if (srcLeft > gap.first)
+    delta += futureCostTable.get(gap.first - 1, srcLeft - 2);
+  if (srcRight < gap.second)
+    delta += futureCostTable.get(srcRight, gap.second - 1);
+  return delta;
+}
+
 template <class HYPOTHESIS>
 void _phraseBasedTransModel<HYPOTHESIS>::expand_ref(const Hypothesis& hyp, std::vector<Hypothesis>& hypVec,
                                                     std::vector<std::vector<Score>>& scrCompVec)
@@ -1833,6 +1990,16 @@ template <class HYPOTHESIS>
 bool _phraseBasedTransModel<HYPOTHESIS>::getHypDataVecForGap(const Hypothesis& hyp, PositionIndex srcLeft,
                                                              PositionIndex srcRight,
                                                              std::vector<HypDataType>& hypDataTypeVec, float N)
+{
+  std::vector<Score> optionScores;
+  return getHypDataVecForGap(hyp, srcLeft, srcRight, hypDataTypeVec, optionScores, N);
+}
+
+template <class HYPOTHESIS>
+bool _phraseBasedTransModel<HYPOTHESIS>::getHypDataVecForGap(const Hypothesis& hyp, PositionIndex srcLeft,
+                                                             PositionIndex srcRight,
+                                                             std::vector<HypDataType>& hypDataTypeVec,
+                                                             std::vector<Score>& optionScores, float N)
 {
   NbestTableNode<PhraseTransTableNodeData> ttNode;
   NbestTableNode<PhraseTransTableNodeData>::iterator ttNodeIter;
@@ -1840,6 +2007,7 @@ bool _phraseBasedTransModel<HYPOTHESIS>::getHypDataVecForGap(const Hypothesis& h
   HypDataType newHypData;
 
   hypDataTypeVec.clear();
+  optionScores.clear();
 
   // Obtain translations for gap
   getTransForHypUncovGap(hyp, srcLeft, srcRight, ttNode, N);
@@ -1867,6 +2035,7 @@ bool _phraseBasedTransModel<HYPOTHESIS>::getHypDataVecForGap(const Hypothesis& h
     newHypData = hypData;
     extendHypDataIdx(srcLeft, srcRight, ttNodeIter->second, newHypData);
     hypDataTypeVec.push_back(newHypData);
+    optionScores.push_back(ttNodeIter->first);
   }
 
   // Return boolean value
@@ -69,6 +69,9 @@ public:
   unsigned int get_I_par() const;
   void set_breadthFirst(bool b);
   bool get_breadthFirst() const;
+  void copyParameters(const _stackDecoder& decoder);
+  // Copies the search parameters of 'decoder', so that both decoders
+  // explore the same hypotheses
 
   // Basic services
   Hypothesis translate(std::string s);
@@ -278,6 +281,17 @@ bool _stackDecoder<SMT_MODEL>::get_breadthFirst() const
   return breadthFirst;
 }
 
+template <class SMT_MODEL>
+void _stackDecoder<SMT_MODEL>::copyParameters(const _stackDecoder& decoder)
+{
+  S = decoder.S;
+  stack_ptr->setMaxStackSize(decoder.stack_ptr->getMaxStackSize());
+  I = decoder.I;
+  set_breadthFirst(decoder.breadthFirst);
+  applyBestScorePruning = decoder.applyBestScorePruning;
+  worstScoreAllowed = decoder.worstScoreAllowed;
+}
+
 template <class SMT_MODEL>
 void _stackDecoder<SMT_MODEL>::addgToHyp(Hypothesis& hyp)
 {
@@ -26,10 +26,63 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "nlp_common/AwkInputStream.h"
 #include "nlp_common/ErrorDefs.h"
+#include "stack_dec/ngram_match.h"
 
 #include <cmath>
 #include <iostream>
 
+namespace
+{
+//---------------
+// Reference implementation used when the n-grams of a sentence pair cannot be packed into 64-bit keys
+void prec_n_quadratic(const std::vector<std::string>& refsen, const std::vector<std::string>& syssen, unsigned int n,
+                      unsigned int& prec, unsigned int& total)
+{
+  unsigned int i;
+  unsigned int j;
+  unsigned int reftotal;
+  std::vector<bool> matched;
+
+  if (n > syssen.size())
+    total = 0;
+  else
+    total = syssen.size() - n + 1;
+
+  if (n > refsen.size())
+    reftotal = 0;
+  else
+    reftotal = refsen.size() - n + 1;
+
+  for (i = 0; i < reftotal; ++i)
+  {
+    matched.push_back(false);
+  }
+
+  prec = 0;
+  for (i = 0; i < total; ++i)
+  {
+    for (j = 0; j < reftotal; ++j)
+    {
+      bool match = true;
+      for (unsigned int k = 0; k < n; ++k)
+      {
+        if (syssen[i + k] != refsen[j + k])
+        {
+          match = false;
+          break;
+        }
+      }
+      if (match && !matched[j])
+      {
+        ++prec;
+        matched[j] = true;
+        break;
+      }
+    }
+  }
+}
+} // namespace
+
 //---------------
 int calc_bleu(const char* ref, const char* sys, float& bleu, float& bp, std::vector<float>& bleu_n, int verbosity)
 {
@@ -96,8 +149,8 @@ int calc_bleuf(FILE* reff, FILE* sysf, float& bleu, float& bp, std::vector<float
 
   while (refStream.getln())
   {
-    unsigned int prec_sent;
-    unsigned int total_sent;
+    std::vector<unsigned int> prec_sent;
+    std::vector<unsigned int> total_sent;
 
     bool ok = sysStream.getln();
     if (!ok)
@@ -139,14 +192,16 @@ int calc_bleuf(FILE* reff, FILE* sysf, float& bleu, float& bp, std::vector<float
     }
 
     // calculate precisions
+    BleuRefNgrams refNgrams(refsen);
+    refNgrams.precs(syssen, prec_sent, total_sent);
     for (i = 1; i <= MAX_N; ++i)
     {
-      prec_n(refsen, syssen, i, prec_sent, total_sent);
-      precs[i - 1] += prec_sent;
-      total[i - 1] += total_sent;
+      precs[i - 1] += prec_sent[i - 1];
+      total[i - 1] += total_sent[i - 1];
       if (verbosity)
       {
-        std::cerr << prec_sent << "|" << precs[i - 1] << " / " << total_sent << "|" << total[i - 1] << " ; ";
+        std::cerr << prec_sent[i - 1] << "|" << precs[i - 1] << " / " << total_sent[i - 1] << "|" << total[i - 1]
+                  << " ; ";
       }
     }
     if (verbosity)
@@ -193,51 +248,103 @@ int calc_bleuf(FILE* reff, FILE* sysf, float& bleu, float& bp, std::vector<float
 }
 
 //---------------
-void prec_n(std::vector<std::string> refsen, std::vector<std::string> syssen, unsigned int n, unsigned int& prec,
-            unsigned int& total)
+void prec_n(const std::vector<std::string>& refsen, const std::vector<std::string>& syssen, unsigned int n,
+            unsigned int& prec, unsigned int& total)
 {
-  unsigned int i;
-  unsigned int j;
-  unsigned int reftotal;
-  std::vector<bool> matched;
+  BleuRefNgrams refNgrams(refsen, n);
+  refNgrams.prec(syssen, n, prec, total);
+}
 
-  if (n > syssen.size())
-    total = 0;
-  else
-    total = syssen.size() - n + 1;
+//---------------
+BleuRefNgrams::BleuRefNgrams(const std::vector<std::string>& refsen, unsigned int maxN)
+    : refWords(refsen), maxOrder(maxN)
+{
+  // Intern reference words, id 0 is reserved for words not appearing in the reference
+  for (unsigned int i = 0; i < refsen.size(); ++i)
+    vocab.insert(std::make_pair(refsen[i], (uint64_t)vocab.size() + 1));
+
+  bitsPerWord = ngram_key_bits(vocab.size());
+  packed = maxOrder * bitsPerWord <= 64;
+  if (!packed)
+    return;
+
+  std::vector<uint64_t> ids;
+  obtainIds(refsen, ids);
+  refKeys.resize(maxOrder);
+  for (unsigned int n = 1; n <= maxOrder; ++n)
+    obtainKeys(ids, n, refKeys[n - 1]);
+}
 
-  if (n > refsen.size())
-    reftotal = 0;
-  else
-    reftotal = refsen.size() - n + 1;
+//---------------
+void BleuRefNgrams::precs(const std::vector<std::string>& syssen, std::vector<unsigned int>& prec,
+                          std::vector<unsigned int>& total) const
+{
+  prec.assign(maxOrder, 0);
+  total.assign(maxOrder, 0);
 
-  for (i = 0; i < reftotal; ++i)
+  if (!packed)
   {
-    matched.push_back(false);
+    for (unsigned int n = 1; n <= maxOrder; ++n)
+      prec_n_quadratic(refWords, syssen, n, prec[n - 1], total[n - 1]);
+    return;
   }
 
-  prec = 0;
-  for (i = 0; i < total; ++i)
+  std::vector<uint64_t> ids;
+  std::vector<uint64_t> keys;
+  obtainIds(syssen, ids);
+  for (unsigned int n = 1; n <= maxOrder; ++n)
   {
-    for (j = 0; j < reftotal; ++j)
-    {
-      bool match = true;
-      for (unsigned int k = 0; k < n; ++k)
-      {
-        if (syssen[i + k] != refsen[j + k])
-        {
-          match = false;
-          break;
-        }
-      }
-      if (match && !matched[j])
-      {
-        ++prec;
-        matched[j] = true;
-        break;
-      }
-    }
+    total[n - 1] = n > syssen.size() ? 0 : syssen.size() - n + 1;
+    obtainKeys(ids, n, keys);
+    prec[n - 1] = clipped_ngram_matches(keys, refKeys[n - 1]);
+  }
+}
+
+//---------------
+void BleuRefNgrams::prec(const std::vector<std::string>& syssen, unsigned int n, unsigned int& prec,
+                         unsigned int& total) const
+{
+  if (!packed || n > maxOrder)
+  {
+    prec_n_quadratic(refWords, syssen, n, prec, total);
+    return;
+  }
+
+  std::vector<uint64_t> ids;
+  std::vector<uint64_t> keys;
+  obtainIds(syssen, ids);
+  obtainKeys(ids, n, keys);
+  total = n > syssen.size() ? 0 : syssen.size() - n + 1;
+  prec = clipped_ngram_matches(keys, refKeys[n - 1]);
+}
+
+//---------------
+void BleuRefNgrams::obtainIds(const std::vector<std::string>& sen, std::vector<uint64_t>& ids) const
+{
+  ids.clear();
+  ids.reserve(sen.size());
+  for (unsigned int i = 0; i < sen.size(); ++i)
+  {
+    std::unordered_map<std::string, uint64_t>::const_iterator iter = vocab.find(sen[i]);
+    ids.push_back(iter == vocab.end() ? 0 : iter->second);
+  }
+}
+
+//---------------
+void BleuRefNgrams::obtainKeys(const std::vector<uint64_t>& ids, unsigned int n, std::vector<uint64_t>& keys) const
+{
+  // n-grams containing words not in the reference can never match, so they are not stored
+  keys.clear();
+  for (size_t i = 0; i + n <= ids.size(); ++i)
+  {
+    uint64_t key = 0;
+    unsigned int k;
+    for (k = 0; k < n && ids[i + k] != 0; ++k)
+      key = (key << bitsPerWord) | ids[i + k];
+    if (k == n)
+      keys.push_back(key);
   }
+  std::sort(keys.begin(), keys.end());
 }
 
 //---------------
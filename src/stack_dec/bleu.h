@@ -24,16 +24,49 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <stdint.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #define MAX_N 4
 
+/**
+ * @brief Reference-side n-gram table used to compute clipped BLEU matches.
+ *
+ * Reference words are interned to small integer ids and the n-grams of orders 1 to maxN are packed into sorted
+ * 64-bit keys, so that any number of candidates can be matched against the same reference without comparing
+ * strings. The object is not modified after construction and can be shared between threads.
+ */
+class BleuRefNgrams
+{
+public:
+  BleuRefNgrams(const std::vector<std::string>& refsen, unsigned int maxN = MAX_N);
+
+  // Obtain clipped matches and totals of a candidate for the n-gram orders 1 to maxN
+  void precs(const std::vector<std::string>& syssen, std::vector<unsigned int>& prec,
+             std::vector<unsigned int>& total) const;
+
+  // Obtain clipped matches and total of a candidate for the n-gram order n (n <= maxN)
+  void prec(const std::vector<std::string>& syssen, unsigned int n, unsigned int& prec, unsigned int& total) const;
+
+private:
+  std::vector<std::string> refWords;
+  unsigned int maxOrder;
+  bool packed;
+  unsigned int bitsPerWord;
+  std::unordered_map<std::string, uint64_t> vocab;
+  std::vector<std::vector<uint64_t>> refKeys;
+
+  void obtainIds(const std::vector<std::string>& sen, std::vector<uint64_t>& ids) const;
+  void obtainKeys(const std::vector<uint64_t>& ids, unsigned int n, std::vector<uint64_t>& keys) const;
+};
+
 int calc_bleu(const char* ref, const char* sys, float& bleu, float& bp, std::vector<float>& bleu_n, int verbosity);
 
 int calc_bleuf(FILE* reff, FILE* sysf, float& bleu, float& bp, std::vector<float>& bleu_n, int verbosity);
 
-void prec_n(std::vector<std::string> refsen, std::vector<std::string> syssen, unsigned int n, unsigned int& prec,
-            unsigned int& total);
+void prec_n(const std::vector<std::string>& refsen, const std::vector<std::string>& syssen, unsigned int n,
+            unsigned int& prec, unsigned int& total);
 
 double my_log(double x);
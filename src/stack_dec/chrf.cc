@@ -27,9 +27,101 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "nlp_common/AwkInputStream.h"
 #include "nlp_common/ErrorDefs.h"
 #include "nlp_common/StrProcUtils.h"
+#include "stack_dec/ngram_match.h"
 
 #include <iostream>
 
+namespace
+{
+unsigned int ngram_total(const std::string& sentence, unsigned int ngramLength)
+{
+  return ngramLength > sentence.size() ? 0 : sentence.size() - ngramLength + 1;
+}
+
+// Pack the bytes of every character n-gram into a 64-bit key (ngramLength <= 8)
+void obtain_ngram_keys(const std::string& sentence, unsigned int ngramLength, std::vector<uint64_t>& keys)
+{
+  keys.clear();
+  unsigned int total = ngram_total(sentence, ngramLength);
+  keys.reserve(total);
+  for (unsigned int i = 0; i < total; ++i)
+  {
+    uint64_t key = 0;
+    for (unsigned int k = 0; k < ngramLength; ++k)
+      key = (key << 8) | (unsigned char)sentence[i + k];
+    keys.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+}
+
+// Reference implementation used for n-grams that do not fit into 64-bit keys
+unsigned int count_ngrams_quadratic(const std::string& refSentence, const std::string& sysSentence,
+                                    unsigned int ngramLength)
+{
+  unsigned int i;
+  unsigned int j;
+  unsigned int countsys = 0;
+  unsigned int countref = 0;
+  unsigned int systotal = ngram_total(sysSentence, ngramLength);
+  unsigned int reftotal = ngram_total(refSentence, ngramLength);
+  std::vector<bool> matched;
+
+  for (i = 0; i < reftotal; ++i)
+  {
+    matched.push_back(false);
+  }
+  for (i = 0; i < systotal; ++i)
+  {
+    for (j = 0; j < reftotal; ++j)
+    {
+      bool match = true;
+      for (unsigned int k = 0; k < ngramLength; ++k)
+      {
+        if (sysSentence[i + k] != refSentence[j + k])
+        {
+          match = false;
+          break;
+        }
+      }
+      if (match && !matched[j])
+      {
+        ++countsys;
+        matched[j] = true;
+        break;
+      }
+    }
+  }
+  matched.clear();
+  for (i = 0; i < systotal; ++i)
+  {
+    matched.push_back(false);
+  }
+  for (i = 0; i < reftotal; ++i)
+  {
+    for (j = 0; j < systotal; ++j)
+    {
+      bool match = true;
+      for (unsigned int k = 0; k < ngramLength; ++k)
+      {
+        if (refSentence[i + k] != sysSentence[j + k])
+        {
+          match = false;
+          break;
+        }
+      }
+      if (match && !matched[j])
+      {
+        ++countref;
+        matched[j] = true;
+        break;
+      }
+    }
+  }
+
+  return std::min(countref, countsys);
+}
+} // namespace
+
 //---------------
 int calculate_chrf_file_name(const char* ref, const char* sys, double& chrf, std::vector<double>& chrf_n, int verbosity)
 {
@@ -190,79 +282,22 @@ void calculate_chrf(const std::string& refSentence, const std::string& sysSenten
 void count_ngrams(const std::string& refSentence, const std::string& sysSentence, unsigned int ngramLength,
                   float& precision, float& recall, unsigned int& count)
 {
-  unsigned int i;
-  unsigned int j;
-  unsigned int countsys = 0;
-  unsigned int countref = 0;
-  unsigned int systotal;
-  unsigned int reftotal;
-  std::vector<bool> matched;
-
-  if (ngramLength > sysSentence.size())
-    systotal = 0;
-  else
-    systotal = sysSentence.size() - ngramLength + 1;
-
-  if (ngramLength > refSentence.size())
-    reftotal = 0;
-  else
-    reftotal = refSentence.size() - ngramLength + 1;
-
-  count = 0;
+  unsigned int systotal = ngram_total(sysSentence, ngramLength);
+  unsigned int reftotal = ngram_total(refSentence, ngramLength);
 
-  for (i = 0; i < reftotal; ++i)
-  {
-    matched.push_back(false);
-  }
-  for (i = 0; i < systotal; ++i)
-  {
-    for (j = 0; j < reftotal; ++j)
-    {
-      bool match = true;
-      for (unsigned int k = 0; k < ngramLength; ++k)
-      {
-        if (sysSentence[i + k] != refSentence[j + k])
-        {
-          match = false;
-          break;
-        }
-      }
-      if (match && !matched[j])
-      {
-        ++countsys;
-        matched[j] = true;
-        break;
-      }
-    }
-  }
-  matched.clear();
-  for (i = 0; i < systotal; ++i)
+  if (ngramLength <= sizeof(uint64_t))
   {
-    matched.push_back(false);
+    std::vector<uint64_t> sysKeys;
+    std::vector<uint64_t> refKeys;
+    obtain_ngram_keys(sysSentence, ngramLength, sysKeys);
+    obtain_ngram_keys(refSentence, ngramLength, refKeys);
+    count = clipped_ngram_matches(sysKeys, refKeys);
   }
-  for (i = 0; i < reftotal; ++i)
+  else
   {
-    for (j = 0; j < systotal; ++j)
-    {
-      bool match = true;
-      for (unsigned int k = 0; k < ngramLength; ++k)
-      {
-        if (refSentence[i + k] != sysSentence[j + k])
-        {
-          match = false;
-          break;
-        }
-      }
-      if (match && !matched[j])
-      {
-        ++countref;
-        matched[j] = true;
-        break;
-      }
-    }
+    count = count_ngrams_quadratic(refSentence, sysSentence, ngramLength);
   }
 
-  count = std::min(countref, countsys);
   precision = systotal == 0 ? 1 : (float)count / systotal;
   recall = reftotal == 0 ? 1 : (float)count / reftotal;
 }
@@ -0,0 +1,71 @@
+/*
+thot package for statistical machine translation
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ngram_match.h
+ *
+ * @brief Helpers to count clipped n-gram matches over n-grams packed into
+ * 64-bit integer keys.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+// Number of bits needed to represent values in the range [0, maxValue]
+inline unsigned int ngram_key_bits(uint64_t maxValue)
+{
+  unsigned int bits = 1;
+  while (bits < 64 && (maxValue >> bits) != 0)
+    ++bits;
+  return bits;
+}
+
+// Sum over the distinct keys of min(count in a, count in b); both vectors must be sorted
+inline unsigned int clipped_ngram_matches(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b)
+{
+  unsigned int matches = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.size() && j < b.size())
+  {
+    if (a[i] < b[j])
+      ++i;
+    else if (b[j] < a[i])
+      ++j;
+    else
+    {
+      uint64_t key = a[i];
+      unsigned int countA = 0;
+      unsigned int countB = 0;
+      while (i < a.size() && a[i] == key)
+      {
+        ++countA;
+        ++i;
+      }
+      while (j < b.size() && b[j] == key)
+      {
+        ++countB;
+        ++j;
+      }
+      matches += std::min(countA, countB);
+    }
+  }
+  return matches;
+}
@@ -32,6 +32,19 @@ public:
   virtual void setVariationalBayes(bool variationalBayes) = 0;
   virtual bool getVariationalBayes() = 0;
 
+  // Pruning of the translation options created when training starts:
+  // only the maxTranslationOptions targets with the highest Dice
+  // coefficient are kept for each source word (0 means no limit), and
+  // targets whose coefficient is below minTranslationOptionDice are
+  // discarded. The coefficient of a word pair is 2 * n(s, t) / (n(s) +
+  // n(t)), where n counts the training sentence pairs in which the words
+  // appear, so it lies in [0, 1]. Pruned word pairs keep the probability
+  // of unseen pairs
+  virtual void setMaxTranslationOptions(unsigned int maxTranslationOptions) = 0;
+  virtual unsigned int getMaxTranslationOptions() = 0;
+  virtual void setMinTranslationOptionDice(double minTranslationOptionDice) = 0;
+  virtual double getMinTranslationOptionDice() = 0;
+
   // Functions to read and add sentence pairs
   virtual bool readSentencePairs(const char* srcFileName, const char* trgFileName, const char* sentCountsFile,
                                  std::pair<unsigned int, unsigned int>& sentRange, int verbose = 0) = 0;
@@ -3,6 +3,10 @@
 #include "nlp_common/ErrorDefs.h"
 #include "nlp_common/StrProcUtils.h"
 
+#include <algorithm>
+#include <future>
+#include <numeric>
+
 #ifdef _WIN32
 #define NOMINMAX
 #include <Windows.h>
@@ -11,13 +15,15 @@
 using namespace std;
 
 AlignmentModelBase::AlignmentModelBase()
-    : alpha{0.01}, variationalBayes{false}, swVocab{make_shared<SingleWordVocab>()},
+    : alpha{0.01}, variationalBayes{false}, maxTranslationOptions{0}, minTranslationOptionDice{0},
+      swVocab{make_shared<SingleWordVocab>()},
       sentenceHandler{make_shared<LightSentenceHandler>()}, wordClasses{std::make_shared<WordClasses>()}
 {
 }
 
 AlignmentModelBase::AlignmentModelBase(AlignmentModelBase& model)
-    : alpha{model.alpha}, variationalBayes{model.variationalBayes}, swVocab{model.swVocab},
+    : alpha{model.alpha}, variationalBayes{model.variationalBayes}, maxTranslationOptions{model.maxTranslationOptions},
+      minTranslationOptionDice{model.minTranslationOptionDice}, swVocab{model.swVocab},
       sentenceHandler{model.sentenceHandler}, wordClasses{model.wordClasses}
 {
 }
@@ -40,6 +46,26 @@ bool AlignmentModelBase::getVariationalBayes()
   return variationalBayes;
 }
 
+void AlignmentModelBase::setMaxTranslationOptions(unsigned int maxTranslationOptions)
+{
+  this->maxTranslationOptions = maxTranslationOptions;
+}
+
+unsigned int AlignmentModelBase::getMaxTranslationOptions()
+{
+  return maxTranslationOptions;
+}
+
+void AlignmentModelBase::setMinTranslationOptionDice(double minTranslationOptionDice)
+{
+  this->minTranslationOptionDice = minTranslationOptionDice;
+}
+
+double AlignmentModelBase::getMinTranslationOptionDice()
+{
+  return minTranslationOptionDice;
+}
+
 bool AlignmentModelBase::readSentencePairs(const char* srcFileName, const char* trgFileName, const char* sentCountsFile,
                                            pair<unsigned int, unsigned int>& sentRange, int verbose)
 {
@@ -348,11 +374,169 @@ bool AlignmentModelBase::loadVariationalBayes(const string& filename)
   return THOT_OK;
 }
 
+size_t AlignmentModelBase::addSentenceCooccurrences(const vector<WordIndex>& src, const vector<WordIndex>& trg,
+                                                    vector<vector<WordIndex>>& insertBuffer)
+{
+  vector<WordIndex> srcWords = src;
+  sort(srcWords.begin(), srcWords.end());
+  srcWords.erase(unique(srcWords.begin(), srcWords.end()), srcWords.end());
+  vector<WordIndex> trgWords = trg;
+  sort(trgWords.begin(), trgWords.end());
+  trgWords.erase(unique(trgWords.begin(), trgWords.end()), trgWords.end());
+
+  if (srcWords.back() >= insertBuffer.size())
+    insertBuffer.resize((size_t)srcWords.back() + 1);
+  if (srcWords.back() >= srcSentenceFreqs.size())
+    srcSentenceFreqs.resize((size_t)srcWords.back() + 1, 0);
+  if (trgWords.back() >= trgSentenceFreqs.size())
+    trgSentenceFreqs.resize((size_t)trgWords.back() + 1, 0);
+
+  for (const WordIndex s : srcWords)
+  {
+    ++srcSentenceFreqs[s];
+    insertBuffer[s].insert(insertBuffer[s].end(), trgWords.begin(), trgWords.end());
+  }
+  for (const WordIndex t : trgWords)
+    ++trgSentenceFreqs[t];
+  return srcWords.size() * trgWords.size();
+}
+
+void AlignmentModelBase::pruneTranslationOptions(LexCounts& lexCounts, LexTable& lexTable)
+{
+  bool pruning = maxTranslationOptions > 0 || minTranslationOptionDice > 0;
+
+#pragma omp parallel for schedule(dynamic)
+  for (int s = 0; s < (int)lexCounts.size(); ++s)
+  {
+    LexCountsElem& elem = lexCounts[s];
+    // The NULL word keeps all its translation options, since it may
+    // generate any target word
+    if (!pruning || s == NULL_WORD)
+    {
+      for (auto& entry : elem)
+        entry.second = 0;
+      continue;
+    }
+
+    vector<pair<double, WordIndex>> candidates;
+    for (auto& entry : elem)
+    {
+      double dice = 2 * entry.second / ((double)srcSentenceFreqs[s] + trgSentenceFreqs[entry.first]);
+      if (dice >= minTranslationOptionDice)
+        candidates.push_back(make_pair(dice, entry.first));
+    }
+    if (maxTranslationOptions > 0 && candidates.size() > maxTranslationOptions)
+    {
+      nth_element(candidates.begin(), candidates.begin() + maxTranslationOptions, candidates.end(),
+                  [](const pair<double, WordIndex>& a, const pair<double, WordIndex>& b) {
+                    return a.first > b.first || (a.first == b.first && a.second < b.second);
+                  });
+      candidates.resize(maxTranslationOptions);
+    }
+    sort(candidates.begin(), candidates.end(),
+         [](const pair<double, WordIndex>& a, const pair<double, WordIndex>& b) { return a.second < b.second; });
+
+    set<WordIndex> prunedTargets;
+    for (auto& entry : elem)
+      prunedTargets.insert(entry.first);
+    for (auto& candidate : candidates)
+      prunedTargets.erase(candidate.second);
+    lexTable.removeTransForSource(s, prunedTargets);
+
+    elem.clear();
+    for (auto& candidate : candidates)
+      elem[candidate.second] = 0;
+  }
+  srcSentenceFreqs.clear();
+  trgSentenceFreqs.clear();
+}
+
 bool AlignmentModelBase::sentenceLengthIsOk(const std::vector<WordIndex> sentence)
 {
   return !sentence.empty() && sentence.size() <= getMaxSentenceLength();
 }
 
+vector<WordIndex> AlignmentModelBase::getSrcSent(unsigned int n)
+{
+  vector<string> srcsStr;
+  vector<WordIndex> result;
+
+  sentenceHandler->getSrcSentence(n, srcsStr);
+  for (unsigned int i = 0; i < srcsStr.size(); ++i)
+  {
+    WordIndex widx = stringToSrcWordIndex(srcsStr[i]);
+    if (widx == UNK_WORD)
+      widx = addSrcSymbol(srcsStr[i]);
+    result.push_back(widx);
+  }
+  return result;
+}
+
+vector<WordIndex> AlignmentModelBase::getTrgSent(unsigned int n)
+{
+  vector<string> trgsStr;
+  vector<WordIndex> trgs;
+
+  sentenceHandler->getTrgSentence(n, trgsStr);
+  for (unsigned int i = 0; i < trgsStr.size(); ++i)
+  {
+    WordIndex widx = stringToTrgWordIndex(trgsStr[i]);
+    if (widx == UNK_WORD)
+      widx = addTrgSymbol(trgsStr[i]);
+    trgs.push_back(widx);
+  }
+  return trgs;
+}
+
+void AlignmentModelBase::processBatches(ProcessBatchFunc process)
+{
+  unsigned int n = 0;
+  auto readBatch = [this, &n]() {
+    vector<pair<vector<WordIndex>, vector<WordIndex>>> buffer;
+    vector<double> costs;
+    size_t cells = 0;
+    for (; n < numSentencePairs() && buffer.size() < ThreadBufferSize && cells < MaxBatchCells; ++n)
+    {
+      vector<WordIndex> src = getSrcSent(n);
+      vector<WordIndex> trg = getTrgSent(n);
+      if (sentenceLengthIsOk(src) && sentenceLengthIsOk(trg))
+      {
+        cells += (src.size() + 1) * (trg.size() + 1);
+        costs.push_back(getSentencePairCost((PositionIndex)src.size(), (PositionIndex)trg.size()));
+        buffer.push_back(make_pair(std::move(src), std::move(trg)));
+      }
+    }
+
+    // The order only depends on the corpus, ties keep the corpus order
+    vector<size_t> order(buffer.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&costs](size_t a, size_t b) { return costs[a] > costs[b]; });
+    vector<pair<vector<WordIndex>, vector<WordIndex>>> batch;
+    batch.reserve(buffer.size());
+    for (size_t idx : order)
+      batch.push_back(std::move(buffer[idx]));
+    return batch;
+  };
+
+  vector<pair<vector<WordIndex>, vector<WordIndex>>> batch = readBatch();
+  while (!batch.empty())
+  {
+    future<vector<pair<vector<WordIndex>, vector<WordIndex>>>> nextBatch = async(launch::async, readBatch);
+    process(batch);
+    batch = nextBatch.get();
+  }
+}
+
+int AlignmentModelBase::getNumBatchParts(size_t numPairs)
+{
+  return (int)std::min<size_t>(numPairs, NumBatchParts);
+}
+
+double AlignmentModelBase::getSentencePairCost(PositionIndex slen, PositionIndex tlen)
+{
+  return double(slen + 1) * tlen;
+}
+
 void AlignmentModelBase::loadConfig(const YAML::Node& config)
 {
   variationalBayes = config["variationalBayes"].as<bool>();
@@ -3,8 +3,12 @@
 #include "nlp_common/SingleWordVocab.h"
 #include "nlp_common/WordClasses.h"
 #include "sw_models/AlignmentModel.h"
+#include "sw_models/CountIncrements.h"
+#include "sw_models/LexCounts.h"
+#include "sw_models/LexTable.h"
 #include "sw_models/LightSentenceHandler.h"
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <yaml-cpp/yaml.h>
@@ -18,6 +22,11 @@ public:
   void setVariationalBayes(bool variationalBayes) override;
   bool getVariationalBayes() override;
 
+  void setMaxTranslationOptions(unsigned int maxTranslationOptions) override;
+  unsigned int getMaxTranslationOptions() override;
+  void setMinTranslationOptionDice(double minTranslationOptionDice) override;
+  double getMinTranslationOptionDice() override;
+
   // Functions to read and add sentence pairs
   bool readSentencePairs(const char* srcFileName, const char* trgFileName, const char* sentCountsFile,
                          std::pair<unsigned int, unsigned int>& sentRange, int verbose = 0) override;
@@ -131,12 +140,48 @@ public:
   }
 
 protected:
+  typedef std::function<void(const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>&)>
+      ProcessBatchFunc;
+
+  const std::size_t ThreadBufferSize = 10000;
+  // Bound of the sum of (slen + 1) * (tlen + 1) over the pairs of a batch, it bounds the memory of the count increments
+  // that are kept until the batch has been processed
+  const std::size_t MaxBatchCells = 1 << 19;
+  // The pairs of a batch are split into at most NumBatchParts parts, see getNumBatchParts
+  const int NumBatchParts = 256;
+
   AlignmentModelBase();
   AlignmentModelBase(AlignmentModelBase& model);
 
   bool loadVariationalBayes(const std::string& filename);
   bool sentenceLengthIsOk(const std::vector<WordIndex> sentence);
 
+  std::vector<WordIndex> getSrcSent(unsigned int n);
+  std::vector<WordIndex> getTrgSent(unsigned int n);
+
+  // Reads the training sentence pairs in batches of at most ThreadBufferSize pairs and MaxBatchCells cells and calls
+  // 'process' for each of them. The pairs of a batch are sorted by decreasing cost, so that the parts of the E-step
+  // have similar costs, and the next batch is read while the current one is being processed
+  void processBatches(ProcessBatchFunc process);
+  // Number of parts in which the E-step splits a batch of numPairs pairs, the pair n belongs to the part
+  // n % getNumBatchParts(numPairs). Each part is processed by a single thread and the counts of the parts are added in
+  // the order of the parts, so that the estimated parameters do not depend on the number of threads
+  int getNumBatchParts(size_t numPairs);
+  // Estimation of the cost of the E-step for a sentence pair, only its relative value is used
+  virtual double getSentencePairCost(PositionIndex slen, PositionIndex tlen);
+
+  // Adds each distinct word pair of a sentence pair once to the buffer of translation options and counts the sentence
+  // pairs in which each word appears, so that the Dice coefficients of the pruning are computed from sentence
+  // frequencies. Returns the number of word pairs added to the buffer
+  size_t addSentenceCooccurrences(const std::vector<WordIndex>& src, const std::vector<WordIndex>& trg,
+                                  std::vector<std::vector<WordIndex>>& insertBuffer);
+  // Receives the number of sentence pairs in which each translation
+  // option co-occurs, removes the options that do not pass the pruning
+  // parameters and sets the counts of the remaining ones to zero. The
+  // entries of the removed options are also removed from lexTable, so
+  // that a table estimated before the pruning does not keep them
+  void pruneTranslationOptions(LexCounts& lexCounts, LexTable& lexTable);
+
   virtual std::string getModelTypeStr() const = 0;
 
   virtual void loadConfig(const YAML::Node& config);
@@ -146,6 +191,13 @@ protected:
   PositionIndex maxSentenceLength = 1024;
   double alpha;
   bool variationalBayes;
+  unsigned int maxTranslationOptions;
+  double minTranslationOptionDice;
+  // Number of sentence pairs in which each word appears, only needed until the translation options are pruned
+  std::vector<unsigned int> srcSentenceFreqs;
+  std::vector<unsigned int> trgSentenceFreqs;
+  // Increments of the EM counts of the batch being processed
+  CountIncrements countIncrements;
   std::shared_ptr<SingleWordVocab> swVocab;
   std::shared_ptr<LightSentenceHandler> sentenceHandler;
   std::shared_ptr<WordClasses> wordClasses;
@@ -0,0 +1,63 @@
+#include "sw_models/CountIncrements.h"
+
+#include <unordered_map>
+
+const size_t CountIncrements::NumBuckets;
+
+void CountIncrements::reset(size_t numParts)
+{
+  if (increments.size() < numParts)
+    increments.resize(numParts, std::vector<std::vector<Increment>>(NumBuckets));
+  for (std::vector<std::vector<Increment>>& partIncrements : increments)
+  {
+    for (std::vector<Increment>& bucketIncrements : partIncrements)
+      bucketIncrements.clear();
+  }
+}
+
+void CountIncrements::apply()
+{
+#pragma omp parallel
+  {
+#ifdef THOT_SINGLE_PRECISION_EM
+    // Sums of the increments of each count of a bucket, a single precision count loses the increments that are small
+    // relative to it, so they are summed in double precision and each count is updated once per batch
+    std::unordered_map<EmFloat*, size_t> sumIndexes;
+    std::vector<Increment> sums;
+#endif
+
+#pragma omp for schedule(dynamic)
+    for (int bucket = 0; bucket < (int)NumBuckets; ++bucket)
+    {
+      for (std::vector<std::vector<Increment>>& partIncrements : increments)
+      {
+        for (const Increment& increment : partIncrements[bucket])
+        {
+#ifdef THOT_SINGLE_PRECISION_EM
+          auto result = sumIndexes.insert(std::make_pair(increment.count, sums.size()));
+          if (result.second)
+            sums.push_back(increment);
+          else
+            sums[result.first->second].value += increment.value;
+#else
+          *increment.count += increment.value;
+#endif
+        }
+        partIncrements[bucket].clear();
+      }
+
+#ifdef THOT_SINGLE_PRECISION_EM
+      for (const Increment& sum : sums)
+        *sum.count += sum.value;
+      sumIndexes.clear();
+      sums.clear();
+#endif
+    }
+  }
+}
+
+void CountIncrements::clear()
+{
+  increments.clear();
+  increments.shrink_to_fit();
+}
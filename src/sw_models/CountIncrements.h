@@ -0,0 +1,43 @@
+#pragma once
+
+#include "sw_models/LexCounts.h"
+
+#include <cstdint>
+#include <vector>
+
+// Increments of the EM counts collected while processing a batch of sentence pairs. The batch is split into parts that
+// are processed by a single thread each, and the increments are added to the counts once the batch has been processed,
+// in the order of the parts, so that the counts do not depend on the number of threads. With single precision counts,
+// the increments of each count are summed in double precision and added to it once per batch
+class CountIncrements
+{
+public:
+  // Discards the logged increments and prepares the log for a batch of numParts parts
+  void reset(size_t numParts);
+  void add(size_t part, EmFloat& count, double increment)
+  {
+    increments[part][getBucket(count)].push_back(Increment{&count, increment});
+  }
+  // Adds the logged increments to their counts and empties the log
+  void apply();
+  // Releases the memory of the log
+  void clear();
+
+private:
+  // The increments of a part are split by the address of their count, so that the buckets can be applied in parallel
+  static const size_t NumBuckets = 128;
+
+  struct Increment
+  {
+    EmFloat* count;
+    double value;
+  };
+
+  size_t getBucket(const EmFloat& count)
+  {
+    return (reinterpret_cast<uintptr_t>(&count) / sizeof(EmFloat)) % NumBuckets;
+  }
+
+  // increments[part][bucket]
+  std::vector<std::vector<std::vector<Increment>>> increments;
+};
@@ -99,12 +99,12 @@ bool DistortionTable::loadPlainText(const char* distortionNumDenFile, int verbos
     {
       if (awk.NF == 6)
       {
-        PositionIndex i = atoi(awk.dollar(1).c_str());
-        PositionIndex slen = atoi(awk.dollar(2).c_str());
-        PositionIndex tlen = atoi(awk.dollar(3).c_str());
-        PositionIndex j = atoi(awk.dollar(4).c_str());
-        float numer = (float)atof(awk.dollar(5).c_str());
-        float denom = (float)atof(awk.dollar(6).c_str());
+        PositionIndex i = awk.dollarToInt(1);
+        PositionIndex slen = awk.dollarToInt(2);
+        PositionIndex tlen = awk.dollarToInt(3);
+        PositionIndex j = awk.dollarToInt(4);
+        float numer = (float)awk.dollarToDouble(5);
+        float denom = (float)awk.dollarToDouble(6);
         set(i, slen, tlen, j, numer, denom);
       }
     }
@@ -61,14 +61,8 @@ unsigned int FastAlignModel::startTraining(int verbosity)
         initCountSlot(NULL_WORD, t);
       }
       for (const WordIndex s : src)
-      {
         lexTable.setDenominator(s, 0);
-        if (s >= insertBuffer.size())
-          insertBuffer.resize((size_t)s + 1);
-        for (const WordIndex t : trg)
-          insertBuffer[s].push_back(t);
-        insertBufferItems += tlen;
-      }
+      insertBufferItems += addSentenceCooccurrences(src, trg, insertBuffer);
       if (insertBufferItems > ThreadBufferSize * 100)
       {
         insertBufferItems = 0;
@@ -79,6 +73,14 @@ unsigned int FastAlignModel::startTraining(int verbosity)
   }
   if (!insertBuffer.empty())
     addTranslationOptions(insertBuffer);
+  pruneTranslationOptions(lexCounts, lexTable);
+
+#pragma omp parallel for schedule(dynamic)
+  for (int s = NULL_WORD + 1; s < (int)lexCounts.size(); ++s)
+  {
+    for (auto& entry : lexCounts[s])
+      lexTable.setNumerator(s, entry.first, 0);
+  }
 
   if (verbosity)
   {
@@ -91,25 +93,7 @@ unsigned int FastAlignModel::startTraining(int verbosity)
 void FastAlignModel::train(int verbosity)
 {
   empFeatSum = 0;
-  vector<pair<vector<WordIndex>, vector<WordIndex>>> buffer;
-  for (unsigned int n = 0; n < numSentencePairs(); ++n)
-  {
-    vector<WordIndex> src = getSrcSent(n);
-    vector<WordIndex> trg = getTrgSent(n);
-    if (sentenceLengthIsOk(src) && sentenceLengthIsOk(trg))
-      buffer.push_back(make_pair(src, trg));
-
-    if (buffer.size() >= ThreadBufferSize)
-    {
-      batchUpdateCounts(buffer);
-      buffer.clear();
-    }
-  }
-  if (buffer.size() > 0)
-  {
-    batchUpdateCounts(buffer);
-    buffer.clear();
-  }
+  processBatches([this](const vector<pair<vector<WordIndex>, vector<WordIndex>>>& pairs) { batchUpdateCounts(pairs); });
 
   if (iter > 0)
     optimizeDiagonalTension(8, verbosity);
@@ -133,17 +117,22 @@ void FastAlignModel::optimizeDiagonalTension(unsigned int nIters, int verbose)
 
   for (unsigned int ii = 0; ii < nIters; ++ii)
   {
-    double modFeat = 0;
-#pragma omp parallel for reduction(+ : modFeat)
+    // The terms are summed in the order of the size counts, so that the tension does not depend on the number of
+    // threads
+    vector<double> modFeatTerms(sizeCounts.size(), 0.0);
+#pragma omp parallel for
     for (int i = 0; i < (int)sizeCounts.size(); ++i)
     {
       const pair<short, short>& p = sizeCounts.getAt(i).first;
       for (short j = 1; j <= p.first; ++j)
       {
         double dLogZ = DiagonalAlignment::ComputeDLogZ(j, p.first, p.second, diagonalTension);
-        modFeat += sizeCounts.getAt(i).second * dLogZ;
+        modFeatTerms[i] += sizeCounts.getAt(i).second * dLogZ;
       }
     }
+    double modFeat = 0;
+    for (double term : modFeatTerms)
+      modFeat += term;
     modFeat /= trgTokenCount;
     if (verbose)
       cerr << "  " << ii + 1 << "  model al-feat: " << modFeat << " (tension=" << diagonalTension << ")\n";
@@ -168,10 +157,7 @@ void FastAlignModel::addTranslationOptions(vector<vector<WordIndex>>& insertBuff
   for (int s = 0; s < (int)insertBuffer.size(); ++s)
   {
     for (WordIndex t : insertBuffer[s])
-    {
-      initCountSlot(s, t);
-      lexTable.setNumerator(s, t, 0);
-    }
+      lexCounts[s][t] += 1;
     insertBuffer[s].clear();
   }
 }
@@ -188,38 +174,55 @@ void FastAlignModel::incrementSizeCount(unsigned int tlen, unsigned int slen)
 
 void FastAlignModel::batchUpdateCounts(const vector<pair<vector<WordIndex>, vector<WordIndex>>>& pairs)
 {
-  double curEmpFeatSum = 0.0;
-#pragma omp parallel for schedule(dynamic) reduction(+ : curEmpFeatSum)
-  for (int line_idx = 0; line_idx < (int)pairs.size(); ++line_idx)
+  int numParts = getNumBatchParts(pairs.size());
+  countIncrements.reset(numParts);
+  vector<double> partEmpFeatSums(numParts, 0.0);
+
+#pragma omp parallel
   {
-    vector<WordIndex> src = pairs[line_idx].first;
-    vector<WordIndex> trg = pairs[line_idx].second;
-    unsigned int slen = (unsigned int)src.size();
-    unsigned int tlen = (unsigned int)trg.size();
-    vector<double> probs(src.size() + 1);
-    for (PositionIndex j = 1; j <= trg.size(); ++j)
+    // Per-thread buffer, reused by every sentence pair the thread processes
+    vector<double> probs;
+
+#pragma omp for schedule(dynamic)
+    for (int part = 0; part < numParts; ++part)
     {
-      const WordIndex& fj = trg[j - 1];
-      double sum = 0;
-      probs[0] = translationProb(NULL_WORD, fj) * (double)alignmentProb(j, slen, tlen, 0);
-      sum += probs[0];
-      double az = computeAZ(j, slen, tlen);
-      for (PositionIndex i = 1; i <= src.size(); ++i)
-      {
-        probs[i] = translationProb(src[i - 1], fj) * (double)alignmentProb(az, j, slen, tlen, i);
-        sum += probs[i];
-      }
-      double count = probs[0] / sum;
-      incrementCount(NULL_WORD, fj, count);
-      for (PositionIndex i = 1; i <= src.size(); ++i)
+      double partEmpFeatSum = 0;
+      for (int line_idx = part; line_idx < (int)pairs.size(); line_idx += numParts)
       {
-        double p = probs[i] / sum;
-        incrementCount(src[i - 1], fj, p);
-        curEmpFeatSum += DiagonalAlignment::Feature(j - 1, i, tlen, slen) * p;
+        const vector<WordIndex>& src = pairs[line_idx].first;
+        const vector<WordIndex>& trg = pairs[line_idx].second;
+        unsigned int slen = (unsigned int)src.size();
+        unsigned int tlen = (unsigned int)trg.size();
+        probs.resize(src.size() + 1);
+        for (PositionIndex j = 1; j <= trg.size(); ++j)
+        {
+          const WordIndex& fj = trg[j - 1];
+          double sum = 0;
+          probs[0] = translationProb(NULL_WORD, fj) * (double)alignmentProb(j, slen, tlen, 0);
+          sum += probs[0];
+          double az = computeAZ(j, slen, tlen);
+          for (PositionIndex i = 1; i <= src.size(); ++i)
+          {
+            probs[i] = translationProb(src[i - 1], fj) * (double)alignmentProb(az, j, slen, tlen, i);
+            sum += probs[i];
+          }
+          double count = probs[0] / sum;
+          incrementCount(part, NULL_WORD, fj, count);
+          for (PositionIndex i = 1; i <= src.size(); ++i)
+          {
+            double p = probs[i] / sum;
+            incrementCount(part, src[i - 1], fj, p);
+            partEmpFeatSum += DiagonalAlignment::Feature(j - 1, i, tlen, slen) * p;
+          }
+        }
       }
+      partEmpFeatSums[part] = partEmpFeatSum;
     }
   }
-  empFeatSum += curEmpFeatSum;
+
+  countIncrements.apply();
+  for (double partEmpFeatSum : partEmpFeatSums)
+    empFeatSum += partEmpFeatSum;
 }
 
 void FastAlignModel::batchMaximizeProbs(void)
@@ -514,10 +517,12 @@ void FastAlignModel::initCountSlot(WordIndex s, WordIndex t)
   lexCounts[s][t] = 0;
 }
 
-void FastAlignModel::incrementCount(WordIndex s, WordIndex t, double x)
+void FastAlignModel::incrementCount(int part, WordIndex s, WordIndex t, double x)
 {
-#pragma omp atomic
-  lexCounts[s].find(t)->second += x;
+  // Pruned translation options are not estimated
+  LexCountsElem::iterator iter = lexCounts[s].find(t);
+  if (iter != lexCounts[s].end())
+    countIncrements.add(part, iter->second, x);
 }
 
 LgProb FastAlignModel::getBestAlignment(const vector<WordIndex>& srcSentence, const vector<WordIndex>& trgSentence,
@@ -840,38 +845,6 @@ bool FastAlignModel::printSizeCounts(const string& filename)
   return THOT_OK;
 }
 
-vector<WordIndex> FastAlignModel::getSrcSent(unsigned int n)
-{
-  vector<string> srcsStr;
-  vector<WordIndex> result;
-
-  sentenceHandler->getSrcSentence(n, srcsStr);
-  for (unsigned int i = 0; i < srcsStr.size(); ++i)
-  {
-    WordIndex widx = stringToSrcWordIndex(srcsStr[i]);
-    if (widx == UNK_WORD)
-      widx = addSrcSymbol(srcsStr[i]);
-    result.push_back(widx);
-  }
-  return result;
-}
-
-vector<WordIndex> FastAlignModel::getTrgSent(unsigned int n)
-{
-  vector<string> trgsStr;
-  vector<WordIndex> trgs;
-
-  sentenceHandler->getTrgSentence(n, trgsStr);
-  for (unsigned int i = 0; i < trgsStr.size(); ++i)
-  {
-    WordIndex widx = stringToTrgWordIndex(trgsStr[i]);
-    if (widx == UNK_WORD)
-      widx = addTrgSymbol(trgsStr[i]);
-    trgs.push_back(widx);
-  }
-  return trgs;
-}
-
 void FastAlignModel::clearSentenceLengthModel()
 {
   totLenRatio = 0;
@@ -881,6 +854,7 @@ void FastAlignModel::clearTempVars()
 {
   iter = 0;
   lexCounts.clear();
+  countIncrements.clear();
   incrLexCounts.clear();
   anji_aux.clear();
 }
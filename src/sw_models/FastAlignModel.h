@@ -79,7 +79,6 @@ public:
 private:
   typedef OrderedVector<std::pair<short, short>, unsigned int, PairLess> SizeCounts;
 
-  const std::size_t ThreadBufferSize = 10000;
   const float SmoothingAnjiNum = 1e-9f;
   const float SmoothingWeightedAnji = 1e-9f;
   const float SmoothingProb = 1e-9f;
@@ -94,8 +93,6 @@ private:
 
   void addTranslationOptions(std::vector<std::vector<WordIndex>>& insertBuffer);
   void batchUpdateCounts(const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs);
-  std::vector<WordIndex> getSrcSent(unsigned int n);
-  std::vector<WordIndex> getTrgSent(unsigned int n);
   double computeAZ(PositionIndex j, PositionIndex slen, PositionIndex tlen);
   Prob alignmentProb(double az, PositionIndex j, PositionIndex slen, PositionIndex tlen, PositionIndex i);
   bool printParams(const std::string& filename);
@@ -106,7 +103,7 @@ private:
   void optimizeDiagonalTension(unsigned int nIters, int verbose);
   void incrementSizeCount(unsigned int tlen, unsigned int slen);
   void initCountSlot(WordIndex s, WordIndex t);
-  void incrementCount(WordIndex s, WordIndex t, double x);
+  void incrementCount(int part, WordIndex s, WordIndex t, double x);
 
   void calcNewLocalSuffStats(std::pair<unsigned int, unsigned int> sentPairRange, int verbosity = 0);
   void calc_anji(unsigned int n, const std::vector<WordIndex>& nsrcSent, const std::vector<WordIndex>& trgSent,
@@ -140,10 +140,10 @@ bool FertilityTable::loadPlainText(const char* fertilityNumDenFile, int verbose)
     {
       if (awk.NF == 4)
       {
-        WordIndex s = atoi(awk.dollar(1).c_str());
-        PositionIndex phi = atoi(awk.dollar(2).c_str());
-        float numer = (float)atof(awk.dollar(3).c_str());
-        float denom = (float)atof(awk.dollar(4).c_str());
+        WordIndex s = awk.dollarToInt(1);
+        PositionIndex phi = awk.dollarToInt(2);
+        float numer = (float)awk.dollarToDouble(3);
+        float denom = (float)awk.dollarToDouble(4);
         set(s, phi, numer, denom);
       }
     }
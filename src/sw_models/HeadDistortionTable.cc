@@ -106,11 +106,11 @@ bool HeadDistortionTable::loadPlainText(const char* tableFile, int verbose)
   {
     if (awk.NF == 6)
     {
-      WordClassIndex sourceWordClass = atoi(awk.dollar(1).c_str());
-      WordClassIndex targetWordClass = atoi(awk.dollar(2).c_str());
-      int dj = atoi(awk.dollar(3).c_str());
-      float numer = (float)atof(awk.dollar(4).c_str());
-      float denom = (float)atof(awk.dollar(5).c_str());
+      WordClassIndex sourceWordClass = awk.dollarToInt(1);
+      WordClassIndex targetWordClass = awk.dollarToInt(2);
+      int dj = awk.dollarToInt(3);
+      float numer = (float)awk.dollarToDouble(4);
+      float denom = (float)awk.dollarToDouble(5);
       set(sourceWordClass, targetWordClass, dj, numer, denom);
     }
   }
@@ -57,7 +57,7 @@ void HmmAlignmentModel::setHmmP0(Prob p0)
 unsigned int HmmAlignmentModel::startTraining(int verbosity)
 {
   clearTempVars();
-  std::vector<std::vector<unsigned>> insertBuffer;
+  std::vector<std::vector<WordIndex>> insertBuffer;
   size_t insertBufferItems = 0;
   unsigned int count = 0;
   for (unsigned int n = 0; n < numSentencePairs(); ++n)
@@ -78,23 +78,14 @@ unsigned int HmmAlignmentModel::startTraining(int verbosity)
       if (elem.size() < src.size())
         elem.resize(src.size(), 0);
 
-      for (PositionIndex i = 1; i <= nsrc.size(); ++i)
+      insertBufferItems += addSentenceCooccurrences(nsrc, trg, insertBuffer);
+      for (PositionIndex i = 1; i <= slen; ++i)
       {
-        WordIndex s = nsrc[i - 1];
-        if (s >= insertBuffer.size())
-          insertBuffer.resize((size_t)s + 1);
-        for (const WordIndex t : trg)
-          insertBuffer[s].push_back(t);
-        insertBufferItems += trg.size();
-
-        if (i <= slen)
-        {
-          HmmAlignmentKey asHmm{i, getCompactedSentenceLength(slen)};
-          hmmAlignmentTable->reserveSpace(asHmm.prev_i, asHmm.slen);
-          HmmAlignmentCountsElem& elem = hmmAlignmentCounts[asHmm];
-          if (elem.size() < src.size())
-            elem.resize(src.size(), 0);
-        }
+        HmmAlignmentKey asHmm{i, getCompactedSentenceLength(slen)};
+        hmmAlignmentTable->reserveSpace(asHmm.prev_i, asHmm.slen);
+        HmmAlignmentCountsElem& elem = hmmAlignmentCounts[asHmm];
+        if (elem.size() < src.size())
+          elem.resize(src.size(), 0);
       }
 
       for (PositionIndex j = 1; j <= trg.size(); ++j)
@@ -117,6 +108,7 @@ unsigned int HmmAlignmentModel::startTraining(int verbosity)
   }
   if (insertBufferItems > 0)
     addTranslationOptions(insertBuffer);
+  pruneTranslationOptions(lexCounts, *lexTable);
 
   if (numSentencePairs() > 0)
   {
@@ -126,141 +118,198 @@ unsigned int HmmAlignmentModel::startTraining(int verbosity)
   return count;
 }
 
+double HmmAlignmentModel::getSentencePairCost(PositionIndex slen, PositionIndex tlen)
+{
+  // the forward-backward algorithm considers every transition between the 2 * slen states for each target word
+  return double(slen) * slen * tlen;
+}
+
 void HmmAlignmentModel::batchUpdateCounts(
     const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs)
 {
-#pragma omp parallel for schedule(dynamic)
-  for (int line_idx = 0; line_idx < (int)pairs.size(); ++line_idx)
+  int numParts = getNumBatchParts(pairs.size());
+  countIncrements.reset(numParts);
+  std::vector<Ibm3TransferCounts> transferCounts;
+  if (ibm3TransferCounts)
+    transferCounts.resize(numParts);
+
+#pragma omp parallel
   {
-    std::vector<WordIndex> src = pairs[line_idx].first;
-    std::vector<WordIndex> nsrc = extendWithNullWord(src);
-    std::vector<WordIndex> trg = pairs[line_idx].second;
-
-    PositionIndex slen = (PositionIndex)src.size();
-    PositionIndex tlen = (PositionIndex)trg.size();
-
-    // Calculate alpha and beta matrices
-    std::vector<std::vector<double>> lexProbs;
-    std::vector<std::vector<double>> alignProbs;
-    std::vector<std::vector<double>> alphaMatrix;
-    std::vector<std::vector<double>> betaMatrix;
-    calcAlphaBetaMatrices(nsrc, trg, slen, lexProbs, alignProbs, alphaMatrix, betaMatrix);
-
-    std::vector<double> lexNums(nsrc.size() + 1);
-    std::vector<double> innerAligNums(src.size() + 1);
-    std::vector<std::vector<double>> aligNums(src.size() + 1, innerAligNums);
-    for (PositionIndex j = 1; j <= trg.size(); ++j)
+    // Per-thread buffers, reused by every sentence pair the thread processes so that they only grow to the size of
+    // its longest pair
+    Matrix<EmFloat> lexProbs;
+    Matrix<EmFloat> alignProbs;
+    Matrix<EmFloat> alphaMatrix;
+    Matrix<EmFloat> betaMatrix;
+    std::vector<double> lexNums;
+    Matrix<double> aligNums;
+    Matrix<double> aligCounts;
+    Matrix<double> posteriors;
+
+#pragma omp for schedule(dynamic)
+    for (int part = 0; part < numParts; ++part)
     {
-      double lexSum = 0;
-      double aligSum = 0;
-      for (PositionIndex i = 1; i <= nsrc.size(); ++i)
+      for (int line_idx = part; line_idx < (int)pairs.size(); line_idx += numParts)
       {
-        // Obtain numerator
-        lexNums[i] = alphaMatrix[i][j] * betaMatrix[i][j];
-
-        // Add contribution to sum
-        lexSum += lexNums[i];
-
-        if (i <= slen)
+        const std::vector<WordIndex>& src = pairs[line_idx].first;
+        std::vector<WordIndex> nsrc = extendWithNullWord(src);
+        const std::vector<WordIndex>& trg = pairs[line_idx].second;
+
+        PositionIndex slen = (PositionIndex)src.size();
+        PositionIndex tlen = (PositionIndex)trg.size();
+
+        // Calculate alpha and beta matrices
+        calcAlphaBetaMatrices(nsrc, trg, slen, lexProbs, alignProbs, alphaMatrix, betaMatrix);
+
+        lexNums.assign(nsrc.size() + 1, 0.0);
+        aligNums.assign(src.size() + 1, src.size() + 1, 0.0);
+        // expected counts of the transitions, summed over the target words of the pair
+        aligCounts.assign(src.size() + 1, src.size() + 1, 0.0);
+        if (ibm3TransferCounts)
+          posteriors.assign(slen + 1, tlen + 1, 0.0);
+        for (PositionIndex j = 1; j <= trg.size(); ++j)
         {
-          aligNums[i][0] = 1.0;
-          if (j == 1)
+          double lexSum = 0;
+          double aligSum = 0;
+          for (PositionIndex i = 1; i <= nsrc.size(); ++i)
           {
             // Obtain numerator
-            if (isNullAlignment(0, slen, i))
-            {
-              if (isFirstNullAlignmentPar(0, slen, i))
-                aligNums[i][0] = alignProbs[i][0] * lexProbs[i][1] * betaMatrix[i][1];
-              else
-                aligNums[i][0] = aligNums[size_t{slen} + 1][0];
-            }
-            else
-            {
-              aligNums[i][0] = alignProbs[i][0] * lexProbs[i][1] * betaMatrix[i][1];
-            }
+            lexNums[i] = (double)alphaMatrix(i, j) * betaMatrix(i, j);
 
             // Add contribution to sum
-            aligSum += aligNums[i][0];
-          }
-          else
-          {
-            for (PositionIndex ip = 1; ip <= src.size(); ++ip)
+            lexSum += lexNums[i];
+
+            if (i <= slen)
             {
-              // Obtain numerator
-              if (isValidAlignment(ip, slen, i))
-                aligNums[i][ip] = alphaMatrix[ip][j - 1] * alignProbs[i][ip] * lexProbs[i][j] * betaMatrix[i][j];
+              aligNums(i, 0) = 1.0;
+              if (j == 1)
+              {
+                // Obtain numerator
+                if (isNullAlignment(0, slen, i))
+                {
+                  if (isFirstNullAlignmentPar(0, slen, i))
+                    aligNums(i, 0) = (double)alignProbs(i, 0) * lexProbs(i, 1) * betaMatrix(i, 1);
+                  else
+                    aligNums(i, 0) = aligNums(size_t{slen} + 1, 0);
+                }
+                else
+                {
+                  aligNums(i, 0) = (double)alignProbs(i, 0) * lexProbs(i, 1) * betaMatrix(i, 1);
+                }
+
+                // Add contribution to sum
+                aligSum += aligNums(i, 0);
+              }
               else
-                aligNums[i][ip] = 0.0;
-
-              // Add contribution to sum
-              aligSum += aligNums[i][ip];
+              {
+                for (PositionIndex ip = 1; ip <= src.size(); ++ip)
+                {
+                  // Obtain numerator
+                  if (isValidAlignment(ip, slen, i))
+                    aligNums(i, ip) =
+                        (double)alphaMatrix(ip, j - 1) * alignProbs(i, ip) * lexProbs(i, j) * betaMatrix(i, j);
+                  else
+                    aligNums(i, ip) = 0.0;
+
+                  // Add contribution to sum
+                  aligSum += aligNums(i, ip);
+                }
+              }
             }
           }
-        }
-      }
-      for (PositionIndex i = 1; i <= nsrc.size(); ++i)
-      {
-        // Obtain expected value
-        double lexCount = lexSum == 0 ? 0 : lexNums[i] / lexSum;
-        if (lexCount > ExpValMax)
-          lexCount = ExpValMax;
-        if (lexCount < ExpValMin)
-          lexCount = ExpValMin;
-
-        // Store expected value
-        WordIndex s = nsrc[i - 1];
-        WordIndex t = trg[j - 1];
 
-#pragma omp atomic
-        lexCounts[s].find(t)->second += lexCount;
-
-        AlignmentKey key{j, slen, getCompactedSentenceLength(tlen)};
-        PositionIndex ibm2_i = i > slen ? 0 : i;
-
-#pragma omp atomic
-        alignmentCounts[key][ibm2_i] += lexCount;
-
-        if (i <= slen)
-        {
-          if (j == 1)
+          WordIndex t = trg[j - 1];
+          AlignmentCountsElem& alignmentElem = alignmentCounts[AlignmentKey{j, slen, getCompactedSentenceLength(tlen)}];
+          // the NULL words share the same counts, their expected values are added once
+          double nullLexCount = 0;
+          for (PositionIndex i = 1; i <= nsrc.size(); ++i)
           {
             // Obtain expected value
-            double aligCount = aligSum == 0 ? 0 : aligNums[i][0] / aligSum;
-            if (aligCount > ExpValMax)
-              aligCount = ExpValMax;
-            if (aligCount < ExpValMin)
-              aligCount = ExpValMin;
+            double lexCount = lexSum == 0 ? 0 : lexNums[i] / lexSum;
+            if (ibm3TransferCounts)
+              posteriors(i > slen ? 0 : i, j) += lexCount;
+            if (lexCount > ExpValMax)
+              lexCount = ExpValMax;
+            if (lexCount < ExpValMin)
+              lexCount = ExpValMin;
+
+            if (i > slen)
+            {
+              nullLexCount += lexCount;
+              continue;
+            }
 
             // Store expected value
-            HmmAlignmentKey asHmm{0, getCompactedSentenceLength(slen)};
-#pragma omp atomic
-            hmmAlignmentCounts[asHmm][i - 1] += aligCount * slen;
-          }
-          else
-          {
-            for (PositionIndex ip = 1; ip <= src.size(); ++ip)
+            WordIndex s = nsrc[i - 1];
+
+            // Pruned translation options are not estimated
+            LexCountsElem::iterator lexCountsIter = lexCounts[s].find(t);
+            if (lexCountsIter != lexCounts[s].end())
+              countIncrements.add(part, lexCountsIter->second, lexCount);
+            countIncrements.add(part, alignmentElem[i], lexCount);
+
+            if (j == 1)
+            {
+              // Obtain expected value
+              double aligCount = aligSum == 0 ? 0 : aligNums(i, 0) / aligSum;
+              if (aligCount > ExpValMax)
+                aligCount = ExpValMax;
+              if (aligCount < ExpValMin)
+                aligCount = ExpValMin;
+
+              aligCounts(i, 0) += aligCount * slen;
+            }
+            else
             {
-              // Obtain information about alignment
-              if (isValidAlignment(ip, slen, i))
+              for (PositionIndex ip = 1; ip <= src.size(); ++ip)
               {
-                // Obtain expected value
-                double aligCount = aligSum == 0 ? 0 : aligNums[i][ip] / aligSum;
-                if (aligCount > ExpValMax)
-                  aligCount = ExpValMax;
-                if (aligCount < ExpValMin)
-                  aligCount = ExpValMin;
-
-                // Store expected value
-                HmmAlignmentKey asHmm{ip, getCompactedSentenceLength(slen)};
-#pragma omp atomic
-                hmmAlignmentCounts[asHmm][i - 1] += aligCount * slen;
+                // Obtain information about alignment
+                if (isValidAlignment(ip, slen, i))
+                {
+                  // Obtain expected value
+                  double aligCount = aligSum == 0 ? 0 : aligNums(i, ip) / aligSum;
+                  if (aligCount > ExpValMax)
+                    aligCount = ExpValMax;
+                  if (aligCount < ExpValMin)
+                    aligCount = ExpValMin;
+
+                  aligCounts(i, ip) += aligCount * slen;
+                }
               }
             }
           }
+
+          // Store expected value of the NULL words
+          WordIndex nullWord = nsrc[slen];
+          LexCountsElem::iterator lexCountsIter = lexCounts[nullWord].find(t);
+          if (lexCountsIter != lexCounts[nullWord].end())
+            countIncrements.add(part, lexCountsIter->second, nullLexCount);
+          countIncrements.add(part, alignmentElem[0], nullLexCount);
         }
+
+        // Store expected values of the transitions, only the valid transitions have a count
+        for (PositionIndex ip = 0; ip <= slen; ++ip)
+        {
+          HmmAlignmentCountsElem* hmmAlignmentElem = nullptr;
+          for (PositionIndex i = 1; i <= slen; ++i)
+          {
+            if (aligCounts(i, ip) == 0)
+              continue;
+            if (hmmAlignmentElem == nullptr)
+              hmmAlignmentElem = &hmmAlignmentCounts[HmmAlignmentKey{ip, getCompactedSentenceLength(slen)}];
+            countIncrements.add(part, (*hmmAlignmentElem)[i - 1], aligCounts(i, ip));
+          }
+        }
+
+        if (ibm3TransferCounts)
+          transferCounts[part].addSentencePair(src, tlen, getCompactedSentenceLength(slen), posteriors);
       }
     }
   }
+
+  countIncrements.apply();
+  for (const Ibm3TransferCounts& partTransferCounts : transferCounts)
+    ibm3TransferCounts->add(partTransferCounts);
 }
 
 void HmmAlignmentModel::batchMaximizeProbs()
@@ -452,8 +501,8 @@ void HmmAlignmentModel::populateMoveSwapScores(const std::vector<WordIndex>& src
   PositionIndex slen = (PositionIndex)src.size();
   PositionIndex tlen = (PositionIndex)trg.size();
 
-  moveScores.resize(slen + 1, tlen + 1);
-  swapScores.resize(tlen + 1, tlen + 1);
+  moveScores.assign(slen + 1, tlen + 1, 0.0);
+  swapScores.assign(tlen + 1, tlen + 1, 0.0);
 
   for (PositionIndex j = 1; j <= tlen; j++)
   {
@@ -879,66 +928,60 @@ std::vector<WordIndex> HmmAlignmentModel::extendWithNullWord(const std::vector<W
 
 void HmmAlignmentModel::calcAlphaBetaMatrices(const std::vector<WordIndex>& nsrcSent,
                                               const std::vector<WordIndex>& trgSent, PositionIndex slen,
-                                              std::vector<std::vector<double>>& lexProbs,
-                                              std::vector<std::vector<double>>& alignProbs,
-                                              std::vector<std::vector<double>>& alphaMatrix,
-                                              std::vector<std::vector<double>>& betaMatrix)
+                                              Matrix<EmFloat>& lexProbs, Matrix<EmFloat>& alignProbs,
+                                              Matrix<EmFloat>& alphaMatrix, Matrix<EmFloat>& betaMatrix)
 {
-  // Create data structure to cache lexical probs
-  lexProbs.clear();
-  std::vector<double> innerLexProbs(trgSent.size() + 1, 0.0);
-  lexProbs.resize(nsrcSent.size() + 1, innerLexProbs);
-
-  // Create data structure to cache alignment probs
-  alignProbs.clear();
-  std::vector<double> innerAlignProbs(nsrcSent.size() + 1, 0.0);
-  alignProbs.resize(nsrcSent.size() + 1, innerAlignProbs);
+  // Initialize data structures to cache lexical and alignment probs, the storage of matrices passed in by the caller
+  // is reused
+  lexProbs.assign(nsrcSent.size() + 1, trgSent.size() + 1, 0.0);
+  alignProbs.assign(nsrcSent.size() + 1, nsrcSent.size() + 1, 0.0);
 
   // Initialize alphaMatrix
-  alphaMatrix.clear();
-  std::vector<double> innerMatrix(trgSent.size() + 1, 0.0);
-  alphaMatrix.resize(nsrcSent.size() + 1, innerMatrix);
+  alphaMatrix.assign(nsrcSent.size() + 1, trgSent.size() + 1, 0.0);
 
   for (PositionIndex j = 1; j <= trgSent.size(); ++j)
   {
     for (PositionIndex i = 1; i <= nsrcSent.size(); ++i)
-      lexProbs[i][j] = translationProb(nsrcSent[i - 1], trgSent[j - 1]);
+      lexProbs(i, j) = translationProb(nsrcSent[i - 1], trgSent[j - 1]);
   }
 
   for (PositionIndex i = 1; i <= nsrcSent.size(); ++i)
   {
     for (PositionIndex i_tilde = 0; i_tilde <= nsrcSent.size(); ++i_tilde)
-      alignProbs[i][i_tilde] = hmmAlignmentProb(i_tilde, slen, i);
+      alignProbs(i, i_tilde) = hmmAlignmentProb(i_tilde, slen, i);
   }
 
-  std::vector<double> sums(trgSent.size() + 1, 0.0);
+  // Sums over the states are computed in double precision whatever the precision of the matrices
+  static thread_local std::vector<double> sums;
+  sums.assign(trgSent.size() + 1, 0.0);
   // Fill alphaMatrix
   for (PositionIndex j = 1; j <= trgSent.size(); ++j)
   {
     for (PositionIndex i = 1; i <= nsrcSent.size(); ++i)
     {
+      double alphaVal = 0;
       if (j == 1)
       {
-        alphaMatrix[i][j] = alignProbs[i][0] * lexProbs[i][j];
+        alphaVal = (double)alignProbs(i, 0) * lexProbs(i, j);
       }
       else
       {
         for (PositionIndex i_tilde = 1; i_tilde <= nsrcSent.size(); ++i_tilde)
-          alphaMatrix[i][j] += alphaMatrix[i_tilde][j - 1] * alignProbs[i][i_tilde] * lexProbs[i][j];
+          alphaVal += (double)alphaMatrix(i_tilde, j - 1) * alignProbs(i, i_tilde) * lexProbs(i, j);
       }
-      sums[j] += alphaMatrix[i][j];
+      alphaMatrix(i, j) = (EmFloat)alphaVal;
+      sums[j] += alphaVal;
     }
 
     if (sums[j] > 0)
     {
       for (PositionIndex i = 1; i <= nsrcSent.size(); ++i)
-        alphaMatrix[i][j] /= sums[j];
+        alphaMatrix(i, j) /= sums[j];
     }
   }
 
   // Initialize betaMatrix
-  betaMatrix.clear();
-  betaMatrix.resize(nsrcSent.size() + 1, innerMatrix);
+  betaMatrix.assign(nsrcSent.size() + 1, trgSent.size() + 1, 0.0);
 
   // Fill betaMatrix
   for (PositionIndex j = trgSent.size(); j >= 1; --j)
@@ -947,20 +990,21 @@ void HmmAlignmentModel::calcAlphaBetaMatrices(const std::vector<WordIndex>& nsrc
     {
       for (PositionIndex i = 1; i <= nsrcSent.size(); ++i)
       {
+        double betaVal = 0;
         if (j == trgSent.size())
         {
-          betaMatrix[i][j] = 1.0;
+          betaVal = 1.0;
         }
         else
         {
           for (PositionIndex i_tilde = 1; i_tilde <= nsrcSent.size(); ++i_tilde)
           {
-            betaMatrix[i][j] +=
-                betaMatrix[i_tilde][size_t{j} + 1] * alignProbs[i_tilde][i] * lexProbs[i_tilde][size_t{j} + 1];
+            betaVal += (double)betaMatrix(i_tilde, size_t{j} + 1) * alignProbs(i_tilde, i) *
+                       lexProbs(i_tilde, size_t{j} + 1);
           }
         }
 
-        betaMatrix[i][j] /= sums[j];
+        betaMatrix(i, j) = (EmFloat)(betaVal / sums[j]);
       }
     }
   }
@@ -1113,7 +1157,7 @@ bool HmmAlignmentModel::loadLexSmIntFactor(const char* lexSmIntFactorFile, int v
     {
       if (awk.NF == 1)
       {
-        setLexicalSmoothFactor((Prob)atof(awk.dollar(1).c_str()));
+        setLexicalSmoothFactor((Prob)awk.dollarToDouble(1));
         return THOT_OK;
       }
       else
@@ -1153,7 +1197,7 @@ bool HmmAlignmentModel::loadAlSmIntFactor(const char* alSmIntFactorFile, int ver
     {
       if (awk.NF == 1)
       {
-        setHmmAlignmentSmoothFactor((Prob)atof(awk.dollar(1).c_str()));
+        setHmmAlignmentSmoothFactor((Prob)awk.dollarToDouble(1));
         return THOT_OK;
       }
       else
@@ -1193,7 +1237,7 @@ bool HmmAlignmentModel::loadHmmP0(const char* hmmP0FileName, int verbose)
     {
       if (awk.NF == 1)
       {
-        hmmP0 = (Prob)atof(awk.dollar(1).c_str());
+        hmmP0 = (Prob)awk.dollarToDouble(1);
         if (verbose)
           std::cerr << "hmm p0 value has been set to " << hmmP0 << std::endl;
         return THOT_OK;
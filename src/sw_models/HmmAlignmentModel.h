@@ -104,7 +104,7 @@ public:
   }
 
 protected:
-  typedef std::vector<double> HmmAlignmentCountsElem;
+  typedef std::vector<EmFloat> HmmAlignmentCountsElem;
   typedef OrderedVector<HmmAlignmentKey, HmmAlignmentCountsElem> HmmAlignmentCounts;
 
   const double ExpValMax = exp(-0.01);
@@ -153,10 +153,8 @@ protected:
                           const std::vector<WordIndex>& trgSentIndexVector, int verbose = 0);
   double lgProbGivenForwardMatrix(const std::vector<std::vector<double>>& forwardMatrix);
   void calcAlphaBetaMatrices(const std::vector<WordIndex>& nsrcSent, const std::vector<WordIndex>& trgSent,
-                             PositionIndex slen, std::vector<std::vector<double>>& lexProbs,
-                             std::vector<std::vector<double>>& alignProbs,
-                             std::vector<std::vector<double>>& alphaMatrix,
-                             std::vector<std::vector<double>>& betaMatrix);
+                             PositionIndex slen, Matrix<EmFloat>& lexProbs, Matrix<EmFloat>& alignProbs,
+                             Matrix<EmFloat>& alphaMatrix, Matrix<EmFloat>& betaMatrix);
   PositionIndex getSrcLen(const std::vector<WordIndex>& nsrcWordIndexVec);
   Prob calcProbOfAlignment(CachedHmmAligLgProb& cached_logap, const std::vector<WordIndex>& nsrc,
                            const std::vector<WordIndex>& trg, AlignmentInfo& alignment, int verbose = 0);
@@ -172,6 +170,7 @@ protected:
   bool isValidAlignment(PositionIndex ip, PositionIndex slen, PositionIndex i);
   bool isNullAlignment(PositionIndex ip, PositionIndex slen, PositionIndex i);
   PositionIndex getModifiedIp(PositionIndex ip, PositionIndex slen, PositionIndex i);
+  double getSentencePairCost(PositionIndex slen, PositionIndex tlen) override;
   void batchUpdateCounts(const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs) override;
   void batchMaximizeProbs() override;
 
@@ -100,11 +100,11 @@ bool HmmAlignmentTable::loadPlainText(const char* aligNumDenFile, int verbose)
     {
       if (awk.NF == 5)
       {
-        PositionIndex prev_i = atoi(awk.dollar(1).c_str());
-        PositionIndex slen = atoi(awk.dollar(2).c_str());
-        PositionIndex i = atoi(awk.dollar(3).c_str());
-        float numer = (float)atof(awk.dollar(4).c_str());
-        float denom = (float)atof(awk.dollar(5).c_str());
+        PositionIndex prev_i = awk.dollarToInt(1);
+        PositionIndex slen = awk.dollarToInt(2);
+        PositionIndex i = awk.dollarToInt(3);
+        float numer = (float)awk.dollarToDouble(4);
+        float denom = (float)awk.dollarToDouble(5);
         set(prev_i, slen, i, numer, denom);
       }
     }
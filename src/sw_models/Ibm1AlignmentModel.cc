@@ -45,18 +45,14 @@ unsigned int Ibm1AlignmentModel::startTraining(int verbosity)
       for (PositionIndex i = 0; i <= slen; ++i)
       {
         initSourceWord(nsrc, trg, i);
-        WordIndex s = nsrc[i];
-        if (s >= insertBuffer.size())
-          insertBuffer.resize((size_t)s + 1);
         for (PositionIndex j = 1; j <= tlen; ++j)
         {
           if (i == 0)
             initTargetWord(nsrc, trg, j);
           initWordPair(nsrc, trg, i, j);
-          insertBuffer[s].push_back(trg[j - 1]);
         }
-        insertBufferItems += trg.size();
       }
+      insertBufferItems += addSentenceCooccurrences(nsrc, trg, insertBuffer);
       if (insertBufferItems > ThreadBufferSize * 100)
       {
         insertBufferItems = 0;
@@ -67,6 +63,7 @@ unsigned int Ibm1AlignmentModel::startTraining(int verbosity)
   }
   if (insertBufferItems > 0)
     addTranslationOptions(insertBuffer);
+  pruneTranslationOptions(lexCounts, *lexTable);
 
   if (numSentencePairs() > 0)
   {
@@ -78,25 +75,7 @@ unsigned int Ibm1AlignmentModel::startTraining(int verbosity)
 
 void Ibm1AlignmentModel::train(int verbosity)
 {
-  vector<pair<vector<WordIndex>, vector<WordIndex>>> buffer;
-  for (unsigned int n = 0; n < numSentencePairs(); ++n)
-  {
-    vector<WordIndex> src = getSrcSent(n);
-    vector<WordIndex> trg = getTrgSent(n);
-    if (sentenceLengthIsOk(src) && sentenceLengthIsOk(trg))
-      buffer.push_back(make_pair(src, trg));
-
-    if (buffer.size() >= ThreadBufferSize)
-    {
-      batchUpdateCounts(buffer);
-      buffer.clear();
-    }
-  }
-  if (buffer.size() > 0)
-  {
-    batchUpdateCounts(buffer);
-    buffer.clear();
-  }
+  processBatches([this](const vector<pair<vector<WordIndex>, vector<WordIndex>>>& pairs) { batchUpdateCounts(pairs); });
 
   batchMaximizeProbs();
 }
@@ -134,35 +113,49 @@ void Ibm1AlignmentModel::addTranslationOptions(vector<vector<WordIndex>>& insert
   for (int s = 0; s < (int)insertBuffer.size(); ++s)
   {
     for (WordIndex t : insertBuffer[s])
-      lexCounts[s][t] = 0;
+      lexCounts[s][t] += 1;
     insertBuffer[s].clear();
   }
 }
 
 void Ibm1AlignmentModel::batchUpdateCounts(const vector<pair<vector<WordIndex>, vector<WordIndex>>>& pairs)
 {
-#pragma omp parallel for schedule(dynamic)
-  for (int line_idx = 0; line_idx < (int)pairs.size(); ++line_idx)
+  int numParts = getNumBatchParts(pairs.size());
+  countIncrements.reset(numParts);
+
+#pragma omp parallel
   {
-    vector<WordIndex> src = pairs[line_idx].first;
-    vector<WordIndex> nsrc = extendWithNullWord(src);
-    vector<WordIndex> trg = pairs[line_idx].second;
-    vector<double> probs(nsrc.size());
-    for (PositionIndex j = 1; j <= trg.size(); ++j)
+    // Per-thread buffer, reused by every sentence pair the thread processes
+    vector<double> probs;
+
+#pragma omp for schedule(dynamic)
+    for (int part = 0; part < numParts; ++part)
     {
-      double sum = 0;
-      for (PositionIndex i = 0; i < nsrc.size(); ++i)
-      {
-        probs[i] = getCountNumerator(nsrc, trg, i, j);
-        sum += probs[i];
-      }
-      for (PositionIndex i = 0; i < nsrc.size(); ++i)
+      for (int line_idx = part; line_idx < (int)pairs.size(); line_idx += numParts)
       {
-        double count = probs[i] / sum;
-        incrementWordPairCounts(nsrc, trg, i, j, count);
+        const vector<WordIndex>& src = pairs[line_idx].first;
+        vector<WordIndex> nsrc = extendWithNullWord(src);
+        const vector<WordIndex>& trg = pairs[line_idx].second;
+        probs.resize(nsrc.size());
+        for (PositionIndex j = 1; j <= trg.size(); ++j)
+        {
+          double sum = 0;
+          for (PositionIndex i = 0; i < nsrc.size(); ++i)
+          {
+            probs[i] = getCountNumerator(nsrc, trg, i, j);
+            sum += probs[i];
+          }
+          for (PositionIndex i = 0; i < nsrc.size(); ++i)
+          {
+            double count = probs[i] / sum;
+            incrementWordPairCounts(part, nsrc, trg, i, j, count);
+          }
+        }
       }
     }
   }
+
+  countIncrements.apply();
 }
 
 double Ibm1AlignmentModel::getCountNumerator(const vector<WordIndex>& nsrcSent, const vector<WordIndex>& trgSent,
@@ -173,14 +166,16 @@ double Ibm1AlignmentModel::getCountNumerator(const vector<WordIndex>& nsrcSent,
   return translationProb(s, t);
 }
 
-void Ibm1AlignmentModel::incrementWordPairCounts(const vector<WordIndex>& nsrc, const vector<WordIndex>& trg,
+void Ibm1AlignmentModel::incrementWordPairCounts(int part, const vector<WordIndex>& nsrc, const vector<WordIndex>& trg,
                                                  PositionIndex i, PositionIndex j, double count)
 {
   WordIndex s = nsrc[i];
   WordIndex t = trg[j - 1];
 
-#pragma omp atomic
-  lexCounts[s].find(t)->second += count;
+  // Pruned translation options are not estimated
+  LexCountsElem::iterator iter = lexCounts[s].find(t);
+  if (iter != lexCounts[s].end())
+    countIncrements.add(part, iter->second, count);
 }
 
 void Ibm1AlignmentModel::batchMaximizeProbs()
@@ -227,43 +222,11 @@ pair<double, double> Ibm1AlignmentModel::loglikelihoodForPairRange(pair<unsigned
   return make_pair(loglikelihood, loglikelihood / (double)numSents);
 }
 
-vector<WordIndex> Ibm1AlignmentModel::getSrcSent(unsigned int n)
-{
-  vector<string> srcsStr;
-  vector<WordIndex> result;
-
-  sentenceHandler->getSrcSentence(n, srcsStr);
-  for (unsigned int i = 0; i < srcsStr.size(); ++i)
-  {
-    WordIndex widx = stringToSrcWordIndex(srcsStr[i]);
-    if (widx == UNK_WORD)
-      widx = addSrcSymbol(srcsStr[i]);
-    result.push_back(widx);
-  }
-  return result;
-}
-
 vector<WordIndex> Ibm1AlignmentModel::extendWithNullWord(const vector<WordIndex>& srcWordIndexVec)
 {
   return addNullWordToWidxVec(srcWordIndexVec);
 }
 
-vector<WordIndex> Ibm1AlignmentModel::getTrgSent(unsigned int n)
-{
-  vector<string> trgsStr;
-  vector<WordIndex> trgs;
-
-  sentenceHandler->getTrgSentence(n, trgsStr);
-  for (unsigned int i = 0; i < trgsStr.size(); ++i)
-  {
-    WordIndex widx = stringToTrgWordIndex(trgsStr[i]);
-    if (widx == UNK_WORD)
-      widx = addTrgSymbol(trgsStr[i]);
-    trgs.push_back(widx);
-  }
-  return trgs;
-}
-
 Prob Ibm1AlignmentModel::translationProb(WordIndex s, WordIndex t)
 {
   double logProb = unsmoothedTranslationLogProb(s, t);
@@ -575,6 +538,7 @@ void Ibm1AlignmentModel::clear()
 void Ibm1AlignmentModel::clearTempVars()
 {
   lexCounts.clear();
+  countIncrements.clear();
 }
 
 void Ibm1AlignmentModel::clearSentenceLengthModel()
@@ -70,16 +70,11 @@ public:
   }
 
 protected:
-  const std::size_t ThreadBufferSize = 10000;
-
   std::string getModelTypeStr() const override
   {
     return "ibm1";
   }
 
-  std::vector<WordIndex> getSrcSent(unsigned int n);
-  std::vector<WordIndex> getTrgSent(unsigned int n);
-
   // given a vector with source words, returns a extended vector including extra NULL words
   virtual std::vector<WordIndex> extendWithNullWord(const std::vector<WordIndex>& srcWordIndexVec);
 
@@ -102,7 +97,8 @@ protected:
   virtual void batchUpdateCounts(const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs);
   virtual double getCountNumerator(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
                                    PositionIndex i, PositionIndex j);
-  virtual void incrementWordPairCounts(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+  // Logs the increment of the counts of the word pair (i, j) in the given part of the batch
+  virtual void incrementWordPairCounts(int part, const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
                                        PositionIndex i, PositionIndex j, double count);
   virtual void batchMaximizeProbs();
 
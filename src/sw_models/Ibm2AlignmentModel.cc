@@ -31,6 +31,26 @@ void Ibm2AlignmentModel::setCompactAlignmentTable(bool value)
   compactAlignmentTable = value;
 }
 
+bool Ibm2AlignmentModel::getCollectIbm3TransferCounts() const
+{
+  return collectIbm3TransferCounts;
+}
+
+void Ibm2AlignmentModel::setCollectIbm3TransferCounts(bool value)
+{
+  collectIbm3TransferCounts = value;
+  if (!collectIbm3TransferCounts)
+    ibm3TransferCounts.reset();
+}
+
+void Ibm2AlignmentModel::train(int verbosity)
+{
+  // only the counts of the last iteration are kept
+  if (collectIbm3TransferCounts)
+    ibm3TransferCounts = make_shared<Ibm3TransferCounts>();
+  Ibm1AlignmentModel::train(verbosity);
+}
+
 void Ibm2AlignmentModel::initTargetWord(const vector<WordIndex>& nsrc, const vector<WordIndex>& trg, PositionIndex j)
 {
   Ibm1AlignmentModel::initTargetWord(nsrc, trg, j);
@@ -46,6 +66,61 @@ void Ibm2AlignmentModel::initTargetWord(const vector<WordIndex>& nsrc, const vec
     elem.resize(nsrc.size(), 0);
 }
 
+void Ibm2AlignmentModel::batchUpdateCounts(const vector<pair<vector<WordIndex>, vector<WordIndex>>>& pairs)
+{
+  if (!ibm3TransferCounts)
+  {
+    Ibm1AlignmentModel::batchUpdateCounts(pairs);
+    return;
+  }
+
+  int numParts = getNumBatchParts(pairs.size());
+  countIncrements.reset(numParts);
+  vector<Ibm3TransferCounts> transferCounts(numParts);
+
+#pragma omp parallel
+  {
+    // Per-thread buffer, reused by every sentence pair the thread processes
+    Matrix<double> probs;
+
+#pragma omp for schedule(dynamic)
+    for (int part = 0; part < numParts; ++part)
+    {
+      for (int line_idx = part; line_idx < (int)pairs.size(); line_idx += numParts)
+      {
+        const vector<WordIndex>& src = pairs[line_idx].first;
+        vector<WordIndex> nsrc = extendWithNullWord(src);
+        const vector<WordIndex>& trg = pairs[line_idx].second;
+
+        PositionIndex slen = (PositionIndex)src.size();
+        PositionIndex tlen = (PositionIndex)trg.size();
+
+        probs.assign(slen + 1, tlen + 1, 0.0);
+        for (PositionIndex j = 1; j <= tlen; ++j)
+        {
+          double sum = 0;
+          for (PositionIndex i = 0; i <= slen; ++i)
+          {
+            probs(i, j) = getCountNumerator(nsrc, trg, i, j);
+            sum += probs(i, j);
+          }
+          for (PositionIndex i = 0; i <= slen; ++i)
+          {
+            probs(i, j) /= sum;
+            incrementWordPairCounts(part, nsrc, trg, i, j, probs(i, j));
+          }
+        }
+
+        transferCounts[part].addSentencePair(src, tlen, getCompactedSentenceLength(slen), probs);
+      }
+    }
+  }
+
+  countIncrements.apply();
+  for (const Ibm3TransferCounts& partTransferCounts : transferCounts)
+    ibm3TransferCounts->add(partTransferCounts);
+}
+
 double Ibm2AlignmentModel::getCountNumerator(const vector<WordIndex>& nsrcSent, const vector<WordIndex>& trgSent,
                                              unsigned int i, unsigned int j)
 {
@@ -54,15 +129,13 @@ double Ibm2AlignmentModel::getCountNumerator(const vector<WordIndex>& nsrcSent,
   return d;
 }
 
-void Ibm2AlignmentModel::incrementWordPairCounts(const vector<WordIndex>& nsrc, const vector<WordIndex>& trg,
+void Ibm2AlignmentModel::incrementWordPairCounts(int part, const vector<WordIndex>& nsrc, const vector<WordIndex>& trg,
                                                  PositionIndex i, PositionIndex j, double count)
 {
-  Ibm1AlignmentModel::incrementWordPairCounts(nsrc, trg, i, j, count);
+  Ibm1AlignmentModel::incrementWordPairCounts(part, nsrc, trg, i, j, count);
 
   AlignmentKey key{j, (PositionIndex)nsrc.size() - 1, getCompactedSentenceLength(trg.size())};
-
-#pragma omp atomic
-  alignmentCounts[key][i] += count;
+  countIncrements.add(part, alignmentCounts[key][i], count);
 }
 
 void Ibm2AlignmentModel::batchMaximizeProbs()
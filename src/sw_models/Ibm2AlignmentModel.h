@@ -2,6 +2,7 @@
 
 #include "sw_models/AlignmentTable.h"
 #include "sw_models/Ibm1AlignmentModel.h"
+#include "sw_models/Ibm3TransferCounts.h"
 
 #include <memory>
 #include <unordered_map>
@@ -9,6 +10,7 @@
 class Ibm2AlignmentModel : public Ibm1AlignmentModel
 {
   friend class IncrIbm2AlignmentTrainer;
+  friend class Ibm3AlignmentModel;
 
 public:
   Ibm2AlignmentModel();
@@ -23,6 +25,14 @@ public:
   bool getCompactAlignmentTable() const;
   void setCompactAlignmentTable(bool value);
 
+  // When enabled, each training iteration also estimates the initial distortion and fertility counts of an IBM-3 model
+  // from its alignment posteriors. An IBM-3 model created from this model then starts from the counts of the last
+  // iteration instead of estimating them in a separate pass over the corpus with the final parameters.
+  bool getCollectIbm3TransferCounts() const;
+  void setCollectIbm3TransferCounts(bool value);
+
+  void train(int verbosity = 0) override;
+
   // Returns p(i|j,slen,tlen)
   virtual Prob alignmentProb(PositionIndex j, PositionIndex slen, PositionIndex tlen, PositionIndex i);
   // Returns log(p(i|j,slen,tlen))
@@ -49,7 +59,7 @@ public:
   }
 
 protected:
-  typedef std::vector<double> AlignmentCountsElem;
+  typedef std::vector<EmFloat> AlignmentCountsElem;
   typedef OrderedVector<AlignmentKey, AlignmentCountsElem> AlignmentCounts;
 
   std::string getModelTypeStr() const override
@@ -66,10 +76,11 @@ protected:
   LgProb getIbm2SumLogProb(const std::vector<WordIndex>& nsSent, const std::vector<WordIndex>& tSent, int verbose = 0);
 
   void initTargetWord(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg, PositionIndex j) override;
+  void batchUpdateCounts(const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs) override;
   double getCountNumerator(const std::vector<WordIndex>& nsrcSent, const std::vector<WordIndex>& trgSent,
                            unsigned int i, unsigned int j) override;
-  void incrementWordPairCounts(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg, PositionIndex i,
-                               PositionIndex j, double count) override;
+  void incrementWordPairCounts(int part, const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                               PositionIndex i, PositionIndex j, double count) override;
   void batchMaximizeProbs() override;
   PositionIndex getCompactedSentenceLength(PositionIndex len);
 
@@ -78,10 +89,12 @@ protected:
   void createConfig(YAML::Emitter& out) override;
 
   bool compactAlignmentTable = true;
+  bool collectIbm3TransferCounts = false;
 
   // model parameters
   std::shared_ptr<AlignmentTable> alignmentTable;
 
   // EM counts
   AlignmentCounts alignmentCounts;
+  std::shared_ptr<Ibm3TransferCounts> ibm3TransferCounts;
 };
@@ -13,7 +13,7 @@ Ibm3AlignmentModel::Ibm3AlignmentModel()
 Ibm3AlignmentModel::Ibm3AlignmentModel(Ibm2AlignmentModel& model)
     : Ibm2AlignmentModel{model}, p1{std::make_shared<Prob>(DefaultP1)},
       distortionTable{std::make_shared<DistortionTable>()}, fertilityTable{std::make_shared<FertilityTable>()},
-      performIbm2Transfer{true}
+      performIbm2Transfer{true}, transferCounts{model.ibm3TransferCounts}
 {
   maxSentenceLength = MaxSentenceLength;
 }
@@ -21,8 +21,11 @@ Ibm3AlignmentModel::Ibm3AlignmentModel(Ibm2AlignmentModel& model)
 Ibm3AlignmentModel::Ibm3AlignmentModel(HmmAlignmentModel& model)
     : Ibm2AlignmentModel{model}, p1{std::make_shared<Prob>(DefaultP1)},
       distortionTable{std::make_shared<DistortionTable>()},
-      fertilityTable{std::make_shared<FertilityTable>()}, hmmModel{new HmmAlignmentModel{model}}
+      fertilityTable{std::make_shared<FertilityTable>()}, transferCounts{model.ibm3TransferCounts}
 {
+  // without the counts collected by the HMM model, they are estimated with it in the first training iteration
+  if (!transferCounts)
+    hmmModel.reset(new HmmAlignmentModel{model});
   maxSentenceLength = MaxSentenceLength;
 }
 
@@ -62,7 +65,14 @@ unsigned int Ibm3AlignmentModel::startTraining(int verbosity)
   for (WordIndex s = 3; s < getSrcVocabSize(); ++s)
     maxSrcWordLen = std::max(maxSrcWordLen, wordIndexToSrcString(s).length());
 
-  if (performIbm2Transfer)
+  if (transferCounts)
+  {
+    addTransferCounts(*transferCounts);
+    batchMaximizeIbm3Probs();
+    transferCounts.reset();
+    performIbm2Transfer = false;
+  }
+  else if (performIbm2Transfer)
   {
     ibm2Transfer();
     performIbm2Transfer = false;
@@ -72,25 +82,9 @@ unsigned int Ibm3AlignmentModel::startTraining(int verbosity)
 
 void Ibm3AlignmentModel::ibm2Transfer()
 {
-  std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>> buffer;
-  for (unsigned int n = 0; n < numSentencePairs(); ++n)
-  {
-    std::vector<WordIndex> src = getSrcSent(n);
-    std::vector<WordIndex> trg = getTrgSent(n);
-    if (sentenceLengthIsOk(src) && sentenceLengthIsOk(trg))
-      buffer.push_back(make_pair(src, trg));
-
-    if (buffer.size() >= ThreadBufferSize)
-    {
-      ibm2TransferUpdateCounts(buffer);
-      buffer.clear();
-    }
-  }
-  if (buffer.size() > 0)
-  {
-    ibm2TransferUpdateCounts(buffer);
-    buffer.clear();
-  }
+  processBatches([this](const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs) {
+    ibm2TransferUpdateCounts(pairs);
+  });
 
   batchMaximizeProbs();
 }
@@ -98,86 +92,85 @@ void Ibm3AlignmentModel::ibm2Transfer()
 void Ibm3AlignmentModel::ibm2TransferUpdateCounts(
     const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs)
 {
-#pragma omp parallel for schedule(dynamic)
-  for (int line_idx = 0; line_idx < (int)pairs.size(); ++line_idx)
-  {
-    std::vector<WordIndex> src = pairs[line_idx].first;
-    std::vector<WordIndex> nsrc = extendWithNullWord(src);
-    std::vector<WordIndex> trg = pairs[line_idx].second;
+  int numParts = getNumBatchParts(pairs.size());
+  countIncrements.reset(numParts);
+  std::vector<Ibm3TransferCounts> counts(numParts);
 
-    PositionIndex slen = PositionIndex(src.size());
-    PositionIndex tlen = PositionIndex(trg.size());
+#pragma omp parallel
+  {
+    // Per-thread buffer, reused by every sentence pair the thread processes
+    Matrix<double> probs;
 
-    Matrix<double> probs{slen + 1, tlen + 1};
-    for (PositionIndex j = 1; j <= tlen; ++j)
+#pragma omp for schedule(dynamic)
+    for (int part = 0; part < numParts; ++part)
     {
-      double sum = 0;
-      for (PositionIndex i = 0; i <= slen; ++i)
+      for (int line_idx = part; line_idx < (int)pairs.size(); line_idx += numParts)
       {
-        probs(i, j) = getCountNumerator(nsrc, trg, i, j);
-        sum += probs(i, j);
-      }
-      if (sum > 0)
-      {
-        for (PositionIndex i = 0; i <= slen; ++i)
+        const std::vector<WordIndex>& src = pairs[line_idx].first;
+        std::vector<WordIndex> nsrc = extendWithNullWord(src);
+        const std::vector<WordIndex>& trg = pairs[line_idx].second;
+
+        PositionIndex slen = PositionIndex(src.size());
+        PositionIndex tlen = PositionIndex(trg.size());
+
+        probs.assign(slen + 1, tlen + 1, 0.0);
+        for (PositionIndex j = 1; j <= tlen; ++j)
         {
-          probs(i, j) /= sum;
-          if (probs(i, j) == 1.0)
-            probs(i, j) = 0.99;
-          else if (probs(i, j) == 0)
-            probs(i, j) = SW_PROB_SMOOTH;
-          double count = probs(i, j);
-          if (count > SW_PROB_SMOOTH)
+          double sum = 0;
+          for (PositionIndex i = 0; i <= slen; ++i)
+          {
+            probs(i, j) = getCountNumerator(nsrc, trg, i, j);
+            sum += probs(i, j);
+          }
+          if (sum > 0)
           {
-            Ibm2AlignmentModel::incrementWordPairCounts(nsrc, trg, i, j, count);
-            if (i > 0)
-            {
-              DistortionKey key{i, getCompactedSentenceLength(slen), tlen};
-
-#pragma omp atomic
-              distortionCounts[key][j - 1] += count;
-            }
+            for (PositionIndex i = 0; i <= slen; ++i)
+              probs(i, j) /= sum;
           }
         }
-      }
-    }
 
-    PositionIndex maxFertility = std::min(tlen + 1, MaxFertility);
-    Matrix<double> alpha{maxFertility, slen + 1};
-    for (PositionIndex i = 1; i <= slen; ++i)
-    {
-      for (PositionIndex phi = 1; phi < maxFertility; ++phi)
-      {
-        double beta = 0;
-        alpha(phi, i) = 0;
+        counts[part].addSentencePair(src, tlen, getCompactedSentenceLength(slen), probs);
+
         for (PositionIndex j = 1; j <= tlen; ++j)
         {
-          double prob = probs(i, j);
-          if (prob > 0.95)
-            prob = 0.95;
-          else if (prob < 0.05)
-            prob = 0.05;
-          beta += pow(prob / (1.0 - prob), double(phi));
+          for (PositionIndex i = 0; i <= slen; ++i)
+          {
+            if (probs(i, j) > SW_PROB_SMOOTH)
+              Ibm2AlignmentModel::incrementWordPairCounts(part, nsrc, trg, i, j, probs(i, j));
+          }
         }
-        alpha(phi, i) = beta * pow(-1.0, double(phi) + 1.0) / double(phi);
       }
     }
+  }
 
-    for (PositionIndex i = 1; i <= slen; ++i)
-    {
-      WordIndex s = nsrc[i];
-      double r = 1;
-      for (PositionIndex j = 1; j <= tlen; ++j)
-        r *= 1 - probs(i, j);
-      for (PositionIndex phi = 0; phi < maxFertility; ++phi)
-      {
-        double sum = getSumOfPartitions(phi, i, alpha);
-        double count = r * sum;
+  countIncrements.apply();
+  // the counts of the parts are summed in double precision and added to the model counts once
+  for (int part = 1; part < numParts; ++part)
+    counts[0].add(counts[part]);
+  if (numParts > 0)
+    addTransferCounts(counts[0]);
+}
 
-#pragma omp atomic
-        fertilityCounts[s][phi] += count;
-      }
-    }
+void Ibm3AlignmentModel::addTransferCounts(const Ibm3TransferCounts& counts)
+{
+  for (auto& entry : counts.distortionCounts)
+  {
+    // the lower model may have been trained on sentences that are too long for this model
+    DistortionCounts::iterator distortionIter = distortionCounts.find(entry.first);
+    if (distortionIter == distortionCounts.end())
+      continue;
+    DistortionCountsElem& distortionEntry = distortionIter->second;
+    for (size_t j = 0; j < entry.second.size() && j < distortionEntry.size(); ++j)
+      distortionEntry[j] += entry.second[j];
+  }
+
+  for (auto& entry : counts.fertilityCounts)
+  {
+    if (entry.first >= fertilityCounts.size() || fertilityCounts[entry.first].empty())
+      continue;
+    FertilityCountsElem& fertilityEntry = fertilityCounts[entry.first];
+    for (PositionIndex phi = 0; phi < MaxFertility; ++phi)
+      fertilityEntry[phi] += entry.second[phi];
   }
 }
 
@@ -210,103 +203,19 @@ void Ibm3AlignmentModel::hmmTransfer()
     return prob;
   };
 
-  std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>> buffer;
-  for (unsigned int n = 0; n < numSentencePairs(); ++n)
-  {
-    std::vector<WordIndex> src = getSrcSent(n);
-    std::vector<WordIndex> trg = getTrgSent(n);
-    if (sentenceLengthIsOk(src) && sentenceLengthIsOk(trg))
-      buffer.push_back(make_pair(src, trg));
-
-    if (buffer.size() >= ThreadBufferSize)
-    {
-      batchUpdateCounts(buffer, search);
-      buffer.clear();
-    }
-  }
-  if (buffer.size() > 0)
-  {
-    batchUpdateCounts(buffer, search);
-    buffer.clear();
-  }
+  processBatches(
+      [this, &search](const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs) {
+        batchUpdateCounts(pairs, search);
+      });
 
   batchMaximizeProbs();
 }
 
-double Ibm3AlignmentModel::getSumOfPartitions(PositionIndex phi, PositionIndex srcPos, const Matrix<double>& alpha)
+double Ibm3AlignmentModel::getSentencePairCost(PositionIndex slen, PositionIndex tlen)
 {
-  std::vector<PositionIndex> partitions(MaxFertility, 0);
-  std::vector<PositionIndex> mult(MaxFertility, 0);
-  PositionIndex numPartitions = 0;
-  double sum = 0;
-
-  bool done = false;
-  bool init = true;
-  while (!done)
-  {
-    if (init)
-    {
-      partitions[1] = phi;
-      mult[1] = 1;
-      numPartitions = 1;
-      init = false;
-    }
-    else
-    {
-      if ((partitions[numPartitions] > 1) || (numPartitions > 1))
-      {
-        int s;
-        PositionIndex k;
-        if (partitions[numPartitions] == 1)
-        {
-          s = partitions[numPartitions - 1] + mult[numPartitions];
-          k = numPartitions - 1;
-        }
-        else
-        {
-          s = partitions[numPartitions];
-          k = numPartitions;
-        }
-        int w = partitions[k] - 1;
-        int u = s / w;
-        int v = s % w;
-        mult[k] -= 1;
-        PositionIndex k1;
-        if (mult[k] == 0)
-          k1 = k;
-        else
-          k1 = k + 1;
-        mult[k1] = u;
-        partitions[k1] = w;
-        if (v == 0)
-        {
-          numPartitions = k1;
-        }
-        else
-        {
-          mult[(size_t)k1 + 1] = 1;
-          partitions[(size_t)k1 + 1] = v;
-          numPartitions = k1 + 1;
-        }
-      }
-      else
-      {
-        done = true;
-      }
-    }
-
-    if (!done)
-    {
-      double prod = 1.0;
-      if (phi != 0)
-      {
-        for (PositionIndex i = 1; i <= numPartitions; ++i)
-          prod *= pow(alpha(partitions[i], srcPos), mult[i]) / MathFuncs::factorial(mult[i]);
-      }
-      sum += prod;
-    }
-  }
-  return sum < 0 ? 0 : sum;
+  // each step of the hill-climbing search scores the (slen + 1) * tlen moves and the tlen * tlen swaps of the
+  // neighbourhood, and the number of steps grows with tlen
+  return double(slen + 1 + tlen) * tlen * tlen;
 }
 
 void Ibm3AlignmentModel::initSentencePair(const std::vector<WordIndex>& src, const std::vector<WordIndex>& trg)
@@ -350,7 +259,7 @@ void Ibm3AlignmentModel::addTranslationOptions(std::vector<std::vector<WordIndex
   for (int s = 0; s < (int)insertBuffer.size(); ++s)
   {
     for (WordIndex t : insertBuffer[s])
-      lexCounts[s][t] = 0;
+      lexCounts[s][t] += 1;
 
     FertilityCountsElem& fertilityEntry = fertilityCounts[s];
     fertilityEntry.resize(MaxFertility, 0);
@@ -373,44 +282,90 @@ void Ibm3AlignmentModel::batchUpdateCounts(
     const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs,
     SearchForBestAlignmentFunc search)
 {
-#pragma omp parallel for schedule(dynamic)
-  for (int line_idx = 0; line_idx < (int)pairs.size(); ++line_idx)
-  {
-    std::vector<WordIndex> src = pairs[line_idx].first;
-    std::vector<WordIndex> nsrc = extendWithNullWord(src);
-    std::vector<WordIndex> trg = pairs[line_idx].second;
+  int numParts = getNumBatchParts(pairs.size());
+  countIncrements.reset(numParts);
+  std::vector<std::unique_ptr<BatchCounts>> counts(numParts);
 
-    AlignmentInfo alignment(nsrc.size() - 1, trg.size());
+#pragma omp parallel
+  {
     Matrix<double> moveScores, swapScores;
-    double aligProb = search(src, trg, alignment, moveScores, swapScores);
-    if (aligProb <= 0)
-      continue;
 
-    updateCounts(nsrc, trg, alignment, aligProb, moveScores, swapScores);
+#pragma omp for schedule(dynamic)
+    for (int part = 0; part < numParts; ++part)
+    {
+      counts[part] = createBatchCounts();
+      for (int line_idx = part; line_idx < (int)pairs.size(); line_idx += numParts)
+      {
+        const std::vector<WordIndex>& src = pairs[line_idx].first;
+        std::vector<WordIndex> nsrc = extendWithNullWord(src);
+        const std::vector<WordIndex>& trg = pairs[line_idx].second;
+
+        AlignmentInfo alignment(nsrc.size() - 1, trg.size());
+        double aligProb = search(src, trg, alignment, moveScores, swapScores);
+        if (aligProb <= 0)
+          continue;
+
+        updateCounts(part, nsrc, trg, alignment, aligProb, moveScores, swapScores, *counts[part]);
+      }
+    }
   }
+
+  countIncrements.apply();
+  // the counts of the parts are summed in double precision and added to the model counts once
+  for (int part = 1; part < numParts; ++part)
+    counts[0]->add(*counts[part]);
+  if (numParts > 0)
+    addBatchCounts(*counts[0]);
 }
 
-void Ibm3AlignmentModel::incrementWordPairCounts(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
-                                                 PositionIndex i, PositionIndex j, double count)
+void Ibm3AlignmentModel::BatchCounts::add(const BatchCounts& counts)
 {
-  Ibm2AlignmentModel::incrementWordPairCounts(nsrc, trg, i, j, count);
+  for (auto& entry : counts.distortionCounts)
+  {
+    std::vector<double>& distortionEntry = distortionCounts[entry.first];
+    if (distortionEntry.size() < entry.second.size())
+      distortionEntry.resize(entry.second.size(), 0);
+    for (size_t j = 0; j < entry.second.size(); ++j)
+      distortionEntry[j] += entry.second[j];
+  }
 
-  DistortionKey key{i, getCompactedSentenceLength(nsrc.size() - 1), (PositionIndex)trg.size()};
+  for (auto& entry : counts.fertilityCounts)
+  {
+    std::vector<double>& fertilityEntry = fertilityCounts[entry.first];
+    if (fertilityEntry.size() < entry.second.size())
+      fertilityEntry.resize(entry.second.size(), 0);
+    for (size_t phi = 0; phi < entry.second.size(); ++phi)
+      fertilityEntry[phi] += entry.second[phi];
+  }
+
+  p1Count += counts.p1Count;
+  p0Count += counts.p0Count;
+}
 
-#pragma omp atomic
-  distortionCounts[key][j - 1] += count;
+std::unique_ptr<Ibm3AlignmentModel::BatchCounts> Ibm3AlignmentModel::createBatchCounts()
+{
+  return std::unique_ptr<BatchCounts>{new BatchCounts};
 }
 
-double Ibm3AlignmentModel::updateCounts(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+double Ibm3AlignmentModel::updateCounts(int part, const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
                                         AlignmentInfo& alignment, double aligProb, const Matrix<double>& moveScores,
-                                        const Matrix<double>& swapScores)
+                                        const Matrix<double>& swapScores, BatchCounts& counts)
 {
   PositionIndex slen = (PositionIndex)nsrc.size() - 1;
   PositionIndex tlen = (PositionIndex)trg.size();
 
-  Matrix<double> moveCounts(slen + 1, tlen + 1), swapCounts(slen + 1, tlen + 1);
-  std::vector<double> negMove((size_t)tlen + 1), negSwap((size_t)tlen + 1), plus1Fert((size_t)slen + 1),
-      minus1Fert((size_t)slen + 1);
+  Matrix<double>& moveCounts = counts.moveCounts;
+  Matrix<double>& swapCounts = counts.swapCounts;
+  moveCounts.assign(slen + 1, tlen + 1, 0.0);
+  swapCounts.assign(slen + 1, tlen + 1, 0.0);
+  std::vector<double>& negMove = counts.negMove;
+  std::vector<double>& negSwap = counts.negSwap;
+  std::vector<double>& plus1Fert = counts.plus1Fert;
+  std::vector<double>& minus1Fert = counts.minus1Fert;
+  negMove.assign((size_t)tlen + 1, 0.0);
+  negSwap.assign((size_t)tlen + 1, 0.0);
+  plus1Fert.assign((size_t)slen + 1, 0.0);
+  minus1Fert.assign((size_t)slen + 1, 0.0);
   double totalMove = aligProb;
   double totalSwap = 0;
 
@@ -444,16 +399,23 @@ double Ibm3AlignmentModel::updateCounts(const std::vector<WordIndex>& nsrc, cons
   }
 
   double totalCount = totalMove + totalSwap;
-  Matrix<double> fertCounts(slen + 1, MaxFertility + 1);
+  Matrix<double>& fertCounts = counts.fertCounts;
+  fertCounts.assign(slen + 1, MaxFertility + 1, 0.0);
   for (PositionIndex i = 0; i <= slen; ++i)
   {
+    std::vector<double>& distortionEntry =
+        counts.distortionCounts[DistortionKey{i, getCompactedSentenceLength(slen), tlen}];
+    distortionEntry.resize(tlen, 0);
     for (PositionIndex j = 1; j <= tlen; ++j)
     {
       double count =
           i == alignment.get(j) ? totalCount - (negMove[j] + negSwap[j]) : moveCounts(i, j) + swapCounts(i, j);
       count /= totalCount;
       if (count > countThreshold)
-        incrementWordPairCounts(nsrc, trg, i, j, count);
+      {
+        Ibm2AlignmentModel::incrementWordPairCounts(part, nsrc, trg, i, j, count);
+        distortionEntry[j - 1] += count;
+      }
     }
 
     if (i > 0)
@@ -471,14 +433,10 @@ double Ibm3AlignmentModel::updateCounts(const std::vector<WordIndex>& nsrc, cons
 
   for (PositionIndex i = 1; i <= slen; ++i)
   {
-    WordIndex s = nsrc[i];
+    std::vector<double>& fertilityEntry = counts.fertilityCounts[nsrc[i]];
+    fertilityEntry.resize(MaxFertility, 0);
     for (PositionIndex phi = 0; phi < MaxFertility; ++phi)
-    {
-      double count = fertCounts(i, phi) / totalCount;
-
-#pragma omp atomic
-      fertilityCounts[s][phi] += count;
-    }
+      fertilityEntry[phi] += fertCounts(i, phi) / totalCount;
   }
 
   PositionIndex phi0 = alignment.getFertility(0);
@@ -496,18 +454,42 @@ double Ibm3AlignmentModel::updateCounts(const std::vector<WordIndex>& nsrc, cons
     p0c += plus1Fert[0] * (tlen - 2 * (phi0 + 1));
   }
 
-#pragma omp atomic
-  p1Count += p1c / totalCount;
-#pragma omp atomic
-  p0Count += p0c / totalCount;
+  counts.p1Count += p1c / totalCount;
+  counts.p0Count += p0c / totalCount;
 
   return totalCount;
 }
 
+void Ibm3AlignmentModel::addBatchCounts(BatchCounts& counts)
+{
+  for (auto& entry : counts.distortionCounts)
+  {
+    DistortionCountsElem& distortionEntry = distortionCounts[entry.first];
+    if (distortionEntry.size() < entry.second.size())
+      distortionEntry.resize(entry.second.size(), 0);
+    for (size_t j = 0; j < entry.second.size(); ++j)
+      distortionEntry[j] += entry.second[j];
+  }
+
+  for (auto& entry : counts.fertilityCounts)
+  {
+    FertilityCountsElem& fertilityEntry = fertilityCounts[entry.first];
+    for (PositionIndex phi = 0; phi < MaxFertility; ++phi)
+      fertilityEntry[phi] += entry.second[phi];
+  }
+
+  p1Count += counts.p1Count;
+  p0Count += counts.p0Count;
+}
+
 void Ibm3AlignmentModel::batchMaximizeProbs()
 {
   Ibm2AlignmentModel::batchMaximizeProbs();
+  batchMaximizeIbm3Probs();
+}
 
+void Ibm3AlignmentModel::batchMaximizeIbm3Probs()
+{
 #pragma omp parallel for schedule(dynamic)
   for (int asIndex = 0; asIndex < (int)distortionCounts.size(); ++asIndex)
   {
@@ -529,17 +511,15 @@ void Ibm3AlignmentModel::batchMaximizeProbs()
     distortionTable->setDenominator(key.i, key.slen, key.tlen, logDenom);
   }
 
+  // The counts of the words are added in the order of the words, so that the probabilities do not depend on the number
+  // of threads
   Matrix<double> counts(maxSrcWordLen + 1, MaxFertility + 1, 0.0);
-#pragma omp parallel for schedule(dynamic)
-  for (int s = 3; s < (int)fertilityCounts.size(); ++s)
+  for (WordIndex s = 3; s < fertilityCounts.size(); ++s)
   {
     size_t len = wordIndexToSrcString(s).length();
     FertilityCountsElem& elem = fertilityCounts[s];
     for (PositionIndex phi = 0; phi < MaxFertility; ++phi)
-    {
-#pragma omp atomic
-      counts(len, phi) += std::max(elem[phi], SW_PROB_SMOOTH);
-    }
+      counts(len, phi) += std::max<double>(elem[phi], SW_PROB_SMOOTH);
   }
 
   for (size_t i = 1; i < maxSrcWordLen + 1; ++i)
@@ -562,7 +542,7 @@ void Ibm3AlignmentModel::batchMaximizeProbs()
     FertilityCountsElem& elem = fertilityCounts[s];
     for (PositionIndex phi = 0; phi < MaxFertility; ++phi)
     {
-      double numer = std::max(elem[phi], SW_PROB_SMOOTH) + (counts(len, phi) * fertilitySmoothFactor);
+      double numer = std::max<double>(elem[phi], SW_PROB_SMOOTH) + (counts(len, phi) * fertilitySmoothFactor);
       denom += numer;
       fertilityTable->setNumerator(s, phi, (float)log(numer));
       elem[phi] = 0.0;
@@ -927,17 +907,16 @@ Prob Ibm3AlignmentModel::searchForBestAlignment(const std::vector<WordIndex>& sr
   // start with IBM-2 alignment
   getInitialAlignmentForSearch(nsrc, trg, bestAlignment);
 
-  if (moveScores != nullptr)
-    moveScores->resize(slen + 1, tlen + 1);
-  if (swapScores != nullptr)
-    swapScores->resize(tlen + 1, tlen + 1);
+  // scores of the whole neighbourhood are only computed for the initial alignment, after each change only the
+  // scores affected by it are updated, its matrices are kept per thread so that their storage is reused across calls
+  static thread_local Neighbourhood neighbourhood;
+  initNeighbourhood(nsrc, trg, bestAlignment, neighbourhood);
 
   // hillclimbing search
   int bestChangeType = -1;
   int changes = 0;
   while (bestChangeType != 0)
   {
-    double cachedAlignmentValue = -1;
     bestChangeType = 0;
     PositionIndex bestChangeArg1 = 0;
     PositionIndex bestChangeArg2 = 0;
@@ -951,9 +930,7 @@ Prob Ibm3AlignmentModel::searchForBestAlignment(const std::vector<WordIndex>& sr
       {
         if (iAlig != bestAlignment.get(j1))
         {
-          double changeScore = swapScore(nsrc, trg, j, j1, bestAlignment, cachedAlignmentValue);
-          if (swapScores != nullptr)
-            swapScores->set(j, j1, changeScore);
+          double changeScore = neighbourhood.swapScores(j, j1);
           if (changeScore > bestChangeScore)
           {
             bestChangeScore = changeScore;
@@ -962,10 +939,6 @@ Prob Ibm3AlignmentModel::searchForBestAlignment(const std::vector<WordIndex>& sr
             bestChangeArg2 = j1;
           }
         }
-        else if (swapScores != nullptr)
-        {
-          swapScores->set(j, j1, 1.0);
-        }
       }
 
       // move alignment by one position
@@ -973,9 +946,7 @@ Prob Ibm3AlignmentModel::searchForBestAlignment(const std::vector<WordIndex>& sr
       {
         if (i != iAlig)
         {
-          double changeScore = moveScore(nsrc, trg, i, j, bestAlignment, cachedAlignmentValue);
-          if (moveScores != nullptr)
-            moveScores->set(i, j, changeScore);
+          double changeScore = neighbourhood.moveScores(i, j);
           if ((i != 0 || (tlen >= 2 * (bestAlignment.getFertility(0) + 1)))
               && bestAlignment.getFertility(i) + 1 < MaxFertility && changeScore > bestChangeScore)
           {
@@ -985,12 +956,9 @@ Prob Ibm3AlignmentModel::searchForBestAlignment(const std::vector<WordIndex>& sr
             bestChangeArg2 = i;
           }
         }
-        else if (moveScores != nullptr)
-        {
-          moveScores->set(i, j, 1.0);
-        }
       }
     }
+    ++changes;
     if (bestChangeType == 1)
     {
       // swap
@@ -1000,21 +968,138 @@ Prob Ibm3AlignmentModel::searchForBestAlignment(const std::vector<WordIndex>& sr
       PositionIndex i1 = bestAlignment.get(j1);
       bestAlignment.set(j, i1);
       bestAlignment.set(j1, i);
+      // the returned scores are those of the last explored neighbourhood
+      if (changes <= 60)
+        updateNeighbourhoodAfterSwap(nsrc, trg, bestAlignment, j, j1, neighbourhood);
     }
     else if (bestChangeType == 2)
     {
       // move
       PositionIndex j = bestChangeArg1;
       PositionIndex i = bestChangeArg2;
+      PositionIndex iOld = bestAlignment.get(j);
       bestAlignment.set(j, i);
+      if (changes <= 60)
+        updateNeighbourhoodAfterMove(nsrc, trg, bestAlignment, j, iOld, neighbourhood);
     }
-    ++changes;
     if (changes > 60)
       break;
   }
+
+  if (moveScores != nullptr)
+    *moveScores = neighbourhood.moveScores;
+  if (swapScores != nullptr)
+    *swapScores = neighbourhood.swapScores;
   return calcProbOfAlignment(nsrc, trg, bestAlignment);
 }
 
+void Ibm3AlignmentModel::initNeighbourhood(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                           AlignmentInfo& alignment, Neighbourhood& neighbourhood)
+{
+  PositionIndex slen = (PositionIndex)nsrc.size() - 1;
+  PositionIndex tlen = (PositionIndex)trg.size();
+
+  neighbourhood.translationProbs.assign(slen + 1, tlen + 1, 0.0);
+  neighbourhood.distortionProbs.assign(slen + 1, tlen + 1, 0.0);
+  for (PositionIndex i = 0; i <= slen; ++i)
+  {
+    for (PositionIndex j = 1; j <= tlen; ++j)
+    {
+      neighbourhood.translationProbs(i, j) = translationProb(nsrc[i], trg[j - 1]);
+      if (i > 0)
+        neighbourhood.distortionProbs(i, j) = distortionProb(i, slen, tlen, j);
+    }
+  }
+
+  // a move can increase the fertility of a source word up to tlen + 1
+  neighbourhood.fertilityProbs.assign(slen + 1, tlen + 2, 0.0);
+  for (PositionIndex i = 1; i <= slen; ++i)
+  {
+    for (PositionIndex phi = 0; phi <= tlen + 1; ++phi)
+      neighbourhood.fertilityProbs(i, phi) = fertilityProb(nsrc[i], phi);
+  }
+
+  neighbourhood.moveScores.assign(slen + 1, tlen + 1, 0.0);
+  neighbourhood.swapScores.assign(tlen + 1, tlen + 1, 0.0);
+  for (PositionIndex j = 1; j <= tlen; ++j)
+  {
+    for (PositionIndex j1 = j + 1; j1 <= tlen; ++j1)
+      neighbourhood.swapScores(j, j1) = tabulatedSwapScore(neighbourhood, j, j1, alignment);
+    for (PositionIndex i = 0; i <= slen; ++i)
+      neighbourhood.moveScores(i, j) = tabulatedMoveScore(neighbourhood, i, j, alignment);
+  }
+}
+
+void Ibm3AlignmentModel::updateNeighbourhoodAfterMove(const std::vector<WordIndex>& nsrc,
+                                                      const std::vector<WordIndex>& trg, AlignmentInfo& alignment,
+                                                      PositionIndex j, PositionIndex iOld, Neighbourhood& neighbourhood)
+{
+  PositionIndex slen = (PositionIndex)nsrc.size() - 1;
+  PositionIndex tlen = (PositionIndex)trg.size();
+  PositionIndex iNew = alignment.get(j);
+
+  // the fertilities of iOld and iNew have changed, which affects the moves from and to them, and the position j is
+  // aligned to a different word
+  for (PositionIndex j1 = 1; j1 <= tlen; ++j1)
+  {
+    PositionIndex i1 = alignment.get(j1);
+    if (j1 == j || i1 == iOld || i1 == iNew)
+    {
+      for (PositionIndex i = 0; i <= slen; ++i)
+        neighbourhood.moveScores(i, j1) = tabulatedMoveScore(neighbourhood, i, j1, alignment);
+    }
+    else
+    {
+      neighbourhood.moveScores(iOld, j1) = tabulatedMoveScore(neighbourhood, iOld, j1, alignment);
+      neighbourhood.moveScores(iNew, j1) = tabulatedMoveScore(neighbourhood, iNew, j1, alignment);
+    }
+  }
+
+  // swaps do not depend on fertilities
+  for (PositionIndex j1 = 1; j1 < j; ++j1)
+    neighbourhood.swapScores(j1, j) = tabulatedSwapScore(neighbourhood, j1, j, alignment);
+  for (PositionIndex j1 = j + 1; j1 <= tlen; ++j1)
+    neighbourhood.swapScores(j, j1) = tabulatedSwapScore(neighbourhood, j, j1, alignment);
+}
+
+void Ibm3AlignmentModel::updateNeighbourhoodAfterSwap(const std::vector<WordIndex>& nsrc,
+                                                      const std::vector<WordIndex>& trg, AlignmentInfo& alignment,
+                                                      PositionIndex j1, PositionIndex j2, Neighbourhood& neighbourhood)
+{
+  PositionIndex slen = (PositionIndex)nsrc.size() - 1;
+  PositionIndex tlen = (PositionIndex)trg.size();
+
+  // fertilities are not modified by a swap, only the changes of j1 and j2 are affected
+  for (PositionIndex j : {j1, j2})
+  {
+    for (PositionIndex i = 0; i <= slen; ++i)
+      neighbourhood.moveScores(i, j) = tabulatedMoveScore(neighbourhood, i, j, alignment);
+    for (PositionIndex j3 = 1; j3 < j; ++j3)
+      neighbourhood.swapScores(j3, j) = tabulatedSwapScore(neighbourhood, j3, j, alignment);
+    for (PositionIndex j3 = j + 1; j3 <= tlen; ++j3)
+      neighbourhood.swapScores(j, j3) = tabulatedSwapScore(neighbourhood, j, j3, alignment);
+  }
+}
+
+void Ibm3AlignmentModel::computeNeighbourhoodScores(const std::vector<WordIndex>& nsrc,
+                                                    const std::vector<WordIndex>& trg, AlignmentInfo& alignment,
+                                                    Neighbourhood& neighbourhood)
+{
+  PositionIndex slen = (PositionIndex)nsrc.size() - 1;
+  PositionIndex tlen = (PositionIndex)trg.size();
+
+  neighbourhood.moveScores.assign(slen + 1, tlen + 1, 0.0);
+  neighbourhood.swapScores.assign(tlen + 1, tlen + 1, 0.0);
+  double cachedAlignmentValue = -1;
+  for (PositionIndex j = 1; j <= tlen; ++j)
+  {
+    for (PositionIndex j1 = j + 1; j1 <= tlen; ++j1)
+      neighbourhood.swapScores(j, j1) = swapScore(nsrc, trg, j, j1, alignment, cachedAlignmentValue);
+    for (PositionIndex i = 0; i <= slen; ++i)
+      neighbourhood.moveScores(i, j) = moveScore(nsrc, trg, i, j, alignment, cachedAlignmentValue);
+  }
+}
+
 void Ibm3AlignmentModel::getInitialAlignmentForSearch(const std::vector<WordIndex>& nsrc,
                                                       const std::vector<WordIndex>& trg, AlignmentInfo& alignment)
 {
@@ -1124,6 +1209,73 @@ double Ibm3AlignmentModel::moveScore(const std::vector<WordIndex>& nsrc, const s
   return change;
 }
 
+double Ibm3AlignmentModel::tabulatedSwapScore(const Neighbourhood& neighbourhood, PositionIndex j1, PositionIndex j2,
+                                              const AlignmentInfo& alignment)
+{
+  PositionIndex i1 = alignment.get(j1);
+  PositionIndex i2 = alignment.get(j2);
+  if (i1 == i2)
+    return 1.0;
+
+  const Matrix<double>& pts = neighbourhood.translationProbs;
+  const Matrix<double>& dist = neighbourhood.distortionProbs;
+  Prob change = (Prob(pts(i2, j1)) / pts(i1, j1)) * (Prob(pts(i1, j2)) / pts(i2, j2));
+  if (i1 > 0)
+    change *= Prob(dist(i1, j2)) / dist(i1, j1);
+  if (i2 > 0)
+    change *= Prob(dist(i2, j1)) / dist(i2, j2);
+  return change;
+}
+
+double Ibm3AlignmentModel::tabulatedMoveScore(const Neighbourhood& neighbourhood, PositionIndex iNew, PositionIndex j,
+                                              const AlignmentInfo& alignment)
+{
+  PositionIndex iOld = alignment.get(j);
+  if (iOld == iNew)
+    return 1.0;
+
+  // same computation as moveScore(), using the probabilities of the sentence pair stored in the neighbourhood
+  const Matrix<double>& pts = neighbourhood.translationProbs;
+  const Matrix<double>& dist = neighbourhood.distortionProbs;
+  const Matrix<double>& fert = neighbourhood.fertilityProbs;
+  PositionIndex tlen = alignment.getTargetLength();
+  PositionIndex phi0 = alignment.getFertility(0);
+  PositionIndex phiOld = alignment.getFertility(iOld);
+  PositionIndex phiNew = alignment.getFertility(iNew);
+  Prob p0 = Prob(1.0) - *p1;
+  Prob change;
+  if (iOld == 0)
+  {
+    Prob phi0Change =
+        (p0 * p0 / *p1) * ((phi0 * (tlen - phi0 + 1.0)) / ((tlen - 2 * phi0 + 1.0) * (tlen - 2 * phi0 + 2.0)));
+    Prob phiChange = phiNew + 1.0;
+    Prob plus1FertChange = Prob(fert(iNew, phiNew + 1)) / fert(iNew, phiNew);
+    Prob ptsChange = Prob(pts(iNew, j)) / pts(iOld, j);
+    Prob distortionChange = dist(iNew, j);
+    change = phi0Change * phiChange * plus1FertChange * ptsChange * distortionChange;
+  }
+  else if (iNew == 0)
+  {
+    Prob phi0Change =
+        (*p1 / (p0 * p0)) * (double((tlen - 2.0 * phi0) * (tlen - 2 * phi0 - 1)) / ((1.0 + phi0) * (tlen - phi0)));
+    Prob phiChange = 1.0 / phiOld;
+    Prob minus1FertChange = Prob(fert(iOld, phiOld - 1)) / fert(iOld, phiOld);
+    Prob ptsChange = Prob(pts(iNew, j)) / pts(iOld, j);
+    Prob distortionChange = Prob(1.0) / dist(iOld, j);
+    change = phi0Change * phiChange * minus1FertChange * ptsChange * distortionChange;
+  }
+  else
+  {
+    Prob phiChange = Prob((phiNew + 1.0) / phiOld);
+    Prob minus1FertChange = Prob(fert(iOld, phiOld - 1)) / fert(iOld, phiOld);
+    Prob plus1FertChange = Prob(fert(iNew, phiNew + 1)) / fert(iNew, phiNew);
+    Prob ptsChange = Prob(pts(iNew, j)) / pts(iOld, j);
+    Prob distortionChange = Prob(dist(iNew, j)) / dist(iOld, j);
+    change = phiChange * minus1FertChange * plus1FertChange * ptsChange * distortionChange;
+  }
+  return change;
+}
+
 void Ibm3AlignmentModel::clear()
 {
   Ibm2AlignmentModel::clear();
@@ -1133,6 +1285,7 @@ void Ibm3AlignmentModel::clear()
   fertilitySmoothFactor = DefaultFertilitySmoothFactor;
   *p1 = DefaultP1;
   performIbm2Transfer = false;
+  transferCounts.reset();
   hmmModel.reset(nullptr);
 }
 
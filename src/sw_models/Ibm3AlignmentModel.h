@@ -6,12 +6,15 @@
 #include "sw_models/FertilityTable.h"
 #include "sw_models/HmmAlignmentModel.h"
 #include "sw_models/Ibm2AlignmentModel.h"
+#include "sw_models/Ibm3TransferCounts.h"
 
 #include <functional>
 #include <memory>
+#include <unordered_map>
 
 class Ibm3AlignmentModel : public Ibm2AlignmentModel
 {
+  friend class Ibm3AlignmentModelTest;
   friend class Ibm4AlignmentModel;
 
 public:
@@ -61,15 +64,51 @@ public:
   }
 
 protected:
-  typedef std::vector<double> DistortionCountsElem;
+  typedef std::vector<EmFloat> DistortionCountsElem;
   typedef OrderedVector<DistortionKey, DistortionCountsElem> DistortionCounts;
-  typedef std::vector<double> FertilityCountsElem;
+  typedef std::vector<EmFloat> FertilityCountsElem;
   typedef std::vector<FertilityCountsElem> FertilityCounts;
   typedef std::function<Prob(const std::vector<WordIndex>&, const std::vector<WordIndex>&, AlignmentInfo&,
                              Matrix<double>&, Matrix<double>&)>
       SearchForBestAlignmentFunc;
 
-  const PositionIndex MaxFertility = 10;
+  // Counts collected while processing a part of a batch of sentence pairs. Once the whole batch has been processed,
+  // the counts of the parts are summed in the order of the parts and added to the model counts
+  struct BatchCounts
+  {
+    std::unordered_map<DistortionKey, std::vector<double>, DistortionKeyHash> distortionCounts;
+    std::unordered_map<WordIndex, std::vector<double>> fertilityCounts;
+    double p0Count = 0;
+    double p1Count = 0;
+
+    // Scratch buffers of updateCounts, reused across the sentence pairs of the part
+    Matrix<double> moveCounts;
+    Matrix<double> swapCounts;
+    Matrix<double> fertCounts;
+    std::vector<double> negMove;
+    std::vector<double> negSwap;
+    std::vector<double> plus1Fert;
+    std::vector<double> minus1Fert;
+
+    virtual void add(const BatchCounts& counts);
+
+    virtual ~BatchCounts()
+    {
+    }
+  };
+
+  // Scores of the alignments that differ from the current alignment of the hill-climbing search by a move or a swap,
+  // together with the probabilities of the sentence pair used to compute them
+  struct Neighbourhood
+  {
+    Matrix<double> moveScores;
+    Matrix<double> swapScores;
+    Matrix<double> translationProbs;
+    Matrix<double> distortionProbs;
+    Matrix<double> fertilityProbs;
+  };
+
+  const PositionIndex MaxFertility = Ibm3TransferCounts::MaxFertility;
   const PositionIndex MaxSentenceLength = 200;
   const double DefaultCountThreshold = 1e-5;
   const double DefaultP1 = 0.05;
@@ -94,24 +133,40 @@ protected:
                            PositionIndex j2, AlignmentInfo& alignment, double& cachedAlignmentValue);
   virtual double moveScore(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg, PositionIndex iNew,
                            PositionIndex j, AlignmentInfo& alignment, double& cachedAlignmentValue);
+  virtual void initNeighbourhood(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                 AlignmentInfo& alignment, Neighbourhood& neighbourhood);
+  virtual void updateNeighbourhoodAfterMove(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                            AlignmentInfo& alignment, PositionIndex j, PositionIndex iOld,
+                                            Neighbourhood& neighbourhood);
+  virtual void updateNeighbourhoodAfterSwap(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                            AlignmentInfo& alignment, PositionIndex j1, PositionIndex j2,
+                                            Neighbourhood& neighbourhood);
+  void computeNeighbourhoodScores(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                  AlignmentInfo& alignment, Neighbourhood& neighbourhood);
+  double tabulatedSwapScore(const Neighbourhood& neighbourhood, PositionIndex j1, PositionIndex j2,
+                            const AlignmentInfo& alignment);
+  double tabulatedMoveScore(const Neighbourhood& neighbourhood, PositionIndex iNew, PositionIndex j,
+                            const AlignmentInfo& alignment);
 
   // batch EM functions
   void ibm2Transfer();
   void ibm2TransferUpdateCounts(const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs);
   void hmmTransfer();
-  double getSumOfPartitions(PositionIndex phi, PositionIndex i, const Matrix<double>& alpha);
+  double getSentencePairCost(PositionIndex slen, PositionIndex tlen) override;
+  void addTransferCounts(const Ibm3TransferCounts& counts);
   void initSentencePair(const std::vector<WordIndex>& src, const std::vector<WordIndex>& trg) override;
   void initSourceWord(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg, PositionIndex i) override;
   void addTranslationOptions(std::vector<std::vector<WordIndex>>& insertBuffer) override;
   void batchUpdateCounts(const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs) override;
   void batchUpdateCounts(const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs,
                          SearchForBestAlignmentFunc search);
-  void incrementWordPairCounts(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg, PositionIndex i,
-                               PositionIndex j, double count) override;
-  virtual double updateCounts(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+  virtual std::unique_ptr<BatchCounts> createBatchCounts();
+  virtual double updateCounts(int part, const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
                               AlignmentInfo& alignment, double aligProb, const Matrix<double>& moveScores,
-                              const Matrix<double>& swapScores);
+                              const Matrix<double>& swapScores, BatchCounts& counts);
+  virtual void addBatchCounts(BatchCounts& counts);
   void batchMaximizeProbs() override;
+  void batchMaximizeIbm3Probs();
 
   bool loadP1(const std::string& filename);
   bool printP1(const std::string& filename);
@@ -136,6 +191,8 @@ protected:
   size_t maxSrcWordLen = 0;
 
   bool performIbm2Transfer = false;
+  // initial counts collected by the lower model during its last training iteration
+  std::shared_ptr<Ibm3TransferCounts> transferCounts;
   std::unique_ptr<HmmAlignmentModel> hmmModel;
   CachedHmmAligLgProb cachedHmmAligLogProbs;
 };
@@ -0,0 +1,200 @@
+#include "sw_models/Ibm3TransferCounts.h"
+
+#include "nlp_common/MathFuncs.h"
+#include "sw_models/SwDefs.h"
+
+#include <algorithm>
+#include <cmath>
+
+const PositionIndex Ibm3TransferCounts::MaxFertility;
+
+Ibm3TransferCounts::Ibm3TransferCounts()
+{
+  initFertilityPartitions();
+}
+
+void Ibm3TransferCounts::addSentencePair(const std::vector<WordIndex>& src, PositionIndex tlen,
+                                         PositionIndex distortionSlen, Matrix<double>& posteriors)
+{
+  PositionIndex slen = PositionIndex(src.size());
+
+  for (PositionIndex i = 0; i <= slen; ++i)
+  {
+    std::vector<double>* distortionEntry = nullptr;
+    if (i > 0)
+    {
+      distortionEntry = &distortionCounts[DistortionKey{i, distortionSlen, tlen}];
+      distortionEntry->resize(tlen, 0);
+    }
+    for (PositionIndex j = 1; j <= tlen; ++j)
+    {
+      if (posteriors(i, j) == 1.0)
+        posteriors(i, j) = 0.99;
+      else if (posteriors(i, j) == 0)
+        posteriors(i, j) = SW_PROB_SMOOTH;
+      if (distortionEntry != nullptr && posteriors(i, j) > SW_PROB_SMOOTH)
+        (*distortionEntry)[j - 1] += posteriors(i, j);
+    }
+  }
+
+  PositionIndex maxFertility = std::min(tlen + 1, MaxFertility);
+  alpha.assign(maxFertility, slen + 1, 0.0);
+  for (PositionIndex i = 1; i <= slen; ++i)
+  {
+    for (PositionIndex phi = 1; phi < maxFertility; ++phi)
+    {
+      double beta = 0;
+      for (PositionIndex j = 1; j <= tlen; ++j)
+      {
+        double prob = posteriors(i, j);
+        if (prob > 0.95)
+          prob = 0.95;
+        else if (prob < 0.05)
+          prob = 0.05;
+        beta += pow(prob / (1.0 - prob), double(phi));
+      }
+      alpha(phi, i) = beta * pow(-1.0, double(phi) + 1.0) / double(phi);
+    }
+  }
+
+  // terms of the products over the partitions, for every part and multiplicity
+  partTerms.assign(maxFertility, maxFertility, 0.0);
+  for (PositionIndex i = 1; i <= slen; ++i)
+  {
+    for (PositionIndex part = 1; part < maxFertility; ++part)
+    {
+      for (PositionIndex mult = 0; mult * part < maxFertility; ++mult)
+        partTerms(part, mult) = pow(alpha(part, i), mult) / factorials[mult];
+    }
+
+    double r = 1;
+    for (PositionIndex j = 1; j <= tlen; ++j)
+      r *= 1 - posteriors(i, j);
+    std::vector<double>& fertilityEntry = fertilityCounts[src[i - 1]];
+    fertilityEntry.resize(MaxFertility, 0);
+    for (PositionIndex phi = 0; phi < maxFertility; ++phi)
+      fertilityEntry[phi] += r * getSumOfPartitions(phi, partTerms);
+  }
+}
+
+void Ibm3TransferCounts::add(const Ibm3TransferCounts& counts)
+{
+  for (auto& entry : counts.distortionCounts)
+  {
+    std::vector<double>& distortionEntry = distortionCounts[entry.first];
+    if (distortionEntry.size() < entry.second.size())
+      distortionEntry.resize(entry.second.size(), 0);
+    for (size_t j = 0; j < entry.second.size(); ++j)
+      distortionEntry[j] += entry.second[j];
+  }
+
+  for (auto& entry : counts.fertilityCounts)
+  {
+    std::vector<double>& fertilityEntry = fertilityCounts[entry.first];
+    fertilityEntry.resize(MaxFertility, 0);
+    for (PositionIndex phi = 0; phi < MaxFertility; ++phi)
+      fertilityEntry[phi] += entry.second[phi];
+  }
+}
+
+void Ibm3TransferCounts::clear()
+{
+  distortionCounts.clear();
+  fertilityCounts.clear();
+}
+
+void Ibm3TransferCounts::initFertilityPartitions()
+{
+  factorials.resize(MaxFertility);
+  for (PositionIndex n = 0; n < MaxFertility; ++n)
+    factorials[n] = MathFuncs::factorial(n);
+
+  fertilityPartitions.clear();
+  fertilityPartitions.resize(MaxFertility);
+  for (PositionIndex phi = 0; phi < MaxFertility; ++phi)
+  {
+    std::vector<PositionIndex> partitions(MaxFertility, 0);
+    std::vector<PositionIndex> mult(MaxFertility, 0);
+    PositionIndex numPartitions = 0;
+
+    bool done = false;
+    bool init = true;
+    while (!done)
+    {
+      if (init)
+      {
+        partitions[1] = phi;
+        mult[1] = 1;
+        numPartitions = 1;
+        init = false;
+      }
+      else
+      {
+        if ((partitions[numPartitions] > 1) || (numPartitions > 1))
+        {
+          int s;
+          PositionIndex k;
+          if (partitions[numPartitions] == 1)
+          {
+            s = partitions[numPartitions - 1] + mult[numPartitions];
+            k = numPartitions - 1;
+          }
+          else
+          {
+            s = partitions[numPartitions];
+            k = numPartitions;
+          }
+          int w = partitions[k] - 1;
+          int u = s / w;
+          int v = s % w;
+          mult[k] -= 1;
+          PositionIndex k1;
+          if (mult[k] == 0)
+            k1 = k;
+          else
+            k1 = k + 1;
+          mult[k1] = u;
+          partitions[k1] = w;
+          if (v == 0)
+          {
+            numPartitions = k1;
+          }
+          else
+          {
+            mult[(size_t)k1 + 1] = 1;
+            partitions[(size_t)k1 + 1] = v;
+            numPartitions = k1 + 1;
+          }
+        }
+        else
+        {
+          done = true;
+        }
+      }
+
+      if (!done)
+      {
+        FertilityPartition partition;
+        if (phi != 0)
+        {
+          for (PositionIndex i = 1; i <= numPartitions; ++i)
+            partition.push_back(std::make_pair(partitions[i], mult[i]));
+        }
+        fertilityPartitions[phi].push_back(partition);
+      }
+    }
+  }
+}
+
+double Ibm3TransferCounts::getSumOfPartitions(PositionIndex phi, const Matrix<double>& partTerms)
+{
+  double sum = 0;
+  for (const FertilityPartition& partition : fertilityPartitions[phi])
+  {
+    double prod = 1.0;
+    for (const std::pair<PositionIndex, PositionIndex>& part : partition)
+      prod *= partTerms(part.first, part.second);
+    sum += prod;
+  }
+  return sum < 0 ? 0 : sum;
+}
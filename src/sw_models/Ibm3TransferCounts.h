@@ -0,0 +1,52 @@
+#pragma once
+
+#include "nlp_common/Matrix.h"
+#include "nlp_common/PositionIndex.h"
+#include "nlp_common/WordIndex.h"
+#include "sw_models/DistortionTable.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Initial distortion and fertility counts of an IBM-3 model, estimated from the alignment posteriors of an IBM-2 or HMM
+// model as in the IBM-2 to IBM-3 transfer
+class Ibm3TransferCounts
+{
+  friend class Ibm3AlignmentModelTest;
+
+public:
+  typedef std::unordered_map<DistortionKey, std::vector<double>, DistortionKeyHash> DistortionCounts;
+  typedef std::unordered_map<WordIndex, std::vector<double>> FertilityCounts;
+
+  static const PositionIndex MaxFertility = 10;
+
+  Ibm3TransferCounts();
+
+  // Adds the counts of a sentence pair given the posteriors of its alignments, where posteriors(i, j) is the
+  // probability of aligning the target word j with the source word i (0 being the NULL word). The posteriors are
+  // clamped in place to the range used to estimate the fertilities. distortionSlen is the source length of the
+  // distortion keys.
+  void addSentencePair(const std::vector<WordIndex>& src, PositionIndex tlen, PositionIndex distortionSlen,
+                       Matrix<double>& posteriors);
+  void add(const Ibm3TransferCounts& counts);
+  void clear();
+
+  DistortionCounts distortionCounts;
+  FertilityCounts fertilityCounts;
+
+private:
+  // (part, multiplicity) pairs of a partition of a fertility
+  typedef std::vector<std::pair<PositionIndex, PositionIndex>> FertilityPartition;
+
+  void initFertilityPartitions();
+  double getSumOfPartitions(PositionIndex phi, const Matrix<double>& partTerms);
+
+  // partitions of each fertility below MaxFertility and factorials of their multiplicities
+  std::vector<std::vector<FertilityPartition>> fertilityPartitions;
+  std::vector<double> factorials;
+
+  // Scratch buffers, reused by every sentence pair that is added
+  Matrix<double> alpha;
+  Matrix<double> partTerms;
+};
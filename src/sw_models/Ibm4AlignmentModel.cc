@@ -47,11 +47,37 @@ void Ibm4AlignmentModel::initWordPair(const std::vector<WordIndex>& nsrc, const
   headDistortionTable->reserveSpace(srcWordClass, trgWordClass);
 }
 
-double Ibm4AlignmentModel::updateCounts(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+void Ibm4AlignmentModel::Ibm4BatchCounts::add(const BatchCounts& counts)
+{
+  BatchCounts::add(counts);
+
+  const Ibm4BatchCounts& ibm4Counts = static_cast<const Ibm4BatchCounts&>(counts);
+  for (auto& entry : ibm4Counts.headDistortionCounts)
+  {
+    OrderedVector<int, double>& elem = headDistortionCounts[entry.first];
+    for (auto& pair : entry.second)
+      elem[pair.first] += pair.second;
+  }
+  for (auto& entry : ibm4Counts.nonheadDistortionCounts)
+  {
+    OrderedVector<int, double>& elem = nonheadDistortionCounts[entry.first];
+    for (auto& pair : entry.second)
+      elem[pair.first] += pair.second;
+  }
+}
+
+std::unique_ptr<Ibm3AlignmentModel::BatchCounts> Ibm4AlignmentModel::createBatchCounts()
+{
+  return std::unique_ptr<BatchCounts>{new Ibm4BatchCounts};
+}
+
+double Ibm4AlignmentModel::updateCounts(int part, const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
                                         AlignmentInfo& alignment, double aligProb, const Matrix<double>& moveScores,
-                                        const Matrix<double>& swapScores)
+                                        const Matrix<double>& swapScores, BatchCounts& counts)
 {
-  double totalCount = Ibm3AlignmentModel::updateCounts(nsrc, trg, alignment, aligProb, moveScores, swapScores);
+  double totalCount =
+      Ibm3AlignmentModel::updateCounts(part, nsrc, trg, alignment, aligProb, moveScores, swapScores, counts);
+  Ibm4BatchCounts& ibm4Counts = static_cast<Ibm4BatchCounts&>(counts);
 
   PositionIndex slen = (PositionIndex)nsrc.size() - 1;
   PositionIndex tlen = (PositionIndex)trg.size();
@@ -61,7 +87,7 @@ double Ibm4AlignmentModel::updateCounts(const std::vector<WordIndex>& nsrc, cons
   (void)sum;
   double normalizedAligProb = aligProb / totalCount;
 
-  incrementDistortionCounts(nsrc, trg, alignment, normalizedAligProb);
+  incrementDistortionCounts(nsrc, trg, alignment, normalizedAligProb, ibm4Counts);
   sum += normalizedAligProb;
 
   for (PositionIndex j = 1; j <= tlen; ++j)
@@ -75,7 +101,7 @@ double Ibm4AlignmentModel::updateCounts(const std::vector<WordIndex>& nsrc, cons
         if (count > countThreshold)
         {
           alignment.set(j, i);
-          incrementDistortionCounts(nsrc, trg, alignment, count);
+          incrementDistortionCounts(nsrc, trg, alignment, count, ibm4Counts);
           alignment.set(j, iOld);
           sum += count;
         }
@@ -92,7 +118,7 @@ double Ibm4AlignmentModel::updateCounts(const std::vector<WordIndex>& nsrc, cons
         {
           alignment.set(j, iOld1);
           alignment.set(j1, iOld);
-          incrementDistortionCounts(nsrc, trg, alignment, count);
+          incrementDistortionCounts(nsrc, trg, alignment, count, ibm4Counts);
           alignment.set(j, iOld);
           alignment.set(j1, iOld1);
           sum += count;
@@ -106,7 +132,7 @@ double Ibm4AlignmentModel::updateCounts(const std::vector<WordIndex>& nsrc, cons
 
 void Ibm4AlignmentModel::incrementDistortionCounts(const std::vector<WordIndex>& nsrc,
                                                    const std::vector<WordIndex>& trg, const AlignmentInfo& alignment,
-                                                   double count)
+                                                   double count, Ibm4BatchCounts& counts)
 {
   for (PositionIndex j = 1; j <= trg.size(); ++j)
   {
@@ -123,21 +149,36 @@ void Ibm4AlignmentModel::incrementDistortionCounts(const std::vector<WordIndex>&
       WordClassIndex srcWordClass = wordClasses->getSrcWordClass(sPrev);
       HeadDistortionKey key{srcWordClass, trgWordClass};
       int dj = j - alignment.getCenter(prevCept);
-
-#pragma omp critical(headDistortionCounts)
-      headDistortionCounts[key][dj] += count;
+      counts.headDistortionCounts[key][dj] += count;
     }
     else
     {
       PositionIndex prevInCept = alignment.getPrevInCept(j);
       int dj = j - prevInCept;
-
-#pragma omp critical(nonheadDistortionCounts)
-      nonheadDistortionCounts[trgWordClass][dj] += count;
+      counts.nonheadDistortionCounts[trgWordClass][dj] += count;
     }
   }
 }
 
+void Ibm4AlignmentModel::addBatchCounts(BatchCounts& counts)
+{
+  Ibm3AlignmentModel::addBatchCounts(counts);
+
+  Ibm4BatchCounts& ibm4Counts = static_cast<Ibm4BatchCounts&>(counts);
+  for (auto& entry : ibm4Counts.headDistortionCounts)
+  {
+    HeadDistortionCountsElem& elem = headDistortionCounts[entry.first];
+    for (auto& pair : entry.second)
+      elem[pair.first] += pair.second;
+  }
+  for (auto& entry : ibm4Counts.nonheadDistortionCounts)
+  {
+    NonheadDistortionCountsElem& elem = nonheadDistortionCounts[entry.first];
+    for (auto& pair : entry.second)
+      elem[pair.first] += pair.second;
+  }
+}
+
 void Ibm4AlignmentModel::train(int verbosity)
 {
   if (ibm3Model)
@@ -506,6 +547,27 @@ double Ibm4AlignmentModel::moveScore(const std::vector<WordIndex>& nsrc, const s
   return change;
 }
 
+void Ibm4AlignmentModel::initNeighbourhood(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                           AlignmentInfo& alignment, Neighbourhood& neighbourhood)
+{
+  computeNeighbourhoodScores(nsrc, trg, alignment, neighbourhood);
+}
+
+void Ibm4AlignmentModel::updateNeighbourhoodAfterMove(const std::vector<WordIndex>& nsrc,
+                                                      const std::vector<WordIndex>& trg, AlignmentInfo& alignment,
+                                                      PositionIndex j, PositionIndex iOld, Neighbourhood& neighbourhood)
+{
+  // a change can modify the heads and centers of any cept, so the distortion part of every score is affected
+  computeNeighbourhoodScores(nsrc, trg, alignment, neighbourhood);
+}
+
+void Ibm4AlignmentModel::updateNeighbourhoodAfterSwap(const std::vector<WordIndex>& nsrc,
+                                                      const std::vector<WordIndex>& trg, AlignmentInfo& alignment,
+                                                      PositionIndex j1, PositionIndex j2, Neighbourhood& neighbourhood)
+{
+  computeNeighbourhoodScores(nsrc, trg, alignment, neighbourhood);
+}
+
 void Ibm4AlignmentModel::ibm3Transfer()
 {
   auto search = [this](const std::vector<WordIndex>& src, const std::vector<WordIndex>& trg,
@@ -513,25 +575,10 @@ void Ibm4AlignmentModel::ibm3Transfer()
     return ibm3Model->searchForBestAlignment(src, trg, bestAlignment, &moveScores, &swapScores);
   };
 
-  std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>> buffer;
-  for (unsigned int n = 0; n < numSentencePairs(); ++n)
-  {
-    std::vector<WordIndex> src = getSrcSent(n);
-    std::vector<WordIndex> trg = getTrgSent(n);
-    if (sentenceLengthIsOk(src) && sentenceLengthIsOk(trg))
-      buffer.push_back(make_pair(src, trg));
-
-    if (buffer.size() >= ThreadBufferSize)
-    {
-      batchUpdateCounts(buffer, search);
-      buffer.clear();
-    }
-  }
-  if (buffer.size() > 0)
-  {
-    batchUpdateCounts(buffer, search);
-    buffer.clear();
-  }
+  processBatches(
+      [this, &search](const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs) {
+        batchUpdateCounts(pairs, search);
+      });
 
   batchMaximizeProbs();
 }
@@ -49,11 +49,19 @@ public:
   }
 
 protected:
-  typedef OrderedVector<int, double> HeadDistortionCountsElem;
+  typedef OrderedVector<int, EmFloat> HeadDistortionCountsElem;
   typedef OrderedVector<HeadDistortionKey, HeadDistortionCountsElem> HeadDistortionCounts;
-  typedef OrderedVector<int, double> NonheadDistortionCountsElem;
+  typedef OrderedVector<int, EmFloat> NonheadDistortionCountsElem;
   typedef std::vector<NonheadDistortionCountsElem> NonheadDistortionCounts;
 
+  struct Ibm4BatchCounts : public BatchCounts
+  {
+    std::unordered_map<HeadDistortionKey, OrderedVector<int, double>, HeadDistortionKeyHash> headDistortionCounts;
+    std::unordered_map<WordClassIndex, OrderedVector<int, double>> nonheadDistortionCounts;
+
+    void add(const BatchCounts& counts) override;
+  };
+
   const double DefaultDistortionSmoothFactor = 0.2;
 
   std::string getModelTypeStr() const override
@@ -72,16 +80,27 @@ protected:
                    PositionIndex j2, AlignmentInfo& alignment, double& cachedAlignmentValue) override;
   double moveScore(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg, PositionIndex iNew,
                    PositionIndex j, AlignmentInfo& alignment, double& cachedAlignmentValue) override;
+  void initNeighbourhood(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                         AlignmentInfo& alignment, Neighbourhood& neighbourhood) override;
+  void updateNeighbourhoodAfterMove(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                    AlignmentInfo& alignment, PositionIndex j, PositionIndex iOld,
+                                    Neighbourhood& neighbourhood) override;
+  void updateNeighbourhoodAfterSwap(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                    AlignmentInfo& alignment, PositionIndex j1, PositionIndex j2,
+                                    Neighbourhood& neighbourhood) override;
 
   void ibm3Transfer();
 
   // batch EM functions
   void initWordPair(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg, PositionIndex i,
                     PositionIndex j) override;
-  double updateCounts(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg, AlignmentInfo& alignment,
-                      double aligProb, const Matrix<double>& moveScores, const Matrix<double>& swapScores) override;
+  std::unique_ptr<BatchCounts> createBatchCounts() override;
+  double updateCounts(int part, const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                      AlignmentInfo& alignment, double aligProb, const Matrix<double>& moveScores,
+                      const Matrix<double>& swapScores, BatchCounts& counts) override;
   void incrementDistortionCounts(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
-                                 const AlignmentInfo& alignment, double count);
+                                 const AlignmentInfo& alignment, double count, Ibm4BatchCounts& counts);
+  void addBatchCounts(BatchCounts& counts) override;
   void batchMaximizeProbs() override;
 
   void loadConfig(const YAML::Node& config) override;
@@ -29,6 +29,12 @@ void IncrHmmAlignmentTrainer::clear()
 
 void IncrHmmAlignmentTrainer::calcNewLocalSuffStats(pair<unsigned int, unsigned int> sentPairRange, int verbosity)
 {
+  // Matrices are reused across training samples
+  Matrix<EmFloat> lexProbs;
+  Matrix<EmFloat> alignProbs;
+  Matrix<EmFloat> alphaMatrix;
+  Matrix<EmFloat> betaMatrix;
+
   // Iterate over the training samples
   for (unsigned int n = sentPairRange.first; n <= sentPairRange.second; ++n)
   {
@@ -46,10 +52,6 @@ void IncrHmmAlignmentTrainer::calcNewLocalSuffStats(pair<unsigned int, unsigned
       PositionIndex slen = (PositionIndex)srcSent.size();
 
       // Calculate alpha and beta matrices
-      vector<vector<double>> lexProbs;
-      vector<vector<double>> alignProbs;
-      vector<vector<double>> alphaMatrix;
-      vector<vector<double>> betaMatrix;
       model.calcAlphaBetaMatrices(nsrcSent, trgSent, slen, lexProbs, alignProbs, alphaMatrix, betaMatrix);
 
       // Calculate sufficient statistics for anji values
@@ -118,8 +120,7 @@ void IncrHmmAlignmentTrainer::calcNewLocalSuffStatsVit(pair<unsigned int, unsign
 
 void IncrHmmAlignmentTrainer::calc_lanji(unsigned int n, const vector<WordIndex>& nsrcSent,
                                          const vector<WordIndex>& trgSent, PositionIndex slen, const Count& weight,
-                                         const vector<vector<double>>& alphaMatrix,
-                                         const vector<vector<double>>& betaMatrix)
+                                         const Matrix<EmFloat>& alphaMatrix, const Matrix<EmFloat>& betaMatrix)
 {
   // Initialize data structures
   unsigned int mapped_n;
@@ -139,7 +140,7 @@ void IncrHmmAlignmentTrainer::calc_lanji(unsigned int n, const vector<WordIndex>
     for (unsigned int i = 1; i <= nsrcSent.size(); ++i)
     {
       // Obtain numerator
-      double num = alphaMatrix[i][j] * betaMatrix[i][j];
+      double num = (double)alphaMatrix(i, j) * betaMatrix(i, j);
       // Add contribution to sum
       sum += num;
       // Store num in numVec
@@ -204,10 +205,9 @@ void IncrHmmAlignmentTrainer::calc_lanji_vit(unsigned int n, const vector<WordIn
 
 void IncrHmmAlignmentTrainer::calc_lanjm1ip_anji(unsigned int n, const vector<WordIndex>& srcSent,
                                                  const vector<WordIndex>& trgSent, PositionIndex slen,
-                                                 const Count& weight, const vector<vector<double>>& lexLogProbs,
-                                                 const vector<vector<double>>& alignProbs,
-                                                 const vector<vector<double>>& alphaMatrix,
-                                                 const vector<vector<double>>& betaMatrix)
+                                                 const Count& weight, const Matrix<EmFloat>& lexLogProbs,
+                                                 const Matrix<EmFloat>& alignProbs, const Matrix<EmFloat>& alphaMatrix,
+                                                 const Matrix<EmFloat>& betaMatrix)
 {
   // Initialize data structures
   unsigned int mapped_n;
@@ -237,12 +237,12 @@ void IncrHmmAlignmentTrainer::calc_lanjm1ip_anji(unsigned int n, const vector<Wo
         if (nullAlig)
         {
           if (model.isFirstNullAlignmentPar(0, slen, i))
-            num = alignProbs[i][0] * lexLogProbs[i][1] * betaMatrix[i][1];
+            num = (double)alignProbs(i, 0) * lexLogProbs(i, 1) * betaMatrix(i, 1);
           else
             num = numVecVec[size_t{slen} + 1][0];
         }
         else
-          num = alignProbs[i][0] * lexLogProbs[i][1] * betaMatrix[i][1];
+          num = (double)alignProbs(i, 0) * lexLogProbs(i, 1) * betaMatrix(i, 1);
 
         // Add contribution to sum
         sum += num;
@@ -264,7 +264,7 @@ void IncrHmmAlignmentTrainer::calc_lanjm1ip_anji(unsigned int n, const vector<Wo
           }
           else
           {
-            num = alphaMatrix[ip][j - 1] * alignProbs[i][ip] * lexLogProbs[i][j] * betaMatrix[i][j];
+            num = (double)alphaMatrix(ip, j - 1) * alignProbs(i, ip) * lexLogProbs(i, j) * betaMatrix(i, j);
           }
           // Add contribution to sum
           sum += num;
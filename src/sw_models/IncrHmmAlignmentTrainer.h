@@ -40,15 +40,14 @@ protected:
   void calcNewLocalSuffStats(std::pair<unsigned int, unsigned int> sentPairRange, int verbosity = 0);
   void calcNewLocalSuffStatsVit(std::pair<unsigned int, unsigned int> sentPairRange, int verbosity = 0);
   void calc_lanji(unsigned int n, const std::vector<WordIndex>& nsrcSent, const std::vector<WordIndex>& trgSent,
-                  PositionIndex slen, const Count& weight, const std::vector<std::vector<double>>& alphaMatrix,
-                  const std::vector<std::vector<double>>& betaMatrix);
+                  PositionIndex slen, const Count& weight, const Matrix<EmFloat>& alphaMatrix,
+                  const Matrix<EmFloat>& betaMatrix);
   void calc_lanji_vit(unsigned int n, const std::vector<WordIndex>& nsrcSent, const std::vector<WordIndex>& trgSent,
                       const std::vector<PositionIndex>& bestAlig, const Count& weight);
   void calc_lanjm1ip_anji(unsigned int n, const std::vector<WordIndex>& srcSent, const std::vector<WordIndex>& trgSent,
-                          PositionIndex slen, const Count& weight, const std::vector<std::vector<double>>& logProbs,
-                          const std::vector<std::vector<double>>& alignProbs,
-                          const std::vector<std::vector<double>>& alphaMatrix,
-                          const std::vector<std::vector<double>>& betaMatrix);
+                          PositionIndex slen, const Count& weight, const Matrix<EmFloat>& logProbs,
+                          const Matrix<EmFloat>& alignProbs, const Matrix<EmFloat>& alphaMatrix,
+                          const Matrix<EmFloat>& betaMatrix);
   void calc_lanjm1ip_anji_vit(unsigned int n, const std::vector<WordIndex>& srcSent,
                               const std::vector<WordIndex>& trgSent, PositionIndex slen,
                               const std::vector<PositionIndex>& bestAlig, const Count& weight);
@@ -8,14 +8,23 @@
 #include "nlp_common/OrderedVector.h"
 #endif
 
+// Precision of the expected counts collected by the EM algorithm and of the matrices of the forward-backward
+// algorithm. Single precision halves the memory of the count tables, the counts of each batch of sentence pairs and
+// the sums used to normalize them are always computed in double precision
+#ifdef THOT_SINGLE_PRECISION_EM
+typedef float EmFloat;
+#else
+typedef double EmFloat;
+#endif
+
 #ifdef THOT_DISABLE_SPACE_EFFICIENT_LEXDATA_STRUCTURES
 typedef std::unordered_map<WordIndex, std::pair<float, float>> IncrLexCountsElem;
 typedef std::vector<IncrLexAuxVarElem> IncrLexCounts;
-typedef std::unordered_map<WordIndex, double> LexCountsElem;
+typedef std::unordered_map<WordIndex, EmFloat> LexCountsElem;
 typedef std::vector<LexAuxVarElem> LexCounts;
 #else
 typedef OrderedVector<WordIndex, std::pair<float, float>> IncrLexCountsElem;
 typedef std::vector<IncrLexCountsElem> IncrLexCounts;
-typedef OrderedVector<WordIndex, double> LexCountsElem;
+typedef OrderedVector<WordIndex, EmFloat> LexCountsElem;
 typedef std::vector<LexCountsElem> LexCounts;
 #endif
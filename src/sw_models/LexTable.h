@@ -17,6 +17,8 @@ public:
   virtual void set(WordIndex s, WordIndex t, float num, float den) = 0;
 
   virtual bool getTransForSource(WordIndex s, std::set<WordIndex>& transSet) const = 0;
+  // Removes the entries of s for the targets in transSet, it must not be called concurrently for the same s
+  virtual void removeTransForSource(WordIndex s, const std::set<WordIndex>& transSet) = 0;
 
   virtual bool load(const char* lexNumDenFile, int verbose = 0) = 0;
 
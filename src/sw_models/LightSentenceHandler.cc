@@ -205,7 +205,7 @@ int LightSentenceHandler::nthSentPairFromFiles(unsigned int n, std::vector<std::
 
   if (countFileExists)
   {
-    c = atof(awkSrcTrgC.dollar(1).c_str());
+    c = awkSrcTrgC.dollarToDouble(1);
   }
   else
   {
@@ -80,6 +80,20 @@ bool MemoryLexTable::getTransForSource(WordIndex s, std::set<WordIndex>& transSe
   }
 }
 
+void MemoryLexTable::removeTransForSource(WordIndex s, const std::set<WordIndex>& transSet)
+{
+  if (s >= numerators.size() || transSet.empty())
+    return;
+
+  NumeratorsElem elem;
+  for (auto& numElemIter : numerators[s])
+  {
+    if (transSet.find(numElemIter.first) == transSet.end())
+      elem[numElemIter.first] = numElemIter.second;
+  }
+  numerators[s] = elem;
+}
+
 void MemoryLexTable::set(WordIndex s, WordIndex t, float num, float den)
 {
   setDenominator(s, den);
@@ -157,10 +171,10 @@ bool MemoryLexTable::loadPlainText(const char* lexNumDenFile, int verbose)
     {
       if (awk.NF == 4)
       {
-        WordIndex s = atoi(awk.dollar(1).c_str());
-        WordIndex t = atoi(awk.dollar(2).c_str());
-        float numer = (float)atof(awk.dollar(3).c_str());
-        float denom = (float)atof(awk.dollar(4).c_str());
+        WordIndex s = awk.dollarToInt(1);
+        WordIndex t = awk.dollarToInt(2);
+        float numer = (float)awk.dollarToDouble(3);
+        float denom = (float)awk.dollarToDouble(4);
         set(s, t, numer, denom);
       }
     }
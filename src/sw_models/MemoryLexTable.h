@@ -23,6 +23,7 @@ public:
   void set(WordIndex s, WordIndex t, float num, float den) override;
 
   bool getTransForSource(WordIndex t, std::set<WordIndex>& transSet) const override;
+  void removeTransForSource(WordIndex s, const std::set<WordIndex>& transSet) override;
 
   bool load(const char* lexNumDenFile, int verbose = 0) override;
 
@@ -142,10 +142,10 @@ bool NonheadDistortionTable::loadPlainText(const char* tableFile, int verbose)
   {
     if (awk.NF == 6)
     {
-      WordClassIndex targetWordClass = atoi(awk.dollar(1).c_str());
-      int dj = atoi(awk.dollar(2).c_str());
-      float numer = (float)atof(awk.dollar(3).c_str());
-      float denom = (float)atof(awk.dollar(4).c_str());
+      WordClassIndex targetWordClass = awk.dollarToInt(1);
+      int dj = awk.dollarToInt(2);
+      float numer = (float)awk.dollarToDouble(3);
+      float denom = (float)awk.dollarToDouble(4);
       set(targetWordClass, dj, numer, denom);
     }
   }
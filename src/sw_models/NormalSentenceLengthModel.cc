@@ -17,7 +17,7 @@ bool NormalSentenceLengthModel::load(const char* filename, int verbose /*=0*/)
   }
   if (awk.getln())
   {
-    if (strcmp("Weighted", awk.dollar(1).c_str()) == 0)
+    if (awk.dollarEquals(1, "Weighted"))
     {
       return readNormalPars(filename, verbose);
     }
@@ -175,20 +175,20 @@ bool NormalSentenceLengthModel::readNormalPars(const char* normParsFileName, int
         std::cerr << "Anomalous sentence length model file!" << std::endl;
       return THOT_ERROR;
     }
-    numSents = atoi(awk.dollar(2).c_str());
-    slenSum = atoi(awk.dollar(5).c_str());
-    tlenSum = atoi(awk.dollar(8).c_str());
+    numSents = awk.dollarToInt(2);
+    slenSum = awk.dollarToInt(5);
+    tlenSum = awk.dollarToInt(8);
 
     // Read gaussian parameters
     while (awk.getln())
     {
       if (awk.NF == 5)
       {
-        unsigned int slen = atoi(awk.dollar(1).c_str());
-        unsigned int k_slen = atoi(awk.dollar(2).c_str());
-        double swk_slen = atof(awk.dollar(3).c_str());
-        double mk_slen = atof(awk.dollar(4).c_str());
-        double sk_slen = atof(awk.dollar(5).c_str());
+        unsigned int slen = awk.dollarToInt(1);
+        unsigned int k_slen = awk.dollarToInt(2);
+        double swk_slen = awk.dollarToDouble(3);
+        double mk_slen = awk.dollarToDouble(4);
+        double sk_slen = awk.dollarToDouble(5);
 
         set_k(slen, k_slen);
         set_swk(slen, (float)swk_slen);
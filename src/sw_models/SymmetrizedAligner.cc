@@ -1,7 +1,13 @@
 #include "sw_models/SymmetrizedAligner.h"
 
-#include "nlp_common/StrProcUtils.h"
+#include "nlp_common/AwkInputStream.h"
+#include "nlp_common/ErrorDefs.h"
 #include "nlp_common/MathDefs.h"
+#include "nlp_common/StrProcUtils.h"
+#include "nlp_common/printAligFuncs.h"
+
+#include <fstream>
+#include <sstream>
 
 using namespace std;
 
@@ -82,6 +88,98 @@ LgProb SymmetrizedAligner::getBestAlignment(const vector<WordIndex>& srcSentence
   return max(logProb, invLogProb);
 }
 
+void SymmetrizedAligner::getBestAlignments(const vector<vector<WordIndex>>& srcSentences,
+                                           const vector<vector<WordIndex>>& trgSentences, vector<LgProb>& logProbs,
+                                           vector<WordAlignmentMatrix>& waMatrices)
+{
+  logProbs.resize(srcSentences.size());
+  waMatrices.resize(srcSentences.size());
+#pragma omp parallel for schedule(dynamic)
+  for (int n = 0; n < (int)srcSentences.size(); ++n)
+    logProbs[n] = getBestAlignment(srcSentences[n], trgSentences[n], waMatrices[n]);
+}
+
+bool SymmetrizedAligner::getBestAlignments(const char* srcFileName, const char* trgFileName, const char* outFileName,
+                                           unsigned int chunkSize)
+{
+  AwkInputStream srcFile, trgFile;
+  if (srcFile.open(srcFileName) == THOT_ERROR)
+  {
+    cerr << "Error in source file, file " << srcFileName << " does not exist.\n";
+    return THOT_ERROR;
+  }
+  if (trgFile.open(trgFileName) == THOT_ERROR)
+  {
+    cerr << "Error in target file, file " << trgFileName << " does not exist.\n";
+    return THOT_ERROR;
+  }
+  ofstream outF(outFileName);
+  if (!outF)
+  {
+    cerr << "Error while opening output file." << endl;
+    return THOT_ERROR;
+  }
+  if (chunkSize == 0)
+    chunkSize = 1;
+
+  vector<vector<string>> srcChunk, trgChunk;
+  vector<vector<WordIndex>> srcIndexChunk, trgIndexChunk;
+  vector<unsigned int> pairNumbers;
+  vector<LgProb> logProbs;
+  vector<WordAlignmentMatrix> waMatrices;
+  bool eof = false;
+  while (!eof)
+  {
+    // Read the next chunk, converting the words to indices serially,
+    // since the conversion may extend the vocabularies
+    srcChunk.clear();
+    trgChunk.clear();
+    srcIndexChunk.clear();
+    trgIndexChunk.clear();
+    pairNumbers.clear();
+    while (srcChunk.size() < chunkSize)
+    {
+      if (!srcFile.getln())
+      {
+        eof = true;
+        break;
+      }
+      if (!trgFile.getln())
+      {
+        cerr << "Error: Source and target files have not the same size." << endl;
+        return THOT_ERROR;
+      }
+      if (srcFile.NF == 0 || trgFile.NF == 0)
+        continue;
+
+      srcChunk.push_back(StrProcUtils::stringToStringVector(srcFile.dollar(0)));
+      trgChunk.push_back(StrProcUtils::stringToStringVector(trgFile.dollar(0)));
+      srcIndexChunk.push_back(strVectorToSrcIndexVector(srcChunk.back()));
+      trgIndexChunk.push_back(strVectorToTrgIndexVector(trgChunk.back()));
+      pairNumbers.push_back(srcFile.FNR);
+    }
+
+    getBestAlignments(srcIndexChunk, trgIndexChunk, logProbs, waMatrices);
+
+    for (size_t n = 0; n < srcChunk.size(); ++n)
+    {
+      vector<string> ns;
+      ns.reserve(srcChunk[n].size() + 1);
+      ns.push_back(NULL_WORD_STR);
+      ns.insert(ns.end(), srcChunk[n].begin(), srcChunk[n].end());
+      ostringstream header;
+      header << "# Sentence pair " << pairNumbers[n] << " alignment score : " << logProbs[n].get_p();
+      printAlignmentInGIZAFormat(outF, ns, trgChunk[n], waMatrices[n], header.str().c_str());
+    }
+  }
+  if (trgFile.getln())
+  {
+    cerr << "Error: Source and target files have not the same size." << endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
 WordIndex SymmetrizedAligner::stringToSrcWordIndex(string s) const
 {
   return directAligner->stringToSrcWordIndex(s);
@@ -28,6 +28,17 @@ public:
   LgProb getBestAlignment(const std::vector<WordIndex>& srcSentence, const std::vector<WordIndex>& trgSentence,
                           WordAlignmentMatrix& bestWaMatrix) override;
 
+  // Aligns a batch of sentence pairs in parallel
+  void getBestAlignments(const std::vector<std::vector<WordIndex>>& srcSentences,
+                         const std::vector<std::vector<WordIndex>>& trgSentences, std::vector<LgProb>& logProbs,
+                         std::vector<WordAlignmentMatrix>& waMatrices);
+
+  // Aligns the sentence pairs of the given files and prints the
+  // alignments in GIZA format. Pairs are read and aligned in chunks of
+  // chunkSize pairs, and the output follows the order of the files
+  bool getBestAlignments(const char* srcFileName, const char* trgFileName, const char* outFileName,
+                         unsigned int chunkSize = 10000);
+
   WordIndex stringToSrcWordIndex(std::string s) const override;
   std::vector<WordIndex> strVectorToSrcIndexVector(std::vector<std::string> s) override;
 
@@ -466,16 +466,16 @@ bool anjm1ip_anjiMatrix::load_maxnsize_data(const char* maxnsizeDataFile, int ve
     if (verbose)
       std::cerr << "Reading matrix maximum size data from file: " << maxnsizeDataFile << std::endl;
     awk.getln();
-    anjm1ip_anji_maxnsize = atoi(awk.dollar(1).c_str());
+    anjm1ip_anji_maxnsize = awk.dollarToInt(1);
     awk.getln();
-    anjm1ip_anji_pointer = atoi(awk.dollar(1).c_str());
+    anjm1ip_anji_pointer = awk.dollarToInt(1);
 
     while (awk.getln())
     {
       if (awk.NF == 2)
       {
-        unsigned int np = atoi(awk.dollar(1).c_str());
-        unsigned int n = atoi(awk.dollar(2).c_str());
+        unsigned int np = awk.dollarToInt(1);
+        unsigned int n = awk.dollarToInt(2);
 
         update_np_to_n_vector(np, std::make_pair(true, n));
         update_n_to_np_vector(n, std::make_pair(true, np));
@@ -0,0 +1,40 @@
+#include "TempFile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+TempFile::TempFile()
+{
+#ifdef _WIN32
+  char dirName[MAX_PATH + 1];
+  char name[MAX_PATH + 1];
+  DWORD dirLength = GetTempPathA(sizeof(dirName), dirName);
+  if (dirLength == 0 || dirLength > sizeof(dirName) || GetTempFileNameA(dirName, "tht", 0, name) == 0)
+    throw std::runtime_error("Unable to create a temporary file");
+  fileName = name;
+#else
+  const char* dirName = getenv("TMPDIR");
+  std::string nameTemplate = std::string(dirName != NULL && *dirName != '\0' ? dirName : "/tmp") + "/thot_test_XXXXXX";
+  std::vector<char> name(nameTemplate.begin(), nameTemplate.end());
+  name.push_back('\0');
+  int fd = mkstemp(name.data());
+  if (fd == -1)
+    throw std::runtime_error("Unable to create a temporary file from " + nameTemplate);
+  close(fd);
+  fileName = name.data();
+#endif
+}
+
+TempFile::~TempFile()
+{
+  remove(fileName.c_str());
+}
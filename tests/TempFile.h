@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+// Empty temporary file that is removed when the object is destroyed
+class TempFile
+{
+public:
+  TempFile();
+  ~TempFile();
+
+  TempFile(const TempFile&) = delete;
+  TempFile& operator=(const TempFile&) = delete;
+
+  const std::string& name() const
+  {
+    return fileName;
+  }
+  const char* c_str() const
+  {
+    return fileName.c_str();
+  }
+
+private:
+  std::string fileName;
+};
@@ -0,0 +1,125 @@
+#include "error_correction/BitParallelEditDist.h"
+
+#include "error_correction/EditDistForStr.h"
+#include "error_correction/EditDistForVec.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::string createRandomString(unsigned int maxLength, unsigned int alphabetSize)
+{
+  std::string str;
+  for (unsigned int i = 0, length = rand() % (maxLength + 1); i < length; ++i)
+    str += (char)('a' + rand() % alphabetSize);
+  return str;
+}
+
+std::vector<unsigned int> createRandomIds(unsigned int maxLength, unsigned int vocabSize)
+{
+  std::vector<unsigned int> ids;
+  for (unsigned int i = 0, length = rand() % (maxLength + 1); i < length; ++i)
+    ids.push_back(rand() % vocabSize);
+  return ids;
+}
+
+// Edit distances calculated with the dynamic programming matrix
+unsigned int dpEditDist(const std::string& x, const std::string& y)
+{
+  EditDistForStr editDist;
+  unsigned int hCount, iCount, sCount, dCount;
+  return (unsigned int)editDist.calculateEditDistOps(x, y, hCount, iCount, sCount, dCount);
+}
+
+unsigned int dpEditDistPrefix(const std::string& x, const std::string& y)
+{
+  EditDistForStr editDist;
+  std::vector<unsigned int> ops;
+  return (unsigned int)editDist.calculateEditDistPrefixOps(x, y, ops);
+}
+
+unsigned int dpEditDist(const std::vector<unsigned int>& x, const std::vector<unsigned int>& y)
+{
+  EditDistForVec<unsigned int> editDist;
+  unsigned int hCount, iCount, sCount, dCount;
+  return (unsigned int)editDist.calculateEditDistOps(x, y, hCount, iCount, sCount, dCount);
+}
+
+// The prefix distance is the minimum distance between y and a prefix of x
+unsigned int dpEditDistPrefix(const std::vector<unsigned int>& x, const std::vector<unsigned int>& y)
+{
+  if (y.empty())
+    return x.size();
+  unsigned int dist = y.size();
+  for (size_t i = 1; i <= x.size(); ++i)
+    dist = std::min(dist, dpEditDist(std::vector<unsigned int>(x.begin(), x.begin() + i), y));
+  return dist;
+}
+} // namespace
+
+TEST(BitParallelEditDistTest, editDist)
+{
+  EXPECT_EQ(BitParallelEditDist::editDist("kitten", "sitting"), 3);
+  EXPECT_EQ(BitParallelEditDist::editDist("", "abc"), 3);
+  EXPECT_EQ(BitParallelEditDist::editDist("abc", ""), 3);
+  EXPECT_EQ(BitParallelEditDist::editDist("", ""), 0);
+  EXPECT_EQ(BitParallelEditDist::editDistPrefix("house", "hou"), 0);
+  EXPECT_EQ(BitParallelEditDist::editDistPrefix("house", "hoe"), 1);
+  EXPECT_EQ(BitParallelEditDist::editDistPrefix("house", ""), 5);
+  EXPECT_EQ(BitParallelEditDist::editDist(std::vector<unsigned int>{1, 2, 3, 4}, std::vector<unsigned int>{1, 3, 4, 5}),
+            2);
+}
+
+TEST(BitParallelEditDistTest, charLevelMatchesDynamicProgramming)
+{
+  srand(27182);
+  for (unsigned int n = 0; n < 500; ++n)
+  {
+    // Long strings are processed in several blocks
+    unsigned int maxLength = n % 5 == 0 ? 150 : 12;
+    unsigned int alphabetSize = 2 + n % 8;
+    std::string x = createRandomString(maxLength, alphabetSize);
+    std::string y = createRandomString(maxLength, alphabetSize);
+
+    unsigned int dist = dpEditDist(x, y);
+    unsigned int prefixDist = dpEditDistPrefix(x, y);
+    EXPECT_EQ(BitParallelEditDist::editDist(x, y), dist) << x << " " << y;
+    EXPECT_EQ(BitParallelEditDist::editDistPrefix(x, y), prefixDist) << x << " " << y;
+
+    BitParallelEditDist editDist;
+    editDist.setPattern(y);
+    EXPECT_EQ(editDist.calculateEditDist(x), dist) << x << " " << y;
+    EXPECT_EQ(editDist.calculateEditDistPrefix(x), prefixDist) << x << " " << y;
+  }
+}
+
+TEST(BitParallelEditDistTest, wordLevelMatchesDynamicProgramming)
+{
+  srand(14142);
+  for (unsigned int n = 0; n < 300; ++n)
+  {
+    unsigned int maxLength = n % 5 == 0 ? 100 : 15;
+    unsigned int vocabSize = 2 + n % 20;
+    std::vector<unsigned int> x = createRandomIds(maxLength, vocabSize);
+    std::vector<unsigned int> y = createRandomIds(maxLength, vocabSize);
+
+    EXPECT_EQ(BitParallelEditDist::editDist(x, y), dpEditDist(x, y));
+    EXPECT_EQ(BitParallelEditDist::editDistPrefix(x, y), dpEditDistPrefix(x, y));
+  }
+}
+
+TEST(BitParallelEditDistTest, weightedCostsUseDynamicProgramming)
+{
+  EditDistForStr editDist;
+  EXPECT_TRUE(editDist.hasUnitCosts());
+  EXPECT_EQ(editDist.calculateEditDistPrefix("house", "hoe"), 1);
+
+  editDist.setErrorModel(0.5, 1, 2, 3);
+  EXPECT_FALSE(editDist.hasUnitCosts());
+  EXPECT_EQ(editDist.calculateEditDist("abc", "abd"), 3);
+  EXPECT_EQ(editDist.calculateEditDist("abc", "ab"), 4);
+}
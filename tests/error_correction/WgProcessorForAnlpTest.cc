@@ -0,0 +1,124 @@
+#include "error_correction/WgProcessorForAnlp.h"
+
+#include "error_correction/PfsmEcmForWg.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace
+{
+std::vector<std::string> words(const std::string& str)
+{
+  std::vector<std::string> result;
+  std::istringstream stream(str);
+  std::string word;
+  while (stream >> word)
+    result.push_back(word);
+  return result;
+}
+
+// Random word graph over a small vocabulary, so that the prefixes
+// match the words of many arcs
+void createRandomWordGraph(WordGraph& wg, unsigned int numStates)
+{
+  const char* vocab[] = {"the", "then", "they", "green", "great", "grey", "house", "home", "horse", ".", "red", "a"};
+  for (HypStateIndex pred = 0; pred + 1 < numStates; ++pred)
+  {
+    for (int n = 0, numArcs = 1 + rand() % 3; n < numArcs; ++n)
+    {
+      HypStateIndex succ = n == 0 ? pred + 1 : pred + 1 + rand() % std::min(3u, numStates - pred - 1);
+      std::vector<std::string> arcWords;
+      for (int k = 0, numWords = 1 + rand() % 2; k < numWords; ++k)
+        arcWords.push_back(vocab[rand() % 12]);
+      wg.addArc(pred, succ, arcWords, 1, 1, false, -(rand() % 100000) / 10000.0);
+    }
+    if (pred > 0 && rand() % 6 == 0)
+      wg.addFinalState(pred);
+  }
+  wg.addFinalState(numStates - 1);
+  wg.orderArcsTopol();
+  if (rand() % 2 == 0)
+    wg.prune(0.5);
+}
+
+std::vector<std::pair<float, std::vector<std::string>>> toVector(const NbestCorrections& corrections)
+{
+  return std::vector<std::pair<float, std::vector<std::string>>>(corrections.begin(), corrections.end());
+}
+} // namespace
+
+TEST(WgProcessorForAnlpTest, correct)
+{
+  WordGraph wg;
+  wg.addArc(0, 1, words("the"), 1, 1, false, -1.0);
+  wg.addArc(1, 2, words("green"), 2, 2, false, -1.5);
+  wg.addArc(1, 2, words("red"), 2, 2, false, -2.0);
+  wg.addArc(2, 3, words("house ."), 3, 4, false, -1.0);
+  wg.addArc(2, 3, words("home ."), 3, 4, false, -3.0);
+  wg.addFinalState(3);
+  wg.orderArcsTopol();
+
+  PfsmEcmForWg ecm;
+  WgProcessorForAnlp<PfsmEcmForWg> wgp;
+  wgp.link_wg(&wg);
+  wgp.link_ecm_wg(&ecm);
+  wgp.set_wgw(1);
+  wgp.set_ecmw(1);
+
+  NbestCorrections corrections = wgp.correct("the r", 1, RejectedWordsSet());
+  ASSERT_EQ(corrections.size(), 1);
+  EXPECT_EQ(corrections.begin()->second, words("the red house ."));
+
+  corrections = wgp.correct("the red h", 1, RejectedWordsSet());
+  ASSERT_EQ(corrections.size(), 1);
+  EXPECT_EQ(corrections.begin()->second, words("the red house ."));
+
+  corrections = wgp.correct("the red ", 1, RejectedWordsSet{{"h", "ouse"}});
+  ASSERT_EQ(corrections.size(), 1);
+  EXPECT_EQ(corrections.begin()->second, words("the red home ."));
+}
+
+TEST(WgProcessorForAnlpTest, incrementalProcessingMatchesProcessingFromScratch)
+{
+  // Keystrokes of a user typing a prefix, correcting it and typing a new
+  // one
+  std::vector<std::string> prefixes = {
+      "t",           "th",           "the",         "the ",         "the g",         "the gr",   "the gre", "the gree",
+      "the green",   "the green ",   "the green h", "the green ho", "the green h",   "the green hu", "the green hou",
+      "the r",       "the re",       "the red ",    "the red hor",  "a",             "a ",       "a g"};
+  PfsmEcmForWg ecm;
+  srand(4242);
+  for (unsigned int n = 0; n < 10; ++n)
+  {
+    WordGraph wg;
+    createRandomWordGraph(wg, 6 + 2 * n);
+
+    WgProcessorForAnlp<PfsmEcmForWg> incrWgp;
+    incrWgp.link_wg(&wg);
+    incrWgp.link_ecm_wg(&ecm);
+    incrWgp.set_wgw(1);
+    incrWgp.set_ecmw(1);
+
+    RejectedWordsSet rejectedWords;
+    for (unsigned int i = 0; i < prefixes.size(); ++i)
+    {
+      if (prefixes[i] == "the green hu")
+        rejectedWords.insert(std::make_pair("h", "ouse"));
+
+      WgProcessorForAnlp<PfsmEcmForWg> wgp;
+      wgp.link_wg(&wg);
+      wgp.link_ecm_wg(&ecm);
+      wgp.set_wgw(1);
+      wgp.set_ecmw(1);
+
+      NbestCorrections corrections = incrWgp.correct(prefixes[i], 5, rejectedWords);
+      EXPECT_EQ(toVector(corrections), toVector(wgp.correct(prefixes[i], 5, rejectedWords)));
+      if (rejectedWords.empty())
+      {
+        EXPECT_FALSE(corrections.empty());
+      }
+    }
+  }
+}
@@ -0,0 +1,393 @@
+#include "error_correction/WordGraph.h"
+
+#include "TempFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace
+{
+std::vector<std::string> words(const std::string& str)
+{
+  std::vector<std::string> result;
+  std::istringstream stream(str);
+  std::string word;
+  while (stream >> word)
+    result.push_back(word);
+  return result;
+}
+
+std::vector<std::string> printedArcs(const WordGraph& wg)
+{
+  std::ostringstream stream;
+  wg.print(stream);
+  std::vector<std::string> lines;
+  std::istringstream lineStream(stream.str());
+  std::string line;
+  while (std::getline(lineStream, line))
+    lines.push_back(line);
+  std::sort(lines.begin(), lines.end());
+  return lines;
+}
+
+// Word graph with several paths between states 0 and 5, arcs are added
+// out of topological order
+void createWordGraph(WordGraph& wg)
+{
+  wg.addArcWithScrComps(2, 4, words("house"), 2, 2, false, -2.0, {-1.0, -1.0});
+  wg.addArcWithScrComps(0, 1, words("the"), 1, 1, false, -1.0, {-0.5, -0.5});
+  wg.addArcWithScrComps(1, 2, words("green"), 3, 3, false, -1.5, {-1.0, -0.5});
+  wg.addArcWithScrComps(0, 2, words("the green"), 1, 3, false, -2.0, {-1.5, -0.5});
+  wg.addArcWithScrComps(1, 3, words("red"), 3, 3, true, -3.0, {-2.0, -1.0});
+  wg.addArcWithScrComps(3, 4, words("house"), 2, 2, false, -1.0, {-0.5, -0.5});
+  wg.addArcWithScrComps(4, 5, words("."), 4, 4, false, -0.5, {-0.25, -0.25});
+  wg.addArcWithScrComps(2, 5, words("home ."), 2, 4, false, -4.0, {-2.0, -2.0});
+  wg.addFinalState(5);
+}
+
+// Random word graph with several final states, some of which have
+// outgoing arcs, and some pruned arcs
+void createRandomWordGraph(WordGraph& wg, unsigned int numStates)
+{
+  for (HypStateIndex pred = 0; pred + 1 < numStates; ++pred)
+  {
+    for (int n = 0, numArcs = 1 + rand() % 3; n < numArcs; ++n)
+    {
+      HypStateIndex succ = pred + 1 + rand() % std::min(3u, numStates - pred - 1);
+      wg.addArc(pred, succ, words("w" + std::to_string(wg.numArcs())), 1, 1, false, -(rand() % 100000) / 1000.0);
+    }
+    if (pred > 0 && rand() % 6 == 0)
+      wg.addFinalState(pred);
+  }
+  wg.addFinalState(numStates - 1);
+  wg.orderArcsTopol();
+  wg.prune(0.5);
+}
+
+void expectEqualWordGraphs(const WordGraph& actual, const WordGraph& expected)
+{
+  ASSERT_EQ(actual.numArcs(), expected.numArcs());
+  ASSERT_EQ(actual.numStates(), expected.numStates());
+  EXPECT_EQ(actual.getInitialStateScore(), expected.getInitialStateScore());
+  EXPECT_EQ(actual.getFinalStateSet(), expected.getFinalStateSet());
+  std::vector<std::pair<std::string, float>> actualWeights, expectedWeights;
+  actual.getCompWeights(actualWeights);
+  expected.getCompWeights(expectedWeights);
+  EXPECT_EQ(actualWeights, expectedWeights);
+  for (WordGraphArcId arcId = 0; arcId < expected.numArcs(); ++arcId)
+  {
+    WordGraphArc actualArc = actual.wordGraphArcId2WordGraphArc(arcId);
+    WordGraphArc expectedArc = expected.wordGraphArcId2WordGraphArc(arcId);
+    EXPECT_EQ(actualArc.predStateIndex, expectedArc.predStateIndex);
+    EXPECT_EQ(actualArc.succStateIndex, expectedArc.succStateIndex);
+    EXPECT_EQ(actualArc.arcScore, expectedArc.arcScore);
+    EXPECT_EQ(actualArc.words, expectedArc.words);
+    EXPECT_EQ(actualArc.srcStartIndex, expectedArc.srcStartIndex);
+    EXPECT_EQ(actualArc.srcEndIndex, expectedArc.srcEndIndex);
+    EXPECT_EQ(actualArc.unknown, expectedArc.unknown);
+    EXPECT_EQ(actual.arcPruned(arcId), expected.arcPruned(arcId));
+  }
+  for (HypStateIndex idx = 0; idx < expected.numStates(); ++idx)
+  {
+    EXPECT_EQ(actual.getWordGraphStateData(idx).arcsToPredStates,
+              expected.getWordGraphStateData(idx).arcsToPredStates);
+    EXPECT_EQ(actual.getWordGraphStateData(idx).arcsToSuccStates,
+              expected.getWordGraphStateData(idx).arcsToSuccStates);
+  }
+  EXPECT_EQ(printedArcs(actual), printedArcs(expected));
+}
+
+std::vector<WordGraphArcId> csrRange(const WordGraphArcId* begin, const WordGraphArcId* end)
+{
+  return std::vector<WordGraphArcId>(begin, end);
+}
+} // namespace
+
+TEST(WordGraphTest, csrLayoutMatchesArcs)
+{
+  WordGraph wg;
+  createWordGraph(wg);
+  wg.orderArcsTopol();
+
+  const WordGraphCsr& csr = wg.getCsr();
+  ASSERT_EQ(csr.numArcs(), wg.numArcs());
+  ASSERT_EQ(csr.numStates(), wg.numStates());
+  for (WordGraphArcId arcId = 0; arcId < wg.numArcs(); ++arcId)
+  {
+    WordGraphArc arc = wg.wordGraphArcId2WordGraphArc(arcId);
+    EXPECT_EQ(csr.predStates[arcId], arc.predStateIndex);
+    EXPECT_EQ(csr.succStates[arcId], arc.succStateIndex);
+    EXPECT_EQ(csr.arcScores[arcId], arc.arcScore);
+    EXPECT_EQ(csr.srcStartIndices[arcId], arc.srcStartIndex);
+    EXPECT_EQ(csr.srcEndIndices[arcId], arc.srcEndIndex);
+    EXPECT_EQ(csr.unknown[arcId] != 0, arc.unknown);
+    ASSERT_EQ(csr.numWords(arcId), arc.words.size());
+    for (unsigned int k = 0; k < arc.words.size(); ++k)
+      EXPECT_EQ(csr.word(arcId, k), arc.words[k]);
+  }
+  // "house" and "." are shared by several arcs
+  EXPECT_EQ(csr.vocab.size(), 6);
+
+  for (HypStateIndex idx = 0; idx < wg.numStates(); ++idx)
+  {
+    std::vector<WordGraphArcId> arcIds;
+    wg.getArcIdsToSuccStates(idx, arcIds);
+    EXPECT_EQ(csrRange(csr.outArcsBegin(idx), csr.outArcsEnd(idx)), arcIds);
+    wg.getArcIdsToPredStates(idx, arcIds);
+    EXPECT_EQ(csrRange(csr.inArcsBegin(idx), csr.inArcsEnd(idx)), arcIds);
+  }
+  EXPECT_EQ(csr.outArcsBegin(wg.numStates()), csr.outArcsEnd(wg.numStates()));
+}
+
+TEST(WordGraphTest, orderArcsTopolKeepsArcInformation)
+{
+  WordGraph wg;
+  createWordGraph(wg);
+  std::vector<std::string> expectedArcs = printedArcs(wg);
+
+  wg.orderArcsTopol();
+  EXPECT_EQ(printedArcs(wg), expectedArcs);
+
+  // Arcs are topologically ordered: no arc arrives to a state after an
+  // arc has left it
+  std::vector<bool> stateLeft(wg.numStates(), false);
+  for (WordGraphArcId arcId = 0; arcId < wg.numArcs(); ++arcId)
+  {
+    WordGraphArc arc = wg.wordGraphArcId2WordGraphArc(arcId);
+    EXPECT_FALSE(stateLeft[arc.succStateIndex]);
+    stateLeft[arc.predStateIndex] = true;
+  }
+}
+
+TEST(WordGraphTest, csrLayoutIsRebuiltAfterChanges)
+{
+  WordGraph wg;
+  createWordGraph(wg);
+  wg.orderArcsTopol();
+  EXPECT_EQ(wg.getCsr().numArcs(), 8);
+
+  wg.addArc(5, 6, words("!"), 4, 4, false, -0.1);
+  EXPECT_EQ(wg.getCsr().numArcs(), 9);
+  EXPECT_EQ(wg.getCsr().word(8, 0), "!");
+
+  wg.setCompWeights({{"a", 2.0}, {"b", 0.0}});
+  EXPECT_EQ(wg.getCsr().arcScores[0], wg.wordGraphArcId2WordGraphArc(0).arcScore);
+
+  wg.clear();
+  EXPECT_EQ(wg.getCsr().numArcs(), 0);
+}
+
+TEST(WordGraphTest, obtainNbestList)
+{
+  WordGraph wg;
+  createWordGraph(wg);
+  wg.orderArcsTopol();
+
+  std::vector<std::pair<Score, std::string>> nblist;
+  std::vector<NbSearchHighLevelHyp> highLevelHypList;
+  std::vector<std::vector<Score>> scoreCompsVec;
+  wg.obtainNbestList(10, nblist, highLevelHypList, scoreCompsVec);
+
+  std::vector<std::pair<Score, std::string>> expected = {
+      {-4.5, "the green house ."}, {-5.0, "the green house ."}, {-5.5, "the red house ."},
+      {-6.0, "the green home ."},  {-6.5, "the green home ."}};
+  ASSERT_EQ(nblist.size(), expected.size());
+  for (unsigned int i = 0; i < expected.size(); ++i)
+  {
+    EXPECT_DOUBLE_EQ(nblist[i].first, expected[i].first);
+    EXPECT_EQ(nblist[i].second, expected[i].second);
+  }
+  ASSERT_EQ(scoreCompsVec.size(), expected.size());
+  EXPECT_DOUBLE_EQ(scoreCompsVec[0][0], -2.75);
+  EXPECT_DOUBLE_EQ(scoreCompsVec[0][1], -1.75);
+
+  std::vector<TranslationData> translations;
+  wg.obtainNbestList(1, translations);
+  ASSERT_EQ(translations.size(), 1);
+  EXPECT_EQ(translations[0].target, words("the green house ."));
+  EXPECT_EQ(translations[0].targetSegmentCuts, (std::vector<PositionIndex>{2, 3, 4}));
+
+  // Prune everything but the best path
+  wg.prune(1);
+  wg.obtainNbestList(10, nblist, highLevelHypList, scoreCompsVec);
+  ASSERT_EQ(nblist.size(), 1);
+  EXPECT_EQ(nblist[0].second, "the green house .");
+}
+
+TEST(WordGraphTest, lazyNbestList)
+{
+  WordGraph wg;
+  createWordGraph(wg);
+  wg.orderArcsTopol();
+
+  std::vector<std::pair<Score, std::string>> nblist;
+  std::vector<NbSearchHighLevelHyp> highLevelHypList;
+  std::vector<std::vector<Score>> scoreCompsVec;
+  wg.obtainNbestList(10, nblist, highLevelHypList, scoreCompsVec, false, true);
+
+  std::vector<std::pair<Score, std::string>> expected = {
+      {-4.5, "the green house ."}, {-5.0, "the green house ."}, {-5.5, "the red house ."},
+      {-6.0, "the green home ."},  {-6.5, "the green home ."}};
+  ASSERT_EQ(nblist.size(), expected.size());
+  ASSERT_EQ(highLevelHypList.size(), expected.size());
+  for (unsigned int i = 0; i < expected.size(); ++i)
+  {
+    EXPECT_DOUBLE_EQ(nblist[i].first, expected[i].first);
+    EXPECT_EQ(nblist[i].second, expected[i].second);
+  }
+  ASSERT_EQ(scoreCompsVec.size(), expected.size());
+  EXPECT_DOUBLE_EQ(scoreCompsVec[0][0], -2.75);
+  EXPECT_DOUBLE_EQ(scoreCompsVec[0][1], -1.75);
+
+  std::vector<TranslationData> translations;
+  wg.obtainNbestList(2, translations, false, true);
+  ASSERT_EQ(translations.size(), 2);
+  EXPECT_EQ(translations[1].target, words("the green house ."));
+  EXPECT_EQ(translations[1].targetSegmentCuts, (std::vector<PositionIndex>{1, 2, 3, 4}));
+}
+
+TEST(WordGraphTest, lazyNbestListMatchesAStarSearch)
+{
+  srand(27182);
+  for (unsigned int n = 0; n < 20; ++n)
+  {
+    WordGraph wg;
+    createRandomWordGraph(wg, 5 + n);
+
+    std::vector<std::pair<Score, std::string>> nblist, lazyNblist;
+    std::vector<NbSearchHighLevelHyp> highLevelHypList, lazyHighLevelHypList;
+    std::vector<std::vector<Score>> scoreCompsVec, lazyScoreCompsVec;
+    wg.obtainNbestList(100, nblist, highLevelHypList, scoreCompsVec);
+    wg.obtainNbestList(100, lazyNblist, lazyHighLevelHypList, lazyScoreCompsVec, false, true);
+
+    ASSERT_EQ(lazyNblist.size(), nblist.size());
+    for (unsigned int i = 0; i < nblist.size(); ++i)
+    {
+      EXPECT_NEAR(lazyNblist[i].first, nblist[i].first, 1e-9);
+      // Hypotheses with the same score may be returned in a different
+      // order
+      bool tied = (i > 0 && nblist[i].first - nblist[i - 1].first > -1e-9) ||
+                  (i + 1 < nblist.size() && nblist[i].first - nblist[i + 1].first < 1e-9);
+      if (!tied)
+      {
+        EXPECT_EQ(lazyNblist[i].second, nblist[i].second);
+      }
+    }
+  }
+}
+
+class WordGraphFileTest : public testing::Test
+{
+protected:
+  TempFile textFile;
+  TempFile binaryFile;
+};
+
+TEST_F(WordGraphFileTest, convertedBinaryWordGraphMatchesTextWordGraph)
+{
+  WordGraph wg;
+  createWordGraph(wg);
+  wg.setCompWeights({{"tm", 1.5}, {"lm", 0.5}});
+  wg.setInitialStateScore(-0.25);
+  wg.orderArcsTopol();
+  ASSERT_EQ(wg.print(textFile.c_str()), THOT_OK);
+
+  ASSERT_EQ(WordGraph::convertToBinary(textFile.c_str(), binaryFile.c_str()), THOT_OK);
+  EXPECT_FALSE(WordGraph::isBinaryFile(textFile.c_str()));
+  EXPECT_TRUE(WordGraph::isBinaryFile(binaryFile.c_str()));
+
+  WordGraph textWg;
+  ASSERT_EQ(textWg.load(textFile.c_str()), THOT_OK);
+  WordGraph binaryWg;
+  ASSERT_EQ(binaryWg.load(binaryFile.c_str()), THOT_OK);
+  expectEqualWordGraphs(binaryWg, textWg);
+
+  std::vector<TranslationData> textNblist, binaryNblist;
+  textWg.obtainNbestList(10, textNblist);
+  binaryWg.obtainNbestList(10, binaryNblist);
+  ASSERT_EQ(binaryNblist.size(), textNblist.size());
+  for (unsigned int i = 0; i < textNblist.size(); ++i)
+  {
+    EXPECT_EQ(binaryNblist[i].score, textNblist[i].score);
+    EXPECT_EQ(binaryNblist[i].target, textNblist[i].target);
+    EXPECT_EQ(binaryNblist[i].scoreComponents, textNblist[i].scoreComponents);
+  }
+}
+
+TEST_F(WordGraphFileTest, binaryWordGraphRoundTripsExactly)
+{
+  WordGraph wg;
+  createWordGraph(wg);
+  // Scores that are not preserved by the text format
+  wg.addArcWithScrComps(5, 6, words("!"), 4, 4, false, -0.123456789012345, {-1.0 / 3.0, -2.0 / 7.0});
+  wg.addFinalState(6);
+  wg.setCompWeights({{"tm", 0.1f}, {"lm", 1.0f / 3.0f}});
+  wg.orderArcsTopol();
+  wg.prune(1);
+  ASSERT_GT(wg.getNumberOfPrunedAndNonPrunedArcs(), wg.getNumberOfNonPrunedArcs());
+
+  ASSERT_EQ(wg.printBinary(binaryFile.c_str()), THOT_OK);
+  WordGraph binaryWg;
+  ASSERT_EQ(binaryWg.load(binaryFile.c_str()), THOT_OK);
+  expectEqualWordGraphs(binaryWg, wg);
+
+  // The CSR layout read from the file matches the one built from the
+  // arcs
+  const WordGraphCsr& loadedCsr = binaryWg.getCsr();
+  const WordGraphCsr& expectedCsr = wg.getCsr();
+  EXPECT_EQ(loadedCsr.vocab, expectedCsr.vocab);
+  EXPECT_EQ(loadedCsr.words, expectedCsr.words);
+  EXPECT_EQ(loadedCsr.outArcs, expectedCsr.outArcs);
+  EXPECT_EQ(loadedCsr.inOffsets, expectedCsr.inOffsets);
+}
+
+TEST_F(WordGraphFileTest, truncatedBinaryWordGraphIsRejected)
+{
+  WordGraph wg;
+  createWordGraph(wg);
+  ASSERT_EQ(wg.printBinary(binaryFile.c_str()), THOT_OK);
+
+  std::ifstream binary(binaryFile.c_str(), std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(binary)), std::istreambuf_iterator<char>());
+  binary.close();
+  std::ofstream truncated(binaryFile.c_str(), std::ios::binary);
+  truncated.write(content.data(), content.size() - 8);
+  truncated.close();
+
+  WordGraph binaryWg;
+  EXPECT_EQ(binaryWg.load(binaryFile.c_str()), THOT_ERROR);
+  EXPECT_TRUE(binaryWg.empty());
+}
+
+TEST_F(WordGraphFileTest, binaryWordGraphWithTooManyElementsIsRejected)
+{
+  WordGraph wg;
+  createWordGraph(wg);
+  ASSERT_EQ(wg.printBinary(binaryFile.c_str()), THOT_OK);
+
+  std::ifstream binary(binaryFile.c_str(), std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(binary)), std::istreambuf_iterator<char>());
+  binary.close();
+
+  // Numbers of words, score components and final states stored in the
+  // header, chosen so that the sizes of their sections wrap around
+  const size_t countOffsets[] = {32, 40, 48};
+  const uint64_t counts[] = {uint64_t(1) << 61, uint64_t(1) << 61, uint64_t(1) << 62};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    std::string corrupted = content;
+    memcpy(&corrupted[countOffsets[i]], &counts[i], sizeof(uint64_t));
+    std::ofstream corruptedFile(binaryFile.c_str(), std::ios::binary);
+    corruptedFile.write(corrupted.data(), corrupted.size());
+    corruptedFile.close();
+
+    WordGraph binaryWg;
+    EXPECT_EQ(binaryWg.load(binaryFile.c_str()), THOT_ERROR);
+    EXPECT_TRUE(binaryWg.empty());
+  }
+}
@@ -0,0 +1,79 @@
+#include "incr_models/IncrJelMerNgramLM.h"
+
+#include "TempFile.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<std::string> createRandomSentence(unsigned int vocabSize)
+{
+  std::vector<std::string> sentence;
+  for (unsigned int i = 0, length = 1 + rand() % 10; i < length; ++i)
+    sentence.push_back("w" + std::to_string(rand() % vocabSize));
+  return sentence;
+}
+
+// Exposes the in-memory perplexity used to update the weights
+class TestIncrJelMerNgramLM : public IncrJelMerNgramLM
+{
+public:
+  double corpusPerplexity(const char* corpusFileName)
+  {
+    CorpusNgramTerms terms;
+    EXPECT_EQ(getCorpusNgramTerms(corpusFileName, terms), THOT_OK);
+    return IncrJelMerNgramLM::corpusPerplexity(terms, weights.data());
+  }
+};
+} // namespace
+
+class IncrJelMerNgramLMTest : public testing::Test
+{
+protected:
+  double perplexity()
+  {
+    unsigned int numOfSentences;
+    unsigned int numWords;
+    LgProb totalLogProb;
+    double perp;
+    EXPECT_EQ(lm.perplexity(corpusFile.c_str(), numOfSentences, numWords, totalLogProb, perp), THOT_OK);
+    return perp;
+  }
+
+  TestIncrJelMerNgramLM lm;
+  TempFile corpusFile;
+};
+
+TEST_F(IncrJelMerNgramLMTest, updateModelWeightsReducesPerplexity)
+{
+  srand(31415);
+  lm.setNgramOrder(3);
+  for (unsigned int n = 0; n < 300; ++n)
+    lm.trainSentence(createRandomSentence(20), 1, 0);
+
+  {
+    std::ofstream corpusStream(corpusFile.c_str());
+    for (unsigned int n = 0; n < 50; ++n)
+    {
+      std::vector<std::string> sentence = createRandomSentence(25);
+      for (unsigned int i = 0; i < sentence.size(); ++i)
+        corpusStream << (i == 0 ? "" : " ") << sentence[i];
+      corpusStream << "\n";
+    }
+  }
+
+  double initialPerplexity = perplexity();
+  EXPECT_NEAR(lm.corpusPerplexity(corpusFile.c_str()), initialPerplexity, initialPerplexity * 1e-6);
+  ASSERT_EQ(lm.updateModelWeights(corpusFile.c_str()), THOT_OK);
+  double updatedPerplexity = perplexity();
+  EXPECT_NEAR(lm.corpusPerplexity(corpusFile.c_str()), updatedPerplexity, updatedPerplexity * 1e-6);
+  EXPECT_LT(updatedPerplexity, initialPerplexity);
+
+  // Updating again from the optimized weights does not change much
+  ASSERT_EQ(lm.updateModelWeights(corpusFile.c_str()), THOT_OK);
+  EXPECT_NEAR(perplexity(), updatedPerplexity, updatedPerplexity * 0.01);
+}
@@ -0,0 +1,140 @@
+#include "incr_models/WordPredictor.h"
+
+#include "TempFile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<std::vector<std::string>> createRandomSentences(unsigned int numSentences)
+{
+  std::vector<std::vector<std::string>> sentences(numSentences);
+  for (unsigned int n = 0; n < numSentences; ++n)
+  {
+    for (unsigned int i = 0, length = 1 + rand() % 8; i < length; ++i)
+    {
+      std::string word;
+      for (unsigned int j = 0, wordLength = 1 + rand() % 5; j < wordLength; ++j)
+        word += (char)('a' + rand() % 3);
+      sentences[n].push_back(word);
+    }
+  }
+  return sentences;
+}
+
+std::vector<std::pair<float, std::string>> toVector(const WordPredictor::SuffixList& suffixList)
+{
+  std::vector<std::pair<float, std::string>> result;
+  for (WordPredictor::SuffixList::const_iterator iter = suffixList.begin(); iter != suffixList.end(); ++iter)
+    result.push_back(std::make_pair((float)iter->first, iter->second));
+  return result;
+}
+
+// Obtains the suffix list from all the words that start with input
+std::vector<std::pair<float, std::string>> getExpectedSuffixList(const std::map<std::string, unsigned int>& counts,
+                                                                 const std::string& input)
+{
+  std::vector<std::pair<unsigned int, std::string>> candidates;
+  for (std::map<std::string, unsigned int>::const_iterator iter = counts.begin(); iter != counts.end(); ++iter)
+  {
+    if (iter->first.compare(0, input.size(), input) == 0)
+      candidates.push_back(std::make_pair(iter->second, iter->first));
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<unsigned int, std::string>& a, const std::pair<unsigned int, std::string>& b) {
+              return a.first > b.first || (a.first == b.first && a.second < b.second);
+            });
+
+  WordPredictor::SuffixList suffixList;
+  for (unsigned int i = 0; i < candidates.size() && i < WP_NUM_COMPLETIONS; ++i)
+    suffixList.insert(std::make_pair(candidates[i].first, candidates[i].second.substr(input.size())));
+  return toVector(suffixList);
+}
+
+void expectSuffixLists(WordPredictor& wordPredictor, const std::map<std::string, unsigned int>& counts)
+{
+  std::vector<std::string> inputs = {"", "a", "b", "c", "ab", "ba", "cc", "abc", "bca", "aaaa", "cabac", "d"};
+  for (const std::string& input : inputs)
+  {
+    WordPredictor::SuffixList suffixList;
+    wordPredictor.getSuffixList(input, suffixList);
+    EXPECT_EQ(toVector(suffixList), getExpectedSuffixList(counts, input)) << "input: " << input;
+  }
+}
+} // namespace
+
+class WordPredictorTest : public testing::Test
+{
+protected:
+  TempFile sentsFile;
+  TempFile binaryFile;
+};
+
+TEST_F(WordPredictorTest, getBestSuffix)
+{
+  WordPredictor wordPredictor;
+  wordPredictor.addSentence({"the", "house", "is", "the", "home"});
+  wordPredictor.addSentence({"a", "house"});
+
+  std::pair<Count, std::string> bestSuffix = wordPredictor.getBestSuffix("ho");
+  EXPECT_EQ((float)bestSuffix.first, 2);
+  EXPECT_EQ(bestSuffix.second, "use");
+  bestSuffix = wordPredictor.getBestSuffix("hom");
+  EXPECT_EQ((float)bestSuffix.first, 1);
+  EXPECT_EQ(bestSuffix.second, "e");
+  bestSuffix = wordPredictor.getBestSuffix("the");
+  EXPECT_EQ((float)bestSuffix.first, 2);
+  EXPECT_EQ(bestSuffix.second, "");
+  bestSuffix = wordPredictor.getBestSuffix("x");
+  EXPECT_EQ((float)bestSuffix.first, 0);
+  EXPECT_EQ(bestSuffix.second, "");
+}
+
+TEST_F(WordPredictorTest, suffixListsMatchWordCounts)
+{
+  srand(16180);
+  std::vector<std::vector<std::string>> sentences = createRandomSentences(300);
+  std::map<std::string, unsigned int> counts;
+
+  {
+    std::ofstream sentsStream(sentsFile.c_str());
+    for (unsigned int n = 0; n < 200; ++n)
+    {
+      for (unsigned int i = 0; i < sentences[n].size(); ++i)
+      {
+        sentsStream << (i == 0 ? "" : " ") << sentences[n][i];
+        ++counts[sentences[n][i]];
+      }
+      sentsStream << "\n";
+    }
+  }
+
+  WordPredictor textWordPredictor;
+  ASSERT_EQ(textWordPredictor.load(sentsFile.c_str()), THOT_OK);
+  expectSuffixLists(textWordPredictor, counts);
+
+  ASSERT_EQ(WordPredictor::convertToBinary(sentsFile.c_str(), binaryFile.c_str()), THOT_OK);
+  WordPredictor binaryWordPredictor;
+  ASSERT_EQ(binaryWordPredictor.load(binaryFile.c_str()), THOT_OK);
+  expectSuffixLists(binaryWordPredictor, counts);
+
+  // Sentences added after loading are combined with the loaded counts
+  for (unsigned int n = 200; n < sentences.size(); ++n)
+  {
+    textWordPredictor.addSentence(sentences[n]);
+    binaryWordPredictor.addSentence(sentences[n]);
+    for (const std::string& word : sentences[n])
+      ++counts[word];
+  }
+  binaryWordPredictor.addSentence({"cabacab"});
+  textWordPredictor.addSentence({"cabacab"});
+  ++counts["cabacab"];
+  expectSuffixLists(textWordPredictor, counts);
+  expectSuffixLists(binaryWordPredictor, counts);
+}
@@ -0,0 +1,44 @@
+#include "nlp_common/AwkInputStream.h"
+
+#include "nlp_common/ErrorDefs.h"
+
+#include <gtest/gtest.h>
+
+TEST(AwkInputStreamTest, fields)
+{
+  FILE* file = tmpfile();
+  fputs("  the  cat ||| 0.25 -3  \n\nlast 1e-2", file);
+  rewind(file);
+
+  AwkInputStream awk;
+  ASSERT_EQ(awk.open_stream(file), THOT_OK);
+
+  ASSERT_TRUE(awk.getln());
+  EXPECT_EQ(awk.NF, 5u);
+  EXPECT_EQ(awk.dollar(0), "  the  cat ||| 0.25 -3  ");
+  EXPECT_EQ(awk.dollar(1), "the");
+  EXPECT_EQ(awk.dollar(2), "cat");
+  EXPECT_EQ(awk.dollar(6), "");
+  EXPECT_EQ(awk.dollarSize(3), 3u);
+  EXPECT_TRUE(awk.dollarEquals(3, "|||"));
+  EXPECT_FALSE(awk.dollarEquals(3, "||"));
+  EXPECT_FALSE(awk.dollarEquals(3, "||||"));
+  EXPECT_DOUBLE_EQ(awk.dollarToDouble(4), 0.25);
+  EXPECT_EQ(awk.dollarToInt(5), -3);
+  EXPECT_EQ(awk.dollarToInt(1), 0);
+  std::string field;
+  awk.dollar(2, field);
+  EXPECT_EQ(field, "cat");
+
+  ASSERT_TRUE(awk.getln());
+  EXPECT_EQ(awk.NF, 0u);
+  EXPECT_EQ(awk.dollar(1), "");
+
+  // Last line without newline
+  ASSERT_TRUE(awk.getln());
+  EXPECT_EQ(awk.NF, 2u);
+  EXPECT_DOUBLE_EQ(awk.dollarToDouble(2), 0.01);
+  EXPECT_EQ(awk.FNR, 3u);
+  EXPECT_FALSE(awk.getln());
+  fclose(file);
+}
@@ -0,0 +1,172 @@
+#include "phrase_models/MmapPhraseTable.h"
+
+#include "phrase_models/WbaIncrPhraseModel.h"
+
+#include "TempFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace
+{
+std::vector<std::string> randomPhrase(const char* prefix)
+{
+  std::vector<std::string> phrase(1 + rand() % 3);
+  for (unsigned int i = 0; i < phrase.size(); ++i)
+    phrase[i] = prefix + std::to_string(rand() % 5);
+  return phrase;
+}
+
+std::string join(const std::vector<std::string>& phrase)
+{
+  std::string str;
+  for (unsigned int i = 0; i < phrase.size(); ++i)
+    str += (i == 0 ? "" : " ") + phrase[i];
+  return str;
+}
+
+std::vector<std::string> readSortedLines(const char* fileName)
+{
+  std::vector<std::string> lines;
+  std::ifstream stream(fileName);
+  std::string line;
+  while (std::getline(stream, line))
+    lines.push_back(line);
+  std::sort(lines.begin(), lines.end());
+  return lines;
+}
+
+void expectEqualNodes(const std::map<std::vector<WordIndex>, PhrasePairInfo>& actual,
+                      const std::map<std::vector<WordIndex>, PhrasePairInfo>& expected)
+{
+  ASSERT_EQ(actual.size(), expected.size());
+  std::map<std::vector<WordIndex>, PhrasePairInfo>::const_iterator actualIter = actual.begin();
+  std::map<std::vector<WordIndex>, PhrasePairInfo>::const_iterator expectedIter = expected.begin();
+  for (; actualIter != actual.end(); ++actualIter, ++expectedIter)
+  {
+    EXPECT_EQ(actualIter->first, expectedIter->first);
+    EXPECT_EQ(actualIter->second.first.get_c_s(), expectedIter->second.first.get_c_s());
+    EXPECT_EQ(actualIter->second.second.get_c_st(), expectedIter->second.second.get_c_st());
+  }
+}
+
+class MmapPhraseTableTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Random table with repeated phrase pairs and phrases shared by
+    // several entries
+    srand(16180);
+    std::ofstream table(tableFile.c_str());
+    for (unsigned int n = 0; n < 300; ++n)
+    {
+      srcPhrases.push_back(randomPhrase("s"));
+      trgPhrases.push_back(randomPhrase("t"));
+      table << join(srcPhrases.back()) << " ||| " << join(trgPhrases.back()) << " ||| " << 1 + rand() % 20 << " "
+            << 1 + rand() % 10 << std::endl;
+    }
+    table << "<UNUSED_WORD> ||| t0 ||| 0 3" << std::endl;
+    table.close();
+
+    ASSERT_EQ(MmapPhraseTable::compile(tableFile.c_str(), compiledFile.c_str()), THOT_OK);
+  }
+
+  std::vector<std::string> unknownPhrase()
+  {
+    return std::vector<std::string>(1, "unknown");
+  }
+
+  TempFile tableFile;
+  TempFile compiledFile;
+  std::vector<std::vector<std::string>> srcPhrases;
+  std::vector<std::vector<std::string>> trgPhrases;
+};
+} // namespace
+
+TEST_F(MmapPhraseTableTest, compiledTableMatchesPlainTextTable)
+{
+  EXPECT_FALSE(MmapPhraseTable::isCompiledTable(tableFile.c_str()));
+  EXPECT_TRUE(MmapPhraseTable::isCompiledTable(compiledFile.c_str()));
+
+  WbaIncrPhraseModel textModel;
+  ASSERT_EQ(textModel.load_ttable(tableFile.c_str()), THOT_OK);
+  WbaIncrPhraseModel compiledModel;
+  ASSERT_EQ(compiledModel.load_ttable(compiledFile.c_str()), THOT_OK);
+
+  EXPECT_EQ(compiledModel.getSrcVocabSize(), textModel.getSrcVocabSize());
+  EXPECT_EQ(compiledModel.getTrgVocabSize(), textModel.getTrgVocabSize());
+  EXPECT_EQ(compiledModel.size(), textModel.size());
+
+  srcPhrases.push_back(unknownPhrase());
+  trgPhrases.push_back(unknownPhrase());
+  for (unsigned int n = 0; n < srcPhrases.size(); ++n)
+  {
+    // Phrases of different entries are combined to query missing pairs as well
+    const std::vector<std::string>& hs = srcPhrases[n];
+    const std::vector<std::string>& ht = trgPhrases[(n * 7) % trgPhrases.size()];
+    EXPECT_EQ(compiledModel.cHSrc(hs).get_c_s(), textModel.cHSrc(hs).get_c_s());
+    EXPECT_EQ(compiledModel.cHTrg(ht).get_c_s(), textModel.cHTrg(ht).get_c_s());
+    EXPECT_EQ(compiledModel.cHSrcHTrg(hs, ht).get_c_st(), textModel.cHSrcHTrg(hs, ht).get_c_st());
+    EXPECT_EQ(compiledModel.cHSrcHTrg(hs, trgPhrases[n]).get_c_st(),
+              textModel.cHSrcHTrg(hs, trgPhrases[n]).get_c_st());
+
+    std::vector<WordIndex> s, t;
+    for (unsigned int i = 0; i < hs.size(); ++i)
+      s.push_back(textModel.stringToSrcWordIndex(hs[i]));
+    for (unsigned int i = 0; i < trgPhrases[n].size(); ++i)
+      t.push_back(textModel.stringToTrgWordIndex(trgPhrases[n][i]));
+    EXPECT_EQ(compiledModel.logpt_s_(s, t), textModel.logpt_s_(s, t));
+    EXPECT_EQ(compiledModel.logps_t_(s, t), textModel.logps_t_(s, t));
+
+    BasePhraseTable::TrgTableNode compiledTrgtn, textTrgtn;
+    EXPECT_EQ(compiledModel.getTransFor_s_(s, compiledTrgtn), textModel.getTransFor_s_(s, textTrgtn));
+    expectEqualNodes(compiledTrgtn, textTrgtn);
+    BasePhraseTable::SrcTableNode compiledSrctn, textSrctn;
+    EXPECT_EQ(compiledModel.getTransFor_t_(t, compiledSrctn), textModel.getTransFor_t_(t, textSrctn));
+    expectEqualNodes(compiledSrctn, textSrctn);
+  }
+
+  TempFile textPrintFile;
+  TempFile compiledPrintFile;
+  for (int n : {-1, 1})
+  {
+    ASSERT_EQ(textModel.printPhraseTable(textPrintFile.c_str(), n), THOT_OK);
+    ASSERT_EQ(compiledModel.printPhraseTable(compiledPrintFile.c_str(), n), THOT_OK);
+    EXPECT_EQ(readSortedLines(compiledPrintFile.c_str()), readSortedLines(textPrintFile.c_str()));
+  }
+}
+
+TEST_F(MmapPhraseTableTest, plainTextTableReplacesCompiledTable)
+{
+  WbaIncrPhraseModel model;
+  ASSERT_EQ(model.load_ttable(compiledFile.c_str()), THOT_OK);
+
+  // The compiled table is read-only
+  size_t size = model.size();
+  model.strIncrCountsOfEntry(unknownPhrase(), unknownPhrase());
+  EXPECT_EQ(model.size(), size);
+
+  // Loading a plain text table restores an incremental table
+  ASSERT_EQ(model.load_ttable(tableFile.c_str()), THOT_OK);
+  model.strIncrCountsOfEntry(unknownPhrase(), unknownPhrase(), 2);
+  EXPECT_EQ(model.cHSrcHTrg(unknownPhrase(), unknownPhrase()).get_c_st(), 2);
+}
+
+TEST_F(MmapPhraseTableTest, truncatedTableIsRejected)
+{
+  std::ifstream compiled(compiledFile.c_str(), std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(compiled)), std::istreambuf_iterator<char>());
+  compiled.close();
+  std::ofstream truncated(compiledFile.c_str(), std::ios::binary);
+  truncated.write(content.data(), content.size() / 2);
+  truncated.close();
+
+  MmapPhraseTable table;
+  EXPECT_EQ(table.load(compiledFile.c_str()), THOT_ERROR);
+  WbaIncrPhraseModel model;
+  EXPECT_EQ(model.load_ttable(compiledFile.c_str()), THOT_ERROR);
+}
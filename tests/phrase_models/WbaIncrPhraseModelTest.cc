@@ -0,0 +1,129 @@
+#include "phrase_models/WbaIncrPhraseModel.h"
+
+#include "TempFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace
+{
+// Writes a corpus of random sentence pairs with random alignments in GIZA format
+FILE* createGizaAligFile(unsigned int numPairs)
+{
+  FILE* file = tmpfile();
+  srand(31415);
+  for (unsigned int n = 0; n < numPairs; ++n)
+  {
+    unsigned int slen = 1 + rand() % 8;
+    unsigned int tlen = 1 + rand() % 8;
+    std::ostringstream giza;
+    giza << "# Sentence pair (" << n + 1 << ") source length " << slen << " target length " << tlen << std::endl;
+    for (unsigned int j = 0; j < tlen; ++j)
+      giza << "t" << rand() % 6 << (j + 1 < tlen ? " " : "\n");
+    std::vector<std::vector<unsigned int>> aligned(slen + 1);
+    for (unsigned int j = 1; j <= tlen; ++j)
+      aligned[rand() % (slen + 1)].push_back(j);
+    for (unsigned int i = 0; i <= slen; ++i)
+    {
+      giza << (i == 0 ? std::string("NULL") : "s" + std::to_string(rand() % 6)) << " ({ ";
+      for (unsigned int k = 0; k < aligned[i].size(); ++k)
+        giza << aligned[i][k] << " ";
+      giza << "})" << (i < slen ? " " : "\n");
+    }
+    fputs(giza.str().c_str(), file);
+  }
+  return file;
+}
+} // namespace
+
+TEST(WbaIncrPhraseModelTest, parallelExtractionMatchesSequentialExtraction)
+{
+  FILE* file = createGizaAligFile(200);
+  PhraseExtractParameters phePars;
+
+  // Pipelined extraction
+  WbaIncrPhraseModel pipelinedModel;
+  rewind(file);
+  AlignmentExtractor alignments;
+  ASSERT_EQ(alignments.open_stream(file), THOT_OK);
+  pipelinedModel.extendModelFromAlignments(phePars, false, alignments);
+
+  // Sentence pair by sentence pair extraction
+  WbaIncrPhraseModel sequentialModel;
+  std::vector<std::vector<PhrasePair>> phrasePairs;
+  rewind(file);
+  ASSERT_EQ(alignments.open_stream(file), THOT_OK);
+  while (alignments.getNextAlignment())
+  {
+    sequentialModel.extendModelFromPairPlusAlig(phePars, false, alignments.get_ns(), alignments.get_t(),
+                                                alignments.get_wamatrix(), alignments.get_numReps());
+    phrasePairs.push_back(std::vector<PhrasePair>());
+    sequentialModel.extractPhrasesFromPairPlusAlig(phePars, alignments.get_ns(), alignments.get_t(),
+                                                   alignments.get_wamatrix(), phrasePairs.back(), 0);
+  }
+  fclose(file);
+
+  ASSERT_EQ(phrasePairs.size(), 200u);
+  EXPECT_EQ(pipelinedModel.getSrcVocabSize(), sequentialModel.getSrcVocabSize());
+  EXPECT_EQ(pipelinedModel.getTrgVocabSize(), sequentialModel.getTrgVocabSize());
+  for (unsigned int n = 0; n < phrasePairs.size(); ++n)
+  {
+    for (unsigned int k = 0; k < phrasePairs[n].size(); ++k)
+    {
+      const PhrasePair& phPair = phrasePairs[n][k];
+      EXPECT_EQ(pipelinedModel.cHSrcHTrg(phPair.s_, phPair.t_).get_c_st(),
+                sequentialModel.cHSrcHTrg(phPair.s_, phPair.t_).get_c_st());
+      EXPECT_EQ(pipelinedModel.cHSrc(phPair.s_).get_c_s(), sequentialModel.cHSrc(phPair.s_).get_c_s());
+    }
+  }
+}
+
+namespace
+{
+std::vector<std::string> readSortedLines(const char* fileName)
+{
+  std::vector<std::string> lines;
+  std::ifstream stream(fileName);
+  std::string line;
+  while (std::getline(stream, line))
+    lines.push_back(line);
+  std::sort(lines.begin(), lines.end());
+  return lines;
+}
+} // namespace
+
+TEST(WbaIncrPhraseModelTest, externalCountingMatchesInMemoryCounting)
+{
+  FILE* file = createGizaAligFile(200);
+  PhraseExtractParameters phePars;
+  AlignmentExtractor alignments;
+
+  WbaIncrPhraseModel inMemoryModel;
+  rewind(file);
+  ASSERT_EQ(alignments.open_stream(file), THOT_OK);
+  inMemoryModel.extendModelFromAlignments(phePars, false, alignments);
+
+  TempFile inMemoryFile;
+  TempFile externalFile;
+  for (int n : {-1, 2})
+  {
+    // A small memory budget forces the counts to be spilled in several runs. Printing releases the counts, so they
+    // are extracted again for each table
+    WbaIncrPhraseModel externalModel;
+    externalModel.enableExternalCounting(4096);
+    rewind(file);
+    ASSERT_EQ(alignments.open_stream(file), THOT_OK);
+    externalModel.extendModelFromAlignments(phePars, false, alignments);
+
+    ASSERT_EQ(inMemoryModel.printPhraseTable(inMemoryFile.c_str(), n), THOT_OK);
+    ASSERT_EQ(externalModel.printPhraseTable(externalFile.c_str(), n), THOT_OK);
+    std::vector<std::string> inMemoryLines = readSortedLines(inMemoryFile.c_str());
+    EXPECT_FALSE(inMemoryLines.empty());
+    EXPECT_EQ(readSortedLines(externalFile.c_str()), inMemoryLines);
+  }
+  fclose(file);
+}
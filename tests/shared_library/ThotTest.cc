@@ -0,0 +1,143 @@
+#include "shared_library/thot.h"
+
+#include "sw_models/AlignmentModel.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+const std::vector<std::pair<std::string, std::string>> sentencePairs = {
+    {"isthay isyay ayay esttay-N .", "this is a test N ."},
+    {"ouyay ouldshay esttay-V oftenyay .", "you should test V often ."},
+    {"isyay isthay orkingway ?", "is this working ?"},
+    {"isthay ouldshay orkway-V .", "this should work V ."},
+    {"ityay isyay orkingway .", "it is working ."},
+    {"orkway-N onyay otherway ingsthay-N .", "work N on other things N ."}};
+
+unsigned int countWords(const std::string& sentence)
+{
+  return (unsigned int)std::count(sentence.begin(), sentence.end(), ' ') + 1;
+}
+
+std::string getTarget(void* dataHandle)
+{
+  char target[256];
+  unsigned int length = tdata_getTarget(dataHandle, target, sizeof(target));
+  return std::string(target, std::min<size_t>(length, sizeof(target) - 1));
+}
+} // namespace
+
+TEST(ThotTest, getBestAlignmentBatchMatchesGetBestAlignment)
+{
+  void* model = swAlignModel_create(AlignmentModelType::Hmm, nullptr);
+  for (const std::pair<std::string, std::string>& sentencePair : sentencePairs)
+    swAlignModel_addSentencePair(model, sentencePair.first.c_str(), sentencePair.second.c_str());
+  swAlignModel_startTraining(model);
+  swAlignModel_train(model, 2);
+  swAlignModel_endTraining(model);
+
+  std::vector<const char*> sourceSentences, targetSentences;
+  for (const std::pair<std::string, std::string>& sentencePair : sentencePairs)
+  {
+    sourceSentences.push_back(sentencePair.first.c_str());
+    targetSentences.push_back(sentencePair.second.c_str());
+  }
+  unsigned int pairCount = (unsigned int)sentencePairs.size();
+  std::vector<double> probs(pairCount);
+  std::vector<unsigned int> alignmentOffsets(pairCount + 1);
+  std::vector<unsigned int> alignments(64);
+  unsigned int alignmentCount =
+      swAlignModel_getBestAlignmentBatch(model, sourceSentences.data(), targetSentences.data(), pairCount,
+                                         probs.data(), alignments.data(), alignmentOffsets.data(), 64);
+  ASSERT_EQ(alignmentCount, alignmentOffsets[pairCount]);
+  ASSERT_LE(alignmentCount, 64u);
+
+  for (unsigned int n = 0; n < pairCount; ++n)
+  {
+    // The matrix must have the size of the alignment
+    unsigned int iLen = countWords(sentencePairs[n].first);
+    unsigned int jLen = countWords(sentencePairs[n].second);
+    bool rows[16][16] = {};
+    bool* matrix[16];
+    for (unsigned int i = 0; i < 16; ++i)
+      matrix[i] = rows[i];
+    double prob = swAlignModel_getBestAlignment(model, sourceSentences[n], targetSentences[n], matrix, &iLen, &jLen);
+    EXPECT_DOUBLE_EQ(probs[n], prob);
+    ASSERT_EQ(alignmentOffsets[n + 1] - alignmentOffsets[n], jLen);
+    for (unsigned int j = 0; j < jLen; ++j)
+    {
+      unsigned int i = alignments[alignmentOffsets[n] + j];
+      ASSERT_LE(i, iLen);
+      for (unsigned int k = 0; k < iLen; ++k)
+        EXPECT_EQ(matrix[k][j], k + 1 == i) << "pair " << n << ", target word " << j;
+    }
+  }
+
+  // With a smaller buffer, only the alignments that fit are stored, and the offsets and probabilities are complete
+  unsigned int capacity = alignmentOffsets[2] + 1;
+  std::vector<double> truncatedProbs(pairCount);
+  std::vector<unsigned int> truncatedOffsets(pairCount + 1);
+  std::vector<unsigned int> truncatedAlignments(capacity + 1, 999);
+  EXPECT_EQ(swAlignModel_getBestAlignmentBatch(model, sourceSentences.data(), targetSentences.data(), pairCount,
+                                               truncatedProbs.data(), truncatedAlignments.data(),
+                                               truncatedOffsets.data(), capacity),
+            alignmentCount);
+  EXPECT_EQ(truncatedProbs, probs);
+  EXPECT_EQ(truncatedOffsets, alignmentOffsets);
+  EXPECT_EQ(std::vector<unsigned int>(truncatedAlignments.begin(), truncatedAlignments.begin() + capacity),
+            std::vector<unsigned int>(alignments.begin(), alignments.begin() + capacity));
+  EXPECT_EQ(truncatedAlignments[capacity], 999u);
+
+  swAlignModel_close(model);
+}
+
+TEST(ThotTest, translateBatchMatchesTranslate)
+{
+  void* smtModel = smtModel_create(AlignmentModelType::IncrHmm);
+  void* decoder = decoder_create(smtModel);
+  for (const std::pair<std::string, std::string>& sentencePair : sentencePairs)
+    decoder_trainSentencePair(decoder, sentencePair.first.c_str(), sentencePair.second.c_str());
+
+  std::vector<const char*> sentences = {"isthay isyay ayay esttay-N .", "isyay isthay orkingway ?",
+                                        "ityay ouldshay orkway-V .", "unknownyay isyay"};
+  unsigned int sentenceCount = (unsigned int)sentences.size();
+  std::vector<void*> results(sentenceCount);
+  decoder_translateBatch(decoder, sentences.data(), sentenceCount, results.data());
+  for (unsigned int i = 0; i < sentenceCount; ++i)
+  {
+    void* result = decoder_translate(decoder, sentences[i]);
+    EXPECT_EQ(getTarget(results[i]), getTarget(result));
+    EXPECT_DOUBLE_EQ(tdata_getScore(results[i]), tdata_getScore(result));
+    tdata_destroy(result);
+    tdata_destroy(results[i]);
+  }
+
+  const unsigned int n = 3;
+  std::vector<void*> nbestResults(n * sentenceCount);
+  std::vector<unsigned int> resultCounts(sentenceCount);
+  unsigned int resultCount = decoder_translateNBestBatch(decoder, n, sentences.data(), sentenceCount,
+                                                         nbestResults.data(), resultCounts.data());
+  unsigned int expectedResultCount = 0;
+  for (unsigned int i = 0; i < sentenceCount; ++i)
+  {
+    void* nbest[n];
+    unsigned int count = std::min(n, decoder_translateNBest(decoder, n, sentences[i], nbest));
+    ASSERT_EQ(resultCounts[i], count);
+    EXPECT_GT(count, 0u);
+    for (unsigned int k = 0; k < count; ++k)
+    {
+      EXPECT_EQ(getTarget(nbestResults[i * n + k]), getTarget(nbest[k]));
+      EXPECT_DOUBLE_EQ(tdata_getScore(nbestResults[i * n + k]), tdata_getScore(nbest[k]));
+      tdata_destroy(nbest[k]);
+      tdata_destroy(nbestResults[i * n + k]);
+    }
+    expectedResultCount += count;
+  }
+  EXPECT_EQ(resultCount, expectedResultCount);
+
+  decoder_close(decoder);
+  smtModel_close(smtModel);
+}
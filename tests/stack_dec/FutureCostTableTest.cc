@@ -0,0 +1,83 @@
+#include "stack_dec/FutureCostTable.h"
+
+#include <cstdlib>
+#include <float.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+// Composes the scores of the spans with the nested table indexed by
+// the right position and the reversed left position
+std::vector<std::vector<Score>> composeNested(const std::vector<std::vector<Score>>& spanScores)
+{
+  unsigned int J = spanScores.size();
+  std::vector<std::vector<Score>> table(J, std::vector<Score>(J, -FLT_MAX));
+  for (unsigned int y = 0; y < J; ++y)
+  {
+    for (unsigned int x = J - y - 1; x < J; ++x)
+    {
+      table[y][x] = spanScores[J - x - 1][y];
+      for (unsigned int z = J - x - 1; z < y; ++z)
+      {
+        Score compositionProduct = table[z][x] + table[y][J - 2 - z];
+        if (table[y][x] < compositionProduct)
+          table[y][x] = compositionProduct;
+      }
+    }
+  }
+  return table;
+}
+} // namespace
+
+TEST(FutureCostTableTest, init)
+{
+  FutureCostTable table;
+  EXPECT_TRUE(table.empty());
+
+  table.init(3);
+  EXPECT_EQ(table.getSentenceLength(), 3);
+  table.set(0, 0, -1);
+  table.set(1, 2, -2);
+  table.set(0, 2, -3);
+  EXPECT_EQ(table.get(0, 0), -1);
+  EXPECT_EQ(table.get(1, 2), -2);
+  EXPECT_EQ(table.get(0, 2), -3);
+  EXPECT_EQ(table.get(0, 1), -FLT_MAX);
+
+  table.clear();
+  EXPECT_TRUE(table.empty());
+}
+
+TEST(FutureCostTableTest, composeMatchesNestedTable)
+{
+  srand(31415);
+  for (unsigned int J = 1; J <= 30; ++J)
+  {
+    // Spans longer than a maximum length have no score, except single
+    // words
+    unsigned int maxLength = 1 + rand() % 7;
+    std::vector<std::vector<Score>> spanScores(J, std::vector<Score>(J, -FLT_MAX));
+    FutureCostTable table;
+    table.init(J);
+    for (unsigned int left = 0; left < J; ++left)
+    {
+      for (unsigned int right = left; right < J && right - left < maxLength; ++right)
+      {
+        if (right == left || rand() % 3 != 0)
+        {
+          spanScores[left][right] = -(double)(rand() % 1000) / 10;
+          table.set(left, right, spanScores[left][right]);
+        }
+      }
+    }
+
+    table.compose();
+    std::vector<std::vector<Score>> nestedTable = composeNested(spanScores);
+    for (unsigned int left = 0; left < J; ++left)
+    {
+      for (unsigned int right = left; right < J; ++right)
+        EXPECT_EQ(table.get(left, right), nestedTable[right][J - left - 1]) << J << " " << left << " " << right;
+    }
+  }
+}
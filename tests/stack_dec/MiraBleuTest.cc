@@ -0,0 +1,132 @@
+#include "stack_dec/MiraBleu.h"
+
+#include "stack_dec/bleu.h"
+#include "stack_dec/chrf.h"
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+namespace
+{
+// Straightforward clipped n-gram matching used to validate the packed-key kernels
+unsigned int clippedMatches(const std::vector<std::string>& ref, const std::vector<std::string>& sys, unsigned int n)
+{
+  std::vector<bool> matched(ref.size(), false);
+  unsigned int prec = 0;
+  for (unsigned int i = 0; i + n <= sys.size(); ++i)
+  {
+    for (unsigned int j = 0; j + n <= ref.size(); ++j)
+    {
+      if (!matched[j] && std::equal(sys.begin() + i, sys.begin() + i + n, ref.begin() + j))
+      {
+        matched[j] = true;
+        ++prec;
+        break;
+      }
+    }
+  }
+  return prec;
+}
+
+std::vector<std::string> randomSentence(unsigned int vocabSize, unsigned int maxLength)
+{
+  std::vector<std::string> sentence;
+  unsigned int length = rand() % (maxLength + 1);
+  for (unsigned int i = 0; i < length; ++i)
+    sentence.push_back("w" + std::to_string(rand() % vocabSize));
+  return sentence;
+}
+} // namespace
+
+TEST(MiraBleuTest, precNMatchesQuadraticCount)
+{
+  srand(31415);
+  for (unsigned int trial = 0; trial < 200; ++trial)
+  {
+    std::vector<std::string> ref = randomSentence(5, 20);
+    std::vector<std::string> sys = randomSentence(7, 20);
+    BleuRefNgrams refNgrams(ref);
+    std::vector<unsigned int> precs, totals;
+    refNgrams.precs(sys, precs, totals);
+    for (unsigned int n = 1; n <= MAX_N; ++n)
+    {
+      unsigned int prec, total;
+      prec_n(ref, sys, n, prec, total);
+      EXPECT_EQ(prec, clippedMatches(ref, sys, n));
+      EXPECT_EQ(total, n > sys.size() ? 0 : sys.size() - n + 1);
+      EXPECT_EQ(precs[n - 1], prec);
+      EXPECT_EQ(totals[n - 1], total);
+    }
+  }
+}
+
+TEST(MiraBleuTest, countNgramsMatchesQuadraticCount)
+{
+  srand(27182);
+  for (unsigned int trial = 0; trial < 200; ++trial)
+  {
+    std::vector<std::string> refVec = randomSentence(3, 30);
+    std::vector<std::string> sysVec = randomSentence(3, 30);
+    std::string ref, sys;
+    for (const std::string& c : refVec)
+      ref += c[1];
+    for (const std::string& c : sysVec)
+      sys += c[1];
+    // Lengths above 8 exercise the fallback for n-grams that do not fit into 64-bit keys
+    for (unsigned int n = 1; n <= 10; ++n)
+    {
+      float precision, recall;
+      unsigned int count;
+      count_ngrams(ref, sys, n, precision, recall, count);
+      EXPECT_EQ(count, clippedMatches(refVec, sysVec, n));
+    }
+  }
+}
+
+TEST(MiraBleuTest, batchScoresMatchSentenceScores)
+{
+  MiraBleu bleu;
+  std::vector<std::string> references;
+  references.push_back("those documents are reunidas in the following file :");
+  references.push_back("the cat is on the mat");
+
+  std::vector<std::vector<std::string>> nblists(2);
+  nblists[0].push_back("these documents are reunidas in the following file :");
+  nblists[0].push_back("these sheets are reunidas in the following file :");
+  nblists[0].push_back("those files are reunidas in the following file :");
+  nblists[1].push_back("the cat the cat on the mat");
+  nblists[1].push_back("");
+  nblists[1].push_back("there is a cat on the mat");
+
+  std::vector<unsigned int> hopeStats;
+  double score;
+  bleu.sentBackgroundScore(nblists[0][0], references[0], score, hopeStats);
+  bleu.updateBackgroundCorpus(hopeStats, 0.999);
+
+  for (unsigned int i = 0; i < references.size(); ++i)
+  {
+    std::vector<double> scores;
+    std::vector<std::vector<unsigned int>> stats;
+    bleu.sentBackgroundScores(nblists[i], references[i], scores, stats);
+    ASSERT_EQ(scores.size(), nblists[i].size());
+    for (unsigned int n = 0; n < nblists[i].size(); ++n)
+    {
+      std::vector<unsigned int> sentStats;
+      bleu.sentBackgroundScore(nblists[i][n], references[i], score, sentStats);
+      EXPECT_EQ(scores[n], score);
+      EXPECT_EQ(stats[n], sentStats);
+    }
+  }
+
+  std::vector<std::vector<double>> matrix;
+  bleu.nbestSentScores(nblists, references, matrix);
+  ASSERT_EQ(matrix.size(), nblists.size());
+  for (unsigned int i = 0; i < references.size(); ++i)
+  {
+    for (unsigned int n = 0; n < nblists[i].size(); ++n)
+    {
+      bleu.sentScore(nblists[i][n], references[i], score);
+      EXPECT_EQ(matrix[i][n], score);
+    }
+  }
+}
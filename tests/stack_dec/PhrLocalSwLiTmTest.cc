@@ -6,9 +6,16 @@
 #include "stack_dec/TranslationMetadata.h"
 #include "stack_dec/multi_stack_decoder_rec.h"
 #include "sw_models/Ibm1AlignmentModel.h"
+#include "sw_models/IncrHmmAlignmentModel.h"
 
+#include "TempFile.h"
+
+#include <algorithm>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <memory>
+#include <tuple>
+#include <omp.h>
 
 class PhrLocalSwLiTmTest : public testing::Test
 {
@@ -48,6 +55,62 @@ protected:
     decoder->setSmtModel(smtModel);
   }
 
+  PhrLocalSwLiTm* createIncrModel()
+  {
+    auto incrModel = new PhrLocalSwLiTm;
+
+    auto langModelInfo = new LangModelInfo;
+    auto phrModelInfo = new PhraseModelInfo;
+    auto swModelInfo = new SwModelInfo;
+
+    langModelInfo->wpModel.reset(new WordPenaltyModel);
+    langModelInfo->langModel.reset(new IncrJelMerNgramLM);
+
+    phrModelInfo->phraseModelPars.ptsWeightVec.push_back(1);
+    phrModelInfo->phraseModelPars.pstWeightVec.push_back(1);
+    phrModelInfo->invPhraseModel.reset(new WbaIncrPhraseModel);
+    swModelInfo->swAligModels.push_back(std::unique_ptr<IncrHmmAlignmentModel>(new IncrHmmAlignmentModel));
+    swModelInfo->invSwAligModels.push_back(std::unique_ptr<IncrHmmAlignmentModel>(new IncrHmmAlignmentModel));
+
+    incrModel->setLangModelInfo(langModelInfo);
+    incrModel->setPhraseModelInfo(phrModelInfo);
+    incrModel->setSwModelInfo(swModelInfo);
+    incrModel->setTranslationMetadata(new TranslationMetadata<PhrScoreInfo>);
+    return incrModel;
+  }
+
+  // Returns the target text, the phrase alignment and the score of each hypothesis, sorted so that expansions
+  // generated in different orders can be compared
+  std::vector<std::tuple<std::string, SourceSegmentation, std::vector<PositionIndex>, Score>> getExpansions(
+      PhrLocalSwLiTm& smtModel, const PhrLocalSwLiTm::Hypothesis& hyp)
+  {
+    std::vector<PhrLocalSwLiTm::Hypothesis> hypVec;
+    std::vector<std::vector<Score>> scrCompVec;
+    smtModel.expand(hyp, hypVec, scrCompVec);
+
+    std::vector<std::tuple<std::string, SourceSegmentation, std::vector<PositionIndex>, Score>> expansions;
+    for (const PhrLocalSwLiTm::Hypothesis& extHyp : hypVec)
+    {
+      SourceSegmentation srcSegm;
+      std::vector<PositionIndex> trgSegmCuts;
+      extHyp.getPhraseAlign(srcSegm, trgSegmCuts);
+      expansions.push_back(
+          std::make_tuple(smtModel.getTransInPlainText(extHyp), srcSegm, trgSegmCuts, extHyp.getScore()));
+    }
+    std::sort(expansions.begin(), expansions.end());
+    return expansions;
+  }
+
+  double getDevPerplexity(PhrLocalSwLiTm& smtModel, const std::string& srcFileName, const std::string& trgFileName)
+  {
+    std::vector<std::vector<PhrasePair>> invPhrPairs;
+    EXPECT_EQ(smtModel.extractPhrPairsFromDevCorpus(srcFileName, trgFileName, invPhrPairs, 0), THOT_OK);
+    PhrLocalSwLiTm::DevPhrPairLgProbs lgProbs;
+    smtModel.getDevPhrPairLgProbs(invPhrPairs, lgProbs);
+    return PhrLocalSwLiTm::phraseModelPerplexity(lgProbs, smtModel.getSwModelInfo()->lambda_swm,
+                                                 smtModel.getSwModelInfo()->lambda_invswm);
+  }
+
   std::unique_ptr<PhrLocalSwLiTm> model;
   std::unique_ptr<multi_stack_decoder_rec<PhrLocalSwLiTm>> decoder;
 };
@@ -77,3 +140,150 @@ TEST_F(PhrLocalSwLiTmTest, constructDecoder)
   EXPECT_EQ(model->getSwModelInfo()->swAligModels.size(), 1);
   EXPECT_EQ(model->getSwModelInfo()->invSwAligModels.size(), 1);
 }
+
+TEST_F(PhrLocalSwLiTmTest, cubePruningPopLimitIsCloned)
+{
+  createModel();
+  EXPECT_EQ(model->get_P_par(), 0);
+
+  model->set_P_par(5);
+  createDecoder();
+
+  EXPECT_EQ(decoder->getSmtModel()->get_P_par(), 5);
+}
+
+TEST_F(PhrLocalSwLiTmTest, cubePruningPopLimitBoundsExpansions)
+{
+  std::vector<std::pair<std::string, std::string>> pairs = {{"la casa verde", "the green house"},
+                                                            {"la casa", "the house"},
+                                                            {"una casa verde", "a green house"},
+                                                            {"la casa azul", "the blue house"}};
+  std::unique_ptr<PhrLocalSwLiTm> incrModel(createIncrModel());
+  for (const std::pair<std::string, std::string>& pair : pairs)
+    ASSERT_EQ(incrModel->onlineTrainFeatsSentPair(pair.first.c_str(), pair.second.c_str(), pair.second.c_str()),
+              THOT_OK);
+
+  incrModel->pre_trans_actions("la casa verde");
+  PhrLocalSwLiTm::Hypothesis nullHyp = incrModel->nullHypothesis();
+  size_t numExpansions = getExpansions(*incrModel, nullHyp).size();
+  ASSERT_GT(numExpansions, 3);
+
+  incrModel->set_P_par(3);
+  EXPECT_EQ(getExpansions(*incrModel, nullHyp).size(), 3);
+
+  incrModel->set_P_par(1);
+  EXPECT_EQ(getExpansions(*incrModel, nullHyp).size(), 1);
+}
+
+TEST_F(PhrLocalSwLiTmTest, cubePruningWithLargePopLimitMatchesExpand)
+{
+  std::vector<std::pair<std::string, std::string>> pairs = {{"la casa verde", "the green house"},
+                                                            {"la casa", "the house"},
+                                                            {"una casa verde", "a green house"},
+                                                            {"la casa azul", "the blue house"}};
+  std::unique_ptr<PhrLocalSwLiTm> incrModel(createIncrModel());
+  for (const std::pair<std::string, std::string>& pair : pairs)
+    ASSERT_EQ(incrModel->onlineTrainFeatsSentPair(pair.first.c_str(), pair.second.c_str(), pair.second.c_str()),
+              THOT_OK);
+
+  incrModel->pre_trans_actions("la casa verde");
+  std::vector<PhrLocalSwLiTm::Hypothesis> hyps = {incrModel->nullHypothesis()};
+  std::vector<std::vector<Score>> scrCompVec;
+  std::vector<PhrLocalSwLiTm::Hypothesis> extHyps;
+  incrModel->expand(hyps[0], extHyps, scrCompVec);
+  ASSERT_FALSE(extHyps.empty());
+  hyps.push_back(extHyps[0]);
+
+  for (const PhrLocalSwLiTm::Hypothesis& hyp : hyps)
+  {
+    incrModel->set_P_par(0);
+    auto expansions = getExpansions(*incrModel, hyp);
+    incrModel->set_P_par((unsigned int)expansions.size());
+    auto lazyExpansions = getExpansions(*incrModel, hyp);
+
+    ASSERT_EQ(lazyExpansions.size(), expansions.size());
+    for (size_t i = 0; i < expansions.size(); ++i)
+    {
+      EXPECT_EQ(std::get<0>(lazyExpansions[i]), std::get<0>(expansions[i]));
+      EXPECT_EQ(std::get<1>(lazyExpansions[i]), std::get<1>(expansions[i]));
+      EXPECT_EQ(std::get<2>(lazyExpansions[i]), std::get<2>(expansions[i]));
+      EXPECT_DOUBLE_EQ(std::get<3>(lazyExpansions[i]), std::get<3>(expansions[i]));
+    }
+  }
+}
+
+TEST_F(PhrLocalSwLiTmTest, concurrentOnlineTrainingMatchesSerialTraining)
+{
+  std::vector<std::pair<std::string, std::string>> pairs = {{"la casa verde", "the green house"},
+                                                            {"la casa", "the house"},
+                                                            {"una casa verde", "a green house"},
+                                                            {"el libro", "the book"},
+                                                            {"un libro verde", "a green book"},
+                                                            {"la mesa", "the table"}};
+
+  std::unique_ptr<PhrLocalSwLiTm> serialModel(createIncrModel());
+  std::unique_ptr<PhrLocalSwLiTm> concurrentModel(createIncrModel());
+
+  // With no active parallel levels, the sections are executed one
+  // after the other by a single thread
+  int maxActiveLevels = omp_get_max_active_levels();
+  omp_set_max_active_levels(0);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    for (const std::pair<std::string, std::string>& pair : pairs)
+      EXPECT_EQ(serialModel->onlineTrainFeatsSentPair(pair.first.c_str(), pair.second.c_str(), pair.second.c_str()),
+                THOT_OK);
+  }
+  omp_set_max_active_levels(maxActiveLevels);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    for (const std::pair<std::string, std::string>& pair : pairs)
+      EXPECT_EQ(
+          concurrentModel->onlineTrainFeatsSentPair(pair.first.c_str(), pair.second.c_str(), pair.second.c_str()),
+          THOT_OK);
+  }
+
+  for (const std::pair<std::string, std::string>& pair : pairs)
+  {
+    EXPECT_EQ((double)serialModel->getSwModelInfo()->swAligModels[0]->computeSumLogProb(pair.first.c_str(),
+                                                                                        pair.second.c_str()),
+              (double)concurrentModel->getSwModelInfo()->swAligModels[0]->computeSumLogProb(pair.first.c_str(),
+                                                                                            pair.second.c_str()));
+    EXPECT_EQ((double)serialModel->getSwModelInfo()->invSwAligModels[0]->computeSumLogProb(pair.second.c_str(),
+                                                                                           pair.first.c_str()),
+              (double)concurrentModel->getSwModelInfo()->invSwAligModels[0]->computeSumLogProb(pair.second.c_str(),
+                                                                                               pair.first.c_str()));
+    std::vector<std::string> trgSentence = StrProcUtils::stringToStringVector(pair.second);
+    EXPECT_EQ((double)serialModel->getLangModelInfo()->langModel->getSentenceLog10ProbStr(trgSentence),
+              (double)concurrentModel->getLangModelInfo()->langModel->getSentenceLog10ProbStr(trgSentence));
+  }
+}
+
+TEST_F(PhrLocalSwLiTmTest, updateLinInterpWeights)
+{
+  std::vector<std::pair<std::string, std::string>> pairs = {{"la casa verde", "the green house"},
+                                                            {"la casa", "the house"},
+                                                            {"una casa verde", "a green house"},
+                                                            {"el libro", "the book"}};
+  std::unique_ptr<PhrLocalSwLiTm> incrModel(createIncrModel());
+  for (const std::pair<std::string, std::string>& pair : pairs)
+    ASSERT_EQ(incrModel->onlineTrainFeatsSentPair(pair.first.c_str(), pair.second.c_str(), pair.second.c_str()),
+              THOT_OK);
+
+  TempFile srcFile;
+  TempFile trgFile;
+  {
+    std::ofstream srcStream(srcFile.c_str());
+    std::ofstream trgStream(trgFile.c_str());
+    srcStream << "la casa verde\nel libro verde\n";
+    trgStream << "the green house\nthe green book\n";
+  }
+
+  double perplexity = getDevPerplexity(*incrModel, srcFile.name(), trgFile.name());
+  EXPECT_EQ(incrModel->updateLinInterpWeights(srcFile.name(), trgFile.name()), THOT_OK);
+  EXPECT_LE(getDevPerplexity(*incrModel, srcFile.name(), trgFile.name()), perplexity);
+  EXPECT_GE(incrModel->getSwModelInfo()->lambda_swm, 0);
+  EXPECT_LT(incrModel->getSwModelInfo()->lambda_swm, 1);
+  EXPECT_GE(incrModel->getSwModelInfo()->lambda_invswm, 0);
+  EXPECT_LT(incrModel->getSwModelInfo()->lambda_invswm, 1);
+}
@@ -0,0 +1,205 @@
+#include "sw_models/Ibm3AlignmentModel.h"
+
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace
+{
+// IBM-3 model that recomputes the scores of the whole neighbourhood after every change of the hill-climbing search
+class ExhaustiveSearchIbm3AlignmentModel : public Ibm3AlignmentModel
+{
+public:
+  ExhaustiveSearchIbm3AlignmentModel(Ibm3AlignmentModel& model) : Ibm3AlignmentModel{model}
+  {
+  }
+
+protected:
+  void initNeighbourhood(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                         AlignmentInfo& alignment, Neighbourhood& neighbourhood) override
+  {
+    computeNeighbourhoodScores(nsrc, trg, alignment, neighbourhood);
+  }
+
+  void updateNeighbourhoodAfterMove(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                    AlignmentInfo& alignment, PositionIndex j, PositionIndex iOld,
+                                    Neighbourhood& neighbourhood) override
+  {
+    computeNeighbourhoodScores(nsrc, trg, alignment, neighbourhood);
+  }
+
+  void updateNeighbourhoodAfterSwap(const std::vector<WordIndex>& nsrc, const std::vector<WordIndex>& trg,
+                                    AlignmentInfo& alignment, PositionIndex j1, PositionIndex j2,
+                                    Neighbourhood& neighbourhood) override
+  {
+    computeNeighbourhoodScores(nsrc, trg, alignment, neighbourhood);
+  }
+};
+} // namespace
+
+class Ibm3AlignmentModelTest : public testing::Test
+{
+protected:
+  // Random sentence pairs over a small vocabulary, so that the search performs many moves and swaps
+  void addRandomSentencePairs(AlignmentModel& model)
+  {
+    srand(31416);
+    for (unsigned int n = 0; n < 40; ++n)
+    {
+      std::string srcSentence, trgSentence;
+      for (int i = 0, slen = 3 + rand() % 10; i < slen; ++i)
+        srcSentence += (i == 0 ? "s" : " s") + std::to_string(rand() % 12);
+      for (int j = 0, tlen = 3 + rand() % 12; j < tlen; ++j)
+        trgSentence += (j == 0 ? "t" : " t") + std::to_string(rand() % 12);
+      addSentencePair(model, srcSentence, trgSentence);
+    }
+  }
+
+  std::unique_ptr<Ibm3AlignmentModel> createTrainedModel()
+  {
+    Ibm1AlignmentModel model1;
+    addRandomSentencePairs(model1);
+    train(model1, 1);
+
+    Ibm2AlignmentModel model2{model1};
+    train(model2, 1);
+
+    std::unique_ptr<Ibm3AlignmentModel> model3{new Ibm3AlignmentModel{model2}};
+    train(*model3, 1);
+    return model3;
+  }
+
+  Prob searchForBestAlignment(Ibm3AlignmentModel& model, unsigned int n, std::vector<PositionIndex>& alignment,
+                              Matrix<double>& moveScores, Matrix<double>& swapScores)
+  {
+    std::vector<WordIndex> src = model.getSrcSent(n);
+    std::vector<WordIndex> trg = model.getTrgSent(n);
+    AlignmentInfo alignmentInfo{(PositionIndex)src.size(), (PositionIndex)trg.size()};
+    Prob prob = model.searchForBestAlignment(src, trg, alignmentInfo, &moveScores, &swapScores);
+    alignment = alignmentInfo.getAlignment();
+    return prob;
+  }
+
+  std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>> getSentencePairs(Ibm3AlignmentModel& model)
+  {
+    std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>> pairs;
+    for (unsigned int n = 0; n < model.numSentencePairs(); ++n)
+      pairs.push_back(std::make_pair(model.getSrcSent(n), model.getTrgSent(n)));
+    return pairs;
+  }
+
+  std::vector<std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>> getBatches(
+      Ibm3AlignmentModel& model)
+  {
+    std::vector<std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>> batches;
+    model.processBatches(
+        [&batches](const std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& pairs) {
+          batches.push_back(pairs);
+        });
+    return batches;
+  }
+
+  double getSentencePairCost(Ibm3AlignmentModel& model,
+                             const std::pair<std::vector<WordIndex>, std::vector<WordIndex>>& pair)
+  {
+    return model.getSentencePairCost((PositionIndex)pair.first.size(), (PositionIndex)pair.second.size());
+  }
+
+  std::vector<size_t> getNumFertilityPartitions(const Ibm3TransferCounts& counts)
+  {
+    std::vector<size_t> numPartitions;
+    for (const std::vector<Ibm3TransferCounts::FertilityPartition>& partitions : counts.fertilityPartitions)
+      numPartitions.push_back(partitions.size());
+    return numPartitions;
+  }
+};
+
+TEST_F(Ibm3AlignmentModelTest, incrementalSearchMatchesExhaustiveSearch)
+{
+  std::unique_ptr<Ibm3AlignmentModel> model = createTrainedModel();
+  ExhaustiveSearchIbm3AlignmentModel exhaustiveModel{*model};
+
+  for (unsigned int n = 0; n < model->numSentencePairs(); ++n)
+  {
+    std::vector<PositionIndex> alignment;
+    Matrix<double> moveScores, swapScores;
+    Prob prob = searchForBestAlignment(*model, n, alignment, moveScores, swapScores);
+
+    std::vector<PositionIndex> expectedAlignment;
+    Matrix<double> expectedMoveScores, expectedSwapScores;
+    Prob expectedProb =
+        searchForBestAlignment(exhaustiveModel, n, expectedAlignment, expectedMoveScores, expectedSwapScores);
+
+    // The scores determine the counts collected in the E-step, so they must be identical
+    EXPECT_EQ(alignment, expectedAlignment);
+    EXPECT_EQ(double{prob}, double{expectedProb});
+    EXPECT_EQ(moveScores.p, expectedMoveScores.p);
+    EXPECT_EQ(swapScores.p, expectedSwapScores.p);
+  }
+}
+
+TEST_F(Ibm3AlignmentModelTest, processBatchesSortsPairsByDecreasingCost)
+{
+  std::unique_ptr<Ibm3AlignmentModel> model = createTrainedModel();
+
+  std::vector<std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>> batches = getBatches(*model);
+  ASSERT_EQ(batches.size(), 1);
+  std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>>& batch = batches[0];
+  for (size_t k = 1; k < batch.size(); ++k)
+    EXPECT_GE(getSentencePairCost(*model, batch[k - 1]), getSentencePairCost(*model, batch[k]));
+
+  // Every sentence pair is processed exactly once
+  std::vector<std::pair<std::vector<WordIndex>, std::vector<WordIndex>>> pairs = getSentencePairs(*model);
+  std::sort(pairs.begin(), pairs.end());
+  std::sort(batch.begin(), batch.end());
+  EXPECT_EQ(batch, pairs);
+}
+
+TEST_F(Ibm3AlignmentModelTest, fertilityPartitions)
+{
+  Ibm3TransferCounts counts;
+  EXPECT_EQ(getNumFertilityPartitions(counts), (std::vector<size_t>{1, 1, 2, 3, 5, 7, 11, 15, 22, 30}));
+}
+
+TEST_F(Ibm3AlignmentModelTest, collectedTransferCountsMatchTransferPass)
+{
+  // The counts collected by an IBM-2 iteration are those of a transfer pass with the parameters it starts from
+  Ibm1AlignmentModel transferModel1;
+  addRandomSentencePairs(transferModel1);
+  train(transferModel1, 1);
+  Ibm2AlignmentModel transferModel2{transferModel1};
+  train(transferModel2, 1);
+  Ibm3AlignmentModel transferModel3{transferModel2};
+  transferModel3.startTraining();
+
+  Ibm1AlignmentModel collectModel1;
+  addRandomSentencePairs(collectModel1);
+  train(collectModel1, 1);
+  Ibm2AlignmentModel collectModel2{collectModel1};
+  train(collectModel2, 1);
+  collectModel2.setCollectIbm3TransferCounts(true);
+  train(collectModel2, 1);
+  Ibm3AlignmentModel collectModel3{collectModel2};
+  collectModel3.startTraining();
+
+  for (const std::pair<std::vector<WordIndex>, std::vector<WordIndex>>& pair : getSentencePairs(transferModel3))
+  {
+    const std::vector<WordIndex>& src = pair.first;
+    PositionIndex slen = (PositionIndex)src.size();
+    PositionIndex tlen = (PositionIndex)pair.second.size();
+    for (PositionIndex i = 1; i <= slen; ++i)
+    {
+      for (PositionIndex j = 1; j <= tlen; ++j)
+      {
+        EXPECT_NEAR(transferModel3.distortionProb(i, slen, tlen, j), collectModel3.distortionProb(i, slen, tlen, j),
+                    1e-6);
+      }
+      for (PositionIndex phi = 0; phi < Ibm3TransferCounts::MaxFertility; ++phi)
+        EXPECT_NEAR(transferModel3.fertilityProb(src[i - 1], phi), collectModel3.fertilityProb(src[i - 1], phi), 1e-6);
+    }
+  }
+}
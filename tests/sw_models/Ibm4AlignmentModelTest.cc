@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 #include <memory>
+#include <omp.h>
 
 class Ibm4AlignmentModelTest : public testing::Test
 {
@@ -84,6 +85,28 @@ protected:
     return logProb;
   }
 
+  void createModelTrainedWithThreads(int numThreads)
+  {
+    int maxThreads = omp_get_max_threads();
+    omp_set_num_threads(numThreads);
+
+    Ibm1AlignmentModel model1;
+    addTrainingDataWordClasses(model1);
+    addTrainingData(model1);
+    train(model1, 2);
+
+    Ibm2AlignmentModel model2{model1};
+    train(model2, 2);
+
+    Ibm3AlignmentModel model3{model2};
+    train(model3, 2);
+
+    model.reset(new Ibm4AlignmentModel{model3});
+    train(*model, 2);
+
+    omp_set_num_threads(maxThreads);
+  }
+
   std::unique_ptr<Ibm4AlignmentModel> model;
 };
 
@@ -213,6 +236,37 @@ TEST_F(Ibm4AlignmentModelTest, trainHmm)
   EXPECT_EQ(alignment, (std::vector<PositionIndex>{1, 2, 3, 5, 4, 4, 6}));
 }
 
+TEST_F(Ibm4AlignmentModelTest, trainWithThreads)
+{
+  // The counts of the parts of each batch are added in a fixed order, so the model does not depend on the number of
+  // threads
+  std::vector<std::string> srcSentences = {"isthay isyay ayay esttay-N .", "isthay isyay otnay ayay esttay-N .",
+                                           "isthay isyay ayay esttay-N ardhay ."};
+  std::vector<std::string> trgSentences = {"this is a test N .", "this is not a test N .",
+                                           "this is a hard test N ."};
+
+  createModelTrainedWithThreads(1);
+  std::vector<std::vector<PositionIndex>> expectedAlignments(srcSentences.size());
+  std::vector<double> expectedLogProbs;
+  for (size_t n = 0; n < srcSentences.size(); ++n)
+  {
+    LgProb logProb = model->getBestAlignment(srcSentences[n].c_str(), trgSentences[n].c_str(), expectedAlignments[n]);
+    expectedLogProbs.push_back(logProb);
+  }
+
+  for (int numThreads : {2, 4})
+  {
+    createModelTrainedWithThreads(numThreads);
+    for (size_t n = 0; n < srcSentences.size(); ++n)
+    {
+      std::vector<PositionIndex> alignment;
+      LgProb logProb = model->getBestAlignment(srcSentences[n].c_str(), trgSentences[n].c_str(), alignment);
+      EXPECT_EQ(alignment, expectedAlignments[n]);
+      EXPECT_EQ((double)logProb, expectedLogProbs[n]);
+    }
+  }
+}
+
 TEST_F(Ibm4AlignmentModelTest, headDistortionProbSmoothing)
 {
   createTrainedModel();
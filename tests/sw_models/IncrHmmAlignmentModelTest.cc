@@ -2,7 +2,9 @@
 
 #include "TestUtils.h"
 
+#include <algorithm>
 #include <gtest/gtest.h>
+#include <omp.h>
 
 TEST(IncrHmmAlignmentModelTest, train)
 {
@@ -22,6 +24,35 @@ TEST(IncrHmmAlignmentModelTest, train)
   EXPECT_EQ(alignment, (std::vector<PositionIndex>{1, 2, 3, 5, 4, 4, 4}));
 }
 
+TEST(IncrHmmAlignmentModelTest, trainWithThreads)
+{
+  // The counts of the parts of each batch are added in a fixed order, so the model does not depend on the number of
+  // threads
+  std::vector<double> expectedLogProbs;
+  for (int numThreads : {1, 2, 4})
+  {
+    int maxThreads = omp_get_max_threads();
+    omp_set_num_threads(numThreads);
+    IncrHmmAlignmentModel model;
+    model.setHmmP0(0.1);
+    addTrainingData(model);
+    train(model, 2);
+    omp_set_num_threads(maxThreads);
+
+    std::vector<PositionIndex> alignment;
+    std::vector<double> logProbs;
+    logProbs.push_back(model.getBestAlignment("isthay isyay ayay esttay-N .", "this is a test N .", alignment));
+    logProbs.push_back(
+        model.getBestAlignment("isthay isyay otnay ayay esttay-N .", "this is not a test N .", alignment));
+    logProbs.push_back(
+        model.getBestAlignment("isthay isyay ayay esttay-N ardhay .", "this is a hard test N .", alignment));
+    if (numThreads == 1)
+      expectedLogProbs = logProbs;
+    else
+      EXPECT_EQ(logProbs, expectedLogProbs);
+  }
+}
+
 TEST(IncrHmmAlignmentModelTest, incrTrain)
 {
   IncrHmmAlignmentModel model;
@@ -54,3 +85,72 @@ TEST(IncrHmmAlignmentModelTest, computeLogProb)
   LgProb logProb = model.computeLogProb("isthay isyay ayay esttay-N .", "this is a test N NULL .", waMatrix);
   EXPECT_NEAR(logProb, expectedLogProb, EPSILON);
 }
+
+TEST(IncrHmmAlignmentModelTest, trainWithPrunedTranslationOptions)
+{
+  IncrHmmAlignmentModel model;
+  model.setHmmP0(0.1);
+  model.setMaxTranslationOptions(3);
+  addTrainingData(model);
+  train(model, 2);
+
+  for (WordIndex s = NULL_WORD + 1; s < model.getSrcVocabSize(); ++s)
+  {
+    NbestTableNode<WordIndex> targetWords;
+    model.getEntriesForSource(s, targetWords);
+    EXPECT_LE(targetWords.size(), 3u);
+  }
+
+  std::vector<PositionIndex> alignment;
+  model.getBestAlignment("isthay isyay ayay esttay-N .", "this is a test N .", alignment);
+  EXPECT_EQ(alignment, (std::vector<PositionIndex>{1, 2, 3, 4, 4, 5}));
+}
+
+TEST(IncrHmmAlignmentModelTest, pruneTranslationOptionsOfTrainedModel)
+{
+  IncrHmmAlignmentModel model;
+  model.setHmmP0(0.1);
+  addTrainingData(model);
+  train(model, 2);
+
+  size_t maxEntries = 0;
+  for (WordIndex s = NULL_WORD + 1; s < model.getSrcVocabSize(); ++s)
+  {
+    NbestTableNode<WordIndex> targetWords;
+    model.getEntriesForSource(s, targetWords);
+    maxEntries = std::max<size_t>(maxEntries, targetWords.size());
+  }
+  ASSERT_GT(maxEntries, 3u);
+
+  // The entries of the table estimated before the pruning are removed for the pruned translation options
+  model.setMaxTranslationOptions(3);
+  train(model, 2);
+  for (WordIndex s = NULL_WORD + 1; s < model.getSrcVocabSize(); ++s)
+  {
+    NbestTableNode<WordIndex> targetWords;
+    model.getEntriesForSource(s, targetWords);
+    EXPECT_LE(targetWords.size(), 3u);
+  }
+}
+
+TEST(IncrHmmAlignmentModelTest, pruneTranslationOptionsBySentenceDice)
+{
+  // With sentence frequencies, Dice(b, x) = 2 * 2 / (4 + 2) and Dice(b, y) = 2 * 3 / (4 + 3), repeating b in the last
+  // pair does not make x a better translation of b than y
+  IncrHmmAlignmentModel model;
+  model.setHmmP0(0.1);
+  model.setMinTranslationOptionDice(0.7);
+  addSentencePair(model, "a b", "x y");
+  addSentencePair(model, "b", "y");
+  addSentencePair(model, "b", "y");
+  addSentencePair(model, "b b b b", "x");
+  train(model, 1);
+
+  NbestTableNode<WordIndex> targetWords;
+  model.getEntriesForSource(model.stringToSrcWordIndex("b"), targetWords);
+  ASSERT_EQ(targetWords.size(), 1u);
+  EXPECT_EQ(targetWords.begin()->second, model.stringToTrgWordIndex("y"));
+
+  model.getEntriesForSource(model.stringToSrcWordIndex("a"), targetWords);
+  EXPECT_EQ(targetWords.size(), 0u);
+}
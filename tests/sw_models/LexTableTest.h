@@ -133,4 +133,38 @@ TYPED_TEST_P(LexTableTest, getTransForSource)
   EXPECT_EQ(transSet, s2Set);
 }
 
-REGISTER_TYPED_TEST_SUITE_P(LexTableTest, getSetDenominator, getSetNumerator, set, getTransForSource);
+TYPED_TEST_P(LexTableTest, removeTransForSource)
+{
+  bool found;
+
+  WordIndex s1 = 1;
+  WordIndex s2 = 9;
+
+  this->table->clear();
+
+  // Fill structure with data
+  this->table->set(s1, 2, 2.2, 3.3);
+  this->table->set(s1, 3, 4.4, 3.3);
+  this->table->set(s1, 5, 6.6, 3.3);
+  this->table->set(s2, 3, 22.1, 22.7);
+
+  // Remove entries of s1, including a target without entry
+  this->table->removeTransForSource(s1, {3, 5, 7});
+
+  std::set<WordIndex> transSet;
+  found = this->table->getTransForSource(s1, transSet);
+  EXPECT_TRUE(found);
+  EXPECT_EQ(transSet, std::set<WordIndex>{2});
+  float restoredNumer = this->table->getNumerator(s1, 2, found);
+  EXPECT_TRUE(found); // Element should be found
+  EXPECT_NEAR(2.2, restoredNumer, EPSILON);
+  this->table->getNumerator(s1, 3, found);
+  EXPECT_FALSE(found); // Element should not be found
+
+  // Entries of other source words are kept
+  this->table->getNumerator(s2, 3, found);
+  EXPECT_TRUE(found); // Element should be found
+}
+
+REGISTER_TYPED_TEST_SUITE_P(LexTableTest, getSetDenominator, getSetNumerator, set, getTransForSource,
+                            removeTransForSource);
@@ -0,0 +1,97 @@
+#include "sw_models/SymmetrizedAligner.h"
+
+#include "TempFile.h"
+#include "TestUtils.h"
+#include "nlp_common/ErrorDefs.h"
+#include "nlp_common/StrProcUtils.h"
+#include "nlp_common/printAligFuncs.h"
+#include "sw_models/HmmAlignmentModel.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace
+{
+const std::vector<std::pair<std::string, std::string>> sentencePairs = {
+    {"isthay isyay ayay esttay-N .", "this is a test N ."},
+    {"ouyay ouldshay esttay-V oftenyay .", "you should test V often ."},
+    {"isyay isthay orkingway ?", "is this working ?"},
+    {"", "this should work V ."},
+    {"ityay isyay orkingway .", "it is working ."},
+    {"orkway-N ancay ebay ardhay !", "work N can be hard !"},
+    {"isthay isyay otnay ayay esttay-N .", "this is not a test N ."},
+    {"isthay isyay ayay ordway !", "this is a word !"}};
+
+std::string readFile(const char* fileName)
+{
+  std::ifstream file(fileName);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+} // namespace
+
+class SymmetrizedAlignerTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    std::shared_ptr<HmmAlignmentModel> directModel = std::make_shared<HmmAlignmentModel>();
+    std::shared_ptr<HmmAlignmentModel> inverseModel = std::make_shared<HmmAlignmentModel>();
+    addTrainingData(*directModel);
+    std::ofstream srcStream(srcFile.c_str()), trgStream(trgFile.c_str());
+    for (const std::pair<std::string, std::string>& sentencePair : sentencePairs)
+    {
+      if (!sentencePair.first.empty())
+        addSentencePair(*inverseModel, sentencePair.second, sentencePair.first);
+      srcStream << sentencePair.first << "\n";
+      trgStream << sentencePair.second << "\n";
+    }
+    train(*directModel, 2);
+    train(*inverseModel, 2);
+    aligner = std::make_shared<SymmetrizedAligner>(directModel, inverseModel);
+  }
+
+  TempFile srcFile;
+  TempFile trgFile;
+  TempFile outFile;
+  std::shared_ptr<SymmetrizedAligner> aligner;
+};
+
+TEST_F(SymmetrizedAlignerTest, getBestAlignmentsForFiles)
+{
+  for (SymmetrizationHeuristic heuristic : {SymmetrizationHeuristic::Och, SymmetrizationHeuristic::GrowDiagFinalAnd})
+  {
+    aligner->setHeuristic(heuristic);
+
+    // Pairs with an empty sentence are skipped, as in the alignment of
+    // single models
+    std::ostringstream expected;
+    for (size_t n = 0; n < sentencePairs.size(); ++n)
+    {
+      if (sentencePairs[n].first.empty())
+        continue;
+      std::vector<std::string> src = StrProcUtils::stringToStringVector(sentencePairs[n].first);
+      std::vector<std::string> trg = StrProcUtils::stringToStringVector(sentencePairs[n].second);
+      WordAlignmentMatrix waMatrix;
+      LgProb logProb = aligner->getBestAlignment(src, trg, waMatrix);
+      src.insert(src.begin(), NULL_WORD_STR);
+      std::ostringstream header;
+      header << "# Sentence pair " << n + 1 << " alignment score : " << logProb.get_p();
+      printAlignmentInGIZAFormat(expected, src, trg, waMatrix, header.str().c_str());
+    }
+
+    for (unsigned int chunkSize : {1, 3, 100})
+    {
+      ASSERT_EQ(aligner->getBestAlignments(srcFile.c_str(), trgFile.c_str(), outFile.c_str(), chunkSize), THOT_OK);
+      EXPECT_EQ(readFile(outFile.c_str()), expected.str()) << "chunk size: " << chunkSize;
+    }
+  }
+}
+
+TEST_F(SymmetrizedAlignerTest, getBestAlignmentsForFilesOfDifferentSize)
+{
+  std::ofstream(trgFile.c_str()) << "this is a test N .\n";
+  EXPECT_EQ(aligner->getBestAlignments(srcFile.c_str(), trgFile.c_str(), outFile.c_str()), THOT_ERROR);
+}
@@ -74,6 +74,30 @@ def test_alignment_model() -> None:
     assert np.array_equal(alignments[2][1].to_numpy(), _create_matrix(6, [1, 2, 3, 5, 4, 4, 4]))
     assert np.array_equal(alignments[3][1].to_numpy(), _create_matrix(0, []))
 
+    log_probs, indices = aligner.get_best_alignments_coo(align_src_sentences, align_trg_sentences)
+    assert log_probs.shape == (4,)
+    for k, (log_prob, matrix) in enumerate(alignments):
+        assert log_probs[k] == approx(log_prob)
+        coo_matrix = np.full((matrix.row_length, matrix.column_length), False)
+        coo_matrix[indices[indices[:, 0] == k, 1], indices[indices[:, 0] == k, 2]] = True
+        assert np.array_equal(coo_matrix, matrix.to_numpy())
+
+    log_probs, padded = aligner.get_best_alignments_padded(align_src_sentences, align_trg_sentences)
+    assert padded.shape == (4, 6, 7)
+    for k, (log_prob, matrix) in enumerate(alignments):
+        assert log_probs[k] == approx(log_prob)
+        assert np.array_equal(padded[k, : matrix.row_length, : matrix.column_length], matrix.to_numpy())
+        assert not padded[k, matrix.row_length :, :].any()
+        assert not padded[k, :, matrix.column_length :].any()
+
+    src_word_indices = np.array([direct_hmm_model.get_src_word_index(w) for w in align_src_sentences[0]])
+    trg_word_indices = np.array([direct_hmm_model.get_trg_word_index(w) for w in align_trg_sentences[0]])
+    probs = direct_hmm_model.translation_prob(src_word_indices[:, np.newaxis], trg_word_indices[np.newaxis, :])
+    assert probs.shape == (5, 6)
+    for i, s in enumerate(src_word_indices):
+        for j, t in enumerate(trg_word_indices):
+            assert probs[i, j] == approx(direct_hmm_model.translation_prob(int(s), int(t)))
+
 
 def test_sentence_length_model() -> None:
     model = NormalSentenceLengthModel()
@@ -1,5 +1,5 @@
 from enum import Enum
-from typing import Optional, Sequence, Tuple, overload
+from typing import Any, Optional, Sequence, Tuple, overload
 
 from ..common import WordAlignmentMatrix
 
@@ -24,6 +24,22 @@ class Aligner:
     def get_best_alignments(
         self, src_sentences: Sequence[Sequence[str]], trg_sentences: Sequence[Sequence[str]]
     ) -> Sequence[Tuple[float, WordAlignmentMatrix]]: ...
+    @overload
+    def get_best_alignments_coo(
+        self, src_sentences: Sequence[Sequence[int]], trg_sentences: Sequence[Sequence[int]]
+    ) -> Tuple[Any, Any]: ...
+    @overload
+    def get_best_alignments_coo(
+        self, src_sentences: Sequence[Sequence[str]], trg_sentences: Sequence[Sequence[str]]
+    ) -> Tuple[Any, Any]: ...
+    @overload
+    def get_best_alignments_padded(
+        self, src_sentences: Sequence[Sequence[int]], trg_sentences: Sequence[Sequence[int]]
+    ) -> Tuple[Any, Any]: ...
+    @overload
+    def get_best_alignments_padded(
+        self, src_sentences: Sequence[Sequence[str]], trg_sentences: Sequence[Sequence[str]]
+    ) -> Tuple[Any, Any]: ...
 
 class SymmetrizationHeuristic(Enum):
     NONE = ...
@@ -67,6 +83,14 @@ class AlignmentModel(Aligner):
     @variational_bayes.setter
     def variational_bayes(self, value: bool) -> None: ...
     @property
+    def max_translation_options(self) -> int: ...
+    @max_translation_options.setter
+    def max_translation_options(self, value: int) -> None: ...
+    @property
+    def min_translation_option_dice(self) -> float: ...
+    @min_translation_option_dice.setter
+    def min_translation_option_dice(self, value: float) -> None: ...
+    @property
     def max_sentence_length(self) -> int: ...
     def read_sentence_pairs(
         self, src_filename: str, trg_filename: str, counts_filename: Optional[str] = None
@@ -86,8 +110,14 @@ class AlignmentModel(Aligner):
     def end_training(self) -> None: ...
     def sentence_length_log_prob(self, src_length: int, trg_length: int) -> float: ...
     def sentence_length_prob(self, src_length: int, trg_length: int) -> float: ...
+    @overload
     def translation_log_prob(self, src_word_index: int, trg_word_index: int) -> float: ...
+    @overload
+    def translation_log_prob(self, src_word_index: Any, trg_word_index: Any) -> Any: ...
+    @overload
     def translation_prob(self, src_word_index: int, trg_word_index: int) -> float: ...
+    @overload
+    def translation_prob(self, src_word_index: Any, trg_word_index: Any) -> Any: ...
     def get_translations(self, s: int, threshold: float = 0) -> Sequence[Tuple[int, float]]: ...
     def map_src_word_to_word_class(self, word: str, word_class: str) -> None: ...
     def map_trg_word_to_word_class(self, word: str, word_class: str) -> None: ...
@@ -115,8 +145,18 @@ class Ibm2AlignmentModel(Ibm1AlignmentModel, AlignmentModel):
     def compact_alignment_table(self) -> bool: ...
     @compact_alignment_table.setter
     def compact_alignment_table(self, value: bool) -> None: ...
+    @property
+    def collect_ibm3_transfer_counts(self) -> bool: ...
+    @collect_ibm3_transfer_counts.setter
+    def collect_ibm3_transfer_counts(self, value: bool) -> None: ...
+    @overload
     def alignment_log_prob(self, j: int, src_length: int, trg_length: int, i: int) -> float: ...
+    @overload
+    def alignment_log_prob(self, j: Any, src_length: Any, trg_length: Any, i: Any) -> Any: ...
+    @overload
     def alignment_prob(self, j: int, src_length: int, trg_length: int, i: int) -> float: ...
+    @overload
+    def alignment_prob(self, j: Any, src_length: Any, trg_length: Any, i: Any) -> Any: ...
 
 class IncrIbm2AlignmentModel(Ibm2AlignmentModel, IncrAlignmentModel):
     def __init__(self) -> None: ...
@@ -127,6 +167,10 @@ class HmmAlignmentModel(Ibm1AlignmentModel, AlignmentModel):
     @overload
     def __init__(self, model: Ibm1AlignmentModel) -> None: ...
     @property
+    def collect_ibm3_transfer_counts(self) -> bool: ...
+    @collect_ibm3_transfer_counts.setter
+    def collect_ibm3_transfer_counts(self, value: bool) -> None: ...
+    @property
     def hmm_p0(self) -> float: ...
     @hmm_p0.setter
     def hmm_p0(self, value: float) -> None: ...
@@ -138,8 +182,14 @@ class HmmAlignmentModel(Ibm1AlignmentModel, AlignmentModel):
     def hmm_alignment_smoothing_factor(self) -> float: ...
     @hmm_alignment_smoothing_factor.setter
     def hmm_alignment_smoothing_factor(self, value: float) -> None: ...
+    @overload
     def hmm_alignment_log_prob(self, prev_i: int, src_length: int, i: int) -> float: ...
+    @overload
+    def hmm_alignment_log_prob(self, prev_i: Any, src_length: Any, i: Any) -> Any: ...
+    @overload
     def hmm_alignment_prob(self, prev_i: int, src_length: int, i: int) -> float: ...
+    @overload
+    def hmm_alignment_prob(self, prev_i: Any, src_length: Any, i: Any) -> Any: ...
 
 class IncrHmmAlignmentModel(HmmAlignmentModel, IncrAlignmentModel):
     def __init__(self) -> None: ...
@@ -150,8 +200,14 @@ class FastAlignModel(IncrAlignmentModel):
     def fast_align_p0(self) -> float: ...
     @fast_align_p0.setter
     def fast_align_p0(self, value: float) -> None: ...
+    @overload
     def alignment_log_prob(self, j: int, src_length: int, trg_length: int, i: int) -> float: ...
+    @overload
+    def alignment_log_prob(self, j: Any, src_length: Any, trg_length: Any, i: Any) -> Any: ...
+    @overload
     def alignment_prob(self, j: int, src_length: int, trg_length: int, i: int) -> float: ...
+    @overload
+    def alignment_prob(self, j: Any, src_length: Any, trg_length: Any, i: Any) -> Any: ...
 
 class Ibm3AlignmentModel(Ibm2AlignmentModel, Ibm1AlignmentModel, AlignmentModel):
     @overload
@@ -31,6 +31,14 @@ class SmtModel:
     @e.setter
     def e(self, value: int) -> None: ...
     @property
+    def cube_pruning_pop_limit(self) -> int: ...
+    @cube_pruning_pop_limit.setter
+    def cube_pruning_pop_limit(self, value: int) -> None: ...
+    @property
+    def future_cost_caching(self) -> bool: ...
+    @future_cost_caching.setter
+    def future_cost_caching(self, value: bool) -> None: ...
+    @property
     def heuristic(self) -> int: ...
     @heuristic.setter
     def heuristic(self, value: int) -> None: ...
@@ -125,6 +133,9 @@ class PhraseModel:
     def __init__(self) -> None: ...
     def build(self, alignment_filename: str, parameters: PhraseExtractParameters, pseudo_ml: bool) -> bool: ...
     def print_phrase_table(self, filename: str, n: int = -1) -> bool: ...
+    def enable_external_counting(self, memory_budget: int = 536870912) -> None: ...
+    @staticmethod
+    def compile_phrase_table(filename: str, compiled_filename: str) -> bool: ...
     def clear(self) -> None: ...
 
 class AlignmentExtractor: